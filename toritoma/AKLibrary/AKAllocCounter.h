@@ -27,24 +27,23 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 /*!
- @file AKTileMapEventParameter.m
- @brief タイルマップイベントパラメータクラス
+ @file AKAllocCounter.h
+ @brief メモリ確保回数計測クラス
  
- タイルマップイベント処理で使用するパラメータ。
+ メモリ確保回数を計測するクラスを定義する。
  */
 
-#import "AKTileMapEventParameter.h"
+#import <Foundation/Foundation.h>
+#import "AKCommon.h"
 
-/*!
- @brief タイルマップイベントパラメータクラス
- 
- タイルマップイベント処理で使用するパラメータ。
- */
-@implementation AKTileMapEventParameter
+// メモリ確保回数計測クラス
+@interface AKAllocCounter : NSObject
 
-@synthesize x = x_;
-@synthesize y = y_;
-@synthesize properties = properties_;
-@synthesize data = data_;
+// 計測開始(呼び出したスレッドを計測対象に加える)
++ (void)install;
+// 計測中かどうか
++ (BOOL)isInstalled;
+// 呼び出したスレッドのメモリ確保回数取得
++ (int64_t)count;
 
 @end
@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2013 Akihiro Kaneda.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1.Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   2.Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   3.Neither the name of the Monochrome Soft nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ @file AKAllocCounter.m
+ @brief メモリ確保回数計測クラス
+ 
+ メモリ確保回数を計測するクラスを定義する。
+ */
+
+#import <malloc/malloc.h>
+#import <mach/mach.h>
+#import <pthread.h>
+#import "AKAllocCounter.h"
+
+/// スレッドごとのメモリ確保回数を格納するスレッド固有データのキー
+static pthread_key_t countKey_;
+/// 計測中かどうか
+static BOOL isInstalled_ = NO;
+/// 元のmalloc関数
+static void *(*originalMalloc_)(malloc_zone_t *zone, size_t size) = NULL;
+/// 元のcalloc関数
+static void *(*originalCalloc_)(malloc_zone_t *zone, size_t num, size_t size) = NULL;
+/// 元のrealloc関数
+static void *(*originalRealloc_)(malloc_zone_t *zone, void *ptr, size_t size) = NULL;
+
+/*!
+ @brief メモリ確保回数のカウント
+ 
+ 呼び出したスレッドが計測対象の場合のみ、そのスレッドのメモリ確保回数をカウントする。
+ スレッド固有データの取得はメモリ確保を行わないため、確保関数の中から呼び出すことができる。
+ */
+static inline void AKCountAlloc(void)
+{
+    int64_t *count = pthread_getspecific(countKey_);
+    if (count != NULL) {
+        (*count)++;
+    }
+}
+
+/*!
+ @brief 計測用malloc関数
+ 
+ 計測対象のスレッドの場合はメモリ確保回数をカウントしてから元のmalloc関数を呼び出す。
+ @param zone メモリゾーン
+ @param size 確保サイズ
+ @return 確保したメモリ
+ */
+static void *AKCountingMalloc(malloc_zone_t *zone, size_t size)
+{
+    AKCountAlloc();
+    return originalMalloc_(zone, size);
+}
+
+/*!
+ @brief 計測用calloc関数
+ 
+ 計測対象のスレッドの場合はメモリ確保回数をカウントしてから元のcalloc関数を呼び出す。
+ @param zone メモリゾーン
+ @param num 要素数
+ @param size 要素サイズ
+ @return 確保したメモリ
+ */
+static void *AKCountingCalloc(malloc_zone_t *zone, size_t num, size_t size)
+{
+    AKCountAlloc();
+    return originalCalloc_(zone, num, size);
+}
+
+/*!
+ @brief 計測用realloc関数
+ 
+ 計測対象のスレッドの場合はメモリ確保回数をカウントしてから元のrealloc関数を呼び出す。
+ @param zone メモリゾーン
+ @param ptr 再確保するメモリ
+ @param size 確保サイズ
+ @return 確保したメモリ
+ */
+static void *AKCountingRealloc(malloc_zone_t *zone, void *ptr, size_t size)
+{
+    AKCountAlloc();
+    return originalRealloc_(zone, ptr, size);
+}
+
+// プライベートメソッド宣言
+@interface AKAllocCounter ()
+// 確保関数の差し替え
++ (void)replaceZoneFunctions;
+@end
+
+/*!
+ @brief メモリ確保回数計測クラス
+ 
+ デフォルトのメモリゾーンの確保関数を差し替えて、メモリ確保回数を計測する。
+ Objective-Cのオブジェクト生成もデフォルトゾーンを経由するため、計測対象に含まれる。
+ 計測は一度開始するとアプリケーション終了まで継続する。
+ 回数はスレッドごとに数え、計測開始を呼び出したスレッドのみを対象とする。
+ ステージの先読みやGCDのワーカースレッドなど、他のスレッドのメモリ確保は計測結果に含まれない。
+ 確保関数の差し替えはプロセス全体に影響するため、デバッグビルドでのみ使用する。
+ */
+@implementation AKAllocCounter
+
+/*!
+ @brief 計測開始
+ 
+ 呼び出したスレッドを計測対象に加え、初回のみデフォルトのメモリゾーンの確保関数を計測用の関数に差し替える。
+ */
++ (void)install
+{
+    @synchronized(self) {
+        
+        // 初回はスレッド固有データのキーを作成し、確保関数を差し替える
+        if (!isInstalled_) {
+            [self replaceZoneFunctions];
+        }
+        
+        // 呼び出したスレッドの回数の格納領域がない場合は作成する
+        // スレッド終了時に解放する
+        if (pthread_getspecific(countKey_) == NULL) {
+            pthread_setspecific(countKey_, calloc(1, sizeof(int64_t)));
+        }
+    }
+}
+
+/*!
+ @brief 確保関数の差し替え
+ 
+ スレッドごとの回数を格納するスレッド固有データのキーを作成し、
+ デフォルトのメモリゾーンの確保関数を計測用の関数に差し替える。
+ */
++ (void)replaceZoneFunctions
+{
+    int result = pthread_key_create(&countKey_, free);
+    NSAssert(result == 0, @"スレッド固有データのキーの作成に失敗:result=%d", result);
+    
+    malloc_zone_t *zone = malloc_default_zone();
+    
+    // ゾーンの関数テーブルを書き込み可能にする
+    kern_return_t ret = vm_protect(mach_task_self(),
+                                   (vm_address_t)zone,
+                                   sizeof(malloc_zone_t),
+                                   0,
+                                   VM_PROT_READ | VM_PROT_WRITE);
+    NSAssert(ret == KERN_SUCCESS, @"メモリゾーンの保護属性変更に失敗:ret=%d", ret);
+    
+    // 元の関数を退避して計測用の関数に差し替える
+    originalMalloc_ = zone->malloc;
+    originalCalloc_ = zone->calloc;
+    originalRealloc_ = zone->realloc;
+    zone->malloc = AKCountingMalloc;
+    zone->calloc = AKCountingCalloc;
+    zone->realloc = AKCountingRealloc;
+    
+    // 保護属性を元に戻す
+    vm_protect(mach_task_self(),
+               (vm_address_t)zone,
+               sizeof(malloc_zone_t),
+               0,
+               VM_PROT_READ);
+    
+    isInstalled_ = YES;
+}
+
+/*!
+ @brief 計測中かどうか
+ 
+ メモリ確保回数の計測を開始しているかどうかを取得する。
+ @return 計測中かどうか
+ */
++ (BOOL)isInstalled
+{
+    return isInstalled_;
+}
+
+/*!
+ @brief メモリ確保回数取得
+ 
+ 呼び出したスレッドの計測開始からのメモリ確保回数を取得する。
+ 区間の確保回数は前後の値の差分で求める。
+ @return メモリ確保回数。計測対象でないスレッドの場合は0
+ */
++ (int64_t)count
+{
+    if (!isInstalled_) {
+        return 0;
+    }
+    
+    int64_t *count = pthread_getspecific(countKey_);
+    return (count != NULL ? *count : 0);
+}
+
+@end
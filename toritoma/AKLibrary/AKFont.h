@@ -40,12 +40,19 @@
 // フォントサイズ
 extern const NSInteger kAKFontSize;
 
+/// 文字テーブルのページ数(文字コードの上位8bit)
+#define kAKGlyphPageCount 256
+
 // フォント管理クラス
 @interface AKFont : NSObject {
     /// 文字のテクスチャ内の位置情報
     NSDictionary *fontMap_;
     /// フォントテクスチャ
     CCTexture2D *fontTexture_;
+    /// 文字コードごとのスプライトフレーム(上位8bitでページ、下位8bitと色反転有無でページ内の位置を決める)
+    CCSpriteFrame **glyphPages_[kAKGlyphPageCount];
+    /// 位置情報に存在しない文字のスプライトフレーム(通常、色反転)
+    CCSpriteFrame *dummyFrames_[2];
 }
 
 /// 文字のテクスチャ内の位置情報
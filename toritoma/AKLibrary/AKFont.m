@@ -46,6 +46,8 @@ static NSString *kAKFontImageName = @"Font.png";
 static NSString *kAKFontMapName = @"Font";
 /// 色反転フォントの位置のキー
 static NSString *kAKReversePosKey = @"Reverse";
+/// 文字テーブルの1ページの文字数(文字コードの下位8bit)
+static const NSInteger kAKGlyphPageSize = 256;
 
 // シングルトンオブジェクト
 static AKFont *sharedInstance_;
@@ -54,7 +56,17 @@ static AKFont *sharedInstance_;
  @brief フォント管理クラス
  
  フォントのテクスチャ情報を管理する。
+ 文字のスプライトフレームは初期化時に位置情報のすべての文字について作成し、文字コードで引けるテーブルに格納する。
+ テーブルは文字コードの上位8bitごとのページに分け、文字が存在するページのみ確保する。
  */
+// プライベートメソッド宣言
+@interface AKFont ()
+// 文字テーブル作成
+- (void)createGlyphTable;
+// テクスチャ内の位置からスプライトフレームを作成する
+- (CCSpriteFrame *)newSpriteFrameWithRect:(CGRect)rect isReverse:(BOOL)isReverse;
+@end
+
 @implementation AKFont
 
 @synthesize fontMap = fontMap_;
@@ -114,6 +126,9 @@ static AKFont *sharedInstance_;
     self.fontMap = [NSDictionary dictionaryWithContentsOfFile:filePath];
     assert(self.fontMap != nil);
     
+    // 文字テーブルを作成する
+    [self createGlyphTable];
+    
     return self;
 }
 
@@ -124,6 +139,21 @@ static AKFont *sharedInstance_;
  */
 - (void)dealloc
 {
+    // 文字テーブルを解放する
+    for (NSInteger page = 0; page < kAKGlyphPageCount; page++) {
+        
+        if (glyphPages_[page] == NULL) {
+            continue;
+        }
+        
+        for (NSInteger i = 0; i < kAKGlyphPageSize * 2; i++) {
+            [glyphPages_[page][i] release];
+        }
+        free(glyphPages_[page]);
+    }
+    [dummyFrames_[0] release];
+    [dummyFrames_[1] release];
+    
     // メンバを解放する
     self.fontMap = nil;
     self.fontTexture = nil;
@@ -132,6 +162,66 @@ static AKFont *sharedInstance_;
     [super dealloc];
 }
 
+/*!
+ @brief 文字テーブル作成
+ 
+ 位置情報の1文字のキーすべてについて通常と色反転のスプライトフレームを作成し、文字テーブルに格納する。
+ 位置情報に存在しない文字用にダミー文字のスプライトフレームも作成する。
+ */
+- (void)createGlyphTable
+{
+    // 位置情報に存在しない文字のスプライトフレームを作成する
+    CGRect dummyRect = CGRectMake(0, 0, [AKFont fontSize], [AKFont fontSize]);
+    dummyFrames_[0] = [self newSpriteFrameWithRect:dummyRect isReverse:NO];
+    dummyFrames_[1] = [self newSpriteFrameWithRect:dummyRect isReverse:YES];
+    
+    for (NSString *key in [self.fontMap keyEnumerator]) {
+        
+        // 1文字のキー以外は文字テーブルには格納しない
+        if (key.length != 1) {
+            continue;
+        }
+        
+        // 文字コードからページと位置を計算する
+        unichar c = [key characterAtIndex:0];
+        NSInteger page = c / kAKGlyphPageSize;
+        NSInteger index = (c % kAKGlyphPageSize) * 2;
+        
+        // ページが確保されていない場合は確保する
+        if (glyphPages_[page] == NULL) {
+            glyphPages_[page] = calloc(kAKGlyphPageSize * 2, sizeof(CCSpriteFrame *));
+        }
+        
+        // 通常と色反転のスプライトフレームを格納する
+        CGRect rect = [self rectByKey:key];
+        glyphPages_[page][index] = [self newSpriteFrameWithRect:rect isReverse:NO];
+        glyphPages_[page][index + 1] = [self newSpriteFrameWithRect:rect isReverse:YES];
+    }
+}
+
+/*!
+ @brief テクスチャ内の位置からスプライトフレームを作成する
+ 
+ フォントのテクスチャから指定した位置を切り出したスプライトフレームを作成する。
+ 色反転する場合は色反転の座標をプラスした位置を切り出す。
+ 呼び出し元で解放する必要がある。
+ @param rect テクスチャ内の位置
+ @param isReverse 色反転するかどうか
+ @return スプライトフレーム
+ */
+- (CCSpriteFrame *)newSpriteFrameWithRect:(CGRect)rect isReverse:(BOOL)isReverse
+{
+    // 色反転する場合は色反転の座標をプラスする
+    if (isReverse) {
+        CGRect reverseRect = [self rectByKey:kAKReversePosKey];
+        
+        rect.origin.x += reverseRect.origin.x;
+        rect.origin.y += reverseRect.origin.y;
+    }
+    
+    return [[CCSpriteFrame alloc] initWithTexture:self.fontTexture rect:rect];
+}
+
 /*!
  @brief 文字のテクスチャ内の位置を取得する
  
@@ -183,28 +273,28 @@ static AKFont *sharedInstance_;
 /*!
  @brief 文字のスプライトフレームを取得する
  
- 文字のスプライトフレームを取得する。
+ 文字のスプライトフレームを文字テーブルから取得する。
+ スプライトフレームは全ラベルで共有するため、変更してはならない。
  @param c 文字
  @param isReverse 色反転するかどうか
  @return 文字のスプライトフレーム
  */
 - (CCSpriteFrame *)spriteFrameOfChar:(unichar)c isReverse:(BOOL)isReverse
 {
-    AKLog(kAKLogFont_1, @"c=%c rect=(%f,%f) isReverse=%d", c, [self rectOfChar:c].origin.x, [self rectOfChar:c].origin.y, isReverse);
+    // 文字コードのページを取得する
+    CCSpriteFrame **page = glyphPages_[c / kAKGlyphPageSize];
     
-    // 文字の座標を取得する
-    CGRect charRect = [self rectOfChar:c];
+    // 文字テーブルから取得する
+    CCSpriteFrame *frame = (page != NULL ? page[(c % kAKGlyphPageSize) * 2 + (isReverse ? 1 : 0)] : nil);
     
-    // 色反転する場合は色反転の座標をプラスする
-    if (isReverse) {
-        CGRect reverseRect = [self rectByKey:kAKReversePosKey];
-        
-        charRect.origin.x += reverseRect.origin.x;
-        charRect.origin.y += reverseRect.origin.y;
+    // 見つからない場合は一番左上のダミー文字を返す
+    if (frame == nil) {
+        frame = dummyFrames_[isReverse ? 1 : 0];
     }
     
-    // フォントのテクスチャから文字の部分を切り出して返す
-    return [CCSpriteFrame frameWithTexture:self.fontTexture rect:charRect];
+    AKLog(kAKLogFont_1, @"c=%C rect=(%f,%f) isReverse=%d", c, frame.rect.origin.x, frame.rect.origin.y, isReverse);
+    
+    return frame;
 }
 
 /*!
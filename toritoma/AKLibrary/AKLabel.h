@@ -56,6 +56,12 @@ enum AKLabelFrame {
     enum AKLabelFrame frame_;
     /// 色反転するかどうか
     BOOL isReverse_;
+    /// 各文字のスプライト
+    CCSprite **cellSprites_;
+    /// 各文字のスプライトに表示中の文字(0は未表示)
+    unichar *cellChars_;
+    /// 数値の設定により表示文字列が表示内容と一致していないかどうか
+    BOOL isStringStale_;
 }
 
 /// 表示文字列
@@ -73,6 +79,8 @@ enum AKLabelFrame {
 - (id)initWithString:(NSString *)str maxLength:(NSInteger)length maxLine:(NSInteger)line frame:(enum AKLabelFrame)frame;
 // 初期文字列を指定したコンビニエンスコンストラクタ
 + (id)labelWithString:(NSString *)str maxLength:(NSInteger)length maxLine:(NSInteger)line frame:(enum AKLabelFrame)frame;
+// 数値の表示
+- (void)setNumber:(NSInteger)number digits:(NSInteger)digits position:(NSInteger)position;
 // 枠表示用バッチノード取得
 - (CCSpriteBatchNode *)frameBatch;
 // 文字表示用バッチノード取得
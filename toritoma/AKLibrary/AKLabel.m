@@ -73,6 +73,8 @@ static NSString *kAKBlank = @" ";
 
 /// 1行の高さ(単位：文字)
 static const float kAKLabelLineHeight = 1.5f;
+/// 表示中の文字の未表示を表す値
+static const unichar kAKNoChar = 0;
 
 // バッチノードのz座標(タグ兼用)
 enum {
@@ -84,6 +86,7 @@ enum {
  @brief ラベル表示クラス
  
  テキストラベルを表示する。
+ 各文字のスプライトに表示中の文字を記憶しておき、表示文字列の変更時は文字が変わったスプライトのみ差し替える。
  */
 @implementation AKLabel
 
@@ -183,6 +186,11 @@ enum {
     // 色反転はなしとする
     isReverse_ = NO;
     
+    // 各文字のスプライトと表示中の文字を記憶する領域を確保する
+    // 表示中の文字は未表示としておき、最初の文字列設定ですべて差し替える
+    cellSprites_ = malloc(sizeof(CCSprite *) * length * line);
+    cellChars_ = calloc(length * line, sizeof(unichar));
+    
     // 文字表示用バッチノードを生成する
     [self addChild:[CCSpriteBatchNode batchNodeWithTexture:[AKFont sharedInstance].fontTexture capacity:length * line]
                  z:kAKLabelBatchPosZ
@@ -225,6 +233,10 @@ enum {
             
             // バッチノードに登録する
             [self.labelBatch addChild:charSprite];
+            
+            // 文字列設定時にバッチノードから検索しなくて済むように記憶しておく
+            // スプライトはバッチノードが保持しているため、ここでは保持しない
+            cellSprites_[x + y * length_] = charSprite;
         }
     }
     
@@ -280,8 +292,13 @@ enum {
         // 枠を更新する
         [self createFrame];
         
+        // すべての文字を差し替えるため、表示中の文字を未表示にする
+        for (NSInteger i = 0; i < length_ * line_; i++) {
+            cellChars_[i] = kAKNoChar;
+        }
+        
         // 表示文字列を更新する
-        [self setString:self.labelString];
+        [self setString:self.string];
     }
 }
 
@@ -316,6 +333,8 @@ enum {
 {
     // メンバを解放する
     self.labelString = nil;
+    free(cellSprites_);
+    free(cellChars_);
     
     // スーパークラスの解放処理を実行する
     [super dealloc];
@@ -325,17 +344,37 @@ enum {
  @brief 表示文字列の取得
  
  表示文字列を取得する。
+ 数値の表示によって表示内容が変わっている場合は、表示中の文字から表示文字列を作り直す。
  @return 表示文字列
  */
 - (NSString *)string
 {
-    return labelString_;
+    // 表示文字列が表示内容と一致していない場合は作り直す
+    if (isStringStale_) {
+        
+        NSMutableString *string = [NSMutableString stringWithCapacity:(length_ + 1) * line_];
+        for (NSInteger y = 0; y < line_; y++) {
+            
+            // 2行目以降は改行文字を入れる
+            if (y > 0) {
+                [string appendString:@"\n"];
+            }
+            
+            [string appendString:[NSString stringWithCharacters:&cellChars_[y * length_] length:length_]];
+        }
+        
+        self.labelString = string;
+        isStringStale_ = NO;
+    }
+    
+    return self.labelString;
 }
 
 /*!
  @brief 表示文字列の設定
  
  表示文字列を変更する。
+ 文字列を先頭から1回だけ走査し、表示中の文字と異なる文字のスプライトのみ差し替える。
  @param label 表示文字列
  */
 - (void)setString:(NSString *)label
@@ -346,11 +385,14 @@ enum {
     assert(label.length <= length_ * line_);
     
     // パラメータをメンバに設定する
-    if (![self.labelString isEqualToString:label]) {
+    if (isStringStale_ || ![self.labelString isEqualToString:label]) {
         self.labelString = [[label copy] autorelease];
+        isStringStale_ = NO;
     }
     
     // 各文字のスプライトを変更する
+    AKFont *font = [AKFont sharedInstance];
+    NSUInteger stringLength = self.labelString.length;
     int charpos = 0;
     BOOL isNewLine = NO;
     for (int y = 0; y < line_; y++) {
@@ -360,13 +402,10 @@ enum {
         
         for (int x = 0; x < length_; x++) {
             
-            // バッチノードからスプライトを取り出す
-            CCSprite *charSprite = (CCSprite *)[self.labelBatch getChildByTag:x + y * length_];
-
             unichar c = ' ';
             
             // 改行されておらず、文字列がまだ残っている場合、1文字切り出す
-            if (!isNewLine && charpos < self.labelString.length) {
+            if (!isNewLine && charpos < stringLength) {
                 c = [self.labelString characterAtIndex:charpos];
                 charpos++;
                 
@@ -381,22 +420,74 @@ enum {
                 c = ' ';
             }
             
+            // 表示中の文字と同じ場合はスプライトを差し替えない
+            NSInteger cell = x + y * length_;
+            if (cellChars_[cell] == c) {
+                continue;
+            }
+            
             AKLog(kAKLogLabel_1, @"x=%d y=%d c=%C", x, y, c);
             
-            // フォントクラスからスプライトフレームを生成する
-            CCSpriteFrame *charSpriteFrame = [[AKFont sharedInstance] spriteFrameOfChar:c isReverse:self.isReverse];
+            // フォントクラスからスプライトフレームを取得する
+            CCSpriteFrame *charSpriteFrame = [font spriteFrameOfChar:c isReverse:self.isReverse];
             
             // スプライトを差し替える
-            [charSprite setDisplayFrame:charSpriteFrame];
+            [cellSprites_[cell] setDisplayFrame:charSpriteFrame];
+            cellChars_[cell] = c;
         }
         
         // 行末の改行文字は飛ばす
-        if (charpos < self.labelString.length && [self.labelString characterAtIndex:charpos] == '\n') {
+        if (charpos < stringLength && [self.labelString characterAtIndex:charpos] == '\n') {
             charpos++;
         }
     }
 }
 
+/*!
+ @brief 数値の表示
+ 
+ 指定した位置から指定した桁数の文字を数値の各桁の文字に置き換える。
+ 表示桁数に満たない上位の桁は0で埋め、表示桁数を超える場合はすべての桁を9とする。
+ 文字列を作成せずに数値から直接文字を決めるため、毎フレーム変化する数値の表示に使用する。
+ 表示中の文字と異なる桁のスプライトのみ差し替える。
+ @param number 表示する数値(0以上)
+ @param digits 表示桁数
+ @param position 先頭の桁の位置(先頭からの文字数)
+ */
+- (void)setNumber:(NSInteger)number digits:(NSInteger)digits position:(NSInteger)position
+{
+    NSAssert(number >= 0, @"負の数値は表示できない");
+    NSAssert(position >= 0 && position + digits <= length_ * line_, @"表示位置が範囲外");
+    
+    AKFont *font = [AKFont sharedInstance];
+    
+    // 表示桁数を超えているかどうかを調べる
+    NSInteger rest = number;
+    for (NSInteger i = 0; i < digits; i++) {
+        rest /= 10;
+    }
+    BOOL isOverflow = (rest > 0);
+    
+    // 下の桁から順に文字を決める
+    for (NSInteger i = position + digits - 1; i >= position; i--) {
+        
+        unichar c = (isOverflow ? '9' : '0' + number % 10);
+        number /= 10;
+        
+        // 表示中の文字と同じ場合はスプライトを差し替えない
+        if (cellChars_[i] == c) {
+            continue;
+        }
+        
+        // スプライトを差し替える
+        [cellSprites_[i] setDisplayFrame:[font spriteFrameOfChar:c isReverse:self.isReverse]];
+        cellChars_[i] = c;
+        
+        // 表示文字列が表示内容と一致しなくなる
+        isStringStale_ = YES;
+    }
+}
+
 /*!
  @brief char配列による表示文字列の設定
  
@@ -56,3 +56,6 @@
 
 // カスタマイズNavigation Controller
 #import "AKNavigationController.h"
+
+// メモリ確保回数計測クラス
+#import "AKAllocCounter.h"
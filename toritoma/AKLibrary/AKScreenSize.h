@@ -44,6 +44,10 @@ extern const CGSize kAKStageSize;
 
 // 画面サイズ取得
 + (CGSize)screenSize;
+// 固定画面サイズ設定
++ (void)setFixedScreenSize:(CGSize)size;
+// 固定画面サイズ取得
++ (CGSize)fixedScreenSize;
 // ステージサイズ取得
 + (CGSize)stageSize;
 // 中央座標取得
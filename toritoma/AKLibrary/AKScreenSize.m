@@ -39,6 +39,9 @@
 /// ゲーム画面のステージサイズ
 const CGSize kAKStageSize = {384, 288};
 
+/// 固定画面サイズ(幅が0の場合はデバイスの画面サイズを使用する)
+static CGSize fixedScreenSize_ = {0, 0};
+
 /*!
  @brief 画面サイズ管理クラス
  
@@ -54,11 +57,40 @@ const CGSize kAKStageSize = {384, 288};
  */
 + (CGSize)screenSize
 {
+    // 固定画面サイズが設定されている場合はそれを返す
+    if (fixedScreenSize_.width > 0) {
+        return fixedScreenSize_;
+    }
+    
     // Landscapeのため、画面の幅と高さを入れ替えて返す
     return CGSizeMake([[UIScreen mainScreen] bounds].size.height,
                       [[UIScreen mainScreen] bounds].size.width);
 }
 
+/*!
+ @brief 固定画面サイズ設定
+ 
+ デバイスの画面サイズの代わりに使用する画面サイズを設定する。
+ 画面を使用せずにゲームを実行する場合に、デバイスによらず同じ座標で処理するために使用する。
+ 幅0のサイズを設定するとデバイスの画面サイズを使用する状態に戻る。
+ @param size 画面サイズ
+ */
++ (void)setFixedScreenSize:(CGSize)size
+{
+    fixedScreenSize_ = size;
+}
+
+/*!
+ @brief 固定画面サイズ取得
+ 
+ デバイスの画面サイズの代わりに使用する画面サイズを取得する。
+ @return 画面サイズ。設定されていない場合は幅0のサイズを返す。
+ */
++ (CGSize)fixedScreenSize
+{
+    return fixedScreenSize_;
+}
+
 /*!
  @brief ステージサイズ取得
  
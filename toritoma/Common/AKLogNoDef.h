@@ -38,6 +38,8 @@
 #ifdef DEBUG
 extern BOOL kAKLogBack_0;
 extern BOOL kAKLogBack_1;
+extern BOOL kAKLogBenchmark_0;
+extern BOOL kAKLogBenchmark_1;
 extern BOOL kAKLogBlock_0;
 extern BOOL kAKLogBlock_1;
 extern BOOL kAKLogCharacter_0;
@@ -49,6 +51,8 @@ extern BOOL kAKLogCharacterPool_0;
 extern BOOL kAKLogCharacterPool_1;
 extern BOOL kAKLogChickenGauge_0;
 extern BOOL kAKLogChickenGauge_1;
+extern BOOL kAKLogCollisionGrid_0;
+extern BOOL kAKLogCollisionGrid_1;
 extern BOOL kAKLogEffect_0;
 extern BOOL kAKLogEffect_1;
 extern BOOL kAKLogEnemy_0;
@@ -58,16 +62,29 @@ extern BOOL kAKLogEnemy_3;
 extern BOOL kAKLogEnemyShot_0;
 extern BOOL kAKLogEnemyShot_1;
 extern BOOL kAKLogEnemyShot_2;
+extern BOOL kAKLogEnemyShotEngine_0;
+extern BOOL kAKLogEnemyShotEngine_1;
+extern BOOL kAKLogEnemyShotEngine_2;
+extern BOOL kAKLogFrameProfiler_0;
+extern BOOL kAKLogFrameProfiler_1;
 extern BOOL kAKLogGameCenterHelper_0;
 extern BOOL kAKLogGameCenterHelper_1;
+extern BOOL kAKLogHeadlessRunner_0;
+extern BOOL kAKLogHeadlessRunner_1;
 extern BOOL kAKLogHowToPlayScene_0;
 extern BOOL kAKLogHowToPlayScene_1;
+extern BOOL kAKLogInputRecorder_0;
+extern BOOL kAKLogInputRecorder_1;
+extern BOOL kAKLogInputReplayer_0;
+extern BOOL kAKLogInputReplayer_1;
 extern BOOL kAKLogLife_0;
 extern BOOL kAKLogLife_1;
 extern BOOL kAKLogOption_0;
 extern BOOL kAKLogOption_1;
 extern BOOL kAKLogOptionScene_0;
 extern BOOL kAKLogOptionScene_1;
+extern BOOL kAKLogParallelRunner_0;
+extern BOOL kAKLogParallelRunner_1;
 extern BOOL kAKLogPlayData_0;
 extern BOOL kAKLogPlayData_1;
 extern BOOL kAKLogPlayData_2;
@@ -89,6 +106,12 @@ extern BOOL kAKLogScript_3;
 extern BOOL kAKLogScript_4;
 extern BOOL kAKLogScriptData_0;
 extern BOOL kAKLogScriptData_1;
+extern BOOL kAKLogSnapshot_0;
+extern BOOL kAKLogSnapshot_1;
+extern BOOL kAKLogStagePack_0;
+extern BOOL kAKLogStagePack_1;
+extern BOOL kAKLogStagePrefetcher_0;
+extern BOOL kAKLogStagePrefetcher_1;
 extern BOOL kAKLogTitleScene_0;
 extern BOOL kAKLogTitleScene_1;
 #endif
\ No newline at end of file
@@ -38,6 +38,8 @@
 #ifdef DEBUG
 BOOL kAKLogBack_0 = YES;
 BOOL kAKLogBack_1 = NO;
+BOOL kAKLogBenchmark_0 = YES;
+BOOL kAKLogBenchmark_1 = NO;
 BOOL kAKLogBlock_0 = YES;
 BOOL kAKLogBlock_1 = NO;
 BOOL kAKLogCharacter_0 = YES;
@@ -49,6 +51,8 @@ BOOL kAKLogCharacterPool_0 = YES;
 BOOL kAKLogCharacterPool_1 = NO;
 BOOL kAKLogChickenGauge_0 = YES;
 BOOL kAKLogChickenGauge_1 = NO;
+BOOL kAKLogCollisionGrid_0 = YES;
+BOOL kAKLogCollisionGrid_1 = NO;
 BOOL kAKLogEffect_0 = YES;
 BOOL kAKLogEffect_1 = NO;
 BOOL kAKLogEnemy_0 = YES;
@@ -58,16 +62,29 @@ BOOL kAKLogEnemy_3 = NO;
 BOOL kAKLogEnemyShot_0 = YES;
 BOOL kAKLogEnemyShot_1 = NO;
 BOOL kAKLogEnemyShot_2 = NO;
+BOOL kAKLogEnemyShotEngine_0 = YES;
+BOOL kAKLogEnemyShotEngine_1 = NO;
+BOOL kAKLogEnemyShotEngine_2 = NO;
+BOOL kAKLogFrameProfiler_0 = YES;
+BOOL kAKLogFrameProfiler_1 = NO;
 BOOL kAKLogGameCenterHelper_0 = YES;
 BOOL kAKLogGameCenterHelper_1 = YES;
+BOOL kAKLogHeadlessRunner_0 = YES;
+BOOL kAKLogHeadlessRunner_1 = NO;
 BOOL kAKLogHowToPlayScene_0 = YES;
 BOOL kAKLogHowToPlayScene_1 = NO;
+BOOL kAKLogInputRecorder_0 = YES;
+BOOL kAKLogInputRecorder_1 = NO;
+BOOL kAKLogInputReplayer_0 = YES;
+BOOL kAKLogInputReplayer_1 = NO;
 BOOL kAKLogLife_0 = YES;
 BOOL kAKLogLife_1 = NO;
 BOOL kAKLogOption_0 = YES;
 BOOL kAKLogOption_1 = NO;
 BOOL kAKLogOptionScene_0 = YES;
 BOOL kAKLogOptionScene_1 = NO;
+BOOL kAKLogParallelRunner_0 = YES;
+BOOL kAKLogParallelRunner_1 = NO;
 BOOL kAKLogPlayData_0 = YES;
 BOOL kAKLogPlayData_1 = NO;
 BOOL kAKLogPlayData_2 = NO;
@@ -89,6 +106,12 @@ BOOL kAKLogScript_3 = NO;
 BOOL kAKLogScript_4 = NO;
 BOOL kAKLogScriptData_0 = YES;
 BOOL kAKLogScriptData_1 = NO;
+BOOL kAKLogSnapshot_0 = YES;
+BOOL kAKLogSnapshot_1 = NO;
+BOOL kAKLogStagePack_0 = YES;
+BOOL kAKLogStagePack_1 = NO;
+BOOL kAKLogStagePrefetcher_0 = YES;
+BOOL kAKLogStagePrefetcher_1 = NO;
 BOOL kAKLogTitleScene_0 = YES;
 BOOL kAKLogTitleScene_1 = NO;
 #endif
\ No newline at end of file
@@ -36,6 +36,27 @@
 #import "AppDelegate.h"
 #import "AKTitleScene.h"
 #import "AKPlayingScene.h"
+#import "AKHeadlessRunner.h"
+#import "AKParallelRunner.h"
+#import "AKBenchmark.h"
+#import "AKStagePack.h"
+
+#ifdef DEBUG
+/// 画面なし実行するステージ番号の起動引数名
+static NSString *kAKHeadlessStageKey = @"AKHeadlessStage";
+/// 画面なし実行する状態更新回数の起動引数名
+static NSString *kAKHeadlessTicksKey = @"AKHeadlessTicks";
+/// 画面なし実行する状態更新回数のデフォルト値
+static const NSInteger kAKHeadlessDefaultTicks = 3600;
+/// 画面なしで再生する入力記録ファイルの起動引数名
+static NSString *kAKHeadlessReplayKey = @"AKHeadlessReplay";
+/// 画面なしで並列実行する回数の起動引数名
+static NSString *kAKHeadlessRunsKey = @"AKHeadlessRuns";
+/// 負荷計測する状態更新回数の起動引数名
+static NSString *kAKBenchmarkTicksKey = @"AKBenchmarkTicks";
+/// ステージパックファイルの出力先ディレクトリの起動引数名
+static NSString *kAKStagePackDirectoryKey = @"AKStagePackDirectory";
+#endif
 
 /*!
  @brief Application controller
@@ -58,6 +79,51 @@
  */
 - (BOOL)application:(UIApplication *)application didFinishLaunchingWithOptions:(NSDictionary *)launchOptions
 {
+#ifdef DEBUG
+    // 起動引数で画面なし実行が指定されている場合は状態更新のみを実行して結果を出力し、終了する
+    // (例: -AKHeadlessStage 1 -AKHeadlessTicks 3600 -AKHeadlessRuns 64、-AKHeadlessReplay input.datのパス)
+    // 負荷計測が指定されている場合は全シナリオを計測して結果を出力し、終了する
+    // (例: -AKBenchmarkTicks 3600)
+    // ステージパックファイルの出力先が指定されている場合は全ステージのタイルマップファイルを変換して終了する
+    // (例: -AKStagePackDirectory 出力先ディレクトリのパス)
+    NSString *stagePackDirectory = [[NSUserDefaults standardUserDefaults] stringForKey:kAKStagePackDirectoryKey];
+    if (stagePackDirectory != nil) {
+        printf("%d\n", [AKStagePack compileAllToDirectory:stagePackDirectory]);
+        exit(0);
+    }
+    
+    NSInteger benchmarkTicks = [[NSUserDefaults standardUserDefaults] integerForKey:kAKBenchmarkTicksKey];
+    if (benchmarkTicks > 0) {
+        printf("%s", [[AKBenchmark runAllWithTickCount:benchmarkTicks] UTF8String]);
+        exit(0);
+    }
+    
+    NSString *headlessReplay = [[NSUserDefaults standardUserDefaults] stringForKey:kAKHeadlessReplayKey];
+    if (headlessReplay != nil) {
+        printf("%s\n", [[AKHeadlessRunner runReplayFile:headlessReplay] UTF8String]);
+        exit(0);
+    }
+    
+    NSInteger headlessStage = [[NSUserDefaults standardUserDefaults] integerForKey:kAKHeadlessStageKey];
+    if (headlessStage > 0) {
+        
+        NSInteger ticks = [[NSUserDefaults standardUserDefaults] integerForKey:kAKHeadlessTicksKey];
+        if (ticks <= 0) {
+            ticks = kAKHeadlessDefaultTicks;
+        }
+        
+        // 実行回数が指定されている場合は並列実行する
+        NSInteger runs = [[NSUserDefaults standardUserDefaults] integerForKey:kAKHeadlessRunsKey];
+        if (runs > 1) {
+            printf("%s", [[AKParallelRunner runStage:headlessStage tickCount:ticks runCount:runs] UTF8String]);
+            exit(0);
+        }
+        
+        printf("%s\n", [[AKHeadlessRunner runStage:headlessStage tickCount:ticks] UTF8String]);
+        exit(0);
+    }
+#endif
+    
 	// Create the main window
 	window_ = [[UIWindow alloc] initWithFrame:[[UIScreen mainScreen] bounds]];
 
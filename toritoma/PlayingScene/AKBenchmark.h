@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2013 Akihiro Kaneda.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1.Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   2.Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   3.Neither the name of the Monochrome Soft nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ @file AKBenchmark.h
+ @brief 負荷計測クラス定義
+ 
+ 高負荷の場面を画面なしで再現して状態更新の処理時間を計測するクラスを定義する。
+ */
+
+#import "AKToritoma.h"
+
+/// 計測シナリオ
+enum AKBenchmarkScenario {
+    kAKBenchmarkEnemyShotGraze = 0, ///< 敵弾最大数でのかすり
+    kAKBenchmarkBlockWalker,        ///< 障害物最大数と地上を歩く敵
+    kAKBenchmarkBoss,               ///< ボスの行動パターン
+    kAKBenchmarkReflection,         ///< シールドによる大量反射
+    kAKBenchmarkStageChange,        ///< ステージの連続読み込み(タイルマップファイル)
+    kAKBenchmarkStageChangePack,    ///< ステージの連続読み込み(ステージパックファイル)
+    kAKBenchmarkScenarioCount       ///< 計測シナリオの数
+};
+
+/// 計測シナリオ1個分の結果
+struct AKBenchmarkResult {
+    NSInteger tickCount;            ///< 計測した状態更新の回数
+    double nsPerTick;               ///< 1回あたりの平均処理時間(ナノ秒)
+    uint64_t p50;                   ///< 処理時間の中央値(ナノ秒)
+    uint64_t p99;                   ///< 処理時間の99パーセンタイル(ナノ秒)
+    uint64_t max;                   ///< 処理時間の最大値(ナノ秒)
+    double allocsPerTick;           ///< 1回あたりのメモリ確保回数(デバッグビルドのみ計測)
+};
+
+// 負荷計測クラス
+@interface AKBenchmark : NSObject {
+    /// 計測結果
+    struct AKBenchmarkResult results_[kAKBenchmarkScenarioCount];
+    /// 状態更新1回ごとの処理時間のバッファ
+    uint64_t *tickTimes_;
+    /// 処理時間のバッファの要素数
+    NSInteger tickCapacity_;
+    /// シナリオ内で生成したキャラクターの通し番号
+    NSInteger serial_;
+}
+
+// シナリオの計測
+- (const struct AKBenchmarkResult *)runScenario:(enum AKBenchmarkScenario)scenario tickCount:(NSInteger)count;
+// 全シナリオの計測
+- (void)runAllWithTickCount:(NSInteger)count;
+// 計測結果取得
+- (const struct AKBenchmarkResult *)resultOfScenario:(enum AKBenchmarkScenario)scenario;
+// 計測結果のJSON文字列作成
+- (NSString *)jsonOfScenario:(enum AKBenchmarkScenario)scenario;
+// 計測結果の文字列作成
+- (NSString *)summary;
+// シナリオ名取得
++ (NSString *)nameOfScenario:(enum AKBenchmarkScenario)scenario;
+// 全シナリオの計測
++ (NSString *)runAllWithTickCount:(NSInteger)count;
+@end
@@ -0,0 +1,712 @@
+/*
+ * Copyright (c) 2013 Akihiro Kaneda.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1.Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   2.Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   3.Neither the name of the Monochrome Soft nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ @file AKBenchmark.m
+ @brief 負荷計測クラス定義
+ 
+ 高負荷の場面を画面なしで再現して状態更新の処理時間を計測するクラスを定義する。
+ */
+
+#import <mach/mach_time.h>
+#import "AKBenchmark.h"
+#import "AKHeadlessRunner.h"
+#import "AKStagePack.h"
+
+/// 計測前に実行する状態更新の回数
+static const NSInteger kAKWarmUpTickCount = 60;
+/// 敵弾の同時出現数
+static const NSInteger kAKShotCount = 256;
+/// 敵弾の生成位置x座標
+static const float kAKShotPosX = 384.0f;
+/// 敵弾の生成位置x座標のずらし幅
+static const float kAKShotPosXStep = 4.0f;
+/// 敵弾の生成位置x座標のずらし数
+static const NSInteger kAKShotPosXCount = 16;
+/// かすり計測時の自機位置x座標
+static const float kAKGrazePlayerPosX = 100.0f;
+/// かすり計測時の自機位置y座標
+static const float kAKGrazePlayerPosY = 144.0f;
+/// かすり計測時の自機と弾の縦方向の最小距離(当たらずにかすり判定に入る距離)
+static const float kAKGrazeDistance = 10.0f;
+/// 障害物のサイズ
+static const float kAKBlockSize = 32.0f;
+/// 障害物の種別
+static const NSInteger kAKBlockType = 6;
+/// 障害物配置の行数
+static const NSInteger kAKBlockMapRowCount = 9;
+/// 障害物配置(上の行から順に'#'の位置に障害物を配置する。障害物プールの最大数と同じ128個)
+static const char *kAKBlockMap[kAKBlockMapRowCount] = {
+    "####################",
+    "####################",
+    "####################",
+    "..#...#...#...#.....",
+    "....................",
+    "....#...#...#...#...",
+    "####################",
+    "####################",
+    "####################"
+};
+/// 地上を歩く敵の同時出現数
+static const NSInteger kAKWalkerCount = 16;
+/// 地上を歩く敵の生成位置の列数(段差のない奇数列に配置する)
+static const NSInteger kAKWalkerColumnCount = 6;
+/// 地面の上端のy座標
+static const float kAKFloorTop = 96.0f;
+/// 天井の下端のy座標
+static const float kAKCeilingBottom = 192.0f;
+/// 地上を歩く敵の種類の数
+static const NSInteger kAKWalkerDefCount = 2;
+/// 地上を歩く敵の定義(敵種別、高さの半分)
+static const struct {
+    NSInteger type;
+    float halfHeight;
+} kAKWalkerDef[kAKWalkerDefCount] = {
+    {2, 8.0f},      // アリ
+    {22, 16.0f}     // カタツムリ
+};
+/// カマキリの敵種別
+static const NSInteger kAKMantisType = 32;
+/// カマキリの生成位置
+static const CGPoint kAKMantisPosition = {300.0f, 56.0f};
+/// カブトムシの敵種別
+static const NSInteger kAKRhinocerosBeetleType = 31;
+/// カブトムシの生成位置
+static const CGPoint kAKRhinocerosBeetlePosition = {340.0f, 144.0f};
+/// 反射計測時の自機の円運動の中心
+static const CGPoint kAKCircleCenter = {120.0f, 144.0f};
+/// 反射計測時の自機の円運動の半径
+static const float kAKCircleRadius = 40.0f;
+/// 反射計測時の自機の円運動の周期(状態更新の回数)
+static const NSInteger kAKCircleFrame = 120;
+/// ステージ連続読み込み時に読み込むステージ番号
+static const NSInteger kAKStageChangeStage = 1;
+/// ステージ連続読み込みの間隔(状態更新の回数)
+static const NSInteger kAKStageChangeInterval = 30;
+/// シナリオ名
+static NSString *kAKScenarioName[kAKBenchmarkScenarioCount] = {
+    @"enemy_shot_graze",
+    @"block_walker",
+    @"boss",
+    @"reflection",
+    @"stage_change",
+    @"stage_change_pack"
+};
+
+/*!
+ @brief 時間のナノ秒への変換
+ 
+ mach_absolute_timeで取得した時間をナノ秒に変換する。
+ @param time 時間
+ @return ナノ秒
+ */
+static double AKNanosecondsOfTime(uint64_t time)
+{
+    // 変換係数は最初に1回だけ取得する
+    static mach_timebase_info_data_t timebase = {0, 0};
+    if (timebase.denom == 0) {
+        mach_timebase_info(&timebase);
+    }
+    
+    return (double)time * timebase.numer / timebase.denom;
+}
+
+/*!
+ @brief 処理時間の比較
+ 
+ qsortで処理時間を昇順に並べ替えるための比較関数。
+ @param a 比較する処理時間
+ @param b 比較する処理時間
+ @return aが小さい場合は負の値、等しい場合は0、aが大きい場合は正の値
+ */
+static int AKCompareTime(const void *a, const void *b)
+{
+    uint64_t timeA = *(const uint64_t *)a;
+    uint64_t timeB = *(const uint64_t *)b;
+    
+    return (timeA > timeB) - (timeA < timeB);
+}
+
+/*!
+ @brief 負荷計測クラス
+ 
+ キャラクターを配置していない画面なしのゲームデータに、シナリオごとに高負荷の場面を作って状態更新を行い、
+ 状態更新1回ごとの処理時間とメモリ確保回数を計測する。
+ シナリオが毎回行うキャラクターの補充も計測に含め、ゲーム中の1フレーム分の処理として扱う。
+ 計測前に慣らし運転を行い、プールやバッファの拡張が落ち着いてから計測する。
+ 計測結果はシナリオごとに1行のJSON形式で出力し、計測結果の比較に使用する。
+ */
+// プライベートメソッド宣言
+@interface AKBenchmark ()
+// シナリオの初期配置
+- (void)setupScenario:(enum AKBenchmarkScenario)scenario data:(AKPlayData *)data;
+// シナリオの状態更新前処理
+- (void)prepareScenario:(enum AKBenchmarkScenario)scenario data:(AKPlayData *)data tick:(NSInteger)tick;
+// 自機の無敵状態維持
+- (void)keepPlayerInvincible:(AKPlayData *)data;
+// かすり判定に入る敵弾の補充
+- (void)fillGrazeShots:(AKPlayData *)data;
+// 自機を狙う敵弾の補充
+- (void)fillAimedShots:(AKPlayData *)data;
+// 障害物の配置
+- (void)createBlocks:(AKPlayData *)data;
+// 地上を歩く敵の補充
+- (void)fillWalkers:(AKPlayData *)data;
+// ボスの補充
+- (void)fillBosses:(AKPlayData *)data;
+// 自機の円運動
+- (void)movePlayerInCircle:(AKPlayData *)data tick:(NSInteger)tick;
+// ステージの再読み込み
+- (void)reloadStage:(AKPlayData *)data scenario:(enum AKBenchmarkScenario)scenario;
+// 計測用のステージパックファイルの作成
+- (void)createStagePackFile;
+// 計測用のステージパックファイルのパス取得
+- (NSString *)stagePackPath;
+@end
+
+@implementation AKBenchmark
+
+/*!
+ @brief インスタンス解放時処理
+ 
+ インスタンス解放時に処理時間のバッファを解放する。
+ */
+- (void)dealloc
+{
+    // 処理時間のバッファを解放する
+    free(tickTimes_);
+    
+    // スーパークラスの解放処理
+    [super dealloc];
+}
+
+/*!
+ @brief シナリオの計測
+ 
+ 指定したシナリオの場面を作り、慣らし運転の後に指定した回数の状態更新を計測する。
+ メモリ確保回数は自動解放プールの作成・解放を除いた状態更新1回分の区間で数える。
+ @param scenario 計測シナリオ
+ @param count 計測する状態更新の回数
+ @return 計測結果
+ */
+- (const struct AKBenchmarkResult *)runScenario:(enum AKBenchmarkScenario)scenario tickCount:(NSInteger)count
+{
+    NSAssert(scenario >= 0 && scenario < kAKBenchmarkScenarioCount, @"計測シナリオが範囲外");
+    NSAssert(count > 0, @"計測回数が0以下");
+    
+    // メモリ確保回数の計測を開始する
+    // 確保関数の差し替えはプロセス全体に影響するためデバッグビルドのみとする
+    // 計測対象はこのメソッドを呼び出したスレッドのみで、ステージの先読みなどは含まない
+    // リリースビルドでは回数は0となる
+#ifdef DEBUG
+    [AKAllocCounter install];
+#endif
+    
+    // 処理時間のバッファが足りない場合は確保し直す
+    if (tickCapacity_ < count) {
+        free(tickTimes_);
+        tickTimes_ = malloc(count * sizeof(uint64_t));
+        tickCapacity_ = count;
+    }
+    
+    // キャラクターを配置していないゲームデータを作成し、シナリオの初期配置を行う
+    AKHeadlessRunner *runner = [[AKHeadlessRunner alloc] initWithStageNo:0];
+    AKPlayData *data = runner.data;
+    serial_ = 0;
+    [self setupScenario:scenario data:data];
+    
+    // 慣らし運転を行う
+    for (NSInteger i = 0; i < kAKWarmUpTickCount; i++) {
+        
+        NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
+        
+        [self prepareScenario:scenario data:data tick:i];
+        [data update];
+        
+        [pool release];
+    }
+    
+    // 状態更新1回ごとに処理時間とメモリ確保回数を計測する
+    uint64_t totalTime = 0;
+    int64_t totalAllocs = 0;
+    for (NSInteger i = 0; i < count; i++) {
+        
+        NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
+        
+        int64_t allocStart = [AKAllocCounter count];
+        uint64_t start = mach_absolute_time();
+        
+        [self prepareScenario:scenario data:data tick:kAKWarmUpTickCount + i];
+        [data update];
+        
+        tickTimes_[i] = mach_absolute_time() - start;
+        totalAllocs += [AKAllocCounter count] - allocStart;
+        totalTime += tickTimes_[i];
+        
+        [pool release];
+    }
+    
+    [runner release];
+    
+    // 処理時間を昇順に並べ替えて中央値・パーセンタイル・最大値を求める
+    qsort(tickTimes_, count, sizeof(uint64_t), AKCompareTime);
+    
+    struct AKBenchmarkResult *result = &results_[scenario];
+    result->tickCount = count;
+    result->nsPerTick = AKNanosecondsOfTime(totalTime) / count;
+    result->p50 = AKNanosecondsOfTime(tickTimes_[(count - 1) * 50 / 100]);
+    result->p99 = AKNanosecondsOfTime(tickTimes_[(count - 1) * 99 / 100]);
+    result->max = AKNanosecondsOfTime(tickTimes_[count - 1]);
+    result->allocsPerTick = (double)totalAllocs / count;
+    
+    AKLog(kAKLogBenchmark_1, @"%@", [self jsonOfScenario:scenario]);
+    
+    return result;
+}
+
+/*!
+ @brief 全シナリオの計測
+ 
+ すべてのシナリオを順番に計測する。
+ @param count 1シナリオあたりに計測する状態更新の回数
+ */
+- (void)runAllWithTickCount:(NSInteger)count
+{
+    for (NSInteger i = 0; i < kAKBenchmarkScenarioCount; i++) {
+        
+        NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
+        
+        [self runScenario:i tickCount:count];
+        
+        [pool release];
+    }
+}
+
+/*!
+ @brief 計測結果取得
+ 
+ 指定したシナリオの計測結果を取得する。計測していない場合は状態更新の回数が0となる。
+ @param scenario 計測シナリオ
+ @return 計測結果
+ */
+- (const struct AKBenchmarkResult *)resultOfScenario:(enum AKBenchmarkScenario)scenario
+{
+    NSAssert(scenario >= 0 && scenario < kAKBenchmarkScenarioCount, @"計測シナリオが範囲外");
+    return &results_[scenario];
+}
+
+/*!
+ @brief 計測結果のJSON文字列作成
+ 
+ 指定したシナリオの計測結果を1行のJSON形式の文字列にする。
+ 時間の単位はナノ秒とする。
+ @param scenario 計測シナリオ
+ @return JSON形式の文字列
+ */
+- (NSString *)jsonOfScenario:(enum AKBenchmarkScenario)scenario
+{
+    const struct AKBenchmarkResult *result = [self resultOfScenario:scenario];
+    
+    return [NSString stringWithFormat:@"{\"scenario\":\"%@\",\"ticks\":%d,\"ns_per_tick\":%.0f,\"p50_ns\":%llu,\"p99_ns\":%llu,\"max_ns\":%llu,\"allocs_per_tick\":%.2f}",
+            [AKBenchmark nameOfScenario:scenario],
+            result->tickCount,
+            result->nsPerTick,
+            result->p50,
+            result->p99,
+            result->max,
+            result->allocsPerTick];
+}
+
+/*!
+ @brief 計測結果の文字列作成
+ 
+ 計測したシナリオの結果を1行1シナリオのJSON形式で出力する(JSON Lines形式)。
+ @return 計測結果の文字列
+ */
+- (NSString *)summary
+{
+    NSMutableString *summary = [NSMutableString string];
+    
+    for (NSInteger i = 0; i < kAKBenchmarkScenarioCount; i++) {
+        
+        // 計測していないシナリオは出力しない
+        if (results_[i].tickCount <= 0) {
+            continue;
+        }
+        
+        [summary appendFormat:@"%@\n", [self jsonOfScenario:i]];
+    }
+    
+    return summary;
+}
+
+/*!
+ @brief シナリオ名取得
+ 
+ 計測結果の出力に使用するシナリオ名を取得する。
+ @param scenario 計測シナリオ
+ @return シナリオ名
+ */
++ (NSString *)nameOfScenario:(enum AKBenchmarkScenario)scenario
+{
+    NSAssert(scenario >= 0 && scenario < kAKBenchmarkScenarioCount, @"計測シナリオが範囲外");
+    return kAKScenarioName[scenario];
+}
+
+/*!
+ @brief 全シナリオの計測
+ 
+ すべてのシナリオを計測し、計測結果の文字列を返す。
+ @param count 1シナリオあたりに計測する状態更新の回数
+ @return 計測結果の文字列
+ */
++ (NSString *)runAllWithTickCount:(NSInteger)count
+{
+    AKBenchmark *benchmark = [[[AKBenchmark alloc] init] autorelease];
+    
+    [benchmark runAllWithTickCount:count];
+    
+    return [benchmark summary];
+}
+
+/*!
+ @brief シナリオの初期配置
+ 
+ シナリオの開始時に1回だけ必要なキャラクターの配置を行う。
+ @param scenario 計測シナリオ
+ @param data ゲームデータ
+ */
+- (void)setupScenario:(enum AKBenchmarkScenario)scenario data:(AKPlayData *)data
+{
+    switch (scenario) {
+        case kAKBenchmarkEnemyShotGraze:    // 敵弾最大数でのかすり
+            
+            // 自機を敵弾の通り道に配置する
+            data.player.positionX = kAKGrazePlayerPosX;
+            data.player.positionY = kAKGrazePlayerPosY;
+            break;
+            
+        case kAKBenchmarkBlockWalker:       // 障害物最大数と地上を歩く敵
+            
+            // 障害物を配置する
+            [self createBlocks:data];
+            break;
+            
+        case kAKBenchmarkReflection:        // シールドによる大量反射
+            
+            // 円運動の開始位置に自機を配置する
+            data.player.positionX = kAKCircleCenter.x + kAKCircleRadius;
+            data.player.positionY = kAKCircleCenter.y;
+            break;
+            
+        case kAKBenchmarkStageChangePack:   // ステージの連続読み込み(ステージパックファイル)
+            
+            // タイルマップファイルを変換してステージパックファイルを作成しておく
+            [self createStagePackFile];
+            
+            // 最初のステージを読み込む
+            [self reloadStage:data scenario:scenario];
+            break;
+            
+        case kAKBenchmarkStageChange:       // ステージの連続読み込み(タイルマップファイル)
+            
+            // 最初のステージを読み込む
+            [self reloadStage:data scenario:scenario];
+            break;
+            
+        default:
+            break;
+    }
+}
+
+/*!
+ @brief シナリオの状態更新前処理
+ 
+ 状態更新の前に、シナリオの負荷を保つためのキャラクターの補充などを行う。
+ @param scenario 計測シナリオ
+ @param data ゲームデータ
+ @param tick 状態更新の番号
+ */
+- (void)prepareScenario:(enum AKBenchmarkScenario)scenario data:(AKPlayData *)data tick:(NSInteger)tick
+{
+    switch (scenario) {
+        case kAKBenchmarkEnemyShotGraze:    // 敵弾最大数でのかすり
+            
+            // 自機の上下をかすめる敵弾を補充する
+            // 自機は無敵にせず、かすり判定と当たり判定を毎回行わせる
+            [self fillGrazeShots:data];
+            break;
+            
+        case kAKBenchmarkBlockWalker:       // 障害物最大数と地上を歩く敵
+            
+            // 自機弾で倒された敵を補充する
+            [self keepPlayerInvincible:data];
+            [self fillWalkers:data];
+            break;
+            
+        case kAKBenchmarkBoss:              // ボスの行動パターン
+            
+            // 2体とも倒された場合は再度出現させる
+            [self keepPlayerInvincible:data];
+            [self fillBosses:data];
+            break;
+            
+        case kAKBenchmarkReflection:        // シールドによる大量反射
+            
+            // チキンゲージを最大に保ってオプションを最大数出し、シールドを有効にする
+            [self keepPlayerInvincible:data];
+            data.player.chickenGauge = 100;
+            if (!data.shield) {
+                data.shield = YES;
+            }
+            
+            // 自機を円運動させてオプションを広げ、自機を狙う敵弾を補充する
+            [self movePlayerInCircle:data tick:tick];
+            [self fillAimedShots:data];
+            break;
+            
+        case kAKBenchmarkStageChange:       // ステージの連続読み込み(タイルマップファイル)
+        case kAKBenchmarkStageChangePack:   // ステージの連続読み込み(ステージパックファイル)
+            
+            // 一定間隔でステージを読み込み直す
+            [self keepPlayerInvincible:data];
+            if (tick % kAKStageChangeInterval == kAKStageChangeInterval - 1) {
+                [self reloadStage:data scenario:scenario];
+            }
+            break;
+            
+        default:
+            NSAssert(NO, @"計測シナリオが範囲外");
+            break;
+    }
+}
+
+/*!
+ @brief 自機の無敵状態維持
+ 
+ 自機が無敵状態でない場合は復活処理を行って無敵状態にする。
+ 自機が破壊されて残機がなくなり、計測が止まることを防ぐ。
+ @param data ゲームデータ
+ */
+- (void)keepPlayerInvincible:(AKPlayData *)data
+{
+    if (!data.player.isInvincible) {
+        [data.player rebirth];
+    }
+}
+
+/*!
+ @brief かすり判定に入る敵弾の補充
+ 
+ 敵弾が最大数になるまで、画面右端から自機の上下をかすめて通過する敵弾を生成する。
+ 自機との縦方向の距離は当たり判定には入らず、かすり判定に入る距離とする。
+ @param data ゲームデータ
+ */
+- (void)fillGrazeShots:(AKPlayData *)data
+{
+    AKEnemyShotEngine *engine = data.enemyShotEngine;
+    struct AKNWayDirection direction = AKNWayDirectionMake(M_PI);
+    
+    while (engine.count < kAKShotCount) {
+        
+        // 自機の上下に交互に、距離をずらしながら配置する
+        float distance = kAKGrazeDistance + (serial_ % 3) * 2.0f;
+        float y = data.player.positionY + ((serial_ % 2 == 0) ? distance : -distance);
+        
+        [engine createNormalShotAtX:kAKShotPosX + (serial_ % kAKShotPosXCount) * kAKShotPosXStep
+                                  y:y
+                          direction:direction
+                              speed:2.0f + (serial_ % 4) * 0.5f];
+        
+        serial_++;
+    }
+}
+
+/*!
+ @brief 自機を狙う敵弾の補充
+ 
+ 敵弾が最大数になるまで、画面右端の縦方向に並べた位置から自機を狙う敵弾を生成する。
+ @param data ゲームデータ
+ */
+- (void)fillAimedShots:(AKPlayData *)data
+{
+    AKEnemyShotEngine *engine = data.enemyShotEngine;
+    CGPoint target = data.playerPosition;
+    
+    while (engine.count < kAKShotCount) {
+        
+        float x = kAKShotPosX + (serial_ % kAKShotPosXCount) * kAKShotPosXStep;
+        float y = kAKBlockSize / 2.0f + (serial_ % kAKBlockMapRowCount) * kAKBlockSize;
+        
+        [engine createNormalShotAtX:x
+                                  y:y
+                          direction:AKNWayDirectionMake(atan2f(target.y - y, target.x - x))
+                              speed:2.0f + (serial_ % 4) * 0.5f];
+        
+        serial_++;
+    }
+}
+
+/*!
+ @brief 障害物の配置
+ 
+ 障害物配置に従って、地面と天井、段差の障害物を配置する。
+ 画面外の障害物もスクロールしないため削除されずに残る。
+ @param data ゲームデータ
+ */
+- (void)createBlocks:(AKPlayData *)data
+{
+    for (NSInteger row = 0; row < kAKBlockMapRowCount; row++) {
+        for (NSInteger col = 0; kAKBlockMap[row][col] != '\0'; col++) {
+            
+            if (kAKBlockMap[row][col] != '#') {
+                continue;
+            }
+            
+            [data createBlock:kAKBlockType
+                            x:kAKBlockSize / 2.0f + col * kAKBlockSize
+                            y:kAKStageSize.height - kAKBlockSize / 2.0f - row * kAKBlockSize];
+        }
+    }
+}
+
+/*!
+ @brief 地上を歩く敵の補充
+ 
+ 地上を歩く敵が一定数になるまで、アリとカタツムリを地面と天井に交互に生成する。
+ @param data ゲームデータ
+ */
+- (void)fillWalkers:(AKPlayData *)data
+{
+    while (data.enemyPool.activeCount < kAKWalkerCount) {
+        
+        NSInteger type = kAKWalkerDef[serial_ % kAKWalkerDefCount].type;
+        float halfHeight = kAKWalkerDef[serial_ % kAKWalkerDefCount].halfHeight;
+        
+        // 段差のない奇数列に配置する
+        float x = kAKBlockSize / 2.0f + (1 + (serial_ % kAKWalkerColumnCount) * 2) * kAKBlockSize;
+        
+        // 地面の上と天井の下に交互に配置する
+        float y = ((serial_ / kAKWalkerDefCount) % 2 == 0) ? kAKFloorTop + halfHeight : kAKCeilingBottom - halfHeight;
+        
+        [data createEnemy:type x:x y:y progress:0];
+        
+        serial_++;
+    }
+}
+
+/*!
+ @brief ボスの補充
+ 
+ ボスが2体とも倒されている場合はカマキリとカブトムシを生成する。
+ @param data ゲームデータ
+ */
+- (void)fillBosses:(AKPlayData *)data
+{
+    if (data.enemyPool.activeCount > 0) {
+        return;
+    }
+    
+    [data createEnemy:kAKMantisType x:kAKMantisPosition.x y:kAKMantisPosition.y progress:0];
+    [data createEnemy:kAKRhinocerosBeetleType
+                    x:kAKRhinocerosBeetlePosition.x
+                    y:kAKRhinocerosBeetlePosition.y
+             progress:0];
+}
+
+/*!
+ @brief 自機の円運動
+ 
+ 自機を円運動させる。自機の移動はオプションの移動の元になるため、移動入力と同じ処理で移動させる。
+ @param data ゲームデータ
+ @param tick 状態更新の番号
+ */
+- (void)movePlayerInCircle:(AKPlayData *)data tick:(NSInteger)tick
+{
+    float angle = 2.0f * M_PI * (tick % kAKCircleFrame) / kAKCircleFrame;
+    
+    [data movePlayerByDx:kAKCircleCenter.x + kAKCircleRadius * cosf(angle) - data.player.positionX
+                      dy:kAKCircleCenter.y + kAKCircleRadius * sinf(angle) - data.player.positionY];
+}
+
+/*!
+ @brief ステージの再読み込み
+ 
+ キャラクターをすべて取り除いてからステージのスクリプトを読み込み直す。
+ ステージパックの作成・読み込みと初期表示の1画面分の配置処理を計測対象とする。
+ タイルマップファイルのシナリオでは毎回タイルマップファイルを解析し、
+ ステージパックファイルのシナリオでは毎回ステージパックファイルをマッピングする。
+ @param data ゲームデータ
+ @param scenario 計測シナリオ
+ */
+- (void)reloadStage:(AKPlayData *)data scenario:(enum AKBenchmarkScenario)scenario
+{
+    [data.blockPool reset];
+    [data.enemyPool reset];
+    [data.effectPool reset];
+    [data.enemyShotEngine removeAllShots];
+    
+    AKStagePack *stagePack = nil;
+    if (scenario == kAKBenchmarkStageChangePack) {
+        stagePack = [[AKStagePack alloc] initWithContentsOfFile:[self stagePackPath]];
+    }
+    else {
+        stagePack = [[AKStagePack alloc] initWithTileMapFile:[AKStagePack tileMapFileNameOfStageNo:kAKStageChangeStage]];
+    }
+    
+    [data readScript:kAKStageChangeStage stagePack:stagePack];
+    [stagePack release];
+}
+
+/*!
+ @brief 計測用のステージパックファイルの作成
+ 
+ 計測するステージのタイルマップファイルを変換し、ステージパックファイルを作成する。
+ */
+- (void)createStagePackFile
+{
+    AKStagePack *stagePack = [[AKStagePack alloc] initWithTileMapFile:[AKStagePack tileMapFileNameOfStageNo:kAKStageChangeStage]];
+    if (![stagePack writeToFile:[self stagePackPath]]) {
+        AKLog(kAKLogBenchmark_0, @"ステージパックファイルの作成に失敗:%@", [self stagePackPath]);
+        NSAssert(NO, @"ステージパックファイルの作成に失敗");
+    }
+    [stagePack release];
+}
+
+/*!
+ @brief 計測用のステージパックファイルのパス取得
+ 
+ ステージパックファイルのシナリオで使用するステージパックファイルのパスを取得する。
+ 一時ディレクトリに作成する。
+ @return ステージパックファイルのパス
+ */
+- (NSString *)stagePackPath
+{
+    return [NSTemporaryDirectory() stringByAppendingPathComponent:[AKStagePack stagePackFileNameOfStageNo:kAKStageChangeStage]];
+}
+@end
@@ -42,20 +42,45 @@ struct AKBlcokDef {
     float animationInterval;    ///< アニメーション更新間隔
     NSInteger hitWidth;         ///< 当たり判定の幅
     NSInteger hitHeight;        ///< 当たり判定の高さ
-    NSInteger offsetX;          ///< 画像オフセットx軸
-    NSInteger offsetY;          ///< 画像オフセットy軸
+    NSInteger offsetX;          ///< タイルの中心から当たり判定の中心へのオフセットx軸(逆方向)
+    NSInteger offsetY;          ///< タイルの中心から当たり判定の中心へのオフセットy軸(逆方向)
 };
 
 // 障害物クラス
 @interface AKBlock : AKCharacter {
-    
+    /// タイル1個分の当たり判定の幅
+    NSInteger cellWidth_;
+    /// タイル1個分の当たり判定の高さ
+    NSInteger cellHeight_;
 }
 
+/// タイル1個分の当たり判定の幅
+@property (nonatomic, readonly)NSInteger cellWidth;
+/// タイル1個分の当たり判定の高さ
+@property (nonatomic, readonly)NSInteger cellHeight;
+
+// 障害物種別ごとのタイル1個分の当たり判定のサイズ取得
++ (CGSize)hitSizeOfType:(NSInteger)type;
 // 障害物生成処理
-- (void)createBlockType:(NSInteger)type x:(float)x y:(float)y parent:(CCNode *)parent;
+- (void)createBlockType:(NSInteger)type
+                      x:(float)x
+                      y:(float)y
+               colCount:(NSInteger)colCount
+               rowCount:(NSInteger)rowCount
+                 parent:(CCNode *)parent;
 // ぶつかったキャラクターを押し動かす
 - (void)pushCharacter:(AKCharacter *)character data:(id<AKPlayDataInterface>)data;
 // ぶつかったキャラクターを消す
 - (void)destroyCharacter:(AKCharacter *)character;
+// 指定したx座標を含むタイルの中心x座標取得
+- (float)cellCenterXAtX:(float)x;
+// 指定したy座標より上にある一番下のタイルの中心y座標取得
+- (float)cellCenterYAboveY:(float)y;
+// 指定したy座標以下にある一番上のタイルの中心y座標取得
+- (float)cellCenterYBelowY:(float)y;
+// 足元のタイルの上端取得
+- (float)cellTopAtFeetFrom:(float)top;
+// 足元のタイルの下端取得(逆さま用)
+- (float)cellBottomAtFeetFrom:(float)top;
 
 @end
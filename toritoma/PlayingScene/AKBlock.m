@@ -39,6 +39,8 @@
 static NSString *kAKImageNameFormat = @"Block_%02d";
 /// 障害物の種類の数
 static const NSInteger kAKBlockDefCount = 6;
+/// 画面外で障害物を残す範囲
+static const float kAKBlockBorder = 50.0f;
 
 /// 障害物定義
 static const struct AKBlcokDef kAKBlockDef[kAKBlockDefCount] = {
@@ -50,25 +52,91 @@ static const struct AKBlcokDef kAKBlockDef[kAKBlockDefCount] = {
     {6, 1, 0.0f, 32, 32, 0,  0}    // ブロック
 };
 
+/// 障害物の種類ごとの画像名
+static NSString *imageNames_[kAKBlockDefCount];
+
+/// 状態保存で保存する障害物固有の状態
+struct AKBlockState {
+    NSInteger cellWidth;        ///< タイル1個分の当たり判定の幅
+    NSInteger cellHeight;       ///< タイル1個分の当たり判定の高さ
+};
+
 /*!
  @brief 障害物クラス
  
  障害物を管理する。
+ ステージの障害物レイヤーで同じ種別のタイルが縦横に並んでいる部分は、
+ ステージパック作成時に1つの矩形にまとめられ、1個の障害物として当たり判定を行う。
+ 画像はまとめる前と同じ描画順で表示するため、キャラクターのバッチノードにタイル1個ずつのスプライトを配置する。
+ 左上のタイルのスプライトを障害物の画像とし、残りのタイルのスプライトはその子ノードとする。
+ 押し動かす処理はタイル1個ずつの障害物が並んでいた場合と同じ結果になるように、
+ 相手と重なっているタイルを列の左から、行の上から順に処理する。
  */
+// プライベートメソッド宣言
+@interface AKBlock ()
+// タイル1個分の範囲から押し動かす
+- (BOOL)pushCharacter:(AKCharacter *)character cellX:(float)cellX cellY:(float)cellY data:(id<AKPlayDataInterface>)data;
+// タイルごとのスプライトの作成
+- (void)createCellImages;
+@end
+
 @implementation AKBlock
 
+@synthesize cellWidth = cellWidth_;
+@synthesize cellHeight = cellHeight_;
+
+/*!
+ @brief クラス初期化処理
+ 
+ 生成のたびに画像名の文字列を作成しないように、障害物の種類ごとの画像名を最初に1回だけ作成しておく。
+ */
++ (void)initialize
+{
+    if (self == [AKBlock class]) {
+        for (NSInteger i = 0; i < kAKBlockDefCount; i++) {
+            imageNames_[i] = [[NSString alloc] initWithFormat:kAKImageNameFormat, kAKBlockDef[i].image];
+        }
+    }
+}
+
+/*!
+ @brief 障害物種別ごとのタイル1個分の当たり判定のサイズ取得
+ 
+ 障害物種別ごとのタイル1個分の当たり判定のサイズを取得する。
+ ステージパック作成時に、隣のタイルと隙間なく並ぶかどうかを判定するために使用する。
+ @param type 障害物種別
+ @return 当たり判定のサイズ
+ */
++ (CGSize)hitSizeOfType:(NSInteger)type
+{
+    NSAssert(type > 0 && type <= kAKBlockDefCount, @"障害物種別の値が範囲外");
+    
+    return CGSizeMake(kAKBlockDef[type - 1].hitWidth, kAKBlockDef[type - 1].hitHeight);
+}
+
 /*!
  @brief 障害物生成処理
  
  障害物を生成する。
+ 複数のタイルをまとめた障害物の場合は、当たり判定のサイズをタイルの数倍にする。
  @param type 障害物種別
- @param x 生成位置x座標
- @param y 生成位置y座標
+ @param x 生成位置x座標(まとめたタイル全体の中心)
+ @param y 生成位置y座標(まとめたタイル全体の中心)
+ @param colCount まとめたタイルの列数
+ @param rowCount まとめたタイルの行数
  @param parent 配置する親ノード
  */
-- (void)createBlockType:(NSInteger)type x:(float)x y:(float)y parent:(CCNode *)parent
+- (void)createBlockType:(NSInteger)type
+                      x:(float)x
+                      y:(float)y
+               colCount:(NSInteger)colCount
+               rowCount:(NSInteger)rowCount
+                 parent:(CCNode *)parent
 {
-    AKLog(kAKLogBlock_1, @"障害物生成");
+    AKLog(kAKLogBlock_1, @"障害物生成:type=%d col=%d row=%d", type, colCount, rowCount);
+    
+    NSAssert(type > 0 && type <= kAKBlockDefCount, @"障害物種別の値が範囲外");
+    NSAssert(colCount > 0 && rowCount > 0, @"障害物のタイル数が範囲外");
     
     // パラメータの内容をメンバに設定する
     self.positionX = x;
@@ -79,11 +147,9 @@ static const struct AKBlcokDef kAKBlockDef[kAKBlockDefCount] = {
 
     // ヒットポイントは1とする
     self.hitPoint = 1;
-        
-    NSAssert(type > 0 && type <= kAKBlockDefCount, @"障害物種別の値が範囲外");
-        
-    // 画像名を作成する
-    self.imageName = [NSString stringWithFormat:kAKImageNameFormat, kAKBlockDef[type - 1].image];
+    
+    // 画像名を設定する
+    self.imageName = imageNames_[type - 1];
     
     // アニメーションフレームの個数を設定する
     self.animationPattern = kAKBlockDef[type - 1].animationFrame;
@@ -92,23 +158,71 @@ static const struct AKBlcokDef kAKBlockDef[kAKBlockDefCount] = {
     self.animationInterval = kAKBlockDef[type - 1].animationInterval;
     
     // 当たり判定のサイズを設定する
-    self.width = kAKBlockDef[type - 1].hitWidth;
-    self.height = kAKBlockDef[type - 1].hitHeight;
+    cellWidth_ = kAKBlockDef[type - 1].hitWidth;
+    cellHeight_ = kAKBlockDef[type - 1].hitHeight;
+    self.width = cellWidth_ * colCount;
+    self.height = cellHeight_ * rowCount;
     
-    // 画像表示位置オフセットを設定する
+    // 当たり判定の位置オフセットを設定する
     offset_ = ccp(kAKBlockDef[type - 1].offsetX, kAKBlockDef[type - 1].offsetY);
     
-    // 画像のオフセットと逆方向にキャラクター位置を移動する
+    // オフセットと逆方向にキャラクター位置を移動する
     self.positionX -= offset_.x;
     self.positionY -= offset_.y;
     
     // 障害物は基本的に画面スクロールに応じて移動する
     self.scrollSpeed = 1.0f;
-        
+    
+    // タイルごとのスプライトを作成する
+    [self createCellImages];
+    
     // レイヤーに配置する
     [parent addChild:self.image];
 }
 
+/*!
+ @brief タイルごとのスプライトの作成
+ 
+ まとめたタイルの数だけスプライトを作成し、タイル1個ずつの障害物が並んでいた場合と同じ位置に表示する。
+ 障害物の画像を左上のタイルのスプライトとし、アンカーポイントをずらして障害物の中心に配置した時に左上のタイルの位置に表示されるようにする。
+ 残りのタイルのスプライトは障害物の画像の子ノードとして、左上のタイルからの相対位置に配置する。
+ 再利用時に前回のスプライトが残らないように、子ノードは作成前にすべて取り除く。
+ 画像不使用モードでスプライトがない場合は処理しない。
+ */
+- (void)createCellImages
+{
+    // スプライトがない場合は処理しない
+    if (self.image == nil) {
+        return;
+    }
+    
+    // 前回の子ノードを取り除く
+    [self.image removeAllChildrenWithCleanup:YES];
+    
+    // タイルの数と画像のサイズを取得する
+    NSInteger colCount = (cellWidth_ > 0 ? self.width / cellWidth_ : 1);
+    NSInteger rowCount = (cellHeight_ > 0 ? self.height / cellHeight_ : 1);
+    CGSize size = self.image.contentSize;
+    
+    // 障害物の中心に配置した時に左上のタイルの位置に表示されるようにアンカーポイントをずらす
+    self.image.anchorPoint = ccp(0.5f + (colCount - 1) / 2.0f, 0.5f - (rowCount - 1) / 2.0f);
+    
+    // 左上以外のタイルのスプライトを子ノードとして配置する
+    for (NSInteger col = 0; col < colCount; col++) {
+        for (NSInteger row = 0; row < rowCount; row++) {
+            
+            // 左上のタイルは障害物の画像で表示する
+            if (col == 0 && row == 0) {
+                continue;
+            }
+            
+            CCSprite *cell = [CCSprite spriteWithSpriteFrame:self.image.displayFrame];
+            cell.position = ccp((col + 0.5f) * size.width, (0.5f - row) * size.height);
+            [self.image addChild:cell];
+        }
+    }
+}
+
 /*!
  @brief 衝突処理
  
@@ -141,7 +255,11 @@ static const struct AKBlcokDef kAKBlockDef[kAKBlockDefCount] = {
  @brief ぶつかったキャラクターを押し動かす
  
  ぶつかったキャラクターを押し動かす。
- 移動先の座標は以下の優先度で設定し、衝突判定で問題なかった時点で採用する。
+ 相手と重なっているタイルを列の左から、行の上から順に選び、
+ そのタイル1個分の範囲から押し動かすことを試みる。
+ どのタイルからも移動できなかったときは元の位置に戻す。
+ 移動できた場合は、画像表示位置の補間で押し動かす前の位置との間に表示されないように、
+ 移動前の座標も同じ量だけ移動する。
  @param character 衝突した相手
  @param data ゲームデータ
  */
@@ -149,14 +267,84 @@ static const struct AKBlcokDef kAKBlockDef[kAKBlockDefCount] = {
 {
     AKLog(kAKLogBlock_1, @"移動前=(%f, %f)", character.positionX, character.positionY);
     
+    // 障害物と相手の上下左右の端を計算する
+    float left = self.positionX - self.width / 2.0f;
+    float top = self.positionY + self.height / 2.0f;
+    float characterLeft = character.positionX - character.width / 2.0f;
+    float characterRight = character.positionX + character.width / 2.0f;
+    float characterTop = character.positionY + character.height / 2.0f;
+    float characterBottom = character.positionY - character.height / 2.0f;
+    
+    // 相手と重なっているタイルの範囲を計算する
+    NSInteger colCount = (cellWidth_ > 0 ? self.width / cellWidth_ : 1);
+    NSInteger rowCount = (cellHeight_ > 0 ? self.height / cellHeight_ : 1);
+    NSInteger firstCol = MAX((NSInteger)floorf((characterLeft - left) / cellWidth_), 0);
+    NSInteger firstRow = MAX((NSInteger)floorf((top - characterTop) / cellHeight_), 0);
+    
+    // 押し動かす前の位置を記憶する
+    // 移動前の座標は画像表示位置の補間に使用するため、作業用には使用しない
+    float startX = character.positionX;
+    float startY = character.positionY;
+    
+    // 重なっているタイルごとに移動を試みる
+    for (NSInteger col = firstCol; col < colCount && left + col * cellWidth_ < characterRight; col++) {
+        
+        // 右端が相手の左端に届いていないタイルは処理しない
+        if (left + (col + 1) * cellWidth_ <= characterLeft) {
+            continue;
+        }
+        
+        for (NSInteger row = firstRow; row < rowCount && top - row * cellHeight_ > characterBottom; row++) {
+            
+            // 下端が相手の上端に届いていないタイルは処理しない
+            if (top - (row + 1) * cellHeight_ >= characterTop) {
+                continue;
+            }
+            
+            // タイルの中心を基準に移動を試みる
+            // タイルが1個の方向は計算誤差が出ないように位置をそのまま使用する
+            float cellX = (colCount > 1 ? left + (col + 0.5f) * cellWidth_ : self.positionX);
+            float cellY = (rowCount > 1 ? top - (row + 0.5f) * cellHeight_ : self.positionY);
+            if ([self pushCharacter:character cellX:cellX cellY:cellY data:data]) {
+                
+                // 移動前の座標も押し動かした量だけ移動する
+                character.prevPositionX += character.positionX - startX;
+                character.prevPositionY += character.positionY - startY;
+                return;
+            }
+            
+            // 移動できなかった場合は元に戻して次のタイルを試す
+            character.positionX = startX;
+            character.positionY = startY;
+        }
+    }
+    
+    // どのタイルからも移動できなかったときは元に戻す
+    character.positionX = startX;
+    character.positionY = startY;
+}
+
+/*!
+ @brief タイル1個分の範囲から押し動かす
+ 
+ 指定したタイル1個分の範囲の外へキャラクターを押し動かす。
+ 移動先の座標は以下の優先度で設定し、衝突判定で問題なかった時点で採用する。
+ @param character 衝突した相手
+ @param cellX タイルの中心x座標
+ @param cellY タイルの中心y座標
+ @param data ゲームデータ
+ @return 移動できた場合YES
+ */
+- (BOOL)pushCharacter:(AKCharacter *)character cellX:(float)cellX cellY:(float)cellY data:(id<AKPlayDataInterface>)data
+{
     // 障害物左端への移動
-    float leftX = self.positionX - (self.width + character.width) / 2;
+    float leftX = cellX - (cellWidth_ + character.width) / 2;
     // 障害物右端への移動
-    float rightX = self.positionX + (self.width + character.width) / 2;
+    float rightX = cellX + (cellWidth_ + character.width) / 2;
     // 障害物下端への移動
-    float bottomY = self.positionY - (self.height + character.height) / 2;
+    float bottomY = cellY - (cellHeight_ + character.height) / 2;
     // 障害物上端への移動
-    float topY = self.positionY + (self.height + character.height) / 2;
+    float topY = cellY + (cellHeight_ + character.height) / 2;
     // 移動先座標配列
     float movePosX[4];
     float movePosY[4];
@@ -190,7 +378,7 @@ static const struct AKBlcokDef kAKBlockDef[kAKBlockDefCount] = {
         }
         
         // 相手が障害物より下にある場合
-        if (self.positionY > character.positionY) {
+        if (cellY > character.positionY) {
             movePosX[1] = character.positionX;
             movePosY[1] = bottomY;
             movePosX[2] = character.positionX;
@@ -224,7 +412,7 @@ static const struct AKBlcokDef kAKBlockDef[kAKBlockDefCount] = {
         }
         
         // 相手が障害物より左にある場合
-        if (self.positionX > character.positionX) {
+        if (cellX > character.positionX) {
             movePosX[1] = leftX;
             movePosY[1] = character.positionY;
             movePosX[2] = rightX;
@@ -240,10 +428,6 @@ static const struct AKBlcokDef kAKBlockDef[kAKBlockDefCount] = {
         }
     }
     
-    // 移動前の位置を記憶する
-    character.prevPositionX = character.positionX;
-    character.prevPositionY = character.positionY;
-    
     // 4方向へ移動を試みる
     for (int i = 0; i < 4; i++) {
         
@@ -266,17 +450,15 @@ static const struct AKBlcokDef kAKBlockDef[kAKBlockDefCount] = {
         }
         
         // 衝突判定を行う
-        if (![character checkHit:[data.blocks objectEnumerator] data:data func:NULL]) {
+        if (![character checkHitWithGrid:data.blockGrid data:data func:NULL]) {
             
             // 衝突しなかった場合はこの値を採用して処理を終了する
             AKLog(kAKLogBlock_1, @"移動後=(%f, %f)", character.positionX, character.positionY);
-            return;
+            return YES;
         }
     }
     
-    // どの方向にも移動できなかったときは元に戻す
-    character.positionX = character.prevPositionX;
-    character.positionY = character.prevPositionY;
+    return NO;
 }
 
 /*!
@@ -291,16 +473,220 @@ static const struct AKBlcokDef kAKBlockDef[kAKBlockDefCount] = {
 }
 
 /*!
- @brief キャラクター固有の動作
+ @brief 指定したx座標を含むタイルの中心x座標取得
+ 
+ 指定したx座標を含むタイルの中心x座標を取得する。
+ 範囲外の座標の場合は一番近い端のタイルの中心とする。
+ @param x x座標
+ @return タイルの中心x座標
+ */
+- (float)cellCenterXAtX:(float)x
+{
+    NSInteger colCount = (cellWidth_ > 0 ? self.width / cellWidth_ : 1);
+    
+    // タイルが1個の場合は位置をそのまま返す
+    if (colCount <= 1) {
+        return self.positionX;
+    }
+    
+    float left = self.positionX - self.width / 2.0f;
+    NSInteger col = MIN(MAX((NSInteger)floorf((x - left) / cellWidth_), 0), colCount - 1);
+    
+    return left + (col + 0.5f) * cellWidth_;
+}
+
+/*!
+ @brief 指定したy座標より上にある一番下のタイルの中心y座標取得
+ 
+ タイルの中心が指定したy座標より上にあるタイルの内、一番下のタイルの中心y座標を取得する。
+ @param y y座標
+ @return タイルの中心y座標、該当するタイルがない場合はFLT_MAX
+ */
+- (float)cellCenterYAboveY:(float)y
+{
+    NSInteger rowCount = (cellHeight_ > 0 ? self.height / cellHeight_ : 1);
+    
+    // タイルが1個の場合は位置で判定する
+    if (rowCount <= 1) {
+        return (self.positionY > y ? self.positionY : FLT_MAX);
+    }
+    
+    float bottomCenter = self.positionY - (self.height - cellHeight_) / 2.0f;
+    NSInteger row = MAX((NSInteger)floorf((y - bottomCenter) / cellHeight_) + 1, 0);
+    
+    return (row < rowCount ? bottomCenter + row * cellHeight_ : FLT_MAX);
+}
+
+/*!
+ @brief 指定したy座標以下にある一番上のタイルの中心y座標取得
+ 
+ タイルの中心が指定したy座標以下にあるタイルの内、一番上のタイルの中心y座標を取得する。
+ @param y y座標
+ @return タイルの中心y座標、該当するタイルがない場合は-FLT_MAX
+ */
+- (float)cellCenterYBelowY:(float)y
+{
+    NSInteger rowCount = (cellHeight_ > 0 ? self.height / cellHeight_ : 1);
+    
+    // タイルが1個の場合は位置で判定する
+    if (rowCount <= 1) {
+        return (self.positionY <= y ? self.positionY : -FLT_MAX);
+    }
+    
+    float bottomCenter = self.positionY - (self.height - cellHeight_) / 2.0f;
+    NSInteger row = MIN((NSInteger)floorf((y - bottomCenter) / cellHeight_), rowCount - 1);
+    
+    return (row >= 0 ? bottomCenter + row * cellHeight_ : -FLT_MAX);
+}
+
+/*!
+ @brief 足元のタイルの上端取得
+ 
+ タイルの下端が頭の位置以下にあるタイルの内、一番上のタイルの上端を取得する。
+ 座標の比較は四捨五入した値で行う。
+ 障害物の下端が頭の位置以下にあることは呼び出し元で判定済みとする。
+ @param top 頭の位置
+ @return タイルの上端
+ */
+- (float)cellTopAtFeetFrom:(float)top
+{
+    NSInteger rowCount = (cellHeight_ > 0 ? self.height / cellHeight_ : 1);
+    
+    // 一番上のタイルが該当する場合は障害物の上端を返す
+    float bottom = self.positionY - self.height / 2.0f;
+    NSInteger row = ((NSInteger)roundf(top) - (NSInteger)roundf(bottom)) / cellHeight_;
+    if (row >= rowCount - 1) {
+        return self.positionY + self.height / 2.0f;
+    }
+    
+    return bottom + (MAX(row, 0) + 1) * cellHeight_;
+}
+
+/*!
+ @brief 足元のタイルの下端取得(逆さま用)
+ 
+ タイルの上端が頭の位置より上にあるタイルの内、一番下のタイルの下端を取得する。
+ 座標の比較は四捨五入した値で行う。
+ 障害物の上端が頭の位置より上にあることは呼び出し元で判定済みとする。
+ @param top 頭の位置
+ @return タイルの下端
+ */
+- (float)cellBottomAtFeetFrom:(float)top
+{
+    NSInteger rowCount = (cellHeight_ > 0 ? self.height / cellHeight_ : 1);
+    
+    // 一番下のタイルが該当する場合は障害物の下端を返す
+    float blockTop = self.positionY + self.height / 2.0f;
+    NSInteger distance = (NSInteger)roundf(blockTop) - (NSInteger)roundf(top);
+    NSInteger row = (distance + cellHeight_ - 1) / cellHeight_ - 1;
+    if (row >= rowCount - 1) {
+        return self.positionY - self.height / 2.0f;
+    }
+    
+    return blockTop - (MAX(row, 0) + 1) * cellHeight_;
+}
+
+/*!
+ @brief 状態の保存
  
- キャラクター種別ごとの動作を行う。
- 実数計算誤差によるタイル間の隙間の発生を防止するため、
- タイルマップの位置を基準として画像表示位置を設定し直す。
+ キャラクター共通の状態に続けて、タイル1個分の当たり判定のサイズを保存する。
+ @param snapshot 保存先
+ */
+- (void)writeSnapshot:(AKSnapshot *)snapshot
+{
+    // スーパークラスの処理を行う
+    [super writeSnapshot:snapshot];
+    
+    struct AKBlockState state = {cellWidth_, cellHeight_};
+    [snapshot writeBytes:&state length:sizeof(state)];
+}
+
+/*!
+ @brief 状態の復元
+ 
+ キャラクター共通の状態に続けて、タイル1個分の当たり判定のサイズを復元し、タイルごとのスプライトを作成し直す。
+ @param snapshot 読み込み元
+ */
+- (void)readSnapshot:(AKSnapshot *)snapshot
+{
+    // スーパークラスの処理を行う
+    [super readSnapshot:snapshot];
+    
+    struct AKBlockState state;
+    [snapshot readBytes:&state length:sizeof(state)];
+    
+    NSAssert(state.cellWidth > 0 && state.cellHeight > 0, @"タイルのサイズが範囲外");
+    
+    cellWidth_ = state.cellWidth;
+    cellHeight_ = state.cellHeight;
+    
+    // タイルごとのスプライトを作成し直す
+    [self createCellImages];
+}
+
+/*!
+ @brief 画面外に出たか判定
+ 
+ 複数のタイルをまとめた障害物は、画面の内側に一番近いタイルの中心で判定する。
+ タイル1個ずつの障害物が並んでいた場合に最後のタイルが削除されるタイミングと同じになる。
  @param data ゲームデータ
+ @return 範囲外に出ている場合はYES、範囲内にある場合はNO
  */
-- (void)action:(id<AKPlayDataInterface>)data
+- (BOOL)isOutOfStage:(id<AKPlayDataInterface>)data
 {
-    // デバイススクリーン座標からマップ座標へ、マップ座標からタイルの座標へ変換する
-    self.image.position = [data tilePositionFromDevicePosition:self.image.position];
+    // 中心から端のタイルの中心までの距離
+    float cellDistanceX = (self.width - cellWidth_) / 2.0f;
+    float cellDistanceY = (self.height - cellHeight_) / 2.0f;
+    
+    // 移動量
+    float moveX = self.speedX - data.scrollSpeedX * self.scrollSpeed;
+    float moveY = self.speedY - data.scrollSpeedY * self.scrollSpeed;
+    
+    if ((self.positionX + cellDistanceX < -kAKBlockBorder && moveX < 0.0f) ||
+        (self.positionX - cellDistanceX > [AKScreenSize stageSize].width + kAKBlockBorder && moveX > 0.0f) ||
+        (self.positionY + cellDistanceY < -kAKBlockBorder && moveY < 0.0f) ||
+        (self.positionY - cellDistanceY > [AKScreenSize stageSize].height + kAKBlockBorder && moveY > 0.0f)) {
+        
+        AKLog(kAKLogBlock_1, @"画面外に出たため削除");
+        
+        return YES;
+    }
+    else {
+        return NO;
+    }
+}
+
+/*!
+ @brief 状態の保存
+ 
+ キャラクター共通の状態に続けて、タイル1個分の当たり判定のサイズを保存する。
+ @param snapshot 保存先
+ */
+- (void)writeSnapshot:(AKSnapshot *)snapshot
+{
+    // スーパークラスの処理を行う
+    [super writeSnapshot:snapshot];
+    
+    NSInteger cellSize[] = {cellWidth_, cellHeight_};
+    
+    [snapshot writeBytes:cellSize length:sizeof(cellSize)];
+}
+
+/*!
+ @brief 状態の復元
+ 
+ キャラクター共通の状態に続けて、タイル1個分の当たり判定のサイズを復元する。
+ @param snapshot 読み込み元
+ */
+- (void)readSnapshot:(AKSnapshot *)snapshot
+{
+    // スーパークラスの処理を行う
+    [super readSnapshot:snapshot];
+    
+    NSInteger cellSize[2];
+    [snapshot readBytes:cellSize length:sizeof(cellSize)];
+    
+    cellWidth_ = cellSize[0];
+    cellHeight_ = cellSize[1];
 }
 @end
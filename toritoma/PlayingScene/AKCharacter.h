@@ -35,6 +35,10 @@
 
 #import "AKToritoma.h"
 #import "AKPlayDataInterface.h"
+#import "AKCollisionGrid.h"
+#import "AKSnapshot.h"
+
+@class AKCharacterPool;
 
 /// 障害物と衝突した時の動作
 enum AKBlockHitAction {
@@ -98,6 +102,16 @@ enum AKBlockHitSide {
     NSUInteger blockHitSide_;
     /// 画像表示のオフセット
     CGPoint offset_;
+    /// 管理しているキャラクタープール(弱い参照)
+    AKCharacterPool *ownerPool_;
+    /// キャラクタープール内の並び順
+    NSInteger poolIndex_;
+    /// パターン番号順の表示フレーム
+    NSArray *spriteFrames_;
+    /// 表示中のパターン番号
+    NSInteger displayPattern_;
+    /// 画像サイズ
+    CGSize imageSize_;
 }
 
 /// 画像
@@ -140,11 +154,29 @@ enum AKBlockHitSide {
 @property (nonatomic)enum AKBlockHitAction blockHitAction;
 /// 障害物と接している面
 @property (nonatomic)NSUInteger blockHitSide;
+/// 管理しているキャラクタープール(弱い参照)
+@property (nonatomic, assign)AKCharacterPool *ownerPool;
+/// キャラクタープール内の並び順
+@property (nonatomic)NSInteger poolIndex;
+/// 画像サイズ
+@property (nonatomic, readonly)CGSize imageSize;
 
 // 画像名の取得
 - (NSString *)imageName;
 // 画像名の設定
 - (void)setImageName:(NSString *)imageName;
+// 画像名に対応する表示フレームの配列取得
++ (NSArray *)spriteFramesOfImageName:(NSString *)imageName;
+// 画像不使用モードの設定
++ (void)setHeadless:(BOOL)headless;
+// 画像不使用モードの取得
++ (BOOL)isHeadless;
+// 画像サイズの読み込み
++ (void)addImageSizesWithFile:(NSString *)fileName;
+// 画像名に対応する画像サイズ取得
++ (CGSize)imageSizeOfImageName:(NSString *)imageName;
+// パターン番号に対応する表示フレーム取得
+- (CCSpriteFrame *)spriteFrameOfPattern:(NSInteger)pattern;
 // 移動処理
 - (void)move:(id<AKPlayDataInterface>)data;
 // キャラクター固有の動作
@@ -155,6 +187,14 @@ enum AKBlockHitSide {
 - (BOOL)checkHit:(const NSEnumerator *)characters data:(id<AKPlayDataInterface>)data func:(SEL)func;
 // キャラクター衝突判定
 - (void)checkHit:(const NSEnumerator *)characters data:(id<AKPlayDataInterface>)data;
+// 衝突判定(1体、汎用)
+- (BOOL)checkHitWithCharacter:(AKCharacter *)character data:(id<AKPlayDataInterface>)data func:(SEL)func;
+// キャラクター衝突判定(1体)
+- (void)checkHitWithCharacter:(AKCharacter *)character data:(id<AKPlayDataInterface>)data;
+// 衝突判定(グリッド使用、汎用)
+- (BOOL)checkHitWithGrid:(AKCollisionGrid *)grid data:(id<AKPlayDataInterface>)data func:(SEL)func;
+// キャラクター衝突判定(グリッド使用)
+- (void)checkHitWithGrid:(AKCollisionGrid *)grid data:(id<AKPlayDataInterface>)data;
 // 衝突処理
 - (void)hit:(AKCharacter *)character data:(id<AKPlayDataInterface>)data;
 // 障害物との衝突による移動
@@ -165,4 +205,10 @@ enum AKBlockHitSide {
 - (BOOL)isOutOfStage:(id<AKPlayDataInterface>)data;
 // 画像表示位置更新
 - (void)updateImagePosition;
+// 画像表示位置更新(補間あり)
+- (void)updateImagePositionWithAlpha:(float)alpha;
+// 状態の保存
+- (void)writeSnapshot:(AKSnapshot *)snapshot;
+// 状態の復元
+- (void)readSnapshot:(AKSnapshot *)snapshot;
 @end
@@ -34,22 +34,71 @@
  */
 
 #import "AKCharacter.h"
+#import "AKCharacterPool.h"
 
 /// デフォルトアニメーション間隔
 static const NSInteger kAKDefaultAnimationInterval = 12;
 /// 画像ファイル名のフォーマット
 static NSString *kAKImageFileFormat = @"%@_%02d.png";
-/// 画像ファイル名の最大文字数
-static const NSUInteger kAKMaxImageFileName = 64;
+/// 1パターン目の画像ファイル名の末尾(画像ファイル名のフォーマットのパターン番号以降)
+static NSString *kAKImageFirstPatternSuffix = @"_01.png";
+/// 画像ファイル名のパターン番号の最大値(2桁)
+static const NSInteger kAKImageMaxPattern = 99;
+/// 状態保存で画像名に使用するバイト数
+#define kAKSnapshotImageNameLength 32
 
-/// アニメーションパターンに応じた画像名
-static NSMutableString *imageFileName_ = nil;
+/// 状態保存で保存するキャラクターの状態
+struct AKCharacterState {
+    NSInteger width;                        ///< 当たり判定サイズ幅
+    NSInteger height;                       ///< 当たり判定サイズ高さ
+    float positionX;                        ///< 位置x座標
+    float positionY;                        ///< 位置y座標
+    float prevPositionX;                    ///< 移動前x座標
+    float prevPositionY;                    ///< 移動前y座標
+    float speedX;                           ///< 速度x方向
+    float speedY;                           ///< 速度y方向
+    NSInteger hitPoint;                     ///< HP
+    NSInteger power;                        ///< 攻撃力
+    BOOL isStaged;                          ///< ステージ上に存在しているかどうか
+    NSInteger animationPattern;             ///< アニメーションパターン数
+    NSInteger animationInterval;            ///< アニメーション間隔
+    NSInteger animationFrame;               ///< アニメーションフレーム数
+    NSInteger animationRepeat;              ///< アニメーション繰り返し回数
+    NSInteger animationInitPattern;         ///< アニメーション初期パターン
+    float scrollSpeed;                      ///< スクロール速度の影響を受ける割合
+    enum AKBlockHitAction blockHitAction;   ///< 障害物と衝突した時の動作
+    NSUInteger blockHitSide;                ///< 障害物と接している面
+    CGPoint offset;                         ///< 画像表示のオフセット
+    NSInteger displayPattern;               ///< 表示中のパターン番号
+    char imageName[kAKSnapshotImageNameLength]; ///< 画像名
+};
+
+/// 画像名ごとの表示フレームの配列
+static NSMutableDictionary *spriteFrameTables_ = nil;
+/// 画像ファイル名と画像名ごとの画像サイズ(画像不使用モードで使用する)
+static NSMutableDictionary *imageSizeTables_ = nil;
+/// 画像サイズを読み込み済みの定義ファイル名
+static NSMutableSet *imageSizeFiles_ = nil;
+/// 画像不使用モードかどうか
+static BOOL isHeadless_ = NO;
 
 /*!
  @brief キャラクタークラス
  
  当たり判定を持つオブジェクトの基本クラス。
  */
+// プライベートメソッド宣言
+@interface AKCharacter ()
+// 相手キャラクターとの衝突判定
+- (BOOL)checkHitTarget:(AKCharacter *)target
+                  left:(float)myleft
+                 right:(float)myright
+                   top:(float)mytop
+                bottom:(float)mybottom
+                  data:(id<AKPlayDataInterface>)data
+                  func:(SEL)func;
+@end
+
 @implementation AKCharacter
 
 @synthesize image = image_;
@@ -72,6 +121,9 @@ static NSMutableString *imageFileName_ = nil;
 @synthesize scrollSpeed = scrollSpeed_;
 @synthesize blockHitAction = blockHitAction_;
 @synthesize blockHitSide = blockHitSide_;
+@synthesize ownerPool = ownerPool_;
+@synthesize poolIndex = poolIndex_;
+@synthesize imageSize = imageSize_;
 
 /*!
  @brief オブジェクト生成処理
@@ -102,6 +154,11 @@ static NSMutableString *imageFileName_ = nil;
     self.animationFrame = 0;
     self.scrollSpeed = 0.0f;
     offset_ = ccp(0.0f, 0.0f);
+    self.ownerPool = nil;
+    self.poolIndex = 0;
+    spriteFrames_ = nil;
+    displayPattern_ = 0;
+    imageSize_ = CGSizeZero;
     
     // 攻撃力の初期値は1とする
     self.power = 1;
@@ -118,14 +175,6 @@ static NSMutableString *imageFileName_ = nil;
     // アニメーション初期パターンは1とする
     self.animationInitPattern = 1;
     
-    // アニメーションパターンに応じた画像名を格納するためのグローバル変数を作成する。
-    // 処理の都度NSStringのアロケートを行うと処理が重くなる。
-    // 高速化のため、最初に1個作っておいて全キャラクターで使い回しを行う。
-    if (imageFileName_ == nil) {
-        imageFileName_ = [[NSMutableString alloc] initWithCapacity:kAKMaxImageFileName];
-        AKLog(kAKLogCharacter_1, @"imageFileName_=%p", imageFileName_);
-    }
-    
     return self;
 }
 
@@ -140,6 +189,10 @@ static NSMutableString *imageFileName_ = nil;
     [self.image removeFromParentAndCleanup:YES];
     self.image = nil;
     
+    // 表示フレームの配列を解放する
+    [spriteFrames_ release];
+    spriteFrames_ = nil;
+    
     // スーパークラスの解放処理
     [super dealloc];
 }
@@ -169,19 +222,252 @@ static NSMutableString *imageFileName_ = nil;
         imageName_ = [imageName retain];
     }
     
+    // 画像不使用モードの場合は画像サイズのみ取得し、スプライトは作成しない
+    if (imageName_ != nil && isHeadless_) {
+        imageSize_ = [AKCharacter imageSizeOfImageName:imageName_];
+        return;
+    }
+    
     // スプライト名が設定された場合はスプライト作成を行う
     if (imageName_ != nil) {
         
-        // 画像ファイル名を決定する
-        NSString *imageFileName = [NSString stringWithFormat:kAKImageFileFormat, imageName_, 1];
+        // 画像名に対応する表示フレームの配列を取得する
+        NSArray *spriteFrames = [AKCharacter spriteFramesOfImageName:imageName_];
+        if (spriteFrames_ != spriteFrames) {
+            [spriteFrames_ release];
+            spriteFrames_ = [spriteFrames retain];
+        }
+        
+        // 1パターン目の表示フレームを取得する
+        CCSpriteFrame *frame = [self spriteFrameOfPattern:1];
         
         // スプライト作成前の場合はスプライトを作成する
         if (self.image == nil) {
-            self.image = [CCSprite spriteWithSpriteFrameName:imageFileName];
+            self.image = [CCSprite spriteWithSpriteFrame:frame];
         }
         // すでにスプライトを作成している場合は画像の切り替えを行う
         else {
-            [self.image setDisplayFrame:[[CCSpriteFrameCache sharedSpriteFrameCache] spriteFrameByName:imageFileName]];
+            [self.image setDisplayFrame:frame];
+        }
+        
+        // 表示中のパターンを記憶する
+        displayPattern_ = 1;
+        
+        // 画像サイズを記憶する
+        imageSize_ = frame.originalSize;
+    }
+}
+
+/*!
+ @brief 画像名に対応する表示フレームの配列取得
+ 
+ 画像名に対応する表示フレームをパターン番号順に並べた配列を取得する。
+ アニメーションのたびに画像ファイル名の作成と検索を行うと処理が重くなるため、
+ 画像名ごとに最初の1回だけ検索を行い、結果を全キャラクターで共有する。
+ パターン番号は1から始まり、画像ファイル名で表せるすべての番号を検索して、存在する最大の番号までを1つの配列とする。
+ 番号が連続していない場合があるため、途中の画像が存在しない番号にはNSNullを格納する。
+ @param imageName 画像名
+ @return 表示フレームの配列(配列の位置はパターン番号-1)
+ */
++ (NSArray *)spriteFramesOfImageName:(NSString *)imageName
+{
+    // 最初に呼ばれた時に配列を格納する辞書を作成する
+    if (spriteFrameTables_ == nil) {
+        spriteFrameTables_ = [[NSMutableDictionary alloc] init];
+    }
+    
+    // 作成済みの場合はそれを返す
+    NSArray *spriteFrames = [spriteFrameTables_ objectForKey:imageName];
+    if (spriteFrames != nil) {
+        return spriteFrames;
+    }
+    
+    // パターン番号順に表示フレームを検索する
+    // 存在しない番号はNSNullで埋め、存在する最大の番号までを配列とする
+    NSMutableArray *newFrames = [NSMutableArray array];
+    NSInteger patternCount = 0;
+    CCSpriteFrameCache *cache = [CCSpriteFrameCache sharedSpriteFrameCache];
+    for (NSInteger pattern = 1; pattern <= kAKImageMaxPattern; pattern++) {
+        
+        // 画像ファイル名を作成して検索する
+        CCSpriteFrame *frame = [cache spriteFrameByName:[NSString stringWithFormat:kAKImageFileFormat, imageName, pattern]];
+        
+        // 存在しない場合は空きとする
+        if (frame == nil) {
+            [newFrames addObject:[NSNull null]];
+            continue;
+        }
+        
+        [newFrames addObject:frame];
+        patternCount = pattern;
+    }
+    
+    // 存在する最大の番号より後ろの空きを取り除く
+    [newFrames removeObjectsInRange:NSMakeRange(patternCount, newFrames.count - patternCount)];
+    
+    AKLog(kAKLogCharacter_0 && newFrames.count == 0, @"画像が存在しない:%@", imageName);
+    AKLog(kAKLogCharacter_1, @"imageName=%@ pattern=%d", imageName, newFrames.count);
+    
+    // 辞書に格納する
+    [spriteFrameTables_ setObject:newFrames forKey:imageName];
+    
+    return newFrames;
+}
+
+/*!
+ @brief 画像不使用モードの設定
+ 
+ 画像不使用モードを設定する。
+ 画像不使用モードではスプライトの作成を行わず、位置やサイズなどの状態のみを処理する。
+ 画面を使用せずにゲームの状態更新のみを実行する場合に使用する。
+ @param headless 画像不使用モードかどうか
+ */
++ (void)setHeadless:(BOOL)headless
+{
+    isHeadless_ = headless;
+}
+
+/*!
+ @brief 画像不使用モードの取得
+ 
+ 画像不使用モードかどうかを取得する。
+ @return 画像不使用モードかどうか
+ */
++ (BOOL)isHeadless
+{
+    return isHeadless_;
+}
+
+/*!
+ @brief 画像サイズの読み込み
+ 
+ テクスチャアトラス定義ファイルから各画像のサイズを読み込む。
+ 画像不使用モードではテクスチャを読み込まないため、
+ スプライトの代わりにこのサイズを画像サイズとして使用する。
+ 同じファイルは1回だけ読み込む。複数スレッドでゲームデータを実行する場合は、
+ 実行開始前に読み込んでおくことで、実行中は読み込み済みのサイズの参照のみとなる。
+ @param fileName テクスチャアトラス定義ファイル名
+ */
++ (void)addImageSizesWithFile:(NSString *)fileName
+{
+    // 複数のゲームデータから同時に呼ばれた場合に備えて排他制御を行う
+    @synchronized(self) {
+        
+        // 最初に呼ばれた時にサイズを格納する辞書を作成する
+        if (imageSizeTables_ == nil) {
+            imageSizeTables_ = [[NSMutableDictionary alloc] init];
+            imageSizeFiles_ = [[NSMutableSet alloc] init];
+        }
+        
+        // 読み込み済みの場合は処理しない
+        if ([imageSizeFiles_ containsObject:fileName]) {
+            return;
+        }
+        
+        // 定義ファイルを読み込む
+        NSString *path = [[NSBundle mainBundle] pathForResource:[fileName stringByDeletingPathExtension]
+                                                         ofType:[fileName pathExtension]];
+        NSDictionary *frames = [[NSDictionary dictionaryWithContentsOfFile:path] objectForKey:@"frames"];
+        
+        AKLog(kAKLogCharacter_0 && frames == nil, @"定義ファイルの読み込みに失敗:%@", fileName);
+        
+        // 画像ファイル名ごとに元画像のサイズを格納する
+        // 1パターン目の画像は、生成時に画像ファイル名を作成せずに検索できるように画像名でも格納する
+        for (NSString *key in [frames keyEnumerator]) {
+            
+            NSString *size = [[frames objectForKey:key] objectForKey:@"sourceSize"];
+            if (size != nil) {
+                NSValue *value = [NSValue valueWithCGSize:CGSizeFromString(size)];
+                [imageSizeTables_ setObject:value forKey:key];
+                
+                if ([key hasSuffix:kAKImageFirstPatternSuffix]) {
+                    [imageSizeTables_ setObject:value
+                                         forKey:[key substringToIndex:key.length - kAKImageFirstPatternSuffix.length]];
+                }
+            }
+        }
+        
+        // 読み込み済みとして記憶する
+        [imageSizeFiles_ addObject:fileName];
+    }
+}
+
+/*!
+ @brief 画像名に対応する画像サイズ取得
+ 
+ 読み込み済みの画像サイズから画像名の1パターン目の画像のサイズを取得する。
+ キャラクター生成のたびに呼ばれるため、画像ファイル名は作成せずに画像名で検索する。
+ @param imageName 画像名
+ @return 画像サイズ。読み込まれていない場合はサイズ0を返す。
+ */
++ (CGSize)imageSizeOfImageName:(NSString *)imageName
+{
+    NSValue *size = [imageSizeTables_ objectForKey:imageName];
+    
+    AKLog(kAKLogCharacter_0 && size == nil, @"画像サイズが存在しない:%@", imageName);
+    
+    if (size == nil) {
+        return CGSizeZero;
+    }
+    
+    return [size CGSizeValue];
+}
+
+/*!
+ @brief パターン番号に対応する表示フレーム取得
+ 
+ 現在の画像名の表示フレームの配列からパターン番号に対応する表示フレームを取得する。
+ 配列にない番号の場合は、画像ファイル名を作成して表示フレームを検索する。
+ @param pattern パターン番号
+ @return 表示フレーム。画像が存在しない場合はnilを返す。
+ */
+- (CCSpriteFrame *)spriteFrameOfPattern:(NSInteger)pattern
+{
+    // 配列にある番号の場合はそれを返す
+    if (pattern >= 1 && pattern <= (NSInteger)spriteFrames_.count) {
+        id frame = [spriteFrames_ objectAtIndex:pattern - 1];
+        if (frame != [NSNull null]) {
+            return frame;
+        }
+    }
+    
+    // 配列にない場合は画像ファイル名を作成して検索する
+    CCSpriteFrame *frame = [[CCSpriteFrameCache sharedSpriteFrameCache] spriteFrameByName:
+                            [NSString stringWithFormat:kAKImageFileFormat, imageName_, pattern]];
+    
+    AKLog(kAKLogCharacter_0 && frame == nil, @"画像が存在しない:%@ pattern=%d", imageName_, pattern);
+    NSAssert(frame != nil, @"パターン番号の画像が存在しない");
+    
+    return frame;
+}
+
+/*!
+ @brief ステージ配置フラグの設定
+ 
+ ステージに配置されているかどうかを設定する。
+ キャラクタープールで管理されている場合は、プール内で使用中または未使用に移動する。
+ 新たに配置された場合は、表示位置の補間で前回配置されていた位置から移動して見えないように
+ 移動前の座標を現在の座標に合わせる。
+ @param isStaged ステージに配置されているかどうか
+ */
+- (void)setIsStaged:(BOOL)isStaged
+{
+    // 新たに配置された場合は移動前の座標を現在の座標に合わせる
+    if (isStaged && !isStaged_) {
+        prevPositionX_ = positionX_;
+        prevPositionY_ = positionY_;
+    }
+    
+    // メンバに設定する
+    isStaged_ = isStaged;
+    
+    // キャラクタープールで管理されている場合は使用中または未使用に移動する
+    if (ownerPool_ != nil) {
+        if (isStaged) {
+            [ownerPool_ activateCharacter:self];
+        }
+        else {
+            [ownerPool_ deactivateCharacter:self];
         }
     }
 }
@@ -203,13 +489,11 @@ static NSMutableString *imageFileName_ = nil;
         // アニメーションフレーム数を初期化する
         self.animationFrame = 0;
         
-        // アニメーションパターンに応じて画像ファイル名を作成する
-        NSRange range = {0, imageFileName_.length};
-        [imageFileName_ deleteCharactersInRange:range];
-        [imageFileName_ appendFormat:kAKImageFileFormat, self.imageName, animationInitPattern];
-        
         // 表示スプライトを変更する
-        [self.image setDisplayFrame:[[CCSpriteFrameCache sharedSpriteFrameCache] spriteFrameByName:imageFileName_]];
+        [self.image setDisplayFrame:[self spriteFrameOfPattern:animationInitPattern]];
+        
+        // 表示中のパターンを記憶する
+        displayPattern_ = animationInitPattern;
     }
 }
 
@@ -263,15 +547,15 @@ static NSMutableString *imageFileName_ = nil;
             break;
             
         case kAKBlockHitMove:       // 移動
-            [self checkHit:[data.blocks objectEnumerator]
-                      data:data
-                      func:@selector(moveOfBlockHit:data:)];
+            [self checkHitWithGrid:data.blockGrid
+                              data:data
+                              func:@selector(moveOfBlockHit:data:)];
             break;
             
         case kAKBlockHitDisappear:  // 消滅
-            [self checkHit:[data.blocks objectEnumerator]
-                      data:data
-                      func:@selector(disappearOfBlockHit:data:)];
+            [self checkHitWithGrid:data.blockGrid
+                              data:data
+                              func:@selector(disappearOfBlockHit:data:)];
             break;
             
         default:
@@ -281,9 +565,6 @@ static NSMutableString *imageFileName_ = nil;
     AKLog(kAKLogCharacter_2, @"pos=(%.0f, %.0f) scr=(%d, %d)",
           self.positionX, self.positionY,
           [AKScreenSize xOfStage:self.positionX], [AKScreenSize yOfStage:self.positionY]);
-        
-    // 画像表示位置の更新を行う
-    [self updateImagePosition];
     
     // アニメーションフレーム数をカウントする
     self.animationFrame++;
@@ -326,13 +607,12 @@ static NSMutableString *imageFileName_ = nil;
         
         AKLog([self.imageName isEqualToString:@"Enemy_12"] && NO, @"pattern=%d frame=%d interval=%d", pattern, self.animationFrame, self.animationInterval);
         
-        // アニメーションパターンに応じて画像ファイル名を作成する
-        NSRange range = {0, imageFileName_.length};
-        [imageFileName_ deleteCharactersInRange:range];
-        [imageFileName_ appendFormat:kAKImageFileFormat, self.imageName, pattern];
-        
-        // 表示スプライトを変更する
-        [self.image setDisplayFrame:[[CCSpriteFrameCache sharedSpriteFrameCache] spriteFrameByName:imageFileName_]];
+        // 表示中のパターンと異なる場合のみ表示スプライトを変更する
+        // 画像不使用モードでスプライトがない場合は変更しない
+        if (pattern != displayPattern_ && self.image != nil) {
+            [self.image setDisplayFrame:[self spriteFrameOfPattern:pattern]];
+            displayPattern_ = pattern;
+        }
     }
     
     // キャラクター固有の動作を行う
@@ -398,38 +678,8 @@ static NSMutableString *imageFileName_ = nil;
     // 判定対象のキャラクターごとに判定を行う
     for (AKCharacter *target in characters) {
         
-        // 相手が画面に配置されていない場合は処理しない
-        if (!target.isStaged) {
-            continue;
-        }
-        
-        // 相手の上下左右の端を計算する
-        float targetleft = target.positionX - target.width / 2.0f;
-        float targetright = target.positionX + target.width / 2.0f;
-        float targettop = target.positionY + target.height / 2.0f;
-        float targetbottom = target.positionY - target.height / 2.0f;
-        
-        // 以下のすべての条件を満たしている時、衝突していると判断する。
-        //   ・相手の右端が自キャラの左端よりも右側にある
-        //   ・相手の左端が自キャラの右端よりも左側にある
-        //   ・相手の上端が自キャラの下端よりも上側にある
-        //   ・相手の下端が自キャラの上端よりも下側にある
-        if ((targetright > myleft) &&
-            (targetleft < myright) &&
-            (targettop > mybottom) &&
-            (targetbottom < mytop)) {
-            
-            AKLog(kAKLogCharacter_3, @"my=(%f, %f, %f, %f)", myleft, myright, mytop, mybottom);
-            AKLog(kAKLogCharacter_3, @"target=(%f, %f, %f, %f)", targetleft, targetright, targettop, targetbottom);
-            
-            // 衝突処理を行う
-            if (func != NULL) {
-                [self performSelector:func withObject:target withObject:data];
-            }
-            
-            AKLog(kAKLogCharacter_3, @"self.hitPoint=%d, target.hitPoint=%d", self.hitPoint, target.hitPoint);
-            
-            // 衝突したかどうかを記憶する
+        // 衝突したかどうかを記憶する
+        if ([self checkHitTarget:target left:myleft right:myright top:mytop bottom:mybottom data:data func:func]) {
             isHit = YES;
         }
     }
@@ -438,6 +688,94 @@ static NSMutableString *imageFileName_ = nil;
     return isHit;
 }
 
+/*!
+ @brief 衝突判定(1体、汎用)
+ 
+ 1体のキャラクターとの衝突判定を行う。衝突時にどのような処理を行うかをパラメータで指定する。
+ 判定対象が1体の場合に判定対象の配列を作成しなくて済むようにする。
+ @param character 判定対象のキャラクター
+ @param data ゲームデータ
+ @param func 衝突時処理
+ @return 衝突したかどうか
+ */
+- (BOOL)checkHitWithCharacter:(AKCharacter *)character data:(id<AKPlayDataInterface>)data func:(SEL)func
+{
+    // 画面に配置されていない場合は処理しない
+    if (!self.isStaged) {
+        return NO;
+    }
+    
+    // 衝突している方向を初期化する
+    self.blockHitSide = 0;
+    
+    // 自キャラの上下左右の端を計算して判定を行う
+    return [self checkHitTarget:character
+                           left:self.positionX - self.width / 2.0f
+                          right:self.positionX + self.width / 2.0f
+                            top:self.positionY + self.height / 2.0f
+                         bottom:self.positionY - self.height / 2.0f
+                           data:data
+                           func:func];
+}
+
+/*!
+ @brief 相手キャラクターとの衝突判定
+ 
+ 自キャラの上下左右の端と相手キャラクターの当たり判定が重なっているか調べ、
+ 重なっている場合は衝突時処理を行う。
+ @param target 相手キャラクター
+ @param myleft 自キャラの左端
+ @param myright 自キャラの右端
+ @param mytop 自キャラの上端
+ @param mybottom 自キャラの下端
+ @param data ゲームデータ
+ @param func 衝突時処理
+ @return 衝突したかどうか
+ */
+- (BOOL)checkHitTarget:(AKCharacter *)target
+                  left:(float)myleft
+                 right:(float)myright
+                   top:(float)mytop
+                bottom:(float)mybottom
+                  data:(id<AKPlayDataInterface>)data
+                  func:(SEL)func
+{
+    // 相手が画面に配置されていない場合は処理しない
+    if (!target.isStaged) {
+        return NO;
+    }
+    
+    // 相手の上下左右の端を計算する
+    float targetleft = target.positionX - target.width / 2.0f;
+    float targetright = target.positionX + target.width / 2.0f;
+    float targettop = target.positionY + target.height / 2.0f;
+    float targetbottom = target.positionY - target.height / 2.0f;
+    
+    // 以下のすべての条件を満たしている時、衝突していると判断する。
+    //   ・相手の右端が自キャラの左端よりも右側にある
+    //   ・相手の左端が自キャラの右端よりも左側にある
+    //   ・相手の上端が自キャラの下端よりも上側にある
+    //   ・相手の下端が自キャラの上端よりも下側にある
+    if (!((targetright > myleft) &&
+          (targetleft < myright) &&
+          (targettop > mybottom) &&
+          (targetbottom < mytop))) {
+        return NO;
+    }
+    
+    AKLog(kAKLogCharacter_3, @"my=(%f, %f, %f, %f)", myleft, myright, mytop, mybottom);
+    AKLog(kAKLogCharacter_3, @"target=(%f, %f, %f, %f)", targetleft, targetright, targettop, targetbottom);
+    
+    // 衝突処理を行う
+    if (func != NULL) {
+        [self performSelector:func withObject:target withObject:data];
+    }
+    
+    AKLog(kAKLogCharacter_3, @"self.hitPoint=%d, target.hitPoint=%d", self.hitPoint, target.hitPoint);
+    
+    return YES;
+}
+
 /*!
  @brief キャラクター衝突判定
 
@@ -450,6 +788,89 @@ static NSMutableString *imageFileName_ = nil;
     [self checkHit:characters data:data func:@selector(hit:data:)];
 }
 
+/*!
+ @brief キャラクター衝突判定(1体)
+ 
+ 1体のキャラクターと衝突しているか調べ、衝突しているときはHPを減らす。
+ @param character 判定対象のキャラクター
+ @param data ゲームデータ
+ */
+- (void)checkHitWithCharacter:(AKCharacter *)character data:(id<AKPlayDataInterface>)data
+{
+    [self checkHitWithCharacter:character data:data func:@selector(hit:data:)];
+}
+
+/*!
+ @brief 衝突判定(グリッド使用、汎用)
+ 
+ 当たり判定グリッドで候補を絞り込んで衝突判定を行う。衝突時にどのような処理を行うかをパラメータで指定する。
+ 衝突時処理は判定対象のキャラクター群の並び順に実行するため、結果はcheckHit:data:func:と同じになる。
+ @param grid 判定対象のキャラクター群を登録した当たり判定グリッド
+ @param data ゲームデータ
+ @param func 衝突時処理
+ @return 衝突したかどうか
+ */
+- (BOOL)checkHitWithGrid:(AKCollisionGrid *)grid data:(id<AKPlayDataInterface>)data func:(SEL)func
+{
+    // 画面に配置されていない場合は処理しない
+    if (!self.isStaged) {
+        return NO;
+    }
+    
+    // 自キャラの上下左右の端を計算する
+    float myleft = self.positionX - self.width / 2.0f;
+    float myright = self.positionX + self.width / 2.0f;
+    float mytop = self.positionY + self.height / 2.0f;
+    float mybottom = self.positionY - self.height / 2.0f;
+    
+    // 衝突したかどうかを記憶する
+    BOOL isHit = NO;
+    
+    // 衝突している方向を初期化する
+    self.blockHitSide = 0;
+    
+    // グリッドから衝突しているキャラクターを検索する
+    NSInteger count = [grid searchHitLeft:myleft right:myright top:mytop bottom:mybottom];
+    
+    // 衝突しているキャラクターごとに処理を行う
+    for (NSInteger i = 0; i < count; i++) {
+        
+        AKCharacter *target = [grid resultAtIndex:i];
+        
+        // 相手が画面に配置されていない場合は処理しない
+        if (!target.isStaged) {
+            continue;
+        }
+        
+        AKLog(kAKLogCharacter_3, @"my=(%f, %f, %f, %f)", myleft, myright, mytop, mybottom);
+        
+        // 衝突処理を行う
+        if (func != NULL) {
+            [self performSelector:func withObject:target withObject:data];
+        }
+        
+        AKLog(kAKLogCharacter_3, @"self.hitPoint=%d, target.hitPoint=%d", self.hitPoint, target.hitPoint);
+        
+        // 衝突したかどうかを記憶する
+        isHit = YES;
+    }
+    
+    // 衝突したかどうかを返す
+    return isHit;
+}
+
+/*!
+ @brief キャラクター衝突判定(グリッド使用)
+ 
+ 当たり判定グリッドで候補を絞り込み、キャラクターが衝突しているか調べ、衝突しているときはHPを減らす。
+ @param grid 判定対象のキャラクター群を登録した当たり判定グリッド
+ @param data ゲームデータ
+ */
+- (void)checkHitWithGrid:(AKCollisionGrid *)grid data:(id<AKPlayDataInterface>)data
+{
+    [self checkHitWithGrid:grid data:data func:@selector(hit:data:)];
+}
+
 /*!
  @brief 衝突処理
  
@@ -677,7 +1098,130 @@ static NSMutableString *imageFileName_ = nil;
  */
 - (void)updateImagePosition
 {
+    // スプライトがない場合は処理しない
+    if (self.image == nil) {
+        return;
+    }
+    
     self.image.position = ccp([AKScreenSize xOfStage:self.positionX + offset_.x],
                               [AKScreenSize yOfStage:self.positionY + offset_.y]);
 }
+
+/*!
+ @brief 画像表示位置更新(補間あり)
+ 
+ 画像の表示位置を移動前の座標と現在の座標の間で補間した位置に更新する。
+ 状態更新の間隔と画面の更新間隔が異なる場合に、画面更新時点の位置に表示するために使用する。
+ @param alpha 補間の割合(0で移動前の座標、1で現在の座標)
+ */
+- (void)updateImagePositionWithAlpha:(float)alpha
+{
+    // スプライトがない場合は処理しない
+    if (self.image == nil) {
+        return;
+    }
+    
+    float x = self.prevPositionX + (self.positionX - self.prevPositionX) * alpha;
+    float y = self.prevPositionY + (self.positionY - self.prevPositionY) * alpha;
+    
+    self.image.position = ccp([AKScreenSize xOfStage:x + offset_.x],
+                              [AKScreenSize yOfStage:y + offset_.y]);
+}
+
+/*!
+ @brief 状態の保存
+ 
+ キャラクターの状態を保存する。
+ 画像名は文字列オブジェクトを作成しないように固定長の文字配列に変換して保存する。
+ サブクラスで固有の状態を持つ場合はオーバーライドして、スーパークラスの処理の後に保存する。
+ @param snapshot 保存先
+ */
+- (void)writeSnapshot:(AKSnapshot *)snapshot
+{
+    struct AKCharacterState state = {
+        width_, height_, positionX_, positionY_, prevPositionX_, prevPositionY_, speedX_, speedY_,
+        hitPoint_, power_, isStaged_, animationPattern_, animationInterval_, animationFrame_,
+        animationRepeat_, animationInitPattern_, scrollSpeed_, blockHitAction_, blockHitSide_,
+        offset_, displayPattern_, {0}
+    };
+    
+    // 画像名を文字配列に変換する
+    if (imageName_ != nil) {
+        
+        BOOL isConverted = [imageName_ getCString:state.imageName
+                                        maxLength:sizeof(state.imageName)
+                                         encoding:NSUTF8StringEncoding];
+        
+        NSAssert(isConverted, @"画像名が長すぎる");
+    }
+    
+    [snapshot writeBytes:&state length:sizeof(state)];
+}
+
+/*!
+ @brief 状態の復元
+ 
+ 保存した状態を読み込んで設定する。
+ 画像名が現在と異なる場合のみ画像の切り替えを行い、表示中のパターンを保存時と合わせる。
+ サブクラスで固有の状態を持つ場合はオーバーライドして、スーパークラスの処理の後に復元する。
+ @param snapshot 読み込み元
+ */
+- (void)readSnapshot:(AKSnapshot *)snapshot
+{
+    struct AKCharacterState state;
+    [snapshot readBytes:&state length:sizeof(state)];
+    
+    // 画像名が異なる場合は画像を切り替える
+    char imageName[kAKSnapshotImageNameLength] = {0};
+    if (imageName_ != nil) {
+        [imageName_ getCString:imageName maxLength:sizeof(imageName) encoding:NSUTF8StringEncoding];
+    }
+    if (strncmp(imageName, state.imageName, sizeof(imageName)) != 0) {
+        
+        if (state.imageName[0] != '\0') {
+            self.imageName = [NSString stringWithUTF8String:state.imageName];
+        }
+        else {
+            self.imageName = nil;
+        }
+    }
+    
+    // ステージ配置フラグを設定する
+    // 配置時に移動前の座標が上書きされるため、座標よりも先に設定する
+    self.isStaged = state.isStaged;
+    
+    // 各メンバを設定する
+    width_ = state.width;
+    height_ = state.height;
+    positionX_ = state.positionX;
+    positionY_ = state.positionY;
+    prevPositionX_ = state.prevPositionX;
+    prevPositionY_ = state.prevPositionY;
+    speedX_ = state.speedX;
+    speedY_ = state.speedY;
+    hitPoint_ = state.hitPoint;
+    power_ = state.power;
+    animationPattern_ = state.animationPattern;
+    animationInterval_ = state.animationInterval;
+    animationFrame_ = state.animationFrame;
+    animationRepeat_ = state.animationRepeat;
+    animationInitPattern_ = state.animationInitPattern;
+    scrollSpeed_ = state.scrollSpeed;
+    blockHitAction_ = state.blockHitAction;
+    blockHitSide_ = state.blockHitSide;
+    offset_ = state.offset;
+    
+    // スプライトがある場合は表示中のパターンと表示状態を合わせる
+    if (self.image != nil) {
+        
+        if (state.displayPattern >= 1) {
+            [self.image setDisplayFrame:[self spriteFrameOfPattern:state.displayPattern]];
+        }
+        
+        self.image.visible = isStaged_;
+        
+        [self updateImagePosition];
+    }
+    displayPattern_ = state.displayPattern;
+}
 @end
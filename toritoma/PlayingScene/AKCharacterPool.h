@@ -43,17 +43,41 @@
     Class class_;
     /// 配列サイズ
     NSInteger size_;
-    /// 次にキャラクターを追加するインデックス
-    NSInteger next_;
+    /// キャラクターの並び(先頭から使用中、未使用の順に並べる)
+    AKCharacter **slots_;
+    /// 使用中のキャラクター数
+    NSInteger activeCount_;
+    /// メッセージ送信中かどうか
+    BOOL isPerforming_;
+    /// 未使用への移動を保留しているキャラクターがあるかどうか
+    BOOL hasDeferred_;
+    /// 取得後、まだ配置フラグが立てられていないキャラクター
+    AKCharacter *pendingNext_;
 }
 
 /// キャラクターを管理する配列
 @property (nonatomic, retain)NSMutableArray *pool;
+/// 使用中のキャラクター数
+@property (nonatomic, readonly)NSInteger activeCount;
 
 // 初期化処理
 - (id)initWithClass:(Class)characlass Size:(NSInteger)size;
-// 未使用キャラクター取得
+// 未使用キャラクター取得(次の取得までに配置フラグを立てること)
 - (id)getNext;
 // 全キャラクター削除
 - (void)reset;
+// 使用中キャラクター取得
+- (id)activeAtIndex:(NSInteger)index;
+// 使用中キャラクターへのメッセージ送信
+- (void)makeActiveObjectsPerformSelector:(SEL)selector withObject:(id)object;
+// 使用中キャラクターの画像表示位置更新
+- (void)updateImagePositionWithAlpha:(float)alpha;
+// 使用中への移動
+- (void)activateCharacter:(AKCharacter *)character;
+// 未使用への移動
+- (void)deactivateCharacter:(AKCharacter *)character;
+// 状態の保存
+- (void)writeSnapshot:(AKSnapshot *)snapshot;
+// 状態の復元
+- (void)readSnapshot:(AKSnapshot *)snapshot parent:(CCNode *)parent;
 @end
@@ -35,14 +35,30 @@
 
 #import "AKCharacterPool.h"
 
+// プライベートメソッド宣言
+@interface AKCharacterPool ()
+// キャラクターの入れ替え
+- (void)swapSlot:(NSInteger)index1 with:(NSInteger)index2;
+// 未使用への移動を保留したキャラクターの整理
+- (void)compactSlots;
+@end
+
 /*!
  @brief キャラクタープールクラス
 
  複数のキャラクターのメモリ管理を行う。
+ キャラクターの並びを先頭から使用中、未使用の順に保ち、
+ 使用中と未使用の境界のキャラクターと入れ替えることで取得を定数時間で行う。
+ キャラクターはステージ配置フラグの変化に合わせて使用中、未使用を移動する。
+ 当たり判定などの処理順が結果に影響するため、使用中のキャラクターは常に使用中になった順に並べる。
+ 未使用への移動では後ろのキャラクターを詰めて並び順を保ち、
+ 使用中キャラクターへのメッセージ送信中は並びを変えないように未使用への移動を保留し、
+ 送信完了後に使用中の並び順を保ったまま未使用へ移動する。
  */
 @implementation AKCharacterPool
 
 @synthesize pool = pool_;
+@synthesize activeCount = activeCount_;
 
 /*!
  @brief オブジェクト生成処理
@@ -71,16 +87,27 @@
     
     // プールの生成
     self.pool = [NSMutableArray arrayWithCapacity:size_];
+    
+    // キャラクターの並びのバッファを確保する
+    slots_ = malloc(sizeof(AKCharacter *) * size_);
+    
+    // 使用中のキャラクターはなしで初期化する
+    activeCount_ = 0;
+    isPerforming_ = NO;
+    hasDeferred_ = NO;
+    pendingNext_ = nil;
 
     // キャラクターの生成
     for (i = 0; i < size_; i++) {
         character = [[[class_ alloc] init] autorelease];
         [pool_ addObject:character];
+        
+        // 管理プールと並び順を設定する
+        character.ownerPool = self;
+        character.poolIndex = i;
+        slots_[i] = character;
     }
     
-    // 次にキャラクターを生成するインデックスを初期化する
-    next_ = 0;
-    
     return self;
 }
 
@@ -91,8 +118,14 @@
  */
 - (void)dealloc
 {
+    // キャラクターから管理プールへの参照を外す
+    for (AKCharacter *character in [self.pool objectEnumerator]) {
+        character.ownerPool = nil;
+    }
+    
     // プールのメモリを解放する
     self.pool = nil;
+    free(slots_);
     
     // スーパークラスの解放処理
     [super dealloc];
@@ -101,66 +134,281 @@
 /*!
  @brief 未使用キャラクター取得
 
- キャラクタープールの中から未使用のキャラクターを検索して返す。
+ キャラクタープールの中から未使用のキャラクターを返す。
+ 取得したキャラクターはステージ配置フラグを立てた時点で使用中となる。
+ 配置フラグを立てるまでは未使用の先頭に残るため、次の取得までに配置フラグを立てること。
+ 立てずに再度取得すると同じキャラクターが返されるため、デバッグビルドではアサーションで検出する。
  @return 未使用キャラクター。見つからないときはnilを返す。
  */
 - (id)getNext
 {
-    int i = 0;              // ループ変数
-    AKCharacter *ret = nil;   // 戻り値
-    AKCharacter *work = nil;  // ワーク変数
+    AKLog(kAKLogCharacterPool_1, @"size_=%d activeCount_=%d", size_, activeCount_);
     
-    AKLog(kAKLogCharacterPool_1, @"size_=%d", size_);
+    NSAssert(pendingNext_ == nil, @"前回取得したキャラクターが配置されていない");
     
-    // 未使用のキャラクターを検索する
-    for (i = 0; i < size_; i++) {
+    // 未使用のキャラクターがない場合はnilを返す
+    if (activeCount_ >= size_) {
+        return nil;
+    }
+    
+    // 未使用の先頭のキャラクターを配置待ちとして返す
+    pendingNext_ = slots_[activeCount_];
+    return pendingNext_;
+}
+
+/*!
+ @brief 全キャラクター削除
+ 
+ すべてのキャラクターを画面から取り除く。
+ メッセージ送信中に呼ばれた場合は、未使用への移動は送信完了後に行われる。
+ 配置待ちのキャラクターも取り消す。
+ */
+- (void)reset
+{
+    // 配置待ちのキャラクターを取り消す
+    pendingNext_ = nil;
+    
+    // 使用中のキャラクターを末尾から画面から取り除く
+    // 末尾から処理するため、配置フラグを落として未使用へ移動しても未処理のキャラクターの位置は変わらない
+    for (NSInteger i = activeCount_ - 1; i >= 0; i--) {
         
         // キャラクターを取得する
-        work = [pool_ objectAtIndex:next_];
+        AKCharacter *character = slots_[i];
+        
+        // 配置フラグを落とす
+        character.isStaged = NO;
         
-        AKLog(kAKLogCharacterPool_1, @"next_=%d work.isStaged=%d", next_, work.isStaged);
+        // 親ノードから取り除く
+        [character.image removeFromParentAndCleanup:YES];
+    }
+}
+
+/*!
+ @brief 使用中キャラクター取得
+ 
+ 使用中のキャラクターを取得する。
+ メッセージ送信中は、送信中に未使用になったキャラクターも含まれる。
+ @param index 使用中キャラクターのインデックス
+ @return 使用中キャラクター
+ */
+- (id)activeAtIndex:(NSInteger)index
+{
+    NSAssert(index >= 0 && index < activeCount_, @"使用中キャラクターの範囲外");
+    
+    return slots_[index];
+}
+
+/*!
+ @brief 使用中キャラクターへのメッセージ送信
+ 
+ 使用中のキャラクターすべてに並び順にメッセージを送信する。
+ 処理中に未使用になったキャラクターは並びを変えずに残し、送信完了後にまとめて未使用へ移動する。
+ これにより、開始時点で使用中のキャラクターは安定した順序で1回ずつ処理される。
+ 処理中に未使用になったキャラクターは、まだ処理していなくても処理しない。
+ 処理中に使用中になったキャラクターは末尾に追加されるため、同じ処理の中で処理する。
+ @param selector 送信するメッセージ
+ @param object メッセージの引数
+ */
+- (void)makeActiveObjectsPerformSelector:(SEL)selector withObject:(id)object
+{
+    NSAssert(!isPerforming_, @"メッセージ送信中の再送信");
+    
+    // 処理中は未使用への移動を保留する
+    isPerforming_ = YES;
+    
+    for (NSInteger i = 0; i < activeCount_; i++) {
         
-        // インデックスを進める
-        next_ = (next_ + 1) % size_;
+        // キャラクターを取得する
+        AKCharacter *character = slots_[i];
         
-        // 使用中かどうか調べる
-        if (!work.isStaged) {
-            // 戻り値に設定する
-            ret = work;
-            // 処理を終了する
-            break;
+        // 処理中に未使用になったキャラクターは処理しない
+        if (!character.isStaged) {
+            continue;
         }
+        
+        // メッセージを送信する
+        [character performSelector:selector withObject:object];
     }
     
-    return ret;
+    isPerforming_ = NO;
+    
+    // 保留したキャラクターを未使用へ移動する
+    [self compactSlots];
 }
 
 /*!
- @brief 全キャラクター削除
+ @brief 使用中キャラクターの画像表示位置更新
  
- すべてのキャラクターを画面から取り除く。
+ 使用中のキャラクターすべての画像表示位置を補間した位置に更新する。
+ 表示位置の更新では使用中・未使用の状態は変わらないため、先頭から順に処理する。
+ @param alpha 補間の割合(0で移動前の座標、1で現在の座標)
  */
-- (void)reset
+- (void)updateImagePositionWithAlpha:(float)alpha
+{
+    for (NSInteger i = 0; i < activeCount_; i++) {
+        [slots_[i] updateImagePositionWithAlpha:alpha];
+    }
+}
+
+/*!
+ @brief 使用中への移動
+ 
+ キャラクターを未使用の先頭と入れ替え、使用中の末尾に移動する。
+ 未使用への移動を保留しているキャラクターの場合は、その位置のまま使用中に戻る。
+ @param character キャラクター
+ */
+- (void)activateCharacter:(AKCharacter *)character
+{
+    NSAssert(character.ownerPool == self, @"管理対象外のキャラクター");
+    
+    // 配置待ちのキャラクターが配置された場合は配置待ちを解除する
+    if (character == pendingNext_) {
+        pendingNext_ = nil;
+    }
+    
+    // すでに使用中の場合は処理しない
+    // 未使用への移動を保留している場合も、配置フラグが立つことで整理の対象外となる
+    if (character.poolIndex < activeCount_) {
+        return;
+    }
+    
+    // 未使用の先頭のキャラクターと入れ替える
+    [self swapSlot:character.poolIndex with:activeCount_];
+    
+    // 使用中の数を増やす
+    activeCount_++;
+}
+
+/*!
+ @brief 未使用への移動
+ 
+ キャラクターを使用中の末尾まで隣と入れ替えながら移動し、未使用の先頭に移動する。
+ 後ろのキャラクターは1つずつ前に詰まるため、残りの使用中のキャラクターの並び順は変わらない。
+ メッセージ送信中は並びを変えずに移動を保留する。
+ @param character キャラクター
+ */
+- (void)deactivateCharacter:(AKCharacter *)character
+{
+    NSAssert(character.ownerPool == self, @"管理対象外のキャラクター");
+    
+    // すでに未使用の場合は処理しない
+    if (character.poolIndex >= activeCount_) {
+        return;
+    }
+    
+    // メッセージ送信中は移動を保留する
+    if (isPerforming_) {
+        hasDeferred_ = YES;
+        return;
+    }
+    
+    // 使用中の末尾まで隣のキャラクターと入れ替えて、後ろのキャラクターを前に詰める
+    for (NSInteger i = character.poolIndex; i < activeCount_ - 1; i++) {
+        [self swapSlot:i with:i + 1];
+    }
+    
+    // 使用中の数を減らす
+    activeCount_--;
+}
+
+/*!
+ @brief 状態の保存
+ 
+ 使用中のキャラクターの数と、使用中のキャラクターの状態を並び順に保存する。
+ 処理順が結果に影響するため、並び順も保存時と同じになるように復元する。
+ @param snapshot 保存先
+ */
+- (void)writeSnapshot:(AKSnapshot *)snapshot
+{
+    [snapshot writeBytes:&activeCount_ length:sizeof(activeCount_)];
+    
+    for (NSInteger i = 0; i < activeCount_; i++) {
+        [slots_[i] writeSnapshot:snapshot];
+    }
+}
+
+/*!
+ @brief 状態の復元
+ 
+ すべてのキャラクターを取り除いた後、保存した数のキャラクターを未使用の先頭から順に取得して状態を復元する。
+ 復元したキャラクターは配置フラグを立てた順に使用中の末尾に並ぶため、保存時と同じ並び順となる。
+ @param snapshot 読み込み元
+ @param parent 画像を配置する親ノード
+ */
+- (void)readSnapshot:(AKSnapshot *)snapshot parent:(CCNode *)parent
 {
-    NSEnumerator *enumerator = nil; // キャラクター解放作業用列挙子
-    AKCharacter *character = nil;   // キャラクター
+    // すべてのキャラクターを取り除く
+    [self reset];
     
-    // 各キャラクターを画面から取り除く
-    enumerator = [self.pool objectEnumerator];
-    for (character in enumerator) {
+    // 使用中のキャラクター数を読み込む
+    NSInteger count = 0;
+    [snapshot readBytes:&count length:sizeof(count)];
+    
+    NSAssert(count >= 0 && count <= size_, @"使用中のキャラクター数が範囲外");
+    
+    for (NSInteger i = 0; i < count; i++) {
+        
+        // 未使用のキャラクターを取得して状態を復元する
+        AKCharacter *character = [self getNext];
+        [character readSnapshot:snapshot];
         
-        // 画面上に配置されている場合は削除する
-        if (character.isStaged) {
-            
-            // 配置フラグを落とす
-            character.isStaged = NO;
-            
-            // 親ノードから取り除く
-            [character.image removeFromParentAndCleanup:YES];
+        // 画像を親ノードに配置する
+        if (parent != nil && character.image != nil) {
+            [parent addChild:character.image];
         }
     }
     
-    // インデックスを初期化する
-    next_ = 0;
+    AKLog(kAKLogCharacterPool_1, @"class=%@ activeCount_=%d", class_, activeCount_);
+}
+
+/*!
+ @brief 未使用への移動を保留したキャラクターの整理
+ 
+ 使用中の範囲に残っている配置フラグの落ちたキャラクターを未使用へ移動する。
+ 配置中のキャラクターを前から詰めていくため、使用中のキャラクターの並び順は変わらない。
+ */
+- (void)compactSlots
+{
+    // 保留しているキャラクターがない場合は処理しない
+    if (!hasDeferred_) {
+        return;
+    }
+    
+    // 配置中のキャラクターを前から詰める
+    NSInteger count = 0;
+    for (NSInteger i = 0; i < activeCount_; i++) {
+        if (slots_[i].isStaged) {
+            [self swapSlot:i with:count];
+            count++;
+        }
+    }
+    
+    // 詰めた後の数を使用中の数とする
+    activeCount_ = count;
+    hasDeferred_ = NO;
+}
+
+/*!
+ @brief キャラクターの入れ替え
+ 
+ キャラクターの並びの2箇所を入れ替える。
+ @param index1 入れ替え位置1
+ @param index2 入れ替え位置2
+ */
+- (void)swapSlot:(NSInteger)index1 with:(NSInteger)index2
+{
+    // 同じ位置の場合は処理しない
+    if (index1 == index2) {
+        return;
+    }
+    
+    // 並びを入れ替える
+    AKCharacter *work = slots_[index1];
+    slots_[index1] = slots_[index2];
+    slots_[index2] = work;
+    
+    // キャラクターの並び順を更新する
+    slots_[index1].poolIndex = index1;
+    slots_[index2].poolIndex = index2;
 }
 @end
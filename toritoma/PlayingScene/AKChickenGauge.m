@@ -88,6 +88,8 @@ static const NSInteger kAKImageHeight = 16;
     self.fullImage.position = ccp([AKScreenSize deviceLength:-kAKImageWidth / 2.0f], 0.0f);
     
     // 比率は0で初期化する
+    // 満ゲージの幅を必ず更新するため、一旦範囲外の値にしておく
+    percent_ = -1.0f;
     self.percent = 0.0f;
     
     return self;
@@ -119,11 +121,16 @@ static const NSInteger kAKImageHeight = 16;
  @brief ゲージの溜まっている比率設定
  
  ゲージの溜まっている比率を設定する。
- 満ゲージの幅を更新する。
+ 満ゲージの幅を更新する。比率が変わっていない場合は何もしない。
  @param parcent ゲージの溜まっている比率
  */
 - (void)setPercent:(float)percent
 {
+    // 比率が変わっていない場合は幅を更新しない
+    if (percent == percent_) {
+        return;
+    }
+    
     // メンバに設定する。
     percent_ = percent;
     
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2013 Akihiro Kaneda.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1.Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   2.Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   3.Neither the name of the Monochrome Soft nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ @file AKCollisionGrid.h
+ @brief 当たり判定グリッドクラス定義
+ 
+ 当たり判定の候補を絞り込むための一様グリッドを管理するクラスを定義する。
+ */
+
+#import "AKToritoma.h"
+
+@class AKCharacter;
+@class AKCharacterPool;
+
+// 当たり判定グリッドクラス
+@interface AKCollisionGrid : NSObject {
+    /// 登録可能なキャラクター数
+    NSInteger capacity_;
+    /// 登録しているキャラクター数
+    NSInteger count_;
+    /// 登録しているキャラクター(弱い参照)
+    AKCharacter **characters_;
+    /// 登録しているキャラクターの左端
+    float *left_;
+    /// 登録しているキャラクターの右端
+    float *right_;
+    /// 登録しているキャラクターの上端
+    float *top_;
+    /// 登録しているキャラクターの下端
+    float *bottom_;
+    /// グリッドの列数
+    NSInteger colCount_;
+    /// グリッドの行数
+    NSInteger rowCount_;
+    /// セルごとの登録開始位置(セル数+1個)
+    NSInteger *cellStart_;
+    /// セルに登録したキャラクターのインデックス
+    NSInteger *cellItems_;
+    /// セル登録時の書き込み位置
+    NSInteger *cellCursor_;
+    /// セル登録バッファのサイズ
+    NSInteger cellItemCapacity_;
+    /// 検索済みのキャラクターに付ける印
+    NSUInteger *stamps_;
+    /// 検索ごとに更新する印の値
+    NSUInteger currentStamp_;
+    /// 検索結果のインデックス
+    NSInteger *results_;
+    /// 検索結果の件数
+    NSInteger resultCount_;
+    /// 当たり判定を行った組み合わせの数
+    NSUInteger pairTestCount_;
+}
+
+/// 登録しているキャラクター数
+@property (nonatomic, readonly)NSInteger count;
+/// 当たり判定を行った組み合わせの数
+@property (nonatomic, readonly)NSUInteger pairTestCount;
+
+// オブジェクト生成処理
+- (id)initWithCapacity:(NSInteger)capacity;
+// グリッド再構築
+- (void)rebuildWithCharacters:(NSArray *)characters;
+// グリッド再構築(キャラクタープール指定)
+- (void)rebuildWithPool:(AKCharacterPool *)pool;
+// 衝突候補の検索
+- (NSInteger)searchHitLeft:(float)left right:(float)right top:(float)top bottom:(float)bottom;
+// セル単位の候補検索
+- (NSInteger)searchCellLeft:(float)left right:(float)right top:(float)top bottom:(float)bottom;
+// 検索結果のキャラクター取得
+- (AKCharacter *)resultAtIndex:(NSInteger)index;
+// 統計情報のリセット
+- (void)resetStatistics;
+@end
@@ -0,0 +1,442 @@
+/*
+ * Copyright (c) 2013 Akihiro Kaneda.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1.Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   2.Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   3.Neither the name of the Monochrome Soft nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ @file AKCollisionGrid.m
+ @brief 当たり判定グリッドクラス定義
+ 
+ 当たり判定の候補を絞り込むための一様グリッドを管理するクラスを定義する。
+ */
+
+#import "AKCollisionGrid.h"
+#import "AKCharacter.h"
+#import "AKCharacterPool.h"
+
+/// セルのサイズ
+static const float kAKCollisionCellSize = 32.0f;
+/// ステージ外側のグリッドで管理する範囲
+static const float kAKCollisionMargin = 64.0f;
+
+/*!
+ @brief 座標からセル位置を計算する
+ 
+ 座標からセルの行または列の位置を計算する。
+ グリッド範囲外の座標は端のセルに含める。
+ @param position 座標
+ @param count セルの行数または列数
+ @return セルの位置
+ */
+static inline NSInteger AKCellPosition(float position, NSInteger count)
+{
+    // グリッドの左端(下端)からのセル数を計算する
+    float cell = floorf((position + kAKCollisionMargin) / kAKCollisionCellSize);
+    
+    // 範囲外の場合は端のセルとする
+    if (cell < 0.0f) {
+        return 0;
+    }
+    else if (cell >= count) {
+        return count - 1;
+    }
+    else {
+        return (NSInteger)cell;
+    }
+}
+
+/*!
+ @brief 当たり判定グリッドクラス
+ 
+ 当たり判定の候補を絞り込むための一様グリッドを管理する。
+ ステージを一定サイズのセルに分割し、キャラクターを当たり判定の範囲が重なるセルに登録する。
+ 検索時は検索範囲と重なるセルのキャラクターだけを判定対象とする。
+ 登録時の位置で判定するため、登録後にキャラクターが移動した場合は再構築が必要となる。
+ */
+// プライベートメソッド宣言
+@interface AKCollisionGrid ()
+// キャラクター登録
+- (void)registerCharacter:(AKCharacter *)character;
+// セル構築
+- (void)buildCells;
+// 検索処理
+- (NSInteger)searchLeft:(float)left right:(float)right top:(float)top bottom:(float)bottom isHitOnly:(BOOL)isHitOnly;
+@end
+
+@implementation AKCollisionGrid
+
+@synthesize count = count_;
+@synthesize pairTestCount = pairTestCount_;
+
+/*!
+ @brief オブジェクト生成処理
+ 
+ オブジェクトの生成を行う。
+ @param capacity 登録可能なキャラクター数
+ @return 生成したオブジェクト。失敗時はnilを返す。
+ */
+- (id)initWithCapacity:(NSInteger)capacity
+{
+    AKLog(kAKLogCollisionGrid_1, @"start capacity=%d", capacity);
+    
+    // スーパークラスの生成処理
+    self = [super init];
+    if (!self) {
+        AKLog(kAKLogCollisionGrid_0, @"error");
+        return nil;
+    }
+    
+    // グリッドの行数、列数を計算する
+    colCount_ = (NSInteger)ceilf((kAKStageSize.width + kAKCollisionMargin * 2) / kAKCollisionCellSize);
+    rowCount_ = (NSInteger)ceilf((kAKStageSize.height + kAKCollisionMargin * 2) / kAKCollisionCellSize);
+    
+    // キャラクター情報のバッファを確保する
+    capacity_ = capacity;
+    count_ = 0;
+    characters_ = malloc(sizeof(AKCharacter *) * capacity_);
+    left_ = malloc(sizeof(float) * capacity_);
+    right_ = malloc(sizeof(float) * capacity_);
+    top_ = malloc(sizeof(float) * capacity_);
+    bottom_ = malloc(sizeof(float) * capacity_);
+    stamps_ = calloc(capacity_, sizeof(NSUInteger));
+    results_ = malloc(sizeof(NSInteger) * capacity_);
+    
+    // セル情報のバッファを確保する
+    // セル登録バッファは1キャラクターあたり4セル分を初期サイズとし、不足した場合は拡張する
+    cellStart_ = calloc(colCount_ * rowCount_ + 1, sizeof(NSInteger));
+    cellCursor_ = malloc(sizeof(NSInteger) * colCount_ * rowCount_);
+    cellItemCapacity_ = capacity_ * 4;
+    cellItems_ = malloc(sizeof(NSInteger) * cellItemCapacity_);
+    
+    // その他のメンバを初期化する
+    currentStamp_ = 0;
+    resultCount_ = 0;
+    pairTestCount_ = 0;
+    
+    AKLog(kAKLogCollisionGrid_1, @"end col=%d row=%d", colCount_, rowCount_);
+    return self;
+}
+
+/*!
+ @brief インスタンス解放時処理
+ 
+ インスタンス解放時にオブジェクトを解放する。
+ */
+- (void)dealloc
+{
+    // バッファを解放する
+    free(characters_);
+    free(left_);
+    free(right_);
+    free(top_);
+    free(bottom_);
+    free(stamps_);
+    free(results_);
+    free(cellStart_);
+    free(cellCursor_);
+    free(cellItems_);
+    
+    // スーパークラスの解放処理
+    [super dealloc];
+}
+
+/*!
+ @brief グリッド再構築
+ 
+ ステージに配置されているキャラクターをグリッドに登録し直す。
+ キャラクターは配列の順番で登録し、検索結果もこの順番で返す。
+ @param characters 登録するキャラクター群
+ */
+- (void)rebuildWithCharacters:(NSArray *)characters
+{
+    // 登録数をクリアする
+    count_ = 0;
+    
+    // ステージに配置されているキャラクターを登録する
+    for (AKCharacter *character in characters) {
+        [self registerCharacter:character];
+    }
+    
+    // セルを構築する
+    [self buildCells];
+}
+
+/*!
+ @brief グリッド再構築(キャラクタープール指定)
+ 
+ キャラクタープールの使用中のキャラクターをグリッドに登録し直す。
+ キャラクターはプール内の並び順で登録し、検索結果もこの順番で返す。
+ @param pool 登録するキャラクターを管理するプール
+ */
+- (void)rebuildWithPool:(AKCharacterPool *)pool
+{
+    // 登録数をクリアする
+    count_ = 0;
+    
+    // 使用中のキャラクターを登録する
+    NSInteger activeCount = pool.activeCount;
+    for (NSInteger i = 0; i < activeCount; i++) {
+        [self registerCharacter:[pool activeAtIndex:i]];
+    }
+    
+    // セルを構築する
+    [self buildCells];
+}
+
+/*!
+ @brief キャラクター登録
+ 
+ キャラクターの当たり判定の範囲を記憶する。
+ ステージに配置されていないキャラクターは登録しない。
+ @param character 登録するキャラクター
+ */
+- (void)registerCharacter:(AKCharacter *)character
+{
+    // 画面に配置されていない場合は登録しない
+    if (!character.isStaged) {
+        return;
+    }
+    
+    // 登録可能数を超えている場合はエラー
+    if (count_ >= capacity_) {
+        AKLog(kAKLogCollisionGrid_0, @"登録可能数オーバー:capacity=%d", capacity_);
+        NSAssert(NO, @"登録可能数オーバー");
+        return;
+    }
+    
+    // 上下左右の端を計算する
+    characters_[count_] = character;
+    left_[count_] = character.positionX - character.width / 2.0f;
+    right_[count_] = character.positionX + character.width / 2.0f;
+    top_[count_] = character.positionY + character.height / 2.0f;
+    bottom_[count_] = character.positionY - character.height / 2.0f;
+    
+    count_++;
+}
+
+/*!
+ @brief セル構築
+ 
+ 登録したキャラクターを当たり判定の範囲が重なるセルに振り分ける。
+ */
+- (void)buildCells
+{
+    // セルごとの登録数をクリアする
+    NSInteger cellCount = colCount_ * rowCount_;
+    memset(cellStart_, 0, sizeof(NSInteger) * (cellCount + 1));
+    
+    // セルごとの登録数を数える
+    NSInteger total = 0;
+    for (NSInteger i = 0; i < count_; i++) {
+        
+        NSInteger minCol = AKCellPosition(left_[i], colCount_);
+        NSInteger maxCol = AKCellPosition(right_[i], colCount_);
+        NSInteger minRow = AKCellPosition(bottom_[i], rowCount_);
+        NSInteger maxRow = AKCellPosition(top_[i], rowCount_);
+        
+        for (NSInteger row = minRow; row <= maxRow; row++) {
+            for (NSInteger col = minCol; col <= maxCol; col++) {
+                cellStart_[row * colCount_ + col + 1]++;
+            }
+        }
+        
+        total += (maxCol - minCol + 1) * (maxRow - minRow + 1);
+    }
+    
+    // セル登録バッファが不足している場合は拡張する
+    if (total > cellItemCapacity_) {
+        
+        AKLog(kAKLogCollisionGrid_1, @"セル登録バッファ拡張:%d->%d", cellItemCapacity_, total);
+        
+        cellItemCapacity_ = total;
+        cellItems_ = realloc(cellItems_, sizeof(NSInteger) * cellItemCapacity_);
+    }
+    
+    // 登録数を累積して各セルの登録開始位置を求める
+    for (NSInteger cell = 0; cell < cellCount; cell++) {
+        cellStart_[cell + 1] += cellStart_[cell];
+        cellCursor_[cell] = cellStart_[cell];
+    }
+    
+    // セルにキャラクターのインデックスを登録する
+    // キャラクターの順番に登録するため、セル内のインデックスは昇順となる
+    for (NSInteger i = 0; i < count_; i++) {
+        
+        NSInteger minCol = AKCellPosition(left_[i], colCount_);
+        NSInteger maxCol = AKCellPosition(right_[i], colCount_);
+        NSInteger minRow = AKCellPosition(bottom_[i], rowCount_);
+        NSInteger maxRow = AKCellPosition(top_[i], rowCount_);
+        
+        for (NSInteger row = minRow; row <= maxRow; row++) {
+            for (NSInteger col = minCol; col <= maxCol; col++) {
+                cellItems_[cellCursor_[row * colCount_ + col]++] = i;
+            }
+        }
+    }
+    
+    // 前回の検索結果をクリアする
+    resultCount_ = 0;
+}
+
+/*!
+ @brief 衝突候補の検索
+ 
+ 指定範囲と重なるセルに登録されているキャラクターから、当たり判定の範囲が重なるものを検索する。
+ 検索結果は登録順に並べる。検索結果は次の検索を行うまで有効。
+ @param left 検索範囲の左端
+ @param right 検索範囲の右端
+ @param top 検索範囲の上端
+ @param bottom 検索範囲の下端
+ @return 検索結果の件数
+ */
+- (NSInteger)searchHitLeft:(float)left right:(float)right top:(float)top bottom:(float)bottom
+{
+    return [self searchLeft:left right:right top:top bottom:bottom isHitOnly:YES];
+}
+
+/*!
+ @brief セル単位の候補検索
+ 
+ 指定範囲と重なるセルに登録されているキャラクターをすべて検索する。
+ 当たり判定の範囲による絞り込みは行わないため、独自の条件で判定する場合に使用する。
+ 検索結果は登録順に並べる。検索結果は次の検索を行うまで有効。
+ @param left 検索範囲の左端
+ @param right 検索範囲の右端
+ @param top 検索範囲の上端
+ @param bottom 検索範囲の下端
+ @return 検索結果の件数
+ */
+- (NSInteger)searchCellLeft:(float)left right:(float)right top:(float)top bottom:(float)bottom
+{
+    return [self searchLeft:left right:right top:top bottom:bottom isHitOnly:NO];
+}
+
+/*!
+ @brief 検索処理
+ 
+ 指定範囲と重なるセルに登録されているキャラクターを検索する。
+ @param left 検索範囲の左端
+ @param right 検索範囲の右端
+ @param top 検索範囲の上端
+ @param bottom 検索範囲の下端
+ @param isHitOnly 当たり判定の範囲が重なるものだけに絞り込むかどうか
+ @return 検索結果の件数
+ */
+- (NSInteger)searchLeft:(float)left right:(float)right top:(float)top bottom:(float)bottom isHitOnly:(BOOL)isHitOnly
+{
+    // 検索結果をクリアする
+    resultCount_ = 0;
+    
+    // 登録がない場合は処理しない
+    if (count_ <= 0) {
+        return 0;
+    }
+    
+    // 検索済みの印を更新する
+    // 一周した場合は全キャラクターの印をクリアする
+    currentStamp_++;
+    if (currentStamp_ == 0) {
+        memset(stamps_, 0, sizeof(NSUInteger) * capacity_);
+        currentStamp_ = 1;
+    }
+    
+    // 検索範囲のセルを計算する
+    NSInteger minCol = AKCellPosition(left, colCount_);
+    NSInteger maxCol = AKCellPosition(right, colCount_);
+    NSInteger minRow = AKCellPosition(bottom, rowCount_);
+    NSInteger maxRow = AKCellPosition(top, rowCount_);
+    
+    // 検索範囲のセルごとに判定を行う
+    for (NSInteger row = minRow; row <= maxRow; row++) {
+        for (NSInteger col = minCol; col <= maxCol; col++) {
+            
+            NSInteger cell = row * colCount_ + col;
+            
+            for (NSInteger item = cellStart_[cell]; item < cellStart_[cell + 1]; item++) {
+                
+                NSInteger i = cellItems_[item];
+                
+                // 複数のセルに登録されている場合は判定済みのため処理しない
+                if (stamps_[i] == currentStamp_) {
+                    continue;
+                }
+                stamps_[i] = currentStamp_;
+                
+                // 判定した組み合わせの数をカウントする
+                pairTestCount_++;
+                
+                // 以下のすべての条件を満たしている時、衝突していると判断する。
+                //   ・相手の右端が検索範囲の左端よりも右側にある
+                //   ・相手の左端が検索範囲の右端よりも左側にある
+                //   ・相手の上端が検索範囲の下端よりも上側にある
+                //   ・相手の下端が検索範囲の上端よりも下側にある
+                if (isHitOnly &&
+                    !((right_[i] > left) &&
+                      (left_[i] < right) &&
+                      (top_[i] > bottom) &&
+                      (bottom_[i] < top))) {
+                    continue;
+                }
+                
+                // 登録順になるように挿入する
+                NSInteger pos = resultCount_;
+                while (pos > 0 && results_[pos - 1] > i) {
+                    results_[pos] = results_[pos - 1];
+                    pos--;
+                }
+                results_[pos] = i;
+                resultCount_++;
+            }
+        }
+    }
+    
+    return resultCount_;
+}
+
+/*!
+ @brief 検索結果のキャラクター取得
+ 
+ 検索結果のキャラクターを取得する。
+ @param index 検索結果のインデックス
+ @return キャラクター
+ */
+- (AKCharacter *)resultAtIndex:(NSInteger)index
+{
+    NSAssert(index >= 0 && index < resultCount_, @"検索結果の範囲外");
+    
+    return characters_[results_[index]];
+}
+
+/*!
+ @brief 統計情報のリセット
+ 
+ 当たり判定を行った組み合わせの数をクリアする。
+ */
+- (void)resetStatistics
+{
+    pairTestCount_ = 0;
+}
+@end
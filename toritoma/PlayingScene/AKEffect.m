@@ -45,6 +45,9 @@ static const struct AKEffectDef kAKEffectDef[kAKEffectDefCount] = {
     {2, 32, 32, 0, -1, 60, 1, 0, 0}     // 自機破壊
 };
 
+/// 画面効果の種類ごとの画像名
+static NSString *imageNames_[kAKEffectDefCount];
+
 /*!
  @brief 画面効果クラス
  
@@ -52,6 +55,20 @@ static const struct AKEffectDef kAKEffectDef[kAKEffectDefCount] = {
  */
 @implementation AKEffect
 
+/*!
+ @brief クラス初期化処理
+ 
+ 生成のたびに画像名の文字列を作成しないように、画面効果の種類ごとの画像名を最初に1回だけ作成しておく。
+ */
++ (void)initialize
+{
+    if (self == [AKEffect class]) {
+        for (NSInteger i = 0; i < kAKEffectDefCount; i++) {
+            imageNames_[i] = [[NSString alloc] initWithFormat:kAKImageNameFormat, kAKEffectDef[i].fileNo];
+        }
+    }
+}
+
 /*!
  @brief 画面効果開始
  
@@ -80,8 +97,8 @@ static const struct AKEffectDef kAKEffectDef[kAKEffectDefCount] = {
     // 生存フレーム数を設定する
     lifeFrame_ = kAKEffectDef[type - 1].lifeFrame;
     
-    // 画像名を作成する
-    self.imageName = [NSString stringWithFormat:kAKImageNameFormat, kAKEffectDef[type - 1].fileNo];
+    // 画像名を設定する
+    self.imageName = imageNames_[type - 1];
         
     // アニメーションフレームの個数を設定する
     self.animationPattern = kAKEffectDef[type - 1].animationFrame;
@@ -122,4 +139,32 @@ static const struct AKEffectDef kAKEffectDef[kAKEffectDefCount] = {
         }
     }
 }
+
+/*!
+ @brief 状態の保存
+ 
+ キャラクター共通の状態に続けて、生存フレーム数を保存する。
+ @param snapshot 保存先
+ */
+- (void)writeSnapshot:(AKSnapshot *)snapshot
+{
+    // スーパークラスの処理を行う
+    [super writeSnapshot:snapshot];
+    
+    [snapshot writeBytes:&lifeFrame_ length:sizeof(lifeFrame_)];
+}
+
+/*!
+ @brief 状態の復元
+ 
+ キャラクター共通の状態に続けて、生存フレーム数を復元する。
+ @param snapshot 読み込み元
+ */
+- (void)readSnapshot:(AKSnapshot *)snapshot
+{
+    // スーパークラスの処理を行う
+    [super readSnapshot:snapshot];
+    
+    [snapshot readBytes:&lifeFrame_ length:sizeof(lifeFrame_)];
+}
 @end
@@ -69,6 +69,10 @@ struct AKEnemyDef {
     NSInteger score_;
     /// 倒した時に進む進行度
     NSInteger progress_;
+    /// 逆さまかどうか
+    BOOL isReverse_;
+    /// 敵の種別
+    NSInteger type_;
 }
 
 // 生成処理
@@ -144,5 +148,5 @@ struct AKEnemyDef {
 + (AKCharacter *)getBlockAtFeetAtX:(float)x
                               from:(float)top
                          isReverse:(BOOL)isReverse
-                            blocks:(NSArray *)blocks;
+                         blockGrid:(AKCollisionGrid *)blockGrid;
 @end
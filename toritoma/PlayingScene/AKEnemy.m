@@ -34,7 +34,8 @@
  */
 
 #import "AKEnemy.h"
-#import "AKEnemyShot.h"
+#import "AKEnemyShotEngine.h"
+#import "AKBlock.h"
 
 /// 画像名のフォーマット
 static NSString *kAKImageNameFormat = @"Enemy_%02d";
@@ -64,6 +65,17 @@ enum AKEnemyType {
 /// 敵の種類の数
 static const NSInteger kAKEnemyDefCount = 40;
 
+/// 状態保存で保存する敵固有の状態
+struct AKEnemyState {
+    NSInteger type;                     ///< 敵の種別
+    NSInteger frame;                    ///< 動作開始からの経過フレーム数
+    NSInteger state;                    ///< 動作状態
+    NSInteger work[kAKEnemyWorkCount];  ///< 作業領域
+    NSInteger score;                    ///< スコア
+    NSInteger progress;                 ///< 倒した時に進む進行度
+    BOOL isReverse;                     ///< 逆さまかどうか
+};
+
 /// 敵の定義
 static const struct AKEnemyDef kAKEnemyDef[kAKEnemyDefCount] = {
     //破壊,画像,フレーム数,フレーム間隔,幅,高さ,HP,スコア
@@ -109,6 +121,9 @@ static const struct AKEnemyDef kAKEnemyDef[kAKEnemyDefCount] = {
     {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}          // 予備40
 };
 
+/// 敵の種類ごとの画像名
+static NSString *imageNames_[kAKEnemyDefCount];
+
 /*!
  @brief 敵クラス
  
@@ -116,6 +131,20 @@ static const struct AKEnemyDef kAKEnemyDef[kAKEnemyDefCount] = {
  */
 @implementation AKEnemy
 
+/*!
+ @brief クラス初期化処理
+ 
+ 生成のたびに画像名の文字列を作成しないように、敵の種類ごとの画像名を最初に1回だけ作成しておく。
+ */
++ (void)initialize
+{
+    if (self == [AKEnemy class]) {
+        for (NSInteger i = 0; i < kAKEnemyDefCount; i++) {
+            imageNames_[i] = [[NSString alloc] initWithFormat:kAKImageNameFormat, kAKEnemyDef[i].image];
+        }
+    }
+}
+
 /*!
  @brief キャラクター固有の動作
 
@@ -177,7 +206,7 @@ static const struct AKEnemyDef kAKEnemyDef[kAKEnemyDefCount] = {
     progress_ = progress;
     
     // 配置フラグを立てる
-    isStaged_ = YES;
+    self.isStaged = YES;
     
     // 各メンバ変数を初期化する
     frame_ = 0;
@@ -189,15 +218,18 @@ static const struct AKEnemyDef kAKEnemyDef[kAKEnemyDefCount] = {
     AKLog(type < 0 || type > kAKEnemyDefCount, @"敵の種類の値が範囲外:%d", type);
     NSAssert(type > 0 && type <= kAKEnemyDefCount, @"敵の種類の値が範囲外");
     
+    // 種別を記憶する
+    type_ = type;
+    
     // 動作処理を設定する
     action_ = [self actionSelector:type];
     
     // 破壊処理を設定する
     destroy_ = [self destroySeletor:kAKEnemyDef[type - 1].destroy];
         
-    // 画像名を作成する
-    self.imageName = [NSString stringWithFormat:kAKImageNameFormat, kAKEnemyDef[type - 1].image];
-    AKLog(1, @"self.imageName = %@", self.imageName);
+    // 画像名を設定する
+    self.imageName = imageNames_[type - 1];
+    AKLog(kAKLogEnemy_1, @"self.imageName = %@", self.imageName);
                 
     // アニメーションフレームの個数を設定する
     self.animationPattern = kAKEnemyDef[type - 1].animationFrame;
@@ -217,8 +249,10 @@ static const struct AKEnemyDef kAKEnemyDef[kAKEnemyDefCount] = {
     // スコアを設定する
     score_ = kAKEnemyDef[type - 1].score;
     
-    // 画像の回転をリセットする
+    // 画像の回転と逆さまの状態をリセットする
     self.image.rotation = 0.0f;
+    self.image.flipY = NO;
+    isReverse_ = NO;
     
     // レイヤーに配置する
     [parent addChild:self.image];
@@ -471,16 +505,13 @@ static const struct AKEnemyDef kAKEnemyDef[kAKEnemyDefCount] = {
     
     // 障害物との衝突判定を行う
     CGPoint newPoint = [AKEnemy checkBlockPosition:ccp(self.positionX, self.positionY)
-                                              size:self.image.contentSize
-                                         isReverse:self.image.flipY
+                                              size:self.imageSize
+                                         isReverse:isReverse_
                                               data:data];
     
     // 移動先の座標を反映する
     self.positionX = newPoint.x;
     self.positionY = newPoint.y;
-
-    // 画像表示位置の更新を行う
-    [self updateImagePosition];
     
     AKLog(kAKLogEnemy_1, @"pos=(%f, %f)", self.positionX, self.positionY);
     AKLog(kAKLogEnemy_1, @"img=(%f, %f)", self.image.position.x, self.image.position.y);
@@ -765,7 +796,7 @@ static const struct AKEnemyDef kAKEnemyDef[kAKEnemyDefCount] = {
     if (state_ == kAKStateLeftMove) {
 
         // 重力加速度をかけて減速する
-        if (!self.image.flipY) {
+        if (!isReverse_) {
             self.speedY -= kAKGravitationAlacceleration;
         }
         else {
@@ -787,8 +818,8 @@ static const struct AKEnemyDef kAKEnemyDef[kAKEnemyDefCount] = {
     }
     
     // 落ちていく方向の障害物に接触している場合、着地したとしてスピードを0にする。
-    if ((!self.image.flipY && (self.blockHitSide & kAKHitSideBottom)) ||
-        (self.image.flipY && (self.blockHitSide & kAKHitSideTop))) {
+    if ((!isReverse_ && (self.blockHitSide & kAKHitSideBottom)) ||
+        (isReverse_ && (self.blockHitSide & kAKHitSideTop))) {
         
         self.speedX = 0.0f;
         self.speedY = 0.0f;
@@ -803,7 +834,7 @@ static const struct AKEnemyDef kAKEnemyDef[kAKEnemyDefCount] = {
         self.speedX = kAKMoveSpeed;
         
         // ジャンプする方向へ加速する
-        if (!self.image.flipY) {
+        if (!isReverse_) {
             self.speedY = kAKJumpSpeed;
         }
         else {
@@ -828,9 +859,6 @@ static const struct AKEnemyDef kAKEnemyDef[kAKEnemyDefCount] = {
     }
     
     AKLog(kAKLogEnemy_3, @"speed=(%f, %f)", self.speedX, self.speedY);
-    
-    // 画像表示位置の更新を行う
-    [self updateImagePosition];
 }
 
 /*!
@@ -1056,16 +1084,13 @@ static const struct AKEnemyDef kAKEnemyDef[kAKEnemyDefCount] = {
     
     // 障害物との衝突判定を行う
     CGPoint newPoint = [AKEnemy checkBlockPosition:ccp(self.positionX, self.positionY)
-                                              size:self.image.contentSize
-                                         isReverse:self.image.flipY
+                                              size:self.imageSize
+                                         isReverse:isReverse_
                                               data:data];
     
     // 移動先の座標を反映する
     self.positionX = newPoint.x;
     self.positionY = newPoint.y;
-    
-    // 画像表示位置の更新を行う
-    [self updateImagePosition];
 }
 
 /*!
@@ -1424,7 +1449,7 @@ static const struct AKEnemyDef kAKEnemyDef[kAKEnemyDefCount] = {
             self.scrollSpeed = 1.0f;
             
             // 地面の上の位置に高さを補正する
-            self.positionY = self.image.contentSize.height / 2 + kAKGround;
+            self.positionY = self.imageSize.height / 2 + kAKGround;
             
             break;
             
@@ -1591,24 +1616,28 @@ static const struct AKEnemyDef kAKEnemyDef[kAKEnemyDefCount] = {
  */
 + (void)fireNWayWithPosition:(CGPoint)position count:(NSInteger)count interval:(float)interval speed:(float)speed data:(id<AKPlayDataInterface>)data
 {
-    // n-way弾の各弾の角度を計算する
-    AKNWayAngle *nWayAngle = [AKNWayAngle angleFromSrc:position
-                                                  dest:data.playerPosition
-                                                 count:count
-                                              interval:interval];
+    // 全弾分の空きを予約する
+    // 空きが足りない場合は弾の並びが崩れないように全弾発射しない
+    if ([data reserveEnemyShots:count].length == 0) {
+        return;
+    }
+    
+    // n-way弾の各弾の方向を計算する
+    struct AKNWayDirection directions[count];
+    [AKNWayAngle calcDirections:directions
+                        fromSrc:position
+                           dest:data.playerPosition
+                          count:count
+                       interval:interval];
     
     // 各弾を発射する
-    for (NSNumber *angle in nWayAngle.angles) {
-        
-        // 敵弾インスタンスを取得する
-        AKEnemyShot *enemyShot = [data getEnemyShot];
+    for (NSInteger i = 0; i < count; i++) {
         
         // 通常弾を生成する
-        [enemyShot createNormalShotAtX:position.x
-                                     y:position.y
-                                 angle:[angle floatValue]
-                                 speed:speed
-                                parent:[data getEnemyShotParent]];
+        [data.enemyShotEngine createNormalShotAtX:position.x
+                                                y:position.y
+                                        direction:directions[i]
+                                            speed:speed];
     }
 }
 
@@ -1632,33 +1661,36 @@ static const struct AKEnemyDef kAKEnemyDef[kAKEnemyDefCount] = {
                  isScroll:(BOOL)isScroll
                      data:(id<AKPlayDataInterface>)data
 {
-    // n-way弾の各弾の角度を計算する
-    AKNWayAngle *nWayAngle = [AKNWayAngle angleFromCenterAngle:angle
-                                                         count:count
-                                                      interval:interval];
+    // 全弾分の空きを予約する
+    // 空きが足りない場合は弾の並びが崩れないように全弾発射しない
+    if ([data reserveEnemyShots:count].length == 0) {
+        return;
+    }
+    
+    // n-way弾の各弾の方向を計算する
+    struct AKNWayDirection directions[count];
+    [AKNWayAngle calcDirections:directions
+                fromCenterAngle:angle
+                          count:count
+                       interval:interval];
     
     // 各弾を発射する
-    for (NSNumber *angle in nWayAngle.angles) {
+    for (NSInteger i = 0; i < count; i++) {
 
-        // 敵弾インスタンスを取得する
-        AKEnemyShot *enemyShot = [data getEnemyShot];
-        
         // スクロールの影響を受けるかどうかで弾の種別を変える
         if (isScroll) {
             // スクロール影響弾を生成する
-            [enemyShot createScrollShotAtX:position.x
-                                         y:position.y
-                                     angle:[angle floatValue]
-                                     speed:speed
-                                    parent:[data getEnemyShotParent]];
+            [data.enemyShotEngine createScrollShotAtX:position.x
+                                                    y:position.y
+                                            direction:directions[i]
+                                                speed:speed];
         }
         else {
             // 通常弾を生成する
-            [enemyShot createNormalShotAtX:position.x
-                                         y:position.y
-                                     angle:[angle floatValue]
-                                     speed:speed
-                                    parent:[data getEnemyShotParent]];
+            [data.enemyShotEngine createNormalShotAtX:position.x
+                                                    y:position.y
+                                            direction:directions[i]
+                                                speed:speed];
         }
     }
 }
@@ -1680,24 +1712,24 @@ static const struct AKEnemyDef kAKEnemyDef[kAKEnemyDefCount] = {
                             speed:(float)speed
                              data:(id<AKPlayDataInterface>)data
 {
-    // 弾の角度を計算する
-    AKNWayAngle *nWayAngle = [AKNWayAngle angleFromSrc:position
-                                                  dest:data.playerPosition
-                                                 count:1
-                                              interval:0.0f];
+    // 全弾分の空きを予約する
+    // 空きが足りない場合は弾の並びが崩れないように全弾発射しない
+    if ([data reserveEnemyShots:count].length == 0) {
+        return;
+    }
+    
+    // 弾の方向を計算する
+    struct AKNWayDirection direction = AKNWayDirectionMake([AKNWayAngle calcDestAngleFrom:position
+                                                                                       to:data.playerPosition]);
     
     // 各弾の位置に通常弾を生成する
     for (int i = 0; i < count; i++) {
 
-        // 敵弾インスタンスを取得する
-        AKEnemyShot *enemyShot = [data getEnemyShot];
-        
         // 通常弾を生成する
-        [enemyShot createNormalShotAtX:position.x + distance[i].x
-                                     y:position.y + distance[i].y
-                                 angle:nWayAngle.topAngle
-                                 speed:speed
-                                parent:[data getEnemyShotParent]];
+        [data.enemyShotEngine createNormalShotAtX:position.x + distance[i].x
+                                                y:position.y + distance[i].y
+                                        direction:direction
+                                            speed:speed];
     }
 }
 
@@ -1724,32 +1756,34 @@ static const struct AKEnemyDef kAKEnemyDef[kAKEnemyDefCount] = {
     // 中心点からの弾の距離
     const float kAKDistance = 4.0f;
     
-    // 破裂弾弾全体の角度を計算する
-    AKNWayAngle *centerAngle = [AKNWayAngle angleFromSrc:position
-                                                    dest:data.playerPosition
-                                                   count:1
-                                                interval:0.0f];
+    // 全弾分の空きを予約する
+    // 空きが足りない場合は弾の並びが崩れないように全弾発射しない
+    if ([data reserveEnemyShots:count].length == 0) {
+        return;
+    }
+    
+    // 破裂弾弾全体の方向を計算する
+    struct AKNWayDirection centerDirection = AKNWayDirectionMake([AKNWayAngle calcDestAngleFrom:position
+                                                                                             to:data.playerPosition]);
     
-    // 個別の弾の角度を計算する
-    AKNWayAngle *burstAngle = [AKNWayAngle angleFromCenterAngle:M_PI
-                                                          count:count
-                                                       interval:interval];
+    // 個別の弾の方向を計算する
+    struct AKNWayDirection burstDirections[count];
+    [AKNWayAngle calcDirections:burstDirections
+                fromCenterAngle:M_PI
+                          count:count
+                       interval:interval];
     
     // 各弾を発射する
-    for (NSNumber *angle in burstAngle.angles) {
-        
-        // 敵弾インスタンスを取得する
-        AKEnemyShot *enemyShot = [data getEnemyShot];
+    for (NSInteger i = 0; i < count; i++) {
         
         // 破裂弾を生成する
-        [enemyShot createChangeSpeedShotAtX:position.x + cosf([angle floatValue]) * kAKDistance
-                                          y:position.y + sinf([angle floatValue]) * kAKDistance
-                                      angle:centerAngle.topAngle
-                                      speed:speed
-                             changeInterval:burstInterval
-                                changeAngle:[angle floatValue]
-                                changeSpeed:burstSpeed
-                                     parent:[data getEnemyShotParent]];
+        [data.enemyShotEngine createChangeSpeedShotAtX:position.x + burstDirections[i].cos * kAKDistance
+                                                     y:position.y + burstDirections[i].sin * kAKDistance
+                                             direction:centerDirection
+                                                 speed:speed
+                                        changeInterval:burstInterval
+                                       changeDirection:burstDirections[i]
+                                           changeSpeed:burstSpeed];
 
     }
 }
@@ -1760,6 +1794,7 @@ static const struct AKEnemyDef kAKEnemyDef[kAKEnemyDefCount] = {
  上方向にある障害物と下方向にある障害物の近い方へ位置を移動する。
  上方向の方が近い場合は天井張り付き、下方向の方が近い場合は床に張り付きとする。
  存在しない場合は無限遠にあるものとして判定し、上下同じ場合は下側を優先する。
+ 複数のタイルをまとめた障害物はタイル1個ずつの中心で距離を判定する。
  @param blocks 障害物
  */
 - (void)checkReverse:(NSArray *)blocks
@@ -1769,42 +1804,39 @@ static const struct AKEnemyDef kAKEnemyDef[kAKEnemyDefCount] = {
     float downDistance = FLT_MAX;
     
     // 移動先位置の初期値を設定する
-    float upPosition = self.image.contentSize.height / 2;
-    float downPosition = self.image.contentSize.height / 2;
+    float upPosition = self.imageSize.height / 2;
+    float downPosition = self.imageSize.height / 2;
 
     // 各障害物との距離を調べる
-    for (AKCharacter *block in [blocks objectEnumerator]) {
+    // 列挙子オブジェクトを作成しないように高速列挙で処理する
+    for (AKBlock *block in blocks) {
         
         // x軸方向に重なりがない場合は処理を飛ばす
-        if (fabsf(self.positionX - block.positionX) > (self.image.contentSize.width + block.image.contentSize.width) / 2) {
+        if (fabsf(self.positionX - block.positionX) > (self.imageSize.width + block.width) / 2) {
             continue;
         }
         
-        // 障害物が上方向にある場合は上方向距離を更新する
-        if (self.positionY < block.positionY) {
+        // 上方向にあるタイルの内、一番近いものとの距離が小さい場合は距離と移動先位置を更新する
+        float upCenter = [block cellCenterYAboveY:self.positionY];
+        if (upCenter < FLT_MAX && upCenter - self.positionY < upDistance) {
             
-            // 距離が小さい場合は距離と移動先位置を更新する
-            if (block.positionY - self.positionY < upDistance) {
-                
-                upDistance = block.positionY - self.positionY;
-                upPosition = block.positionY - (block.height + self.image.contentSize.height) / 2;
-            }
+            upDistance = upCenter - self.positionY;
+            upPosition = upCenter - (block.cellHeight + self.imageSize.height) / 2;
         }
-        // 上方向にない場合は下方向距離を更新する
-        else {
+        
+        // 上方向にないタイルの内、一番近いものとの距離が小さい場合は距離と移動先位置を更新する
+        float downCenter = [block cellCenterYBelowY:self.positionY];
+        if (downCenter > -FLT_MAX && self.positionY - downCenter < downDistance) {
             
-            // 距離が小さい場合は距離と移動先位置を更新する
-            if (self.positionY - block.positionY < downDistance) {
-                
-                downDistance = self.positionY - block.positionY;
-                downPosition = block.positionY + (block.height + self.image.contentSize.height) / 2;
-            }
+            downDistance = self.positionY - downCenter;
+            downPosition = downCenter + (block.cellHeight + self.imageSize.height) / 2;
         }
     }
     
     // 上方向の距離が小さい場合は上方向に移動して、逆さにする
     if (upDistance < downDistance) {
         self.positionY = upPosition;
+        isReverse_ = YES;
         self.image.flipY = YES;
     }
     // 下方向の距離が小さい場合は下方向に移動する
@@ -1846,19 +1878,19 @@ static const struct AKEnemyDef kAKEnemyDef[kAKEnemyDefCount] = {
     float left = current.x - size.width / 2.0f;
     
     // 左側の足元の障害物を取得する
-    AKCharacter *leftBlock = [AKEnemy getBlockAtFeetAtX:left
-                                                   from:top
-                                              isReverse:isReverse
-                                                 blocks:data.blocks];
+    AKBlock *leftBlock = (AKBlock *)[AKEnemy getBlockAtFeetAtX:left
+                                                          from:top
+                                                     isReverse:isReverse
+                                                     blockGrid:data.blockGrid];
     
     // 右端の座標を計算する
     float right = current.x+ size.width / 2.0f;
 
     // 左側の足元の障害物を取得する
-    AKCharacter *rightBlock = [AKEnemy getBlockAtFeetAtX:right
-                                                    from:top
-                                               isReverse:isReverse
-                                                  blocks:data.blocks];
+    AKBlock *rightBlock = (AKBlock *)[AKEnemy getBlockAtFeetAtX:right
+                                                           from:top
+                                                      isReverse:isReverse
+                                                      blockGrid:data.blockGrid];
     
     AKLog(kAKLogEnemy_2, @"left=(%.0f, %.0f, %d, %d) right=(%.0f, %.0f, %d, %d)",
           leftBlock.positionX, leftBlock.positionY, leftBlock.width, leftBlock.height,
@@ -1870,34 +1902,40 @@ static const struct AKEnemyDef kAKEnemyDef[kAKEnemyDefCount] = {
         return current;
     }
     
-    // 高さを合わせる障害物と移動先のx座標を決定する
-    AKCharacter *blockAtFeet = nil;
+    // 複数のタイルをまとめた障害物の場合は足元のタイルの中心と足を乗せる端を求める
+    // 逆向きでない場合は上端、逆向きの場合は下端を足を乗せる端とする
+    float leftCenterX = [leftBlock cellCenterXAtX:left];
+    float rightCenterX = [rightBlock cellCenterXAtX:right];
+    float leftEdge = (!isReverse ? [leftBlock cellTopAtFeetFrom:top] : [leftBlock cellBottomAtFeetFrom:top]);
+    float rightEdge = (!isReverse ? [rightBlock cellTopAtFeetFrom:top] : [rightBlock cellBottomAtFeetFrom:top]);
+    
+    // 高さを合わせる端と移動先のx座標を決定する
+    float edgeAtFeet = 0.0f;
     float newX = 0.0f;
 
     // 左側の障害物がない場合は自分の左端を右側の障害物の左端に合わせる
     if (leftBlock == nil) {
         AKLog(kAKLogEnemy_2, @"左側に障害物なし");
-        newX = rightBlock.positionX - rightBlock.width / 2.0f + size.width / 2.0f;
-        blockAtFeet = rightBlock;
+        newX = rightCenterX - rightBlock.cellWidth / 2.0f + size.width / 2.0f;
+        edgeAtFeet = rightEdge;
     }
     // 右側の障害物がない場合は自分の右端を左側の障害物の右端に合わせる
     else if (rightBlock == nil) {
         AKLog(kAKLogEnemy_2, @"右側に障害物なし");
-        newX = leftBlock.positionX + leftBlock.width / 2.0f - size.width / 2.0f;
-        blockAtFeet = leftBlock;
+        newX = leftCenterX + leftBlock.cellWidth / 2.0f - size.width / 2.0f;
+        edgeAtFeet = leftEdge;
     }
     // 左右の障害物の高さの差が1/2ブロック以上ある場合は進行方向と逆側の障害物に合わせる
-    else if ((!isReverse && (fabsf((leftBlock.positionY + leftBlock.height / 2.0f) - (rightBlock.positionY + rightBlock.height / 2.0f)) > kAKHalfBlockSize)) ||
-             (isReverse && (fabsf((leftBlock.positionY - leftBlock.height / 2.0f) - (rightBlock.positionY - rightBlock.height / 2.0f)) > kAKHalfBlockSize))) {
+    else if (fabsf(leftEdge - rightEdge) > kAKHalfBlockSize) {
         
         // 近い方のブロックに移動する
-        if  (rightBlock.positionX - current.x < current.x - leftBlock.positionX) {
-            newX = rightBlock.positionX - rightBlock.width / 2.0f + size.width / 2.0f;
-            blockAtFeet = rightBlock;
+        if  (rightCenterX - current.x < current.x - leftCenterX) {
+            newX = rightCenterX - rightBlock.cellWidth / 2.0f + size.width / 2.0f;
+            edgeAtFeet = rightEdge;
         }
         else {
-            newX = leftBlock.positionX + leftBlock.width / 2.0f - size.width / 2.0f;
-            blockAtFeet = leftBlock;
+            newX = leftCenterX + leftBlock.cellWidth / 2.0f - size.width / 2.0f;
+            edgeAtFeet = leftEdge;
         }
     }
     // その他の場合は足元に近い方の高さに合わせる
@@ -1905,21 +1943,11 @@ static const struct AKEnemyDef kAKEnemyDef[kAKEnemyDefCount] = {
         
         // 逆向きでない場合は上の方にあるものを採用する
         if (!isReverse) {
-            if (leftBlock.positionY + leftBlock.height / 2.0f > rightBlock.positionY + rightBlock.height / 2.0f) {
-                blockAtFeet = leftBlock;
-            }
-            else {
-                blockAtFeet = rightBlock;
-            }
+            edgeAtFeet = MAX(leftEdge, rightEdge);
         }
         // 逆向きの場合は下の方にあるものを採用する
         else {
-            if (leftBlock.positionY - leftBlock.height / 2.0f < rightBlock.positionY - rightBlock.height / 2.0f) {
-                blockAtFeet = leftBlock;
-            }
-            else {
-                blockAtFeet = rightBlock;
-            }
+            edgeAtFeet = MIN(leftEdge, rightEdge);
         }
         
         // x軸方向は移動しない
@@ -1931,11 +1959,11 @@ static const struct AKEnemyDef kAKEnemyDef[kAKEnemyDefCount] = {
     
     // 逆向きでない場合は自分の下端の位置を障害物の上端に合わせる
     if (!isReverse) {
-        newY = blockAtFeet.positionY + blockAtFeet.height / 2.0f + size.height / 2.0f;
+        newY = edgeAtFeet + size.height / 2.0f;
     }
     // 逆向きの場合は自分の上端の位置を障害物の下端に合わせる
     else {
-        newY = blockAtFeet.positionY - blockAtFeet.height / 2.0f - size.height / 2.0f;
+        newY = edgeAtFeet - size.height / 2.0f;
     }
     
     AKLog(kAKLogEnemy_2, @"(%.0f, %.0f)->(%.0f, %.0f)", current.x, current.y, newX, newY);
@@ -1953,14 +1981,22 @@ static const struct AKEnemyDef kAKEnemyDef[kAKEnemyDefCount] = {
  @param x x座標
  @param top 頭の位置
  @param isReverse 逆さまになっているかどうか
- @param blocks 障害物
+ @param blockGrid 障害物当たり判定グリッド
  @return 足元の障害物
  */
-+ (AKCharacter *)getBlockAtFeetAtX:(float)x from:(float)top isReverse:(BOOL)isReverse blocks:(NSArray *)blocks
-{    
++ (AKCharacter *)getBlockAtFeetAtX:(float)x from:(float)top isReverse:(BOOL)isReverse blockGrid:(AKCollisionGrid *)blockGrid
+{
+    // 指定したx座標の列のセルにある障害物を検索する
+    // 幅の範囲の判定は四捨五入した座標で行うため、検索範囲は前後に1ずつ広げる
+    NSInteger count = [blockGrid searchCellLeft:x - 1.0f right:x + 1.0f top:FLT_MAX bottom:-FLT_MAX];
+    
     // 足元の障害物を探す
+    // 複数のタイルをまとめた障害物は足元のタイルの端で比較する
     AKCharacter *blockAtFeet = nil;
-    for (AKCharacter *block in [blocks objectEnumerator]) {
+    float edgeAtFeet = 0.0f;
+    for (NSInteger i = 0; i < count; i++) {
+        
+        AKBlock *block = (AKBlock *)[blockGrid resultAtIndex:i];
         
         // 配置されていない障害物は除外する
         if (!block.isStaged) {
@@ -1976,10 +2012,13 @@ static const struct AKEnemyDef kAKEnemyDef[kAKEnemyDefCount] = {
                 
                 // 障害物の下端が自分の上端よりも下にあるものの内、
                 // 一番上にあるものを採用する
-                if (roundf(block.positionY - block.height / 2) <= roundf(top) &&
-                    (blockAtFeet == nil || block.positionY + block.height / 2 > blockAtFeet.positionY + blockAtFeet.height / 2)) {
+                if (roundf(block.positionY - block.height / 2) <= roundf(top)) {
                     
-                    blockAtFeet = block;
+                    float edge = [block cellTopAtFeetFrom:top];
+                    if (blockAtFeet == nil || edge > edgeAtFeet) {
+                        blockAtFeet = block;
+                        edgeAtFeet = edge;
+                    }
                 }
             }
             // 逆さまの場合
@@ -1987,10 +2026,13 @@ static const struct AKEnemyDef kAKEnemyDef[kAKEnemyDefCount] = {
                 
                 // 障害物の上端が自分の下端より上にあるものの内、
                 // 一番下にあるものを採用する
-                if (roundf(block.positionY + block.height / 2) > roundf(top) &&
-                    (blockAtFeet == nil || block.positionY - block.height / 2 < blockAtFeet.positionY - blockAtFeet.height / 2)) {
+                if (roundf(block.positionY + block.height / 2) > roundf(top)) {
                     
-                    blockAtFeet = block;
+                    float edge = [block cellBottomAtFeetFrom:top];
+                    if (blockAtFeet == nil || edge < edgeAtFeet) {
+                        blockAtFeet = block;
+                        edgeAtFeet = edge;
+                    }
                 }
             }
         }
@@ -1999,4 +2041,56 @@ static const struct AKEnemyDef kAKEnemyDef[kAKEnemyDefCount] = {
     return blockAtFeet;
 }
 
+/*!
+ @brief 状態の保存
+ 
+ キャラクター共通の状態に続けて、敵固有の状態を保存する。
+ 動作処理・破壊処理のセレクタは種別から求められるため、種別のみを保存する。
+ @param snapshot 保存先
+ */
+- (void)writeSnapshot:(AKSnapshot *)snapshot
+{
+    // スーパークラスの処理を行う
+    [super writeSnapshot:snapshot];
+    
+    struct AKEnemyState state = {type_, frame_, state_, {0}, score_, progress_, isReverse_};
+    memcpy(state.work, work_, sizeof(work_));
+    
+    [snapshot writeBytes:&state length:sizeof(state)];
+}
+
+/*!
+ @brief 状態の復元
+ 
+ キャラクター共通の状態に続けて、敵固有の状態を復元する。
+ 動作処理・破壊処理のセレクタは種別から設定し直す。
+ @param snapshot 読み込み元
+ */
+- (void)readSnapshot:(AKSnapshot *)snapshot
+{
+    // スーパークラスの処理を行う
+    [super readSnapshot:snapshot];
+    
+    struct AKEnemyState state;
+    [snapshot readBytes:&state length:sizeof(state)];
+    
+    NSAssert(state.type > 0 && state.type <= kAKEnemyDefCount, @"敵の種類の値が範囲外");
+    
+    // 各メンバを設定する
+    type_ = state.type;
+    frame_ = state.frame;
+    state_ = state.state;
+    memcpy(work_, state.work, sizeof(work_));
+    score_ = state.score;
+    progress_ = state.progress;
+    isReverse_ = state.isReverse;
+    
+    // 種別から動作処理と破壊処理を設定する
+    action_ = [self actionSelector:type_];
+    destroy_ = [self destroySeletor:kAKEnemyDef[type_ - 1].destroy];
+    
+    // 画像の逆さまの状態を合わせる
+    self.image.flipY = isReverse_;
+}
+
 @end
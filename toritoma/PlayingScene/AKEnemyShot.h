@@ -44,71 +44,34 @@ struct AKEnemyShotImageDef {
 
 /// 敵弾種別定義
 struct AKEnemyShotDef {
-    NSInteger action;       ///< 動作処理の種別
     NSInteger image;        ///< 画像ID
     NSInteger hitWidth;     ///< 当たり判定の幅
     NSInteger hitHeight;    ///< 当たり判定の高さ
     NSInteger grazePoint;   ///< かすりポイント
 };
 
-// 敵の発射する弾のクラス
-@interface AKEnemyShot : AKCharacter {
-    /// 動作開始からの経過フレーム数(各敵種別で使用)
-    NSInteger frame_;
-    /// 動作状態(各敵種別で使用)
-    NSInteger state_;
-    /// 動作処理のセレクタ
-    SEL action_;
-    /// かすりポイント
-    float grazePoint_;
-    /// 速度変更までの間隔
-    NSInteger changeInterval_;
-    /// 変更後のx軸方向の速度
-    float changeSpeedX_;
-    /// 変更後のy軸方向の速度
-    float changeSpeedY_;
-}
+/// 敵弾の種類
+enum AKEnemyShotType {
+    kAKEnemyShotTypeNormal = 0,     ///< 標準弾
+    kAKEnemyShotTypeDefCount        ///< 敵弾の種類の数
+};
 
-/// 動作処理のセレクタ
-@property (nonatomic)SEL action;
-/// かすりポイント
-@property (nonatomic)float grazePoint;
+// 敵の発射する弾のクラス
+// 敵弾は敵弾エンジンで管理するため、このクラスは反射弾として使用する。
+@interface AKEnemyShot : AKCharacter
 
-// 通常弾生成
-- (void)createNormalShotAtX:(NSInteger)x
-                          y:(NSInteger)y
-                      angle:(float)angle
-                      speed:(float)speed
-                     parent:(CCNode *)parent;
-// スクロール影響弾生成
-- (void)createScrollShotAtX:(NSInteger)x
-                          y:(NSInteger)y
-                      angle:(float)angle
-                      speed:(float)speed
-                     parent:(CCNode *)parent;
-// 速度変更弾生成
-- (void)createChangeSpeedShotAtX:(NSInteger)x
-                               y:(NSInteger)y
-                           angle:(float)angle
-                           speed:(float)speed
-                  changeInterval:(NSInteger)changeInterval
-                     changeAngle:(float)changeAngle
-                     changeSpeed:(float)changeSpeed
-                          parent:(CCNode *)parent;
-// 敵弾生成
-- (void)createEnemyShotType:(NSInteger)type
-                          x:(NSInteger)x
-                          y:(NSInteger)y
-                      angle:(float)angle
-                      speed:(float)speed
-                     parent:(CCNode *)parent;
+// 敵弾種別定義取得
++ (const struct AKEnemyShotDef *)definitionOfType:(NSInteger)type;
+// 敵弾画像定義取得
++ (const struct AKEnemyShotImageDef *)imageDefinitionOfType:(NSInteger)type;
+// 敵弾画像名取得
++ (NSString *)imageNameOfType:(NSInteger)type;
 // 反射弾生成
-- (void)createReflectedShot:(AKEnemyShot *)base parent:(CCNode *)parent;
-// 動作処理取得
-- (SEL)actionSelector:(NSInteger)type;
-// 動作処理なし
-- (void)actionNone:(id<AKPlayDataInterface>)data;
-// 速度変更
-- (void)actionChangeSpeed:(id<AKPlayDataInterface>)data;
+- (void)createReflectedShotType:(NSInteger)type
+                              x:(float)x
+                              y:(float)y
+                         speedX:(float)speedX
+                         speedY:(float)speedY
+                         parent:(CCNode *)parent;
 
 @end
@@ -35,13 +35,6 @@
 
 #import "AKEnemyShot.h"
 
-// 敵弾の種類
-enum AKEnemyShotType {
-    kAKEnemyShotTypeNormal = 0,     ///< 標準弾
-    kAKEnemyShotTypeChangeSpeed,    ///< 速度変更弾
-    kAKEnemyShotTypeDefCount        ///< 敵弾の種類の数
-};
-
 /// 画像名のフォーマット
 static NSString *kAKImageNameFormat = @"EnemyShot_%02d";
 /// 画像の種類の数
@@ -56,164 +49,108 @@ static const struct AKEnemyShotImageDef kAKEnemyShotImageDef[kAKEnemyShotImageDe
 
 /// 敵弾の定義
 static const struct AKEnemyShotDef kAKEnemyShotDef[kAKEnemyShotTypeDefCount] = {
-    {1, 1, 6, 6, 5},    // 標準弾
-    {2, 1, 6, 6, 5}     // 速度変更弾
+    {1, 6, 6, 5}    // 標準弾
 };
 
-@implementation AKEnemyShot
+/// 画像の種類ごとの画像名
+static NSString *imageNames_[kAKEnemyShotImageDefCount];
 
-@synthesize action = action_;
-@synthesize grazePoint = grazePoint_;
+@implementation AKEnemyShot
 
 /*!
- @brief キャラクター固有の動作
+ @brief クラス初期化処理
  
- 生成時に指定されたセレクタを呼び出す。
- @param dt フレーム更新間隔
- @param data ゲームデータ
+ 生成のたびに画像名の文字列を作成しないように、画像の種類ごとの画像名を最初に1回だけ作成しておく。
  */
-- (void)action:(id<AKPlayDataInterface>)data
++ (void)initialize
 {
-    // 動作開始からのフレーム数をカウントする
-    frame_++;
-
-    // 敵弾種別ごとの処理を実行
-    [self performSelector:action_ withObject:data];
+    if (self == [AKEnemyShot class]) {
+        for (NSInteger i = 0; i < kAKEnemyShotImageDefCount; i++) {
+            imageNames_[i] = [[NSString alloc] initWithFormat:kAKImageNameFormat, kAKEnemyShotImageDef[i].fileNo];
+        }
+    }
 }
 
 /*!
- @brief 通常弾生成
+ @brief 敵弾種別定義取得
  
- 通常弾を生成する。
- @param x 生成位置x座標
- @param y 生成位置y座標
- @param angle 進行方向
- @param speed スピード
- @param parent 配置する親ノード
+ 敵弾の種類から種別定義を取得する。
+ @param type 敵弾の種類
+ @return 敵弾種別定義
  */
-- (void)createNormalShotAtX:(NSInteger)x
-                          y:(NSInteger)y
-                      angle:(float)angle
-                      speed:(float)speed
-                     parent:(CCNode *)parent
++ (const struct AKEnemyShotDef *)definitionOfType:(NSInteger)type
 {
-    // 種別に通常弾を指定して生成を行う
-    [self createEnemyShotType:kAKEnemyShotTypeNormal
-                            x:x
-                            y:y
-                        angle:angle
-                        speed:speed
-                       parent:parent];
+    NSAssert(type >= 0 && type < kAKEnemyShotTypeDefCount, @"不正な種別");
+    return &kAKEnemyShotDef[type];
 }
 
 /*!
- @brief スクロール影響弾生成
+ @brief 敵弾画像定義取得
  
- スクリールスピードの影響を受ける弾を生成する。
- @param x 生成位置x座標
- @param y 生成位置y座標
- @param angle 進行方向
- @param speed スピード
- @param parent 配置する親ノード
+ 敵弾の種類から画像定義を取得する。
+ @param type 敵弾の種類
+ @return 敵弾画像定義
  */
-- (void)createScrollShotAtX:(NSInteger)x
-                          y:(NSInteger)y
-                      angle:(float)angle
-                      speed:(float)speed
-                     parent:(CCNode *)parent
++ (const struct AKEnemyShotImageDef *)imageDefinitionOfType:(NSInteger)type
 {
-    // 種別に通常弾を指定して生成を行う
-    [self createEnemyShotType:kAKEnemyShotTypeNormal
-                            x:x
-                            y:y
-                        angle:angle
-                        speed:speed
-                       parent:parent];
-    
-    // スクロールスピードの影響を設定する
-    self.scrollSpeed = 1.0f;
+    return &kAKEnemyShotImageDef[[AKEnemyShot definitionOfType:type]->image - 1];
 }
 
 /*!
- @brief 速度変更弾生成
-
- 途中で速度を変更する弾を生成する。
- @param x 生成位置x座標
- @param y 生成位置y座標
- @param angle 進行方向
- @param speed スピード
- @param parent 配置する親ノード
+ @brief 敵弾画像名取得
+ 
+ 敵弾の種類から画像名を取得する。
+ @param type 敵弾の種類
+ @return 画像名
  */
-- (void)createChangeSpeedShotAtX:(NSInteger)x
-                               y:(NSInteger)y
-                           angle:(float)angle
-                           speed:(float)speed
-                  changeInterval:(NSInteger)changeInterval
-                     changeAngle:(float)changeAngle
-                     changeSpeed:(float)changeSpeed
-                          parent:(CCNode *)parent
++ (NSString *)imageNameOfType:(NSInteger)type
 {
-    // 種別に速度変更弾を指定して生成を行う
-    [self createEnemyShotType:kAKEnemyShotTypeChangeSpeed
-                            x:x
-                            y:y
-                        angle:angle
-                        speed:speed
-                       parent:parent];
-    
-    // 速度変更までの間隔を設定する
-    changeInterval_ = changeInterval;
-    
-    // 変更後のスピードを設定する
-    changeSpeedX_ = cosf(changeAngle) * changeSpeed;
-    changeSpeedY_ = sinf(changeAngle) * changeSpeed;
+    // 画像定義の位置の画像名を返す
+    return imageNames_[[AKEnemyShot definitionOfType:type]->image - 1];
 }
 
 /*!
- @brief 敵弾生成
+ @brief 反射弾生成
  
- 敵の弾を生成する。
- @para, type 種別
+ 反射弾を生成する。
+ 敵弾エンジンで反射した弾の種類、位置、反転後の速度を受け取って生成する。
+ @param type 反射した弾の種類
  @param x 生成位置x座標
  @param y 生成位置y座標
- @param angle 進行方向
- @param speed スピード
+ @param speedX x方向の速度
+ @param speedY y方向の速度
  @param parent 配置する親ノード
  */
-- (void)createEnemyShotType:(NSInteger)type
-                          x:(NSInteger)x
-                          y:(NSInteger)y
-                      angle:(float)angle
-                      speed:(float)speed
-                     parent:(CCNode *)parent
+- (void)createReflectedShotType:(NSInteger)type
+                              x:(float)x
+                              y:(float)y
+                         speedX:(float)speedX
+                         speedY:(float)speedY
+                         parent:(CCNode *)parent
 {
-    // パラメータの内容をメンバに設定する
-    self.positionX = x;
-    self.positionY = y;
+    AKLog(kAKLogEnemyShot_1, @"反射弾生成");
     
-    // スピードをxとyに分割して設定する
-    self.speedX = cos(angle) * speed;
-    self.speedY = sin(angle) * speed;
+    // 種別定義を取得する
+    const struct AKEnemyShotDef *def = [AKEnemyShot definitionOfType:type];
     
-    AKLog(kAKLogEnemyShot_1, @"angle=%f speed=(%f, %f)", angle * 180 / M_PI, self.speedX, self.speedY);
+    // 画像定義を取得する
+    const struct AKEnemyShotImageDef *imageDef = [AKEnemyShot imageDefinitionOfType:type];
     
-    // 配置フラグを立てる
-    isStaged_ = YES;
-
-    // 動作フレーム数をクリアする
-    frame_ = 0;
+    // 位置を設定する
+    self.positionX = x;
+    self.positionY = y;
     
-    // 状態をクリアする
-    state_ = 0;
+    // スピードを設定する
+    self.speedX = speedX;
+    self.speedY = speedY;
     
-    // 動作処理を設定する
-    self.action = [self actionSelector:kAKEnemyShotDef[type].action];
+    AKLog(kAKLogEnemyShot_1, @"speed=(%f, %f)", self.speedX, self.speedY);
     
-    // 画像定義を取得する
-    const struct AKEnemyShotImageDef *imageDef = &kAKEnemyShotImageDef[kAKEnemyShotDef[type].image - 1];
+    // 配置フラグを立てる
+    self.isStaged = YES;
     
-    // 画像名を作成する
-    self.imageName = [NSString stringWithFormat:kAKImageNameFormat, imageDef->fileNo];
+    // 画像名を設定する
+    self.imageName = [AKEnemyShot imageNameOfType:type];
     
     // アニメーションフレームの個数を設定する
     self.animationPattern = imageDef->animationFrame;
@@ -222,135 +159,22 @@ static const struct AKEnemyShotDef kAKEnemyShotDef[kAKEnemyShotTypeDefCount] = {
     self.animationInterval = imageDef->animationInterval;
     
     // 当たり判定のサイズを設定する
-    self.width = kAKEnemyShotDef[type].hitWidth;
-    self.height = kAKEnemyShotDef[type].hitHeight;
+    self.width = def->hitWidth;
+    self.height = def->hitHeight;
     
     // ヒットポイントを設定する
     self.hitPoint = 1;
     
-    // かすりポイントを設定する
-    self.grazePoint = kAKEnemyShotDef[type].grazePoint;
+    // 攻撃力は反射弾の場合は補正をかける
+    self.power = kAKReflectionPower;
     
     // 障害物衝突時は消滅する
     self.blockHitAction = kAKBlockHitDisappear;
     
     // スクロールをなしにする
     self.scrollSpeed = 0.0f;
-
-    // レイヤーに配置する
-    [parent addChild:self.image];
-}
-
-/*!
- @brief 反射弾生成
- 
- 反射弾を生成する。
- 元になった弾と速度を反対にし、残りのパラメータは同じものを生成する。
- @param base 反射する弾
- @param parent 配置する親ノード
- */
-- (void)createReflectedShot:(AKEnemyShot *)base parent:(CCNode *)parent
-{
-    AKLog(kAKLogEnemyShot_1, @"反射弾生成");
-    
-    // 位置を設定する
-    self.positionX = base.positionX;
-    self.positionY = base.positionY;
-    
-    // スピード反転させて設定する
-    self.speedX = -base.speedX;
-    self.speedY = -base.speedY;
-    
-    // 配置フラグを立てる
-    isStaged_ = YES;
-    
-    // 動作フレーム数をクリアする
-    frame_ = 0;
-    
-    // 状態をクリアする
-    state_ = 0;
-    
-    // 動作処理をなしにする
-    self.action = @selector(actionNone:);
-    
-    // 画像名を作成する
-    self.imageName = base.imageName;
-    
-    // アニメーションフレームの個数を設定する
-    self.animationPattern = base.animationPattern;
-    
-    // アニメーションフレーム間隔を設定する
-    self.animationInterval = base.animationInterval;
-    
-    // 当たり判定のサイズを設定する
-    self.width = base.width;
-    self.height = base.height;
-    
-    // ヒットポイントを設定する
-    self.hitPoint = 1;
-    
-    // 攻撃力は反射弾の場合は補正をかける
-    self.power = kAKReflectionPower;
-    
-    // 障害物衝突時は消滅する
-    self.blockHitAction = kAKBlockHitDisappear;
     
     // レイヤーに配置する
     [parent addChild:self.image];
 }
-
-/*!
- @brief 動作処理取得
- 
- 種別番号から動作処理のセレクタを取得する。
- @param type 種別番号
- @return 動作処理のセレクタ
- */
-- (SEL)actionSelector:(NSInteger)type
-{
-    switch (type) {
-        case 1:
-            return @selector(actionNone:);
-            
-        case 2:
-            return @selector(actionChangeSpeed:);
-            
-        default:
-            NSAssert(NO, @"不正な種別");
-            return @selector(actionNone:);
-    }
-}
-
-/*!
- @brief 動作処理なし
- 
- スピード一定のまま進めるため、無処理。
- @param data ゲームデータ
- */
-- (void)actionNone:(id<AKPlayDataInterface>)data
-{
-    
-}
-
-/*!
- @brief 速度変更
- 
- 途中で速度を変更する。
- @param data ゲームデータ
- */
-- (void)actionChangeSpeed:(id<AKPlayDataInterface>)data
-{
-    AKLog(kAKLogEnemyShot_2, @"frame=%d changeInterval=%d", frame_, changeInterval_);
-    
-    // 速度変更までの間隔が経過している場合は速度を変更する
-    if (frame_ >= changeInterval_) {
-        
-        AKLog(kAKLogEnemyShot_1, @"speed=(%f, %f)", self.speedX, self.speedY);
-        
-        self.speedX = changeSpeedX_;
-        self.speedY = changeSpeedY_;
-
-        AKLog(kAKLogEnemyShot_1, @"speed=(%f, %f)", self.speedX, self.speedY);
-    }
-}
 @end
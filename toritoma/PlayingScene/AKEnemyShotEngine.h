@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2013 Akihiro Kaneda.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1.Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   2.Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   3.Neither the name of the Monochrome Soft nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ @file AKEnemyShotEngine.h
+ @brief 敵弾エンジンクラス定義
+ 
+ 敵弾の状態を配列で一括管理するクラスを定義する。
+ */
+
+#import "AKToritoma.h"
+#import "AKPlayDataInterface.h"
+#import "AKNWayAngle.h"
+
+@class AKCharacter;
+@class AKCollisionGrid;
+@class AKSnapshot;
+
+/// 敵弾の動作種別
+enum AKEnemyShotMotion {
+    kAKEnemyShotMotionNormal = 0,   ///< 等速移動
+    kAKEnemyShotMotionChangeSpeed,  ///< 速度変更
+    kAKEnemyShotMotionAccel,        ///< 加速度
+    kAKEnemyShotMotionAngular       ///< 角速度
+};
+
+// 敵弾エンジンクラス
+@interface AKEnemyShotEngine : NSObject {
+    /// 管理可能な弾の数
+    NSInteger capacity_;
+    /// 配置している弾の数
+    NSInteger count_;
+    /// 予約済みで未使用の弾の数
+    NSInteger reservedCount_;
+    /// 弾の種類
+    NSInteger *type_;
+    /// 動作種別
+    NSInteger *motion_;
+    /// 位置x座標
+    float *positionX_;
+    /// 位置y座標
+    float *positionY_;
+    /// 移動前の位置x座標
+    float *prevPositionX_;
+    /// 移動前の位置y座標
+    float *prevPositionY_;
+    /// 速度x方向
+    float *speedX_;
+    /// 速度y方向
+    float *speedY_;
+    /// 加速度x方向
+    float *accelX_;
+    /// 加速度y方向
+    float *accelY_;
+    /// 1フレームあたりの回転量の余弦
+    float *rotateCos_;
+    /// 1フレームあたりの回転量の正弦
+    float *rotateSin_;
+    /// スクロール速度の影響を受ける割合
+    float *scrollSpeed_;
+    /// 当たり判定サイズ幅の半分
+    float *halfWidth_;
+    /// 当たり判定サイズ高さの半分
+    float *halfHeight_;
+    /// かすりポイント
+    float *grazePoint_;
+    /// HP
+    NSInteger *hitPoint_;
+    /// 攻撃力
+    NSInteger *power_;
+    /// 生成からの経過フレーム数
+    NSInteger *frame_;
+    /// 速度変更までの間隔(速度変更しない場合は0)
+    NSInteger *changeInterval_;
+    /// 変更後のx軸方向の速度
+    float *changeSpeedX_;
+    /// 変更後のy軸方向の速度
+    float *changeSpeedY_;
+    /// 削除対象かどうか
+    BOOL *isRemoved_;
+    /// 弾の画像(配列の位置ごとに1個ずつ割り当てる)
+    CCSprite **sprites_;
+    /// 画像に表示している表示フレーム(弱い参照)
+    CCSpriteFrame **spriteFrame_;
+    /// 作成済みの画像の数
+    NSInteger spriteCount_;
+    /// 表示中の画像の数
+    NSInteger visibleCount_;
+    /// 表示フレーム(弾の種類ごとにアニメーションパターン順に並べる)
+    CCSpriteFrame **frames_;
+    /// 表示フレームの数
+    NSInteger frameCount_;
+    /// 弾の種類ごとの表示フレームの先頭位置
+    NSInteger *frameOffset_;
+    /// 弾の種類ごとのアニメーションパターン数
+    NSInteger *patternCount_;
+    /// 弾の種類ごとのアニメーション間隔
+    NSInteger *animationInterval_;
+    /// 画像を配置する親ノード(弱い参照)
+    CCNode *parent_;
+    /// 検索結果のインデックス
+    NSInteger *results_;
+    /// 検索結果の件数
+    NSInteger resultCount_;
+    /// 当たり判定を行った弾の数
+    NSUInteger hitTestCount_;
+}
+
+/// 管理可能な弾の数
+@property (nonatomic, readonly)NSInteger capacity;
+/// 配置している弾の数
+@property (nonatomic, readonly)NSInteger count;
+/// 当たり判定を行った弾の数
+@property (nonatomic, readonly)NSUInteger hitTestCount;
+
+// オブジェクト生成処理
+- (id)initWithCapacity:(NSInteger)capacity parent:(CCNode *)parent;
+// 弾の一括予約
+- (NSRange)reserveShots:(NSInteger)count;
+// 通常弾生成
+- (NSInteger)createNormalShotAtX:(float)x
+                               y:(float)y
+                       direction:(struct AKNWayDirection)direction
+                           speed:(float)speed;
+// スクロール影響弾生成
+- (NSInteger)createScrollShotAtX:(float)x
+                               y:(float)y
+                       direction:(struct AKNWayDirection)direction
+                           speed:(float)speed;
+// 速度変更弾生成
+- (NSInteger)createChangeSpeedShotAtX:(float)x
+                                    y:(float)y
+                            direction:(struct AKNWayDirection)direction
+                                speed:(float)speed
+                       changeInterval:(NSInteger)changeInterval
+                      changeDirection:(struct AKNWayDirection)changeDirection
+                          changeSpeed:(float)changeSpeed;
+// 加速弾生成
+- (NSInteger)createAccelShotAtX:(float)x
+                              y:(float)y
+                      direction:(struct AKNWayDirection)direction
+                          speed:(float)speed
+                          accel:(float)accel;
+// 回転弾生成
+- (NSInteger)createAngularShotAtX:(float)x
+                                y:(float)y
+                        direction:(struct AKNWayDirection)direction
+                            speed:(float)speed
+                     angularSpeed:(float)angularSpeed;
+// 移動処理
+- (void)move:(id<AKPlayDataInterface>)data;
+// 移動処理(パラメータ指定)
+- (void)moveWithScrollSpeedX:(float)scrollSpeedX
+                scrollSpeedY:(float)scrollSpeedY
+                   blockGrid:(AKCollisionGrid *)blockGrid;
+// 画像更新
+- (void)updateSpritesWithAlpha:(float)alpha;
+// 画像のアニメーション停止
+- (void)pauseSprites;
+// 画像のアニメーション再開
+- (void)resumeSprites;
+// 衝突している弾の検索
+- (NSInteger)searchHitLeft:(float)left right:(float)right top:(float)top bottom:(float)bottom;
+// 検索結果の弾のインデックス取得
+- (NSInteger)resultAtIndex:(NSInteger)index;
+// かすり判定
+- (float)grazeLeft:(float)left right:(float)right top:(float)top bottom:(float)bottom;
+// キャラクター衝突判定
+- (void)checkHitWithCharacter:(AKCharacter *)character;
+// 反射判定
+- (void)reflectWithCharacter:(AKCharacter *)character data:(id<AKPlayDataInterface>)data;
+// 全弾削除
+- (void)removeAllShots;
+// 統計情報のリセット
+- (void)resetStatistics;
+// 弾の種類取得
+- (NSInteger)typeAtIndex:(NSInteger)index;
+// 動作種別取得
+- (enum AKEnemyShotMotion)motionAtIndex:(NSInteger)index;
+// 位置取得
+- (CGPoint)positionAtIndex:(NSInteger)index;
+// 速度取得
+- (CGPoint)speedAtIndex:(NSInteger)index;
+// HP取得
+- (NSInteger)hitPointAtIndex:(NSInteger)index;
+// 状態の保存
+- (void)writeSnapshot:(AKSnapshot *)snapshot;
+// 状態の復元
+- (void)readSnapshot:(AKSnapshot *)snapshot;
+@end
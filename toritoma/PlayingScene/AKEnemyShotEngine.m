@@ -0,0 +1,1209 @@
+/*
+ * Copyright (c) 2013 Akihiro Kaneda.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1.Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   2.Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   3.Neither the name of the Monochrome Soft nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ @file AKEnemyShotEngine.m
+ @brief 敵弾エンジンクラス定義
+ 
+ 敵弾の状態を配列で一括管理するクラスを定義する。
+ */
+
+#import "AKEnemyShotEngine.h"
+#import "AKEnemyShot.h"
+#import "AKCharacter.h"
+#import "AKCollisionGrid.h"
+#import "AKSnapshot.h"
+
+/// 表示範囲外で弾を残す範囲
+static const float kAKBorder = 50.0f;
+/// 状態保存で保存する項目ごとの配列の数
+#define kAKShotStateArrayCount 23
+
+/*!
+ @brief 敵弾エンジンクラス
+ 
+ 敵弾の位置、速度、当たり判定などを弾ごとのオブジェクトではなく項目ごとの配列で管理する。
+ 配置中の弾は配列の先頭から詰めて格納し、移動・画面外判定・速度変更は配列を先頭から順に処理する。
+ 画像は配列の位置ごとに1個ずつ割り当て、弾を削除した時は末尾の弾を空いた位置へ移動する。
+ */
+// プライベートメソッド宣言
+@interface AKEnemyShotEngine ()
+// 弾生成
+- (NSInteger)createShotType:(NSInteger)type
+                     motion:(enum AKEnemyShotMotion)motion
+                          x:(float)x
+                          y:(float)y
+                  direction:(struct AKNWayDirection)direction
+                      speed:(float)speed;
+// 削除対象の判定
+- (void)markRemovedShotsWithScrollSpeedX:(float)scrollSpeedX scrollSpeedY:(float)scrollSpeedY;
+// 削除対象の弾の除去
+- (void)compactShots;
+// 弾の配列内の移動
+- (void)moveShotFrom:(NSInteger)src to:(NSInteger)dest;
+// 位置・速度の更新
+- (void)integrateWithScrollSpeedX:(float)scrollSpeedX scrollSpeedY:(float)scrollSpeedY;
+// 速度変更
+- (void)changeSpeed;
+// 障害物との衝突判定
+- (void)checkBlockHit:(AKCollisionGrid *)blockGrid;
+// 表示フレームの取得
+- (void)loadFrames;
+// 画像の作成
+- (void)createSpritesTo:(NSInteger)end;
+// 画像の表示数更新
+- (void)updateVisibleCount;
+// 状態保存で保存する配列の取得
+- (void)getStateArrays:(void **)arrays elementSizes:(size_t *)sizes;
+@end
+
+@implementation AKEnemyShotEngine
+
+@synthesize capacity = capacity_;
+@synthesize count = count_;
+@synthesize hitTestCount = hitTestCount_;
+
+/*!
+ @brief オブジェクト生成処理
+ 
+ オブジェクトの生成を行う。
+ 親ノードにnilを指定した場合は画像の作成を行わない。
+ @param capacity 管理可能な弾の数
+ @param parent 画像を配置する親ノード
+ @return 生成したオブジェクト。失敗時はnilを返す。
+ */
+- (id)initWithCapacity:(NSInteger)capacity parent:(CCNode *)parent
+{
+    AKLog(kAKLogEnemyShotEngine_1, @"start capacity=%d", capacity);
+    
+    // スーパークラスの生成処理
+    self = [super init];
+    if (!self) {
+        AKLog(kAKLogEnemyShotEngine_0, @"error");
+        return nil;
+    }
+    
+    // 弾の情報のバッファを確保する
+    capacity_ = capacity;
+    count_ = 0;
+    reservedCount_ = 0;
+    type_ = malloc(sizeof(NSInteger) * capacity_);
+    motion_ = malloc(sizeof(NSInteger) * capacity_);
+    positionX_ = malloc(sizeof(float) * capacity_);
+    positionY_ = malloc(sizeof(float) * capacity_);
+    prevPositionX_ = malloc(sizeof(float) * capacity_);
+    prevPositionY_ = malloc(sizeof(float) * capacity_);
+    speedX_ = malloc(sizeof(float) * capacity_);
+    speedY_ = malloc(sizeof(float) * capacity_);
+    accelX_ = malloc(sizeof(float) * capacity_);
+    accelY_ = malloc(sizeof(float) * capacity_);
+    rotateCos_ = malloc(sizeof(float) * capacity_);
+    rotateSin_ = malloc(sizeof(float) * capacity_);
+    scrollSpeed_ = malloc(sizeof(float) * capacity_);
+    halfWidth_ = malloc(sizeof(float) * capacity_);
+    halfHeight_ = malloc(sizeof(float) * capacity_);
+    grazePoint_ = malloc(sizeof(float) * capacity_);
+    hitPoint_ = malloc(sizeof(NSInteger) * capacity_);
+    power_ = malloc(sizeof(NSInteger) * capacity_);
+    frame_ = malloc(sizeof(NSInteger) * capacity_);
+    changeInterval_ = malloc(sizeof(NSInteger) * capacity_);
+    changeSpeedX_ = malloc(sizeof(float) * capacity_);
+    changeSpeedY_ = malloc(sizeof(float) * capacity_);
+    isRemoved_ = malloc(sizeof(BOOL) * capacity_);
+    results_ = malloc(sizeof(NSInteger) * capacity_);
+    
+    // 画像のバッファを確保する
+    // 画像は配置数が増えた時に作成する
+    sprites_ = calloc(capacity_, sizeof(CCSprite *));
+    spriteFrame_ = calloc(capacity_, sizeof(CCSpriteFrame *));
+    spriteCount_ = 0;
+    visibleCount_ = 0;
+    parent_ = parent;
+    
+    // 弾の種類ごとの表示フレームを取得する
+    frames_ = NULL;
+    frameCount_ = 0;
+    frameOffset_ = malloc(sizeof(NSInteger) * kAKEnemyShotTypeDefCount);
+    patternCount_ = malloc(sizeof(NSInteger) * kAKEnemyShotTypeDefCount);
+    animationInterval_ = malloc(sizeof(NSInteger) * kAKEnemyShotTypeDefCount);
+    [self loadFrames];
+    
+    // その他のメンバを初期化する
+    resultCount_ = 0;
+    hitTestCount_ = 0;
+    
+    AKLog(kAKLogEnemyShotEngine_1, @"end");
+    return self;
+}
+
+/*!
+ @brief インスタンス解放時処理
+ 
+ インスタンス解放時にオブジェクトを解放する。
+ */
+- (void)dealloc
+{
+    // 画像を解放する
+    for (NSInteger i = 0; i < spriteCount_; i++) {
+        [sprites_[i] removeFromParentAndCleanup:YES];
+        [sprites_[i] release];
+    }
+    for (NSInteger i = 0; i < frameCount_; i++) {
+        [frames_[i] release];
+    }
+    
+    // バッファを解放する
+    free(type_);
+    free(motion_);
+    free(positionX_);
+    free(positionY_);
+    free(prevPositionX_);
+    free(prevPositionY_);
+    free(speedX_);
+    free(speedY_);
+    free(accelX_);
+    free(accelY_);
+    free(rotateCos_);
+    free(rotateSin_);
+    free(scrollSpeed_);
+    free(halfWidth_);
+    free(halfHeight_);
+    free(grazePoint_);
+    free(hitPoint_);
+    free(power_);
+    free(frame_);
+    free(changeInterval_);
+    free(changeSpeedX_);
+    free(changeSpeedY_);
+    free(isRemoved_);
+    free(results_);
+    free(sprites_);
+    free(spriteFrame_);
+    free(frames_);
+    free(frameOffset_);
+    free(patternCount_);
+    free(animationInterval_);
+    
+    // スーパークラスの解放処理
+    [super dealloc];
+}
+
+/*!
+ @brief 表示フレームの取得
+ 
+ 弾の種類ごとにアニメーションパターン数とアニメーション間隔を画像定義から取得し、
+ 各パターンの表示フレームを1つの配列に並べて保持する。
+ 画像更新のたびに画像名から検索しないように最初に取得しておく。
+ 親ノードがない場合は表示フレームを取得しない。
+ */
+- (void)loadFrames
+{
+    // 弾の種類ごとのパターン数と間隔を取得し、表示フレームの先頭位置を決める
+    // 間隔は0の場合に除算できないため、最低1とする
+    frameCount_ = 0;
+    for (NSInteger i = 0; i < kAKEnemyShotTypeDefCount; i++) {
+        const struct AKEnemyShotImageDef *imageDef = [AKEnemyShot imageDefinitionOfType:i];
+        frameOffset_[i] = frameCount_;
+        patternCount_[i] = MAX(imageDef->animationFrame, 1);
+        animationInterval_[i] = MAX((NSInteger)imageDef->animationInterval, 1);
+        frameCount_ += patternCount_[i];
+    }
+    
+    // 表示フレームの配列を確保する
+    frames_ = calloc(frameCount_, sizeof(CCSpriteFrame *));
+    
+    // 親ノードがない場合は表示フレームを使用しない
+    if (parent_ == nil) {
+        return;
+    }
+    
+    for (NSInteger i = 0; i < kAKEnemyShotTypeDefCount; i++) {
+        
+        // 画像名に対応する表示フレームの配列を取得する
+        NSArray *spriteFrames = [AKCharacter spriteFramesOfImageName:[AKEnemyShot imageNameOfType:i]];
+        
+        for (NSInteger j = 0; j < patternCount_[i]; j++) {
+            
+            // パターンの画像が存在しない場合は1パターン目で代用する
+            id frame = (j < (NSInteger)spriteFrames.count ? [spriteFrames objectAtIndex:j] : [NSNull null]);
+            if (frame == [NSNull null]) {
+                AKLog(kAKLogEnemyShotEngine_0, @"画像が存在しない:type=%d pattern=%d", i, j + 1);
+                NSAssert(NO, @"パターン番号の画像が存在しない");
+                frame = [spriteFrames objectAtIndex:0];
+            }
+            
+            frames_[frameOffset_[i] + j] = [frame retain];
+        }
+    }
+}
+
+/*!
+ @brief 弾の一括予約
+ 
+ n-way弾などで一度に発射する弾の数だけ配列の空きを予約する。
+ 空きが足りない場合は一部だけを発射すると弾の並びが崩れるため、全体を予約失敗とする。
+ 予約に成功した場合、以降の弾生成は予約した範囲に先頭から順に格納し、空きの判定は行わない。
+ 予約した範囲の画像はここでまとめて作成する。
+ @param count 予約する弾の数
+ @return 予約した範囲。予約に失敗した場合は長さ0の範囲を返す。
+ */
+- (NSRange)reserveShots:(NSInteger)count
+{
+    // 空きが足りない場合は予約しない
+    if (count <= 0 || count_ + count > capacity_) {
+        AKLog(kAKLogEnemyShotEngine_1, @"敵弾の空き不足:count=%d free=%d", count, capacity_ - count_);
+        reservedCount_ = 0;
+        return NSMakeRange(count_, 0);
+    }
+    
+    // 予約数を設定する
+    reservedCount_ = count;
+    
+    // 予約した範囲の画像を作成する
+    [self createSpritesTo:count_ + count];
+    
+    return NSMakeRange(count_, count);
+}
+
+/*!
+ @brief 通常弾生成
+ 
+ 等速で移動する弾を生成する。
+ @param x 生成位置x座標
+ @param y 生成位置y座標
+ @param direction 進行方向
+ @param speed スピード
+ @return 生成した弾のインデックス。空きがない場合は-1を返す。
+ */
+- (NSInteger)createNormalShotAtX:(float)x
+                               y:(float)y
+                       direction:(struct AKNWayDirection)direction
+                           speed:(float)speed
+{
+    return [self createShotType:kAKEnemyShotTypeNormal
+                         motion:kAKEnemyShotMotionNormal
+                              x:x
+                              y:y
+                      direction:direction
+                          speed:speed];
+}
+
+/*!
+ @brief スクロール影響弾生成
+ 
+ スクロールスピードの影響を受ける弾を生成する。
+ @param x 生成位置x座標
+ @param y 生成位置y座標
+ @param direction 進行方向
+ @param speed スピード
+ @return 生成した弾のインデックス。空きがない場合は-1を返す。
+ */
+- (NSInteger)createScrollShotAtX:(float)x
+                               y:(float)y
+                       direction:(struct AKNWayDirection)direction
+                           speed:(float)speed
+{
+    // 種別に通常弾を指定して生成を行う
+    NSInteger index = [self createShotType:kAKEnemyShotTypeNormal
+                                    motion:kAKEnemyShotMotionNormal
+                                         x:x
+                                         y:y
+                                 direction:direction
+                                     speed:speed];
+    
+    // スクロールスピードの影響を設定する
+    if (index >= 0) {
+        scrollSpeed_[index] = 1.0f;
+    }
+    
+    return index;
+}
+
+/*!
+ @brief 速度変更弾生成
+ 
+ 途中で速度を変更する弾を生成する。
+ @param x 生成位置x座標
+ @param y 生成位置y座標
+ @param direction 進行方向
+ @param speed スピード
+ @param changeInterval 速度変更までの間隔
+ @param changeDirection 変更後の進行方向
+ @param changeSpeed 変更後のスピード
+ @return 生成した弾のインデックス。空きがない場合は-1を返す。
+ */
+- (NSInteger)createChangeSpeedShotAtX:(float)x
+                                    y:(float)y
+                            direction:(struct AKNWayDirection)direction
+                                speed:(float)speed
+                       changeInterval:(NSInteger)changeInterval
+                      changeDirection:(struct AKNWayDirection)changeDirection
+                          changeSpeed:(float)changeSpeed
+{
+    // 種別に速度変更弾を指定して生成を行う
+    NSInteger index = [self createShotType:kAKEnemyShotTypeNormal
+                                    motion:kAKEnemyShotMotionChangeSpeed
+                                         x:x
+                                         y:y
+                                 direction:direction
+                                     speed:speed];
+    
+    if (index >= 0) {
+        
+        // 速度変更までの間隔を設定する
+        // 経過フレーム数は最初の移動後に1となるため、それより前に変更することはできない
+        changeInterval_[index] = MAX(changeInterval, 1);
+        
+        // 変更後のスピードを設定する
+        changeSpeedX_[index] = changeDirection.cos * changeSpeed;
+        changeSpeedY_[index] = changeDirection.sin * changeSpeed;
+    }
+    
+    return index;
+}
+
+/*!
+ @brief 加速弾生成
+ 
+ 進行方向に一定の加速度で加速する弾を生成する。
+ 加速度に負の値を指定した場合は減速し、速度が0を下回ると反対方向へ進む。
+ @param x 生成位置x座標
+ @param y 生成位置y座標
+ @param direction 進行方向
+ @param speed 初速
+ @param accel 1フレームあたりの加速度
+ @return 生成した弾のインデックス。空きがない場合は-1を返す。
+ */
+- (NSInteger)createAccelShotAtX:(float)x
+                              y:(float)y
+                      direction:(struct AKNWayDirection)direction
+                          speed:(float)speed
+                          accel:(float)accel
+{
+    // 種別に加速弾を指定して生成を行う
+    NSInteger index = [self createShotType:kAKEnemyShotTypeNormal
+                                    motion:kAKEnemyShotMotionAccel
+                                         x:x
+                                         y:y
+                                 direction:direction
+                                     speed:speed];
+    
+    // 加速度をxとyに分割して設定する
+    if (index >= 0) {
+        accelX_[index] = direction.cos * accel;
+        accelY_[index] = direction.sin * accel;
+    }
+    
+    return index;
+}
+
+/*!
+ @brief 回転弾生成
+ 
+ 一定の角速度で進行方向を変えながら進む弾を生成する。
+ @param x 生成位置x座標
+ @param y 生成位置y座標
+ @param direction 初期の進行方向
+ @param speed スピード
+ @param angularSpeed 1フレームあたりの進行方向の変化量(正の値で反時計回り)
+ @return 生成した弾のインデックス。空きがない場合は-1を返す。
+ */
+- (NSInteger)createAngularShotAtX:(float)x
+                                y:(float)y
+                        direction:(struct AKNWayDirection)direction
+                            speed:(float)speed
+                     angularSpeed:(float)angularSpeed
+{
+    // 種別に回転弾を指定して生成を行う
+    NSInteger index = [self createShotType:kAKEnemyShotTypeNormal
+                                    motion:kAKEnemyShotMotionAngular
+                                         x:x
+                                         y:y
+                                 direction:direction
+                                     speed:speed];
+    
+    // 1フレームあたりの回転量を設定する
+    // 移動のたびに三角関数を計算しないように余弦と正弦を保持しておく
+    if (index >= 0) {
+        rotateCos_[index] = cosf(angularSpeed);
+        rotateSin_[index] = sinf(angularSpeed);
+    }
+    
+    return index;
+}
+
+/*!
+ @brief 弾生成
+ 
+ 配列の末尾に弾を追加する。
+ @param type 弾の種類
+ @param motion 動作種別
+ @param x 生成位置x座標
+ @param y 生成位置y座標
+ @param direction 進行方向
+ @param speed スピード
+ @return 生成した弾のインデックス。空きがない場合は-1を返す。
+ */
+- (NSInteger)createShotType:(NSInteger)type
+                     motion:(enum AKEnemyShotMotion)motion
+                          x:(float)x
+                          y:(float)y
+                  direction:(struct AKNWayDirection)direction
+                      speed:(float)speed
+{
+    // 予約済みの場合は予約数を減らす
+    if (reservedCount_ > 0) {
+        reservedCount_--;
+    }
+    // 予約なしで空きがない場合はエラーとする
+    else if (count_ >= capacity_) {
+        AKLog(kAKLogEnemyShotEngine_0, @"敵弾に空きなし");
+        NSAssert(NO, @"敵弾に空きなし");
+        return -1;
+    }
+    
+    // 弾の種別定義を取得する
+    const struct AKEnemyShotDef *def = [AKEnemyShot definitionOfType:type];
+    
+    // 末尾に追加する
+    NSInteger index = count_;
+    count_++;
+    
+    // 種類を設定する
+    type_[index] = type;
+    motion_[index] = motion;
+    
+    // 位置を設定する
+    // 移動前の位置も同じ位置とし、表示位置の補間で移動して見えないようにする
+    positionX_[index] = x;
+    positionY_[index] = y;
+    prevPositionX_[index] = x;
+    prevPositionY_[index] = y;
+    
+    // スピードをxとyに分割して設定する
+    // 角度の三角関数は方向の計算時に求めてあるため、ここでは計算しない
+    speedX_[index] = direction.cos * speed;
+    speedY_[index] = direction.sin * speed;
+    
+    AKLog(kAKLogEnemyShotEngine_2, @"angle=%f speed=(%f, %f)", direction.angle * 180 / M_PI, speedX_[index], speedY_[index]);
+    
+    // 加速・回転はなしにする
+    // 移動処理ではすべての弾に同じ計算を行うため、変化しない値を設定しておく
+    accelX_[index] = 0.0f;
+    accelY_[index] = 0.0f;
+    rotateCos_[index] = 1.0f;
+    rotateSin_[index] = 0.0f;
+    
+    // スクロールをなしにする
+    scrollSpeed_[index] = 0.0f;
+    
+    // 当たり判定のサイズを設定する
+    halfWidth_[index] = def->hitWidth / 2.0f;
+    halfHeight_[index] = def->hitHeight / 2.0f;
+    
+    // かすりポイントを設定する
+    grazePoint_[index] = def->grazePoint;
+    
+    // ヒットポイント、攻撃力を設定する
+    hitPoint_[index] = 1;
+    power_[index] = 1;
+    
+    // 動作フレーム数をクリアする
+    frame_[index] = 0;
+    
+    // 速度変更はなしにする
+    changeInterval_[index] = 0;
+    changeSpeedX_[index] = 0.0f;
+    changeSpeedY_[index] = 0.0f;
+    
+    // 削除フラグをクリアする
+    isRemoved_[index] = NO;
+    
+    return index;
+}
+
+/*!
+ @brief 移動処理
+ 
+ ゲームデータからスクロールスピードと障害物を取得し、全弾の移動処理を行う。
+ @param data ゲームデータ
+ */
+- (void)move:(id<AKPlayDataInterface>)data
+{
+    [self moveWithScrollSpeedX:data.scrollSpeedX
+                  scrollSpeedY:data.scrollSpeedY
+                     blockGrid:data.blockGrid];
+}
+
+/*!
+ @brief 移動処理(パラメータ指定)
+ 
+ 全弾の移動処理を行う。
+ HPが0になった弾と画面外に出た弾を取り除いた後、位置と速度を更新し、障害物との衝突判定を行う。
+ 処理の順番はキャラクタークラスの移動処理と同じにする。
+ @param scrollSpeedX x軸方向のスクロールスピード
+ @param scrollSpeedY y軸方向のスクロールスピード
+ @param blockGrid 障害物当たり判定グリッド
+ */
+- (void)moveWithScrollSpeedX:(float)scrollSpeedX
+                scrollSpeedY:(float)scrollSpeedY
+                   blockGrid:(AKCollisionGrid *)blockGrid
+{
+    // 使われなかった予約を取り消す
+    reservedCount_ = 0;
+    
+    // HPが0になった弾と画面外に出た弾を取り除く
+    [self markRemovedShotsWithScrollSpeedX:scrollSpeedX scrollSpeedY:scrollSpeedY];
+    [self compactShots];
+    
+    // 位置と速度を更新する
+    [self integrateWithScrollSpeedX:scrollSpeedX scrollSpeedY:scrollSpeedY];
+    
+    // 速度変更までの間隔が経過した弾の速度を変更する
+    [self changeSpeed];
+    
+    // 障害物と衝突した弾のHPを0にする
+    [self checkBlockHit:blockGrid];
+    
+    AKLog(kAKLogEnemyShotEngine_2, @"count=%d", count_);
+}
+
+/*!
+ @brief 削除対象の判定
+ 
+ HPが0以下の弾と画面外に出た弾に削除フラグを立てる。
+ 画面外判定はキャラクタークラスと同じく、座標が範囲外で外側に向かって移動している場合に範囲外とみなす。
+ 分岐をなくすため、条件は論理演算ではなくビット演算で結合する。
+ @param scrollSpeedX x軸方向のスクロールスピード
+ @param scrollSpeedY y軸方向のスクロールスピード
+ */
+- (void)markRemovedShotsWithScrollSpeedX:(float)scrollSpeedX scrollSpeedY:(float)scrollSpeedY
+{
+    // 範囲の右端と上端を計算する
+    const float right = kAKStageSize.width + kAKBorder;
+    const float top = kAKStageSize.height + kAKBorder;
+    
+    for (NSInteger i = 0; i < count_; i++) {
+        
+        // スクロールを含めた移動量を計算する
+        float moveX = speedX_[i] - scrollSpeedX * scrollSpeed_[i];
+        float moveY = speedY_[i] - scrollSpeedY * scrollSpeed_[i];
+        
+        isRemoved_[i] = (BOOL)((hitPoint_[i] <= 0) |
+                               ((positionX_[i] < -kAKBorder) & (moveX < 0.0f)) |
+                               ((positionX_[i] > right) & (moveX > 0.0f)) |
+                               ((positionY_[i] < -kAKBorder) & (moveY < 0.0f)) |
+                               ((positionY_[i] > top) & (moveY > 0.0f)));
+    }
+}
+
+/*!
+ @brief 削除対象の弾の除去
+ 
+ 削除フラグの立っている弾の位置へ末尾の弾を移動し、配置中の弾を配列の先頭に詰める。
+ */
+- (void)compactShots
+{
+    NSInteger i = 0;
+    while (i < count_) {
+        
+        // 削除対象の場合は末尾の弾を移動する
+        // 移動してきた弾も削除対象の可能性があるため、同じ位置をもう一度判定する
+        if (isRemoved_[i]) {
+            count_--;
+            [self moveShotFrom:count_ to:i];
+        }
+        else {
+            i++;
+        }
+    }
+}
+
+/*!
+ @brief 弾の配列内の移動
+ 
+ 弾の情報を配列内の別の位置へコピーする。
+ @param src 移動元のインデックス
+ @param dest 移動先のインデックス
+ */
+- (void)moveShotFrom:(NSInteger)src to:(NSInteger)dest
+{
+    // 同じ位置の場合は処理しない
+    if (src == dest) {
+        return;
+    }
+    
+    type_[dest] = type_[src];
+    motion_[dest] = motion_[src];
+    positionX_[dest] = positionX_[src];
+    positionY_[dest] = positionY_[src];
+    prevPositionX_[dest] = prevPositionX_[src];
+    prevPositionY_[dest] = prevPositionY_[src];
+    speedX_[dest] = speedX_[src];
+    speedY_[dest] = speedY_[src];
+    accelX_[dest] = accelX_[src];
+    accelY_[dest] = accelY_[src];
+    rotateCos_[dest] = rotateCos_[src];
+    rotateSin_[dest] = rotateSin_[src];
+    scrollSpeed_[dest] = scrollSpeed_[src];
+    halfWidth_[dest] = halfWidth_[src];
+    halfHeight_[dest] = halfHeight_[src];
+    grazePoint_[dest] = grazePoint_[src];
+    hitPoint_[dest] = hitPoint_[src];
+    power_[dest] = power_[src];
+    frame_[dest] = frame_[src];
+    changeInterval_[dest] = changeInterval_[src];
+    changeSpeedX_[dest] = changeSpeedX_[src];
+    changeSpeedY_[dest] = changeSpeedY_[src];
+    isRemoved_[dest] = isRemoved_[src];
+}
+
+/*!
+ @brief 位置・速度の更新
+ 
+ 速度によって位置を移動した後、加速度と回転を速度に反映する。
+ 動作種別による分岐をなくすため、すべての弾に同じ計算を行う。
+ 加速しない弾は加速度0、回転しない弾は回転量0(余弦1、正弦0)としているため、速度は変化しない。
+ @param scrollSpeedX x軸方向のスクロールスピード
+ @param scrollSpeedY y軸方向のスクロールスピード
+ */
+- (void)integrateWithScrollSpeedX:(float)scrollSpeedX scrollSpeedY:(float)scrollSpeedY
+{
+    for (NSInteger i = 0; i < count_; i++) {
+        
+        // 移動前の座標を記憶する
+        prevPositionX_[i] = positionX_[i];
+        prevPositionY_[i] = positionY_[i];
+        
+        // 座標の移動
+        // 画面スクロールの影響を受ける場合は画面スクロール分も移動する
+        positionX_[i] += speedX_[i] - scrollSpeedX * scrollSpeed_[i];
+        positionY_[i] += speedY_[i] - scrollSpeedY * scrollSpeed_[i];
+        
+        // 加速度を加える
+        float speedX = speedX_[i] + accelX_[i];
+        float speedY = speedY_[i] + accelY_[i];
+        
+        // 進行方向を回転させる
+        speedX_[i] = speedX * rotateCos_[i] - speedY * rotateSin_[i];
+        speedY_[i] = speedX * rotateSin_[i] + speedY * rotateCos_[i];
+    }
+}
+
+/*!
+ @brief 速度変更
+ 
+ 動作開始からのフレーム数をカウントし、速度変更までの間隔が経過した弾の速度を変更する。
+ 速度変更しない弾は間隔を0としているため、経過フレーム数と一致することはない。
+ */
+- (void)changeSpeed
+{
+    for (NSInteger i = 0; i < count_; i++) {
+        
+        // 動作開始からのフレーム数をカウントする
+        frame_[i]++;
+        
+        // 速度変更までの間隔が経過した場合は速度を変更する
+        BOOL isChange = (frame_[i] == changeInterval_[i]);
+        speedX_[i] = isChange ? changeSpeedX_[i] : speedX_[i];
+        speedY_[i] = isChange ? changeSpeedY_[i] : speedY_[i];
+    }
+}
+
+/*!
+ @brief 障害物との衝突判定
+ 
+ 障害物と衝突している弾のHPを0にする。
+ HPが0になった弾は次の移動処理で取り除かれる。
+ @param blockGrid 障害物当たり判定グリッド
+ */
+- (void)checkBlockHit:(AKCollisionGrid *)blockGrid
+{
+    // 障害物が配置されていない場合は処理しない
+    if (blockGrid == nil || blockGrid.count <= 0) {
+        return;
+    }
+    
+    for (NSInteger i = 0; i < count_; i++) {
+        
+        // グリッドから衝突している障害物を検索する
+        NSInteger hitCount = [blockGrid searchHitLeft:positionX_[i] - halfWidth_[i]
+                                                right:positionX_[i] + halfWidth_[i]
+                                                  top:positionY_[i] + halfHeight_[i]
+                                               bottom:positionY_[i] - halfHeight_[i]];
+        
+        // 画面に配置されている障害物と衝突している場合はHPを0にする
+        for (NSInteger j = 0; j < hitCount; j++) {
+            if ([blockGrid resultAtIndex:j].isStaged) {
+                hitPoint_[i] = 0;
+                break;
+            }
+        }
+    }
+}
+
+/*!
+ @brief 画像更新
+ 
+ 配置中の弾の移動前の位置と現在の位置の間で補間した位置に画像を移動する。
+ 画像が不足している場合は作成し、弾の種類と生成からの経過フレーム数で決まるアニメーションパターンが
+ 表示中のものと異なる場合は表示フレームを切り替える。
+ パターンの決め方はキャラクタークラスのアニメーションと同じにする。
+ 移動処理とは別に画面更新のたびに呼び出す。
+ @param alpha 補間の割合(0で移動前の位置、1で現在の位置)
+ */
+- (void)updateSpritesWithAlpha:(float)alpha
+{
+    // 親ノードがない場合は画像を使用しない
+    if (parent_ == nil) {
+        return;
+    }
+    
+    // ステージ座標からデバイススクリーン座標への変換係数を計算する
+    float originX = [AKScreenSize xOfStage:0.0f];
+    float originY = [AKScreenSize yOfStage:0.0f];
+    float scale = ([AKScreenSize xOfStage:kAKStageSize.width] - originX) / kAKStageSize.width;
+    
+    // 画像が不足している場合は作成する
+    [self createSpritesTo:count_];
+    
+    for (NSInteger i = 0; i < count_; i++) {
+        
+        // 経過フレーム数からアニメーションパターンを決定する
+        // パターン数が1の場合は常に1パターン目となる
+        NSInteger type = type_[i];
+        NSInteger pattern = (frame_[i] % (patternCount_[type] * animationInterval_[type])) / animationInterval_[type];
+        CCSpriteFrame *frame = frames_[frameOffset_[type] + pattern];
+        
+        // 表示中の表示フレームと異なる場合のみ切り替える
+        if (spriteFrame_[i] != frame) {
+            [sprites_[i] setDisplayFrame:frame];
+            spriteFrame_[i] = frame;
+        }
+        
+        // 移動前の位置と現在の位置の間で補間する
+        float x = prevPositionX_[i] + (positionX_[i] - prevPositionX_[i]) * alpha;
+        float y = prevPositionY_[i] + (positionY_[i] - prevPositionY_[i]) * alpha;
+        
+        // 画像の表示位置を更新する
+        sprites_[i].position = ccp((NSInteger)(x * scale + originX),
+                                   (NSInteger)(y * scale + originY));
+    }
+    
+    // 画像の表示数を更新する
+    [self updateVisibleCount];
+}
+
+/*!
+ @brief 画像のアニメーション停止
+ 
+ ゲームの一時停止時に作成済みのすべての画像のアニメーションを停止する。
+ */
+- (void)pauseSprites
+{
+    for (NSInteger i = 0; i < spriteCount_; i++) {
+        [sprites_[i] pauseSchedulerAndActions];
+    }
+}
+
+/*!
+ @brief 画像のアニメーション再開
+ 
+ ゲームの再開時に作成済みのすべての画像のアニメーションを再開する。
+ */
+- (void)resumeSprites
+{
+    for (NSInteger i = 0; i < spriteCount_; i++) {
+        [sprites_[i] resumeSchedulerAndActions];
+    }
+}
+
+/*!
+ @brief 画像の作成
+ 
+ 指定した位置までの画像のうち、未作成のものをまとめて作成して親ノードに配置する。
+ 作成した画像は表示数の更新で表示するまで非表示にしておく。
+ @param end 画像を作成する範囲の終端(この位置は含まない)
+ */
+- (void)createSpritesTo:(NSInteger)end
+{
+    // 親ノードがない場合は画像を使用しない
+    if (parent_ == nil) {
+        return;
+    }
+    
+    for (NSInteger i = spriteCount_; i < end; i++) {
+        spriteFrame_[i] = frames_[frameOffset_[kAKEnemyShotTypeNormal]];
+        sprites_[i] = [[CCSprite alloc] initWithSpriteFrame:spriteFrame_[i]];
+        sprites_[i].visible = NO;
+        [parent_ addChild:sprites_[i]];
+    }
+    
+    spriteCount_ = MAX(spriteCount_, end);
+}
+
+/*!
+ @brief 画像の表示数更新
+ 
+ 配置中の弾の数に合わせて画像の表示・非表示を切り替える。
+ 前回から表示数が変わった範囲の画像だけを切り替える。
+ */
+- (void)updateVisibleCount
+{
+    // 配置数が増えた場合は増えた分の画像を表示する
+    for (NSInteger i = visibleCount_; i < count_ && i < spriteCount_; i++) {
+        sprites_[i].visible = YES;
+    }
+    
+    // 配置数が減った場合は減った分の画像を非表示にする
+    for (NSInteger i = count_; i < visibleCount_; i++) {
+        sprites_[i].visible = NO;
+    }
+    
+    visibleCount_ = MIN(count_, spriteCount_);
+}
+
+/*!
+ @brief 衝突している弾の検索
+ 
+ 指定した範囲と当たり判定が重なっている弾を検索する。
+ 分岐をなくすため、すべての弾のインデックスを結果に書き込み、重なっている場合のみ件数を進める。
+ @param left 検索範囲の左端
+ @param right 検索範囲の右端
+ @param top 検索範囲の上端
+ @param bottom 検索範囲の下端
+ @return 検索結果の件数
+ */
+- (NSInteger)searchHitLeft:(float)left right:(float)right top:(float)top bottom:(float)bottom
+{
+    resultCount_ = 0;
+    for (NSInteger i = 0; i < count_; i++) {
+        
+        // 以下のすべての条件を満たしている時、衝突していると判断する。
+        //   ・弾の右端が範囲の左端よりも右側にある
+        //   ・弾の左端が範囲の右端よりも左側にある
+        //   ・弾の上端が範囲の下端よりも上側にある
+        //   ・弾の下端が範囲の上端よりも下側にある
+        NSInteger isHit = ((positionX_[i] + halfWidth_[i] > left) &
+                           (positionX_[i] - halfWidth_[i] < right) &
+                           (positionY_[i] + halfHeight_[i] > bottom) &
+                           (positionY_[i] - halfHeight_[i] < top));
+        
+        results_[resultCount_] = i;
+        resultCount_ += isHit;
+    }
+    
+    // 判定した弾の数を記録する
+    hitTestCount_ += count_;
+    
+    return resultCount_;
+}
+
+/*!
+ @brief 検索結果の弾のインデックス取得
+ 
+ 直前の検索結果の弾のインデックスを取得する。
+ @param index 検索結果内の位置
+ @return 弾のインデックス
+ */
+- (NSInteger)resultAtIndex:(NSInteger)index
+{
+    NSAssert(index >= 0 && index < resultCount_, @"検索結果の範囲外");
+    return results_[index];
+}
+
+/*!
+ @brief かすり判定
+ 
+ かすり判定の範囲に入っている弾のかすりポイントを合計し、弾のかすりポイントをリセットする。
+ @param left かすり判定の左端
+ @param right かすり判定の右端
+ @param top かすり判定の上端
+ @param bottom かすり判定の下端
+ @return かすりポイントの合計
+ */
+- (float)grazeLeft:(float)left right:(float)right top:(float)top bottom:(float)bottom
+{
+    float grazePoint = 0.0f;
+    
+    // かすり判定の範囲と重なっている弾を検索する
+    NSInteger count = [self searchHitLeft:left right:right top:top bottom:bottom];
+    
+    // 弾のかすりポイントを取得してリセットする
+    for (NSInteger i = 0; i < count; i++) {
+        NSInteger index = results_[i];
+        grazePoint += grazePoint_[index];
+        grazePoint_[index] = 0.0f;
+    }
+    
+    return grazePoint;
+}
+
+/*!
+ @brief キャラクター衝突判定
+ 
+ キャラクターと衝突している弾を調べ、衝突しているときはキャラクターと弾のHPを互いの攻撃力分減らす。
+ @param character 判定するキャラクター
+ */
+- (void)checkHitWithCharacter:(AKCharacter *)character
+{
+    // 画面に配置されていない場合は処理しない
+    if (!character.isStaged) {
+        return;
+    }
+    
+    // キャラクターの当たり判定と重なっている弾を検索する
+    NSInteger count = [self searchHitLeft:character.positionX - character.width / 2.0f
+                                    right:character.positionX + character.width / 2.0f
+                                      top:character.positionY + character.height / 2.0f
+                                   bottom:character.positionY - character.height / 2.0f];
+    
+    // 衝突している弾ごとに互いのHPを減らす
+    for (NSInteger i = 0; i < count; i++) {
+        NSInteger index = results_[i];
+        character.hitPoint -= power_[index];
+        hitPoint_[index] -= character.power;
+    }
+}
+
+/*!
+ @brief 反射判定
+ 
+ キャラクターと衝突している弾を調べ、衝突しているときは反射弾を生成し、弾のHPを0にする。
+ @param character 判定するキャラクター
+ @param data ゲームデータ
+ */
+- (void)reflectWithCharacter:(AKCharacter *)character data:(id<AKPlayDataInterface>)data
+{
+    // 画面に配置されていない場合は処理しない
+    if (!character.isStaged) {
+        return;
+    }
+    
+    // キャラクターの当たり判定と重なっている弾を検索する
+    NSInteger count = [self searchHitLeft:character.positionX - character.width / 2.0f
+                                    right:character.positionX + character.width / 2.0f
+                                      top:character.positionY + character.height / 2.0f
+                                   bottom:character.positionY - character.height / 2.0f];
+    
+    // 衝突している弾ごとに反射弾を生成する
+    for (NSInteger i = 0; i < count; i++) {
+        
+        NSInteger index = results_[i];
+        
+        AKLog(kAKLogEnemyShotEngine_1, @"反射処理開始");
+        
+        // 速度を反転させて反射弾を生成する
+        [data createReflectedShotType:type_[index]
+                                    x:positionX_[index]
+                                    y:positionY_[index]
+                               speedX:-speedX_[index]
+                               speedY:-speedY_[index]];
+        
+        // 弾のHPを0にする
+        hitPoint_[index] = 0;
+    }
+}
+
+/*!
+ @brief 全弾削除
+ 
+ 配置中の弾をすべて取り除く。
+ */
+- (void)removeAllShots
+{
+    count_ = 0;
+    reservedCount_ = 0;
+    [self updateVisibleCount];
+}
+
+/*!
+ @brief 統計情報のリセット
+ 
+ 当たり判定を行った弾の数をクリアする。
+ */
+- (void)resetStatistics
+{
+    hitTestCount_ = 0;
+}
+
+/*!
+ @brief 弾の種類取得
+ 
+ 弾の種類を取得する。
+ @param index 弾のインデックス
+ @return 弾の種類
+ */
+- (NSInteger)typeAtIndex:(NSInteger)index
+{
+    NSAssert(index >= 0 && index < count_, @"弾のインデックスが範囲外");
+    return type_[index];
+}
+
+/*!
+ @brief 動作種別取得
+ 
+ 弾の動作種別を取得する。
+ @param index 弾のインデックス
+ @return 動作種別
+ */
+- (enum AKEnemyShotMotion)motionAtIndex:(NSInteger)index
+{
+    NSAssert(index >= 0 && index < count_, @"弾のインデックスが範囲外");
+    return (enum AKEnemyShotMotion)motion_[index];
+}
+
+/*!
+ @brief 位置取得
+ 
+ 弾の位置を取得する。
+ @param index 弾のインデックス
+ @return 位置
+ */
+- (CGPoint)positionAtIndex:(NSInteger)index
+{
+    NSAssert(index >= 0 && index < count_, @"弾のインデックスが範囲外");
+    return ccp(positionX_[index], positionY_[index]);
+}
+
+/*!
+ @brief 速度取得
+ 
+ 弾の速度を取得する。
+ @param index 弾のインデックス
+ @return 速度
+ */
+- (CGPoint)speedAtIndex:(NSInteger)index
+{
+    NSAssert(index >= 0 && index < count_, @"弾のインデックスが範囲外");
+    return ccp(speedX_[index], speedY_[index]);
+}
+
+/*!
+ @brief HP取得
+ 
+ 弾のHPを取得する。
+ @param index 弾のインデックス
+ @return HP
+ */
+- (NSInteger)hitPointAtIndex:(NSInteger)index
+{
+    NSAssert(index >= 0 && index < count_, @"弾のインデックスが範囲外");
+    return hitPoint_[index];
+}
+
+/*!
+ @brief 状態の保存
+ 
+ 配置している弾の数と、項目ごとの配列の配置中の範囲をそのまま保存する。
+ 画像は保存しない。
+ @param snapshot 保存先
+ */
+- (void)writeSnapshot:(AKSnapshot *)snapshot
+{
+    void *arrays[kAKShotStateArrayCount];
+    size_t sizes[kAKShotStateArrayCount];
+    [self getStateArrays:arrays elementSizes:sizes];
+    
+    [snapshot writeBytes:&count_ length:sizeof(count_)];
+    
+    for (NSInteger i = 0; i < kAKShotStateArrayCount; i++) {
+        [snapshot writeBytes:arrays[i] length:sizes[i] * count_];
+    }
+}
+
+/*!
+ @brief 状態の復元
+ 
+ 配置している弾の数と、項目ごとの配列の配置中の範囲を読み込む。
+ 予約済みの弾は破棄する。画像は次の画像更新で配置数に合わせて作成・表示する。
+ @param snapshot 読み込み元
+ */
+- (void)readSnapshot:(AKSnapshot *)snapshot
+{
+    void *arrays[kAKShotStateArrayCount];
+    size_t sizes[kAKShotStateArrayCount];
+    [self getStateArrays:arrays elementSizes:sizes];
+    
+    NSInteger count = 0;
+    [snapshot readBytes:&count length:sizeof(count)];
+    
+    NSAssert(count >= 0 && count <= capacity_, @"弾の数が範囲外");
+    
+    for (NSInteger i = 0; i < kAKShotStateArrayCount; i++) {
+        [snapshot readBytes:arrays[i] length:sizes[i] * count];
+    }
+    
+    count_ = count;
+    reservedCount_ = 0;
+    
+    // 画像の表示数を更新する
+    [self updateVisibleCount];
+}
+
+/*!
+ @brief 状態保存で保存する配列の取得
+ 
+ 弾の状態を格納している項目ごとの配列と、その要素のサイズを取得する。
+ 保存と復元で同じ順序となるように、配列の並びはここでのみ定義する。
+ @param arrays 配列の格納先(kAKShotStateArrayCount個)
+ @param sizes 要素のサイズの格納先(kAKShotStateArrayCount個)
+ */
+- (void)getStateArrays:(void **)arrays elementSizes:(size_t *)sizes
+{
+    NSInteger i = 0;
+    
+#define AKAddStateArray(array) arrays[i] = (array); sizes[i] = sizeof(*(array)); i++
+    AKAddStateArray(type_);
+    AKAddStateArray(motion_);
+    AKAddStateArray(positionX_);
+    AKAddStateArray(positionY_);
+    AKAddStateArray(prevPositionX_);
+    AKAddStateArray(prevPositionY_);
+    AKAddStateArray(speedX_);
+    AKAddStateArray(speedY_);
+    AKAddStateArray(accelX_);
+    AKAddStateArray(accelY_);
+    AKAddStateArray(rotateCos_);
+    AKAddStateArray(rotateSin_);
+    AKAddStateArray(scrollSpeed_);
+    AKAddStateArray(halfWidth_);
+    AKAddStateArray(halfHeight_);
+    AKAddStateArray(grazePoint_);
+    AKAddStateArray(hitPoint_);
+    AKAddStateArray(power_);
+    AKAddStateArray(frame_);
+    AKAddStateArray(changeInterval_);
+    AKAddStateArray(changeSpeedX_);
+    AKAddStateArray(changeSpeedY_);
+    AKAddStateArray(isRemoved_);
+#undef AKAddStateArray
+    
+    NSAssert(i == kAKShotStateArrayCount, @"状態保存で保存する配列の数が不正");
+}
+@end
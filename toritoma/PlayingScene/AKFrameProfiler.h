@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2013 Akihiro Kaneda.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1.Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   2.Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   3.Neither the name of the Monochrome Soft nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ @file AKFrameProfiler.h
+ @brief フレームプロファイラクラス定義
+ 
+ 1フレームの処理の区間ごとの処理時間を計測するクラスを定義する。
+ */
+
+#import <Foundation/Foundation.h>
+#import <mach/mach_time.h>
+
+/// 計測区間
+enum AKProfilePhase {
+    kAKProfilePhaseFrame = 0,       ///< フレーム全体
+    kAKProfilePhaseStageLoad,       ///< ステージ読み込み(先読みの完了待ちを含む)
+    kAKProfilePhaseTileMap,         ///< マップ更新
+    kAKProfilePhaseBlockMove,       ///< 障害物移動
+    kAKProfilePhasePlayerMove,      ///< 自機移動
+    kAKProfilePhaseShotMove,        ///< 自機弾・反射弾移動
+    kAKProfilePhaseEnemyMove,       ///< 敵移動
+    kAKProfilePhaseEnemyShotMove,   ///< 敵弾移動
+    kAKProfilePhaseEffectMove,      ///< 画面効果移動
+    kAKProfilePhaseGridRebuild,     ///< 当たり判定グリッド再構築
+    kAKProfilePhaseBlockHit,        ///< 障害物当たり判定
+    kAKProfilePhaseEnemyHit,        ///< 敵当たり判定
+    kAKProfilePhaseReflect,         ///< 反射判定
+    kAKProfilePhasePlayerHit,       ///< 自機かすり・当たり判定
+    kAKProfilePhaseHUD,             ///< 情報表示更新
+    kAKProfilePhaseDraw,            ///< 画像表示位置更新
+    kAKProfilePhaseCount            ///< 計測区間の数
+};
+
+/// 計数項目
+enum AKProfileCounter {
+    kAKProfileCounterStep = 0,          ///< 状態更新回数
+    kAKProfileCounterBlock,             ///< 障害物数
+    kAKProfileCounterPlayerShot,        ///< 自機弾数
+    kAKProfileCounterReflectedShot,     ///< 反射弾数
+    kAKProfileCounterEnemy,             ///< 敵数
+    kAKProfileCounterEnemyShot,         ///< 敵弾数
+    kAKProfileCounterEffect,            ///< 画面効果数
+    kAKProfileCounterPairTest,          ///< 当たり判定を行った組み合わせの数
+    kAKProfileCounterAlloc,             ///< メモリ確保回数(デバッグビルドのみ)
+    kAKProfileCounterCount              ///< 計数項目の数
+};
+
+/// 1フレーム分の計測結果
+struct AKProfileFrame {
+    uint64_t start;                                 ///< フレーム開始時刻
+    uint64_t phaseStart[kAKProfilePhaseCount];      ///< 区間ごとの最初の開始時刻
+    uint64_t phaseTime[kAKProfilePhaseCount];       ///< 区間ごとの処理時間の合計
+    NSUInteger counters[kAKProfileCounterCount];    ///< 計数項目の値
+};
+
+// フレームプロファイラクラス
+@interface AKFrameProfiler : NSObject {
+    /// 計測結果のリングバッファ
+    struct AKProfileFrame *frames_;
+    /// 保持するフレーム数
+    NSInteger capacity_;
+    /// 計測を開始したフレームの数
+    NSInteger frameCount_;
+    /// 計測中のフレーム
+    struct AKProfileFrame *current_;
+    /// フレーム開始時のメモリ確保回数
+    int64_t allocStart_;
+}
+
+/// 保持するフレーム数
+@property (nonatomic, readonly)NSInteger capacity;
+/// 計測を開始したフレームの数
+@property (nonatomic, readonly)NSInteger frameCount;
+
+// 初期化処理
+- (id)initWithCapacity:(NSInteger)capacity;
+// フレーム開始
+- (void)beginFrame;
+// フレーム終了
+- (void)endFrame;
+// 区間の処理時間加算
+- (void)addTime:(uint64_t)time start:(uint64_t)start phase:(enum AKProfilePhase)phase;
+// 計数項目の設定
+- (void)setCount:(NSUInteger)count counter:(enum AKProfileCounter)counter;
+// 計数項目の加算
+- (void)addCount:(NSUInteger)count counter:(enum AKProfileCounter)counter;
+// 保持しているフレーム数取得
+- (NSInteger)storedFrameCount;
+// 計測結果取得
+- (const struct AKProfileFrame *)frameAtIndex:(NSInteger)index;
+// 時刻のマイクロ秒への変換
+- (double)microsecondsOfTime:(uint64_t)time;
+// CSV形式の文字列作成
+- (NSString *)csvString;
+// Chromeトレース形式の文字列作成
+- (NSString *)chromeTraceString;
+@end
+
+/*!
+ @brief 区間計測開始
+ 
+ 区間の計測を開始する。プロファイラがnilの場合は時刻を取得しない。
+ @param profiler プロファイラ
+ @return 開始時刻
+ */
+static inline uint64_t AKProfilerBegin(AKFrameProfiler *profiler)
+{
+    return (profiler != nil) ? mach_absolute_time() : 0;
+}
+
+/*!
+ @brief 区間計測終了
+ 
+ 区間の計測を終了し、開始からの経過時間をプロファイラに加算する。
+ プロファイラがnilの場合は何もしない。
+ @param profiler プロファイラ
+ @param phase 計測区間
+ @param start 開始時刻
+ */
+static inline void AKProfilerEnd(AKFrameProfiler *profiler, enum AKProfilePhase phase, uint64_t start)
+{
+    if (profiler != nil) {
+        [profiler addTime:mach_absolute_time() - start start:start phase:phase];
+    }
+}
@@ -0,0 +1,366 @@
+/*
+ * Copyright (c) 2013 Akihiro Kaneda.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1.Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   2.Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   3.Neither the name of the Monochrome Soft nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ @file AKFrameProfiler.m
+ @brief フレームプロファイラクラス定義
+ 
+ 1フレームの処理の区間ごとの処理時間を計測するクラスを定義する。
+ */
+
+#import "AKFrameProfiler.h"
+#import "AKToritoma.h"
+
+/// 計測区間の名前
+static NSString *kAKPhaseNames[kAKProfilePhaseCount] = {
+    @"Frame",
+    @"StageLoad",
+    @"TileMap",
+    @"BlockMove",
+    @"PlayerMove",
+    @"ShotMove",
+    @"EnemyMove",
+    @"EnemyShotMove",
+    @"EffectMove",
+    @"GridRebuild",
+    @"BlockHit",
+    @"EnemyHit",
+    @"Reflect",
+    @"PlayerHit",
+    @"HUD",
+    @"Draw"
+};
+
+/// 計数項目の名前
+static NSString *kAKCounterNames[kAKProfileCounterCount] = {
+    @"Step",
+    @"Block",
+    @"PlayerShot",
+    @"ReflectedShot",
+    @"Enemy",
+    @"EnemyShot",
+    @"Effect",
+    @"PairTest",
+    @"Alloc"
+};
+
+/*!
+ @brief フレームプロファイラクラス
+ 
+ 1フレームの処理の区間ごとの処理時間と、キャラクター数などの計数項目を記録する。
+ 計測結果は固定サイズのリングバッファに保持し、古いフレームから上書きする。
+ 計測中にメモリの確保は行わない。
+ 計測を行わない場合はプロファイラを作成せず、計測関数にnilを渡すことで時刻の取得も行わない。
+ デバッグビルドではフレーム中のメモリ確保回数も計数項目として記録する。
+ */
+@implementation AKFrameProfiler
+
+@synthesize capacity = capacity_;
+@synthesize frameCount = frameCount_;
+
+/*!
+ @brief 初期化処理
+ 
+ 計測結果のバッファを確保する。
+ デバッグビルドではメモリ確保回数の計測を開始する。
+ @param capacity 保持するフレーム数
+ @return 初期化したオブジェクト。失敗時はnilを返す。
+ */
+- (id)initWithCapacity:(NSInteger)capacity
+{
+    // スーパークラスの初期化処理を行う
+    self = [super init];
+    if (!self) {
+        AKLog(kAKLogFrameProfiler_0, @"error");
+        return nil;
+    }
+    
+    NSAssert(capacity > 0, @"保持するフレーム数が不正");
+    
+    // 計測結果のバッファを確保する
+    capacity_ = capacity;
+    frames_ = calloc(capacity_, sizeof(struct AKProfileFrame));
+    frameCount_ = 0;
+    current_ = NULL;
+    allocStart_ = 0;
+    
+#ifdef DEBUG
+    // メモリ確保回数の計測を開始する
+    [AKAllocCounter install];
+#endif
+    
+    return self;
+}
+
+/*!
+ @brief インスタンス解放時処理
+ 
+ インスタンス解放時にオブジェクトを解放する。
+ */
+- (void)dealloc
+{
+    // バッファを解放する
+    free(frames_);
+    
+    // スーパークラスの解放処理
+    [super dealloc];
+}
+
+/*!
+ @brief フレーム開始
+ 
+ 次のフレームの計測を開始する。
+ リングバッファが一杯の場合は最も古いフレームの計測結果を上書きする。
+ */
+- (void)beginFrame
+{
+    // 書き込み先のフレームをクリアする
+    current_ = &frames_[frameCount_ % capacity_];
+    memset(current_, 0, sizeof(struct AKProfileFrame));
+    
+#ifdef DEBUG
+    // 開始時のメモリ確保回数を記録する
+    allocStart_ = [AKAllocCounter count];
+#endif
+    
+    // 開始時刻を記録する
+    current_->start = mach_absolute_time();
+}
+
+/*!
+ @brief フレーム終了
+ 
+ 計測中のフレームの処理時間を記録し、計測を終了する。
+ デバッグビルドではフレーム中のメモリ確保回数を記録する。
+ */
+- (void)endFrame
+{
+    // フレームを開始していない場合は処理しない
+    if (current_ == NULL) {
+        return;
+    }
+    
+    // フレーム全体の処理時間を記録する
+    current_->phaseStart[kAKProfilePhaseFrame] = current_->start;
+    current_->phaseTime[kAKProfilePhaseFrame] = mach_absolute_time() - current_->start;
+    
+#ifdef DEBUG
+    // フレーム中のメモリ確保回数を記録する
+    current_->counters[kAKProfileCounterAlloc] = (NSUInteger)([AKAllocCounter count] - allocStart_);
+#endif
+    
+    // 計測済みのフレーム数を進める
+    frameCount_++;
+    current_ = NULL;
+}
+
+/*!
+ @brief 区間の処理時間加算
+ 
+ 計測中のフレームに区間の処理時間を加算する。
+ 1フレームに複数回状態更新を行う場合は同じ区間が複数回計測されるため、処理時間は合計し、開始時刻は最初のものを残す。
+ @param time 処理時間
+ @param start 開始時刻
+ @param phase 計測区間
+ */
+- (void)addTime:(uint64_t)time start:(uint64_t)start phase:(enum AKProfilePhase)phase
+{
+    // フレームを開始していない場合は処理しない
+    if (current_ == NULL) {
+        return;
+    }
+    
+    if (current_->phaseTime[phase] == 0) {
+        current_->phaseStart[phase] = start;
+    }
+    current_->phaseTime[phase] += time;
+}
+
+/*!
+ @brief 計数項目の設定
+ 
+ 計測中のフレームの計数項目に値を設定する。
+ @param count 値
+ @param counter 計数項目
+ */
+- (void)setCount:(NSUInteger)count counter:(enum AKProfileCounter)counter
+{
+    if (current_ != NULL) {
+        current_->counters[counter] = count;
+    }
+}
+
+/*!
+ @brief 計数項目の加算
+ 
+ 計測中のフレームの計数項目に値を加算する。
+ @param count 加算する値
+ @param counter 計数項目
+ */
+- (void)addCount:(NSUInteger)count counter:(enum AKProfileCounter)counter
+{
+    if (current_ != NULL) {
+        current_->counters[counter] += count;
+    }
+}
+
+/*!
+ @brief 保持しているフレーム数取得
+ 
+ リングバッファに保持している計測済みのフレームの数を取得する。
+ @return 保持しているフレーム数
+ */
+- (NSInteger)storedFrameCount
+{
+    return MIN(frameCount_, capacity_);
+}
+
+/*!
+ @brief 計測結果取得
+ 
+ 保持している計測済みのフレームの計測結果を古い順に取得する。
+ @param index 古い方から数えたフレームの位置
+ @return 計測結果
+ */
+- (const struct AKProfileFrame *)frameAtIndex:(NSInteger)index
+{
+    NSAssert(index >= 0 && index < [self storedFrameCount], @"フレームの位置が範囲外");
+    
+    return &frames_[(frameCount_ - [self storedFrameCount] + index) % capacity_];
+}
+
+/*!
+ @brief 時刻のマイクロ秒への変換
+ 
+ mach_absolute_timeで取得した時刻または時間をマイクロ秒に変換する。
+ @param time 時刻または時間
+ @return マイクロ秒
+ */
+- (double)microsecondsOfTime:(uint64_t)time
+{
+    // 変換係数は最初に1回だけ取得する
+    static mach_timebase_info_data_t timebase = {0, 0};
+    if (timebase.denom == 0) {
+        mach_timebase_info(&timebase);
+    }
+    
+    return (double)time * timebase.numer / timebase.denom / 1000.0;
+}
+
+/*!
+ @brief CSV形式の文字列作成
+ 
+ 保持しているフレームの計測結果を1行1フレームのCSV形式の文字列にする。
+ 処理時間の単位はマイクロ秒とする。
+ @return CSV形式の文字列
+ */
+- (NSString *)csvString
+{
+    NSMutableString *csv = [NSMutableString string];
+    
+    // ヘッダー行を作成する
+    [csv appendString:@"frame"];
+    for (NSInteger i = 0; i < kAKProfilePhaseCount; i++) {
+        [csv appendFormat:@",%@", kAKPhaseNames[i]];
+    }
+    for (NSInteger i = 0; i < kAKProfileCounterCount; i++) {
+        [csv appendFormat:@",%@", kAKCounterNames[i]];
+    }
+    [csv appendString:@"\n"];
+    
+    // 1フレームずつ出力する
+    NSInteger first = frameCount_ - [self storedFrameCount];
+    for (NSInteger i = 0; i < [self storedFrameCount]; i++) {
+        
+        const struct AKProfileFrame *frame = [self frameAtIndex:i];
+        
+        [csv appendFormat:@"%d", first + i];
+        for (NSInteger j = 0; j < kAKProfilePhaseCount; j++) {
+            [csv appendFormat:@",%.3f", [self microsecondsOfTime:frame->phaseTime[j]]];
+        }
+        for (NSInteger j = 0; j < kAKProfileCounterCount; j++) {
+            [csv appendFormat:@",%u", frame->counters[j]];
+        }
+        [csv appendString:@"\n"];
+    }
+    
+    return csv;
+}
+
+/*!
+ @brief Chromeトレース形式の文字列作成
+ 
+ 保持しているフレームの計測結果をChromeのトレースビューアで読み込めるJSON形式の文字列にする。
+ 各区間は最初の開始時刻から合計の処理時間の長さのイベントとして出力し、計数項目はカウンターイベントとして出力する。
+ 時刻は最も古いフレームの開始時刻を0とする。
+ @return JSON形式の文字列
+ */
+- (NSString *)chromeTraceString
+{
+    NSMutableString *json = [NSMutableString stringWithString:@"{\"traceEvents\":["];
+    
+    // 基準時刻を取得する
+    uint64_t origin = ([self storedFrameCount] > 0) ? [self frameAtIndex:0]->start : 0;
+    
+    BOOL isFirst = YES;
+    for (NSInteger i = 0; i < [self storedFrameCount]; i++) {
+        
+        const struct AKProfileFrame *frame = [self frameAtIndex:i];
+        
+        // 計測した区間を出力する
+        for (NSInteger j = 0; j < kAKProfilePhaseCount; j++) {
+            
+            // 処理を行っていない区間は出力しない
+            if (frame->phaseTime[j] == 0) {
+                continue;
+            }
+            
+            [json appendFormat:@"%@{\"name\":\"%@\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}",
+             (isFirst ? @"" : @","),
+             kAKPhaseNames[j],
+             [self microsecondsOfTime:frame->phaseStart[j] - origin],
+             [self microsecondsOfTime:frame->phaseTime[j]]];
+            isFirst = NO;
+        }
+        
+        // 計数項目を出力する
+        [json appendFormat:@"%@{\"name\":\"Counters\",\"ph\":\"C\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"args\":{",
+         (isFirst ? @"" : @","),
+         [self microsecondsOfTime:frame->start - origin]];
+        for (NSInteger j = 0; j < kAKProfileCounterCount; j++) {
+            [json appendFormat:@"%@\"%@\":%u", (j == 0 ? @"" : @","), kAKCounterNames[j], frame->counters[j]];
+        }
+        [json appendString:@"}}"];
+        isFirst = NO;
+    }
+    
+    [json appendString:@"]}"];
+    
+    return json;
+}
+@end
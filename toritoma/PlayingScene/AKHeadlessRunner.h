@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2013 Akihiro Kaneda.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1.Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   2.Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   3.Neither the name of the Monochrome Soft nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ @file AKHeadlessRunner.h
+ @brief 画面なし実行クラス定義
+ 
+ 画面を使用せずにゲームの状態更新のみを実行するクラスを定義する。
+ */
+
+#import "AKToritoma.h"
+#import "AKPlayData.h"
+#import "AKInputReplayer.h"
+
+// 画面なし実行クラス
+@interface AKHeadlessRunner : NSObject {
+    /// ゲームデータ
+    AKPlayData *data_;
+    /// ステージ番号
+    NSInteger stage_;
+    /// 実行した状態更新の回数
+    NSInteger tickCount_;
+    /// 状態更新にかかった時間の合計(秒)
+    NSTimeInterval elapsedTime_;
+    /// 実行前の画像不使用モード
+    BOOL prevHeadless_;
+    /// 実行前の固定画面サイズ
+    CGSize prevScreenSize_;
+}
+
+/// ゲームデータ
+@property (nonatomic, retain)AKPlayData *data;
+/// ステージ番号
+@property (nonatomic, readonly)NSInteger stage;
+/// 実行した状態更新の回数
+@property (nonatomic, readonly)NSInteger tickCount;
+/// 状態更新にかかった時間の合計(秒)
+@property (nonatomic, readonly)NSTimeInterval elapsedTime;
+
+// 初期化処理
+- (id)initWithStageNo:(NSInteger)stage;
+// 状態更新の実行
+- (void)runTicks:(NSInteger)count;
+// 入力記録の再生
+- (NSInteger)runReplay:(AKInputReplayer *)replayer;
+// 実行結果の文字列作成
+- (NSString *)summary;
+// ステージの実行
++ (NSString *)runStage:(NSInteger)stage tickCount:(NSInteger)count;
+// 入力記録ファイルの再生
++ (NSString *)runReplayFile:(NSString *)path;
+@end
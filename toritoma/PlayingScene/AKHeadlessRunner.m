@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) 2013 Akihiro Kaneda.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1.Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   2.Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   3.Neither the name of the Monochrome Soft nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ @file AKHeadlessRunner.m
+ @brief 画面なし実行クラス定義
+ 
+ 画面を使用せずにゲームの状態更新のみを実行するクラスを定義する。
+ */
+
+#import "AKHeadlessRunner.h"
+
+/// 画面なし実行時の画面サイズ(デバイスによらず3.5インチiPhoneの画面サイズに固定する)
+static const CGSize kAKHeadlessScreenSize = {480, 320};
+
+/*!
+ @brief 画面なし実行クラス
+ 
+ キャラクターを画像不使用モードにしてゲームデータを作成し、
+ シーンなしでステージの状態更新を指定した回数だけ実行する。
+ 画面サイズを固定するため、実行するデバイスによらず同じ結果となる。
+ 処理時間の計測や、画面を使用しないテストで使用する。
+ */
+@implementation AKHeadlessRunner
+
+@synthesize data = data_;
+@synthesize stage = stage_;
+@synthesize tickCount = tickCount_;
+@synthesize elapsedTime = elapsedTime_;
+
+/*!
+ @brief 初期化処理
+ 
+ 画像不使用モードでゲームデータを作成し、ステージのスクリプトを読み込む。
+ ステージ番号が0以下の場合はスクリプトを読み込まず、キャラクターが配置されていない状態とする。
+ 画像不使用モードと画面サイズはインスタンス解放時に元に戻す。
+ @param stage ステージ番号(0以下の場合はスクリプトを読み込まない)
+ @return 初期化したオブジェクト。失敗時はnilを返す。
+ */
+- (id)initWithStageNo:(NSInteger)stage
+{
+    // スーパークラスの初期化処理を行う
+    self = [super init];
+    if (!self) {
+        AKLog(kAKLogHeadlessRunner_0, @"error");
+        return nil;
+    }
+    
+    // 画像不使用モードにして画面サイズを固定する
+    // 並列実行で設定済みの場合は他のインスタンスの実行中に値を書き換えないように設定を行わない
+    prevHeadless_ = [AKCharacter isHeadless];
+    prevScreenSize_ = [AKScreenSize fixedScreenSize];
+    if (!prevHeadless_) {
+        [AKCharacter setHeadless:YES];
+    }
+    if (!CGSizeEqualToSize(prevScreenSize_, kAKHeadlessScreenSize)) {
+        [AKScreenSize setFixedScreenSize:kAKHeadlessScreenSize];
+    }
+    
+    // シーンなしでゲームデータを作成する
+    self.data = [[[AKPlayData alloc] initWithScene:nil] autorelease];
+    
+    // ステージのスクリプトを読み込む
+    // ステージ番号が0以下の場合は呼び出し側でキャラクターを配置するため読み込まない
+    stage_ = stage;
+    if (stage > 0) {
+        [self.data readScript:stage];
+    }
+    
+    // その他のメンバを初期化する
+    tickCount_ = 0;
+    elapsedTime_ = 0.0;
+    
+    AKLog(kAKLogHeadlessRunner_1, @"stage=%d", stage);
+    
+    return self;
+}
+
+/*!
+ @brief インスタンス解放時処理
+ 
+ インスタンス解放時にオブジェクトを解放し、画像不使用モードと画面サイズを元に戻す。
+ */
+- (void)dealloc
+{
+    // メンバを解放する
+    self.data = nil;
+    
+    // 画像不使用モードと画面サイズを変更した場合は元に戻す
+    if (!prevHeadless_) {
+        [AKCharacter setHeadless:NO];
+    }
+    if (!CGSizeEqualToSize(prevScreenSize_, kAKHeadlessScreenSize)) {
+        [AKScreenSize setFixedScreenSize:prevScreenSize_];
+    }
+    
+    // スーパークラスの解放処理
+    [super dealloc];
+}
+
+/*!
+ @brief 状態更新の実行
+ 
+ ゲームデータの状態更新を指定した回数実行し、処理時間を加算する。
+ ゲームデータにフレームプロファイラが設定されている場合は1回の状態更新を1フレームとして計測する。
+ @param count 実行する回数
+ */
+- (void)runTicks:(NSInteger)count
+{
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    
+    for (NSInteger i = 0; i < count; i++) {
+        
+        [self.data.profiler beginFrame];
+        
+        [self.data update];
+        
+        [self.data.profiler endFrame];
+    }
+    
+    elapsedTime_ += CFAbsoluteTimeGetCurrent() - start;
+    tickCount_ += count;
+    
+    AKLog(kAKLogHeadlessRunner_1, @"tickCount=%d elapsedTime=%f", tickCount_, elapsedTime_);
+}
+
+/*!
+ @brief 入力記録の再生
+ 
+ 記録した入力をゲームデータに入力しながら最後まで状態更新を実行し、処理時間を加算する。
+ ゲームデータにフレームプロファイラが設定されている場合は1回の状態更新を1フレームとして計測する。
+ 入力記録の開始ステージはこのインスタンスのステージと一致している必要がある。
+ @param replayer 入力再生
+ @return 最初にチェックサムが不一致となった状態更新の番号。すべて一致した場合はkAKReplayNoMismatch。
+ */
+- (NSInteger)runReplay:(AKInputReplayer *)replayer
+{
+    NSAssert(replayer.stage == stage_, @"入力記録のステージが異なる");
+    
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    
+    while (![replayer isEnd]) {
+        
+        [self.data.profiler beginFrame];
+        
+        [replayer replayTickWithData:self.data];
+        
+        [self.data.profiler endFrame];
+    }
+    
+    elapsedTime_ += CFAbsoluteTimeGetCurrent() - start;
+    tickCount_ += replayer.tickCount;
+    
+    AKLog(kAKLogHeadlessRunner_0 && replayer.mismatchTick != kAKReplayNoMismatch,
+          @"チェックサム不一致:tick=%d", replayer.mismatchTick);
+    
+    return replayer.mismatchTick;
+}
+
+/*!
+ @brief 実行結果の文字列作成
+ 
+ 実行した回数、処理時間、現在のキャラクター数を1行の文字列にする。
+ @return 実行結果の文字列
+ */
+- (NSString *)summary
+{
+    // 1回あたりの処理時間をマイクロ秒で計算する
+    double perTick = (tickCount_ > 0) ? elapsedTime_ * 1000000.0 / tickCount_ : 0.0;
+    
+    return [NSString stringWithFormat:@"stage=%d ticks=%d time=%.3fms perTick=%.3fus block=%d enemy=%d enemyShot=%d",
+            stage_,
+            tickCount_,
+            elapsedTime_ * 1000.0,
+            perTick,
+            self.data.blockPool.activeCount,
+            self.data.enemyPool.activeCount,
+            self.data.enemyShotEngine.count];
+}
+
+/*!
+ @brief ステージの実行
+ 
+ 指定したステージを画面なしで指定した回数だけ状態更新し、実行結果の文字列を返す。
+ @param stage ステージ番号
+ @param count 実行する回数
+ @return 実行結果の文字列
+ */
++ (NSString *)runStage:(NSInteger)stage tickCount:(NSInteger)count
+{
+    AKHeadlessRunner *runner = [[[AKHeadlessRunner alloc] initWithStageNo:stage] autorelease];
+    
+    [runner runTicks:count];
+    
+    return [runner summary];
+}
+
+/*!
+ @brief 入力記録ファイルの再生
+ 
+ 入力記録ファイルを画面なしで再生し、実行結果の文字列を返す。
+ チェックサムが不一致となった場合はその状態更新の番号を結果に加える。
+ @param path 入力記録ファイルのパス
+ @return 実行結果の文字列。ファイルが不正な場合はnilを返す。
+ */
++ (NSString *)runReplayFile:(NSString *)path
+{
+    // 入力記録ファイルを読み込む
+    AKInputReplayer *replayer = [[[AKInputReplayer alloc] initWithData:[NSData dataWithContentsOfFile:path]] autorelease];
+    if (replayer == nil) {
+        AKLog(kAKLogHeadlessRunner_0, @"入力記録ファイルが不正:%@", path);
+        return nil;
+    }
+    
+    // 記録開始時のステージから再生する
+    AKHeadlessRunner *runner = [[[AKHeadlessRunner alloc] initWithStageNo:replayer.stage] autorelease];
+    NSInteger mismatchTick = [runner runReplay:replayer];
+    
+    return [NSString stringWithFormat:@"%@ mismatchTick=%d", [runner summary], mismatchTick];
+}
+@end
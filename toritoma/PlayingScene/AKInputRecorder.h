@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2013 Akihiro Kaneda.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1.Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   2.Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   3.Neither the name of the Monochrome Soft nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ @file AKInputRecorder.h
+ @brief 入力記録クラス定義
+ 
+ プレイ中の入力を状態更新単位で記録するクラスを定義する。
+ */
+
+#import <Foundation/Foundation.h>
+
+/// 入力記録のバイナリ形式の識別子
+extern const uint32_t kAKInputRecordMagic;
+/// 入力記録のバイナリ形式のバージョン
+extern const uint16_t kAKInputRecordVersion;
+
+/// 入力記録のヘッダー
+struct AKInputRecordHeader {
+    uint32_t magic;     ///< 識別子
+    uint16_t version;   ///< バージョン
+    uint16_t stage;     ///< 開始ステージ番号
+};
+
+/// 入力記録のイベントの種類
+enum AKInputEventType {
+    kAKInputEventMove = 1,  ///< 自機の移動(移動量x, y: float×2)
+    kAKInputEventShield,    ///< シールドボタンの操作(有効/無効: uint8_t)
+    kAKInputEventPause,     ///< 一時停止
+    kAKInputEventResume,    ///< ゲーム再開
+    kAKInputEventTick       ///< 状態更新(更新後の状態のチェックサム: uint32_t)
+};
+
+/// チェックサムの初期値
+static const uint32_t kAKChecksumInit = 2166136261u;
+
+/*!
+ @brief チェックサムの加算
+ 
+ FNV-1aハッシュでデータをチェックサムに加える。
+ 実数はビット列のまま加えるため、計算結果が1ビットでも異なれば値が変わる。
+ @param checksum 加算前のチェックサム
+ @param bytes データ
+ @param length データのバイト数
+ @return 加算後のチェックサム
+ */
+static inline uint32_t AKChecksumAdd(uint32_t checksum, const void *bytes, size_t length)
+{
+    const uint8_t *p = bytes;
+    for (size_t i = 0; i < length; i++) {
+        checksum ^= p[i];
+        checksum *= 16777619u;
+    }
+    return checksum;
+}
+
+// 入力記録クラス
+@interface AKInputRecorder : NSObject {
+    /// 記録したデータ
+    NSMutableData *data_;
+    /// 記録した状態更新の回数
+    NSInteger tickCount_;
+}
+
+/// 記録したデータ
+@property (nonatomic, readonly)NSData *data;
+/// 記録した状態更新の回数
+@property (nonatomic, readonly)NSInteger tickCount;
+
+// 初期化処理
+- (id)initWithStageNo:(NSInteger)stage;
+// 自機の移動の記録
+- (void)recordMoveDx:(float)dx dy:(float)dy;
+// シールドボタンの操作の記録
+- (void)recordShield:(BOOL)shield;
+// 一時停止の記録
+- (void)recordPause;
+// ゲーム再開の記録
+- (void)recordResume;
+// 状態更新の記録
+- (void)recordTickWithChecksum:(uint32_t)checksum;
+@end
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2013 Akihiro Kaneda.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1.Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   2.Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   3.Neither the name of the Monochrome Soft nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ @file AKInputRecorder.m
+ @brief 入力記録クラス定義
+ 
+ プレイ中の入力を状態更新単位で記録するクラスを定義する。
+ */
+
+#import "AKInputRecorder.h"
+#import "AKToritoma.h"
+
+/// 入力記録のバイナリ形式の識別子("AKIR")
+const uint32_t kAKInputRecordMagic = 0x52494B41;
+/// 入力記録のバイナリ形式のバージョン
+const uint16_t kAKInputRecordVersion = 1;
+/// 記録バッファの初期サイズ(1分間、1回の状態更新ごとに移動1回分)
+static const NSUInteger kAKInputRecordInitCapacity = 60 * 60 * 14;
+
+/*!
+ @brief 入力記録クラス
+ 
+ 自機の移動量、シールドボタンの操作、一時停止・再開を入力された順にバイナリ形式で記録する。
+ 状態更新のたびに更新後のゲームの状態のチェックサムを記録し、
+ 再生時に同じ状態になっているかを状態更新単位で検証できるようにする。
+ 各イベントは種類1バイトとそれに続くデータで構成し、数値はデバイスのバイト順で格納する。
+ */
+@implementation AKInputRecorder
+
+@synthesize data = data_;
+@synthesize tickCount = tickCount_;
+
+/*!
+ @brief 初期化処理
+ 
+ 記録バッファを確保し、ヘッダーを書き込む。
+ @param stage 開始ステージ番号
+ @return 初期化したオブジェクト。失敗時はnilを返す。
+ */
+- (id)initWithStageNo:(NSInteger)stage
+{
+    // スーパークラスの初期化処理を行う
+    self = [super init];
+    if (!self) {
+        AKLog(kAKLogInputRecorder_0, @"error");
+        return nil;
+    }
+    
+    // 記録バッファを確保する
+    data_ = [[NSMutableData alloc] initWithCapacity:kAKInputRecordInitCapacity];
+    tickCount_ = 0;
+    
+    // ヘッダーを書き込む
+    struct AKInputRecordHeader header = {kAKInputRecordMagic, kAKInputRecordVersion, (uint16_t)stage};
+    [data_ appendBytes:&header length:sizeof(header)];
+    
+    return self;
+}
+
+/*!
+ @brief インスタンス解放時処理
+ 
+ インスタンス解放時にオブジェクトを解放する。
+ */
+- (void)dealloc
+{
+    // メンバを解放する
+    [data_ release];
+    
+    // スーパークラスの解放処理
+    [super dealloc];
+}
+
+/*!
+ @brief 自機の移動の記録
+ 
+ 自機の移動量を記録する。
+ @param dx x座標の移動量
+ @param dy y座標の移動量
+ */
+- (void)recordMoveDx:(float)dx dy:(float)dy
+{
+    uint8_t type = kAKInputEventMove;
+    [data_ appendBytes:&type length:sizeof(type)];
+    [data_ appendBytes:&dx length:sizeof(dx)];
+    [data_ appendBytes:&dy length:sizeof(dy)];
+}
+
+/*!
+ @brief シールドボタンの操作の記録
+ 
+ シールドボタンの操作を記録する。
+ @param shield シールドを有効にしたかどうか
+ */
+- (void)recordShield:(BOOL)shield
+{
+    uint8_t event[2] = {kAKInputEventShield, shield ? 1 : 0};
+    [data_ appendBytes:event length:sizeof(event)];
+}
+
+/*!
+ @brief 一時停止の記録
+ 
+ 一時停止したことを記録する。
+ */
+- (void)recordPause
+{
+    uint8_t type = kAKInputEventPause;
+    [data_ appendBytes:&type length:sizeof(type)];
+}
+
+/*!
+ @brief ゲーム再開の記録
+ 
+ ゲームを再開したことを記録する。
+ */
+- (void)recordResume
+{
+    uint8_t type = kAKInputEventResume;
+    [data_ appendBytes:&type length:sizeof(type)];
+}
+
+/*!
+ @brief 状態更新の記録
+ 
+ 状態更新を1回行ったことを更新後の状態のチェックサムとともに記録する。
+ @param checksum 更新後の状態のチェックサム
+ */
+- (void)recordTickWithChecksum:(uint32_t)checksum
+{
+    uint8_t type = kAKInputEventTick;
+    [data_ appendBytes:&type length:sizeof(type)];
+    [data_ appendBytes:&checksum length:sizeof(checksum)];
+    tickCount_++;
+}
+@end
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2013 Akihiro Kaneda.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1.Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   2.Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   3.Neither the name of the Monochrome Soft nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ @file AKInputReplayer.h
+ @brief 入力再生クラス定義
+ 
+ 記録した入力をゲームデータに再入力するクラスを定義する。
+ */
+
+#import "AKInputRecorder.h"
+
+@class AKPlayData;
+
+/// チェックサムが不一致となった状態更新がない場合の値
+extern const NSInteger kAKReplayNoMismatch;
+
+// 入力再生クラス
+@interface AKInputReplayer : NSObject {
+    /// 記録したデータ
+    NSData *data_;
+    /// 次に読み込む位置
+    NSUInteger offset_;
+    /// 開始ステージ番号
+    NSInteger stage_;
+    /// 再生した状態更新の回数
+    NSInteger tickCount_;
+    /// 最初にチェックサムが不一致となった状態更新の番号
+    NSInteger mismatchTick_;
+}
+
+/// 開始ステージ番号
+@property (nonatomic, readonly)NSInteger stage;
+/// 再生した状態更新の回数
+@property (nonatomic, readonly)NSInteger tickCount;
+/// 最初にチェックサムが不一致となった状態更新の番号
+@property (nonatomic, readonly)NSInteger mismatchTick;
+
+// 初期化処理
+- (id)initWithData:(NSData *)data;
+// 再生終了判定
+- (BOOL)isEnd;
+// 状態更新1回分の再生
+- (BOOL)replayTickWithData:(AKPlayData *)playData;
+// 最後までの再生
+- (NSInteger)replayAllWithData:(AKPlayData *)playData;
+@end
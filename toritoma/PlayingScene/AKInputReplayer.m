@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2013 Akihiro Kaneda.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1.Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   2.Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   3.Neither the name of the Monochrome Soft nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ @file AKInputReplayer.m
+ @brief 入力再生クラス定義
+ 
+ 記録した入力をゲームデータに再入力するクラスを定義する。
+ */
+
+#import "AKInputReplayer.h"
+#import "AKPlayData.h"
+
+/// チェックサムが不一致となった状態更新がない場合の値
+const NSInteger kAKReplayNoMismatch = -1;
+
+/*!
+ @brief 入力再生クラス
+ 
+ 入力記録クラスで記録したデータを先頭から読み込み、
+ 記録された順に自機の移動、シールドボタンの操作、一時停止・再開をゲームデータに入力する。
+ 状態更新のイベントでゲームデータの状態更新を行い、更新後の状態のチェックサムを記録時の値と比較する。
+ */
+// プライベートメソッド宣言
+@interface AKInputReplayer ()
+// データの読み込み
+- (BOOL)readBytes:(void *)bytes length:(NSUInteger)length;
+@end
+
+@implementation AKInputReplayer
+
+@synthesize stage = stage_;
+@synthesize tickCount = tickCount_;
+@synthesize mismatchTick = mismatchTick_;
+
+/*!
+ @brief 初期化処理
+ 
+ 記録したデータのヘッダーを読み込む。
+ @param data 入力記録クラスで記録したデータ
+ @return 初期化したオブジェクト。ヘッダーが不正な場合はnilを返す。
+ */
+- (id)initWithData:(NSData *)data
+{
+    // スーパークラスの初期化処理を行う
+    self = [super init];
+    if (!self) {
+        AKLog(kAKLogInputReplayer_0, @"error");
+        return nil;
+    }
+    
+    // メンバを初期化する
+    data_ = [data retain];
+    offset_ = 0;
+    tickCount_ = 0;
+    mismatchTick_ = kAKReplayNoMismatch;
+    
+    // ヘッダーを読み込む
+    struct AKInputRecordHeader header;
+    if (![self readBytes:&header length:sizeof(header)] ||
+        header.magic != kAKInputRecordMagic ||
+        header.version != kAKInputRecordVersion) {
+        
+        AKLog(kAKLogInputReplayer_0, @"ヘッダーが不正");
+        [self release];
+        return nil;
+    }
+    
+    stage_ = header.stage;
+    
+    return self;
+}
+
+/*!
+ @brief インスタンス解放時処理
+ 
+ インスタンス解放時にオブジェクトを解放する。
+ */
+- (void)dealloc
+{
+    // メンバを解放する
+    [data_ release];
+    
+    // スーパークラスの解放処理
+    [super dealloc];
+}
+
+/*!
+ @brief データの読み込み
+ 
+ 現在の読み込み位置から指定したバイト数を読み込み、読み込み位置を進める。
+ @param bytes 読み込み先
+ @param length 読み込むバイト数
+ @return 読み込めた場合YES、データが足りない場合NO
+ */
+- (BOOL)readBytes:(void *)bytes length:(NSUInteger)length
+{
+    // データが足りない場合は読み込まない
+    if (offset_ + length > data_.length) {
+        return NO;
+    }
+    
+    // 境界が揃っていない位置から読み込むため、バイト単位でコピーする
+    memcpy(bytes, (const uint8_t *)data_.bytes + offset_, length);
+    offset_ += length;
+    
+    return YES;
+}
+
+/*!
+ @brief 再生終了判定
+ 
+ 記録したデータを最後まで読み込んだかどうかを判定する。
+ @return 最後まで読み込んだ場合YES
+ */
+- (BOOL)isEnd
+{
+    return offset_ >= data_.length;
+}
+
+/*!
+ @brief 状態更新1回分の再生
+ 
+ 次の状態更新のイベントまでの入力をゲームデータに入力し、状態更新を1回行う。
+ 更新後の状態のチェックサムを記録時の値と比較し、最初に不一致となった状態更新の番号を記憶する。
+ @param playData ゲームデータ
+ @return チェックサムが一致した場合YES、不一致またはデータの終端に達した場合NO
+ */
+- (BOOL)replayTickWithData:(AKPlayData *)playData
+{
+    uint8_t type = 0;
+    while ([self readBytes:&type length:sizeof(type)]) {
+        
+        switch (type) {
+            case kAKInputEventMove:     // 自機の移動
+            {
+                float dx = 0.0f;
+                float dy = 0.0f;
+                if (![self readBytes:&dx length:sizeof(dx)] || ![self readBytes:&dy length:sizeof(dy)]) {
+                    return NO;
+                }
+                [playData movePlayerByDx:dx dy:dy];
+                break;
+            }
+                
+            case kAKInputEventShield:   // シールドボタンの操作
+            {
+                uint8_t shield = 0;
+                if (![self readBytes:&shield length:sizeof(shield)]) {
+                    return NO;
+                }
+                [playData changeShield:(shield != 0)];
+                break;
+            }
+                
+            case kAKInputEventPause:    // 一時停止
+                [playData pause];
+                break;
+                
+            case kAKInputEventResume:   // ゲーム再開
+                [playData resume];
+                break;
+                
+            case kAKInputEventTick:     // 状態更新
+            {
+                uint32_t checksum = 0;
+                if (![self readBytes:&checksum length:sizeof(checksum)]) {
+                    return NO;
+                }
+                
+                // 状態更新を行い、チェックサムを比較する
+                [playData update];
+                BOOL isMatch = ([playData stateChecksum] == checksum);
+                
+                AKLog(kAKLogInputReplayer_0 && !isMatch, @"チェックサム不一致:tick=%d", tickCount_);
+                
+                // 最初の不一致の場合は番号を記憶する
+                if (!isMatch && mismatchTick_ == kAKReplayNoMismatch) {
+                    mismatchTick_ = tickCount_;
+                }
+                
+                tickCount_++;
+                return isMatch;
+            }
+                
+            default:
+                AKLog(kAKLogInputReplayer_0, @"不明なイベント:%d", type);
+                NSAssert(NO, @"不明なイベント");
+                offset_ = data_.length;
+                return NO;
+        }
+    }
+    
+    return NO;
+}
+
+/*!
+ @brief 最後までの再生
+ 
+ 記録したデータを最後まで再生する。
+ @param playData ゲームデータ
+ @return 最初にチェックサムが不一致となった状態更新の番号。すべて一致した場合はkAKReplayNoMismatch。
+ */
+- (NSInteger)replayAllWithData:(AKPlayData *)playData
+{
+    while (![self isEnd]) {
+        [self replayTickWithData:playData];
+    }
+    
+    return mismatchTick_;
+}
+@end
@@ -41,6 +41,10 @@ static NSString *kAKLifeMarkImageName = @"Life.png";
 static NSString *kAKLifeNumberFormat = @":%02d";
 /// 残機数表示の最大値
 static const NSInteger kAKLifeCountViewMax = 99;
+/// 残機数の桁数
+static const NSInteger kAKLifeNumberDigits = 2;
+/// 残機数の位置(先頭からの文字数)
+static const NSInteger kAKLifeNumberPosition = 1;
 /// 残機マークのサイズ
 static const NSInteger kAKLifeMarkSize = 16;
 
@@ -150,12 +154,12 @@ static const NSInteger kAKLifeMarkSize = 16;
         lifeCountView = lifeCount;
     }
     
-    // 残機文字列を作成する
-    NSString *labelStr = [NSString stringWithFormat:kAKLifeNumberFormat, lifeCountView];
-    
     // ラベルが作成されていない場合
     if (self.numberLabel == nil) {
         
+        // 残機文字列を作成する
+        NSString *labelStr = [NSString stringWithFormat:kAKLifeNumberFormat, lifeCountView];
+        
         AKLog(kAKLogLife_1, @"ラベル作成:\"%@\"", labelStr);
         
         // 残機数ラベルを作成する
@@ -167,10 +171,10 @@ static const NSInteger kAKLifeMarkSize = 16;
     // ラベルが作成されている場合
     else {
 
-        AKLog(kAKLogLife_1, @"ラベル変更:\"%@\"", labelStr);
+        AKLog(kAKLogLife_1, @"ラベル変更:%d", lifeCountView);
 
-        // 表示文字列を変更する
-        [self.numberLabel setString:labelStr];
+        // 文字列を作成せずに残機数の部分を変更する
+        [self.numberLabel setNumber:lifeCountView digits:kAKLifeNumberDigits position:kAKLifeNumberPosition];
     }
     
     AKLog(kAKLogLife_1, @"end");
@@ -36,25 +36,40 @@
 #import <Foundation/Foundation.h>
 #import <CoreGraphics/CoreGraphics.h>
 
-// n-way弾角度計算クラス
-@interface AKNWayAngle : NSObject {
-    /// 弾の角度
-    NSMutableArray *angles_;
+/// 弾の方向
+struct AKNWayDirection {
+    float angle;    ///< 角度
+    float cos;      ///< 角度の余弦(x方向の単位ベクトル)
+    float sin;      ///< 角度の正弦(y方向の単位ベクトル)
+};
+
+/*!
+ @brief 角度からの方向作成
+ 
+ 角度から弾の方向を作成する。
+ @param angle 角度
+ @return 弾の方向
+ */
+static inline struct AKNWayDirection AKNWayDirectionMake(float angle)
+{
+    struct AKNWayDirection direction = {angle, cosf(angle), sinf(angle)};
+    return direction;
 }
 
-/// 弾の角度
-@property (nonatomic, retain)NSMutableArray *angles;
-/// 1個目の弾の角度
-@property (nonatomic, readonly)float topAngle;
+// n-way弾角度計算クラス
+@interface AKNWayAngle : NSObject
 
-// 2点間指定によるn-way角度計算
-- (id)initFromSrc:(CGPoint)src dest:(CGPoint)dest count:(NSInteger)count interval:(float)interval;
-// 中心角度指定によるn-way角度計算
-- (id)initFromCenterAngle:(float)center count:(NSInteger)count interval:(float)interval;
-// 2点間指定によるn-way角度計算(コンビニエンスコンストラクタ)
-+ (id)angleFromSrc:(CGPoint)src dest:(CGPoint)dest count:(NSInteger)count interval:(float)interval;
-// 中心角度指定によるn-way角度計算(コンビニエンスコンストラクタ)
-+ (id)angleFromCenterAngle:(float)center count:(NSInteger)count interval:(float)interval;
+// 2点間指定によるn-way方向計算
++ (NSInteger)calcDirections:(struct AKNWayDirection *)directions
+                    fromSrc:(CGPoint)src
+                       dest:(CGPoint)dest
+                      count:(NSInteger)count
+                   interval:(float)interval;
+// 中心角度指定によるn-way方向計算
++ (NSInteger)calcDirections:(struct AKNWayDirection *)directions
+            fromCenterAngle:(float)center
+                      count:(NSInteger)count
+                   interval:(float)interval;
 // 2点間の角度計算
 + (float)calcDestAngleFrom:(CGPoint)src to:(CGPoint)dest;
 
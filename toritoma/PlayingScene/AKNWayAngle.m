@@ -39,159 +39,90 @@
  @brief n-way弾角度計算クラス
  
  n-way弾を作成する際の角度を計算するクラス。
+ 計算結果は呼び出し元が用意したバッファに書き込み、オブジェクトの生成は行わない。
  */
 @implementation AKNWayAngle
 
-@synthesize angles = angles_;
-
-/*!
- @brief 1個目の弾の角度
- 
- 1個目の弾の角度を取得する。
- @return 1個目の弾の角度
- */
-- (float)topAngle
-{
-    return [[angles_ objectAtIndex:0] floatValue];
-}
-
-/*!
- @brief コンビニエンスコンストラクタ
- 
- コンビニエンスコンストラクタ。
- @return 初期化したオブジェクト
- */
-+ (id)angle
-{
-    return [[[AKNWayAngle alloc] init] autorelease];
-}
-
 /*!
- @brief オブジェクト解放処理
+ @brief 2点間指定によるn-way方向計算
  
- オブジェクトの解放を行う。
- */
-- (void)dealloc
-{
-    // メンバを解放する
-    self.angles = nil;
-    
-    // スーパークラスの処理を行う
-    [super dealloc];
-}
-
-/*!
- @brief 2点間指定によるn-way角度計算
- 
- 2点の座標からn-way弾の各弾の角度を計算する。
+ 2点の座標からn-way弾の各弾の方向を計算する。
+ @param directions 計算結果を格納するバッファ(弾数分の領域が必要)
  @param src 始点
  @param dest 終点
  @param count 弾数
  @param interval 弾の間の角度
- @return 初期化したインスタンス
+ @return 計算した方向の数
  */
-- (id)initFromSrc:(CGPoint)src dest:(CGPoint)dest count:(NSInteger)count interval:(float)interval
++ (NSInteger)calcDirections:(struct AKNWayDirection *)directions
+                    fromSrc:(CGPoint)src
+                       dest:(CGPoint)dest
+                      count:(NSInteger)count
+                   interval:(float)interval
 {
     // 中心の弾の角度を計算する
     float centerAngle = [AKNWayAngle calcDestAngleFrom:src to:dest];
     
-    // 中心角からn-way角度を計算する
-    return [self initFromCenterAngle:centerAngle count:count interval:interval];
+    // 中心角からn-way方向を計算する
+    return [AKNWayAngle calcDirections:directions
+                       fromCenterAngle:centerAngle
+                                 count:count
+                              interval:interval];
 }
 
 /*!
- @brief 中心角度指定によるn-way角度計算
+ @brief 中心角度指定によるn-way方向計算
  
- 中心の弾の角度からn-way弾の各弾の角度を計算する。
+ 中心の弾の角度からn-way弾の各弾の方向を計算する。
+ 三角関数の計算は1個目の弾と弾の間の角度の2回だけ行い、
+ 2個目以降の弾は前の弾の方向を弾の間の角度分回転させて求める。
+ @param directions 計算結果を格納するバッファ(弾数分の領域が必要)
  @param center 中心角度
  @param count 弾数
  @param interval 弾の間の角度
- @return 初期化したインスタンス
+ @return 計算した方向の数
  */
-- (id)initFromCenterAngle:(float)center count:(NSInteger)count interval:(float)interval
++ (NSInteger)calcDirections:(struct AKNWayDirection *)directions
+            fromCenterAngle:(float)center
+                      count:(NSInteger)count
+                   interval:(float)interval
 {
-    // スーパークラスの初期化処理を行う
-    self = [super init];
-    if (!self) {
-        NSAssert(NO, @"インスタンスの初期化に失敗。");
-        return nil;
-    }
+    NSAssert(count > 0, @"弾数が不正");
     
-    // 角度格納用配列を生成する
-    self.angles = [NSMutableArray arrayWithCapacity:count];
-
     // 最小値の角度を計算する
     float minAngle = center - (interval * (count - 1)) / 2.0f;
-
-    // 各弾の発射角度を計算する
-    for (int i = 0; i < count; i++) {
     
-        // 弾の角度を計算する
-        float angle = minAngle + i * interval;
+    // 1個目の弾の方向を計算する
+    directions[0] = AKNWayDirectionMake(minAngle);
     
-        // NSArrayに格納するためにオブジェクトを作成する
-        NSNumber *angleObj = [NSNumber numberWithFloat:angle];
+    // 弾の間の角度の回転量を計算する
+    float stepCos = cosf(interval);
+    float stepSin = sinf(interval);
     
-        // 配列に追加する
-        [angles_ addObject:angleObj];
+    // 2個目以降の弾は前の弾の方向を回転させる
+    for (NSInteger i = 1; i < count; i++) {
+        
+        const struct AKNWayDirection *prev = &directions[i - 1];
+        
+        directions[i].angle = minAngle + i * interval;
+        directions[i].cos = prev->cos * stepCos - prev->sin * stepSin;
+        directions[i].sin = prev->sin * stepCos + prev->cos * stepSin;
     }
-
-    return self;
-}
-
-/*!
- @brief 2点間指定によるn-way角度計算(コンビニエンスコンストラクタ)
- 
- 2点の座標からn-way弾の各弾の角度を計算する。
- @param src 始点
- @param dest 終点
- @param count 弾数
- @param interval 弾の間の角度
- @return 生成したインスタンス
- */
-+ (id)angleFromSrc:(CGPoint)src dest:(CGPoint)dest count:(NSInteger)count interval:(float)interval
-{
-    return [[[AKNWayAngle alloc] initFromSrc:src dest:dest count:count interval:interval] autorelease];
-}
-
-/*!
- @brief 中心角度指定によるn-way角度計算
- 
- 中心の弾の角度からn-way弾の各弾の角度を計算する。
- @param center 中心角度
- @param count 弾数
- @param interval 弾の間の角度
- @return 生成したインスタンス
- */
-+ (id)angleFromCenterAngle:(float)center count:(NSInteger)count interval:(float)interval
-{
-    return [[[AKNWayAngle alloc] initFromCenterAngle:center count:count interval:interval] autorelease];
+    
+    return count;
 }
 
 /*!
  @brief 2点間の角度計算
  
  2点間を線で結んだときの角度を計算する。
- @param srcx 始点
+ @param src 始点
  @param dest 終点
  @return 2点間の角度
  */
 + (float)calcDestAngleFrom:(CGPoint)src to:(CGPoint)dest
 {
-    // x方向のベクトルの大きさを計算する
-    float vx = dest.x - src.x;
-    
-    // y方向のベクトルの大きさを計算する
-    float vy = dest.y - src.y;
-
-    // 角度を計算する
-    float angle = atan(vy / vx);
-    
-    // 第2象限、第3象限の場合はπ進める
-    if (vx < 0.0f) {
-        angle += M_PI;
-    }
-        
-    return angle;
+    // 象限を考慮して角度を計算する
+    return atan2f(dest.y - src.y, dest.x - src.x);
 }
 @end
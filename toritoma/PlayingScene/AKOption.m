@@ -43,26 +43,43 @@ static const NSInteger kAKOptionAnimationCountOfShieldOff = 2;
 static const NSInteger kAKOptionAnimationCountOfShieldOn = 1;
 /// 弾発射の間隔
 static const NSInteger kAKOptionShotInterval = 12;
-/// オプション間の距離
-static const NSInteger kAKOptionSpace = 20;
 /// オプションの当たり判定
 static const NSInteger kAKOptionSize = 16;
 
+/// シールド有無ごとの画像名(0:シールドなし、1:シールドあり)
+static NSString *imageNames_[2];
+
+/*!
+ @brief オプションクラス
+ 
+ 自機に付属するオプションを管理する。
+ オプションの移動座標は自機の移動履歴から自機が設定するため、オプション自身は移動座標を持たない。
+ */
 @implementation AKOption
 
-@synthesize movePositions = movePositions_;
 @synthesize shield = shield_;
 
+/*!
+ @brief クラス初期化処理
+ 
+ シールドの切り替えのたびに画像名の文字列を作成しないように、画像名を最初に1回だけ作成しておく。
+ */
++ (void)initialize
+{
+    if (self == [AKOption class]) {
+        imageNames_[0] = [[NSString alloc] initWithFormat:kAKOptionImageFile, 1];
+        imageNames_[1] = [[NSString alloc] initWithFormat:kAKOptionImageFile, 2];
+    }
+}
+
 /*!
  @brief オブジェクト生成処理
  
  オブジェクトの生成を行う。
- 指定されたオプションの個数分を再帰的に生成する。
- @param count オプションの個数
  @param parent 画像を配置する親ノード
  @return 生成したオブジェクト。失敗時はnilを返す。
  */
-- (id)initWithOptionCount:(NSInteger)count parent:(CCNode *)parent
+- (id)initWithParent:(CCNode *)parent
 {
     // スーパークラスの生成処理
     self = [super init];
@@ -74,14 +91,11 @@ static const NSInteger kAKOptionSize = 16;
     self.animationPattern = kAKOptionAnimationCountOfShieldOff;
     
     // 画像名を設定する
-    self.imageName = [NSString stringWithFormat:kAKOptionImageFile, 1];
+    self.imageName = imageNames_[0];
     
     // 弾発射までの残りフレーム数を設定する
     shootFrame_ = kAKOptionShotInterval;
     
-    // 移動座標を保存する配列を作成する
-    self.movePositions = [NSMutableArray arrayWithCapacity:kAKOptionSpace];
-    
     // ヒットポイントは1としておく
     self.hitPoint = 1;
     
@@ -100,34 +114,14 @@ static const NSInteger kAKOptionSize = 16;
     // 画像を親ノードに配置する
     [parent addChild:self.image];
     
-    // オプション個数が指定されている場合は次のオプションを生成する
-    if (count > 0) {
-        self.next = [[[AKOption alloc] initWithOptionCount:count - 1 parent:parent] autorelease];
-    }
-    
     return self;
 }
 
-/*!
- @brief インスタンス解放時処理
- 
- インスタンス解放時にメンバを解放する。
- */
-- (void)dealloc
-{
-    // メンバを解放する
-    self.movePositions = nil;
-    
-    // スーパークラスの解放処理
-    [super dealloc];
-}
-
 /*!
  @brief シールド有無設定
  
  シールド有無を設定する。
  画像の切り替えも行う。
- 次のオプションに対しても同様の設定を行う。
  @param shield シールド有無
  */
 - (void)setShield:(BOOL)shield
@@ -141,7 +135,7 @@ static const NSInteger kAKOptionSize = 16;
         AKLog(kAKLogOption_1, @"シールドあり");
         
         // 画像名を設定する
-        self.imageName = [NSString stringWithFormat:kAKOptionImageFile, 2];
+        self.imageName = imageNames_[1];
         
         // アニメーションフレームの個数を設定する
         self.animationPattern = kAKOptionAnimationCountOfShieldOn;
@@ -151,23 +145,17 @@ static const NSInteger kAKOptionSize = 16;
         AKLog(kAKLogOption_1, @"シールドなし");
 
         // 画像名を設定する
-        self.imageName = [NSString stringWithFormat:kAKOptionImageFile, 1];
+        self.imageName = imageNames_[0];
         
         // アニメーションフレームの個数を設定する
         self.animationPattern = kAKOptionAnimationCountOfShieldOff;
     }
-    
-    // 次のオプションがある場合は次のオプションにも設定する
-    if (self.next != nil) {
-        self.next.shield = shield;
-    }
 }
 
 /*!
  @brief キャラクター固有の動作
  
- 速度によって位置を移動する。オプションの表示位置は固定とする。
- 次のオプションの移動を行う。
+ 一定間隔で自機弾を発射する。移動は自機が移動座標を設定することで行う。
  @param data ゲームデータ
  */
 - (void)action:(id<AKPlayDataInterface>)data
@@ -184,122 +172,94 @@ static const NSInteger kAKOptionSize = 16;
         // 弾発射までの残り時間をリセットする
         shootFrame_ = kAKOptionShotInterval;
     }
-    
-    // 次のオプションの移動を行う
-    if (self.next != nil) {
-        [self.next move:data];
-    }
 }
 
 /*!
- @brief 衝突処理
+ @brief 配置
  
- 衝突した時の処理。
- 反射弾を作成後、相手のHPを0にする。
- @param character 衝突した相手
- @param data ゲームデータ
+ 配置されていない場合は配置状態にして、初期配置位置に移動する。
+ @param x 初期配置位置x座標
+ @param y 初期配置位置y座標
  */
-- (void)hit:(AKCharacter *)character data:(id<AKPlayDataInterface>)data
+- (void)stageAtX:(float)x y:(float)y
 {
-    AKLog(kAKLogOption_1, @"反射処理開始");
+    // 配置済みの場合は処理しない
+    if (self.isStaged) {
+        return;
+    }
     
-    // 衝突したものが敵弾以外の場合はエラー
-    NSAssert([character isKindOfClass:[AKEnemyShot class]], @"不正なオブジェクトと衝突");
+    AKLog(kAKLogOption_1, @"オプション配置");
     
-    // 反射弾を作成する
-    [data createReflectiedShot:(AKEnemyShot *)character];
+    self.isStaged = YES;
+    self.image.visible = YES;
+    self.positionX = x;
+    self.positionY = y;
     
-    // 相手のHPを0にする
-    character.hitPoint = 0;
+    // 初期表示時に前回の位置に表示されることを防ぐため、画像表示位置の更新も行う
+    [self updateImagePosition];
 }
 
 /*!
- @brief 移動座標設定
+ @brief 配置解除
  
- 移動座標を設定する。オプションが付属している場合はオプションの移動も行う。
- @param x 移動先x座標
- @param y 移動先y座標
+ 配置されている場合は配置状態を解除する。
  */
-- (void)setPositionX:(float)x y:(float)y
+- (void)unstage
 {
-    // オプションに自分の移動前の座標を通知する
-    if (self.next != nil && self.next.isStaged) {
-        [self.next setPositionX:self.positionX y:self.positionY];
+    // 配置されていない場合は処理しない
+    if (!self.isStaged) {
+        return;
     }
     
-    // 移動先座標が間隔分溜まっている場合は先頭の座標に移動する
-    if (self.movePositions.count >= kAKOptionSpace) {
-        
-        // 先頭の要素を取得する
-        NSData *data = [self.movePositions objectAtIndex:0];
-        
-        // 取得した要素を配列から取り除く
-        [self.movePositions removeObjectAtIndex:0];
-        
-        // 先頭の要素から座標情報を取得する
-        CGPoint point;
-        [data getBytes:&point length:sizeof(point)];
-        
-        // 座標を移動する
-        self.positionX = point.x;
-        self.positionY = point.y;
-    }
-    
-    // 移動先座標の構造体を作成する
-    CGPoint newPoint = ccp(x, y);
+    AKLog(kAKLogOption_1, @"オプション削除");
     
-    // 配列に格納するために座標オブジェクトを作成する
-    NSData *newData = [NSData dataWithBytes:&newPoint length:sizeof(newPoint)];
-    
-    // 移動先座標の配列の末尾に追加する
-    [self.movePositions addObject:newData];
+    self.isStaged = NO;
+    self.image.visible = NO;
 }
 
 /*!
- @brief オプション数設定
+ @brief 画像表示位置更新(補間あり)
  
- オプションの個数を設定する。
- 1以上が設定された場合は自分を配置状態に設定する。
- 0以下が設定された場合は自分を配置状態から外す。
- 次のオプションが存在する場合は個数を一つ減らして再帰的に呼び出す。
- @param count オプション個数
- @param x 初期配置位置x座標
- @param y 初期配置位置y座標
+ オプションは自機の移動に合わせて移動するため、補間を行わずに現在の座標に表示する。
+ @param alpha 補間の割合(使用しない)
  */
-- (void)setOptionCount:(NSInteger)count x:(float)x y:(float)y
+- (void)updateImagePositionWithAlpha:(float)alpha
 {
-    AKLog(kAKLogOption_1, @"count=%d", count);
+    // 現在の座標に表示する
+    [self updateImagePosition];
+}
+
+/*!
+ @brief 状態の保存
+ 
+ キャラクター共通の状態に続けて、オプション固有の状態を保存する。
+ @param snapshot 保存先
+ */
+- (void)writeSnapshot:(AKSnapshot *)snapshot
+{
+    // スーパークラスの処理を行う
+    [super writeSnapshot:snapshot];
     
-    // オプション個数が設定された場合はオプションを有効とする
-    if (count > 0) {
-        
-        // 配置されていない場合は配置状態にして、初期配置位置に移動する
-        if (!self.isStaged) {
-            AKLog(kAKLogOption_1, @"オプション配置");
-            self.isStaged = YES;
-            self.image.visible = YES;
-            self.positionX = x;
-            self.positionY = y;
-            // 初期表示時に前回の位置に表示されることを防ぐため、画像表示位置の更新も行う
-            [self updateImagePosition];
-        }
-    }
-    // オプション個数が0以下の場合はオプションを無効とする
-    else {
-        
-        // 配置されている場合は配置状態を解除して、移動座標をすべてクリアする
-        if (self.isStaged) {
-            AKLog(kAKLogOption_1, @"オプション削除");
-            self.isStaged = NO;
-            self.image.visible = NO;
-            [self.movePositions removeAllObjects];
-        }
-    }
+    NSInteger values[] = {shootFrame_, shield_};
+    [snapshot writeBytes:values length:sizeof(values)];
+}
+
+/*!
+ @brief 状態の復元
+ 
+ キャラクター共通の状態に続けて、オプション固有の状態を復元する。
+ シールド有無による画像の切り替えはキャラクター共通の状態で復元済みのため、メンバのみ設定する。
+ @param snapshot 読み込み元
+ */
+- (void)readSnapshot:(AKSnapshot *)snapshot
+{
+    // スーパークラスの処理を行う
+    [super readSnapshot:snapshot];
     
-    // 自分の座標を初期座標として次のオプションを設定する
-    if (self.next != nil) {
-        [self.next setOptionCount:count - 1 x:self.positionX y:self.positionY];
-    }
+    NSInteger values[2];
+    [snapshot readBytes:values length:sizeof(values)];
+    shootFrame_ = values[0];
+    shield_ = values[1];
 }
 
 @end
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2013 Akihiro Kaneda.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1.Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   2.Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   3.Neither the name of the Monochrome Soft nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ @file AKParallelRunner.h
+ @brief 並列実行クラス定義
+ 
+ 複数のゲームデータを画面なしで並列に実行するクラスを定義する。
+ */
+
+#import "AKToritoma.h"
+
+/// 並列実行の1回分の結果
+struct AKParallelRunResult {
+    NSInteger stage;                ///< 開始ステージ番号
+    NSInteger tickCount;            ///< 実行した状態更新の回数
+    NSTimeInterval elapsedTime;     ///< 状態更新にかかった時間の合計(秒)
+    NSInteger score;                ///< 終了時のスコア
+    NSInteger life;                 ///< 終了時の残機
+    uint32_t checksum;              ///< 終了時の状態のチェックサム
+    NSInteger mismatchTick;         ///< 入力再生でチェックサムが不一致となった状態更新の番号
+};
+
+// 並列実行クラス
+@interface AKParallelRunner : NSObject {
+    /// 実行結果
+    struct AKParallelRunResult *results_;
+    /// 実行した回数
+    NSInteger runCount_;
+    /// 全体の実行にかかった時間(秒)
+    NSTimeInterval wallTime_;
+}
+
+/// 実行した回数
+@property (nonatomic, readonly)NSInteger runCount;
+/// 全体の実行にかかった時間(秒)
+@property (nonatomic, readonly)NSTimeInterval wallTime;
+
+// ステージの並列実行
+- (void)runStage:(NSInteger)stage tickCount:(NSInteger)tickCount runCount:(NSInteger)runCount;
+// 入力記録の並列再生
+- (void)runReplays:(NSArray *)replays;
+// 実行結果取得
+- (const struct AKParallelRunResult *)resultAtIndex:(NSInteger)index;
+// 状態更新の合計回数取得
+- (NSInteger)totalTickCount;
+// 1秒あたりの状態更新回数取得
+- (double)ticksPerSecond;
+// 実行結果の文字列作成
+- (NSString *)summary;
+// ステージの並列実行
++ (NSString *)runStage:(NSInteger)stage tickCount:(NSInteger)tickCount runCount:(NSInteger)runCount;
+@end
@@ -0,0 +1,307 @@
+/*
+ * Copyright (c) 2013 Akihiro Kaneda.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1.Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   2.Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   3.Neither the name of the Monochrome Soft nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ @file AKParallelRunner.m
+ @brief 並列実行クラス定義
+ 
+ 複数のゲームデータを画面なしで並列に実行するクラスを定義する。
+ */
+
+#import "AKParallelRunner.h"
+#import "AKHeadlessRunner.h"
+#import "AKInputReplayer.h"
+
+/// 画面なし実行時の画面サイズ(画面なし実行クラスと合わせる)
+static const CGSize kAKParallelScreenSize = {480, 320};
+
+/*!
+ @brief 並列実行クラス
+ 
+ 画面なし実行クラスを実行1回につき1個作成し、GCDのグローバルキューで並列に実行する。
+ 各実行はゲームデータを個別に持ち、実行中に共有するのは読み込み済みの画像サイズなどの参照のみとする。
+ 画像不使用モードと固定画面サイズは実行開始前に設定し、実行中は書き換えない。
+ ステージの実行では、実行番号ごとに移動パターンをずらした自機の移動を入力する。
+ */
+// プライベートメソッド宣言
+@interface AKParallelRunner ()
+// 実行結果のバッファ確保
+- (void)prepareResults:(NSInteger)runCount;
+// 並列実行
+- (void)runWithBlock:(void (^)(NSInteger index, struct AKParallelRunResult *result))block;
+@end
+
+@implementation AKParallelRunner
+
+@synthesize runCount = runCount_;
+@synthesize wallTime = wallTime_;
+
+/*!
+ @brief インスタンス解放時処理
+ 
+ インスタンス解放時に実行結果のバッファを解放する。
+ */
+- (void)dealloc
+{
+    // 実行結果のバッファを解放する
+    free(results_);
+    
+    // スーパークラスの解放処理
+    [super dealloc];
+}
+
+/*!
+ @brief ステージの並列実行
+ 
+ 指定したステージを指定した回数だけ並列に実行する。
+ 自機は実行番号ごとに異なる移動パターンで動かす。
+ @param stage ステージ番号
+ @param tickCount 1回の実行で行う状態更新の回数
+ @param runCount 実行する回数
+ */
+- (void)runStage:(NSInteger)stage tickCount:(NSInteger)tickCount runCount:(NSInteger)runCount
+{
+    [self prepareResults:runCount];
+    
+    [self runWithBlock:^(NSInteger index, struct AKParallelRunResult *result) {
+        
+        AKHeadlessRunner *runner = [[AKHeadlessRunner alloc] initWithStageNo:stage];
+        
+        // 実行番号で移動パターンをずらしながら状態更新を行う
+        for (NSInteger i = 0; i < tickCount; i++) {
+            [runner.data movePlayerByDx:((i + index) % 7) - 3.0f dy:((i + index * 3) % 5) - 2.0f];
+            [runner runTicks:1];
+        }
+        
+        // 実行結果を記録する
+        result->stage = stage;
+        result->tickCount = runner.tickCount;
+        result->elapsedTime = runner.elapsedTime;
+        result->score = runner.data.score;
+        result->life = runner.data.life;
+        result->checksum = [runner.data stateChecksum];
+        result->mismatchTick = kAKReplayNoMismatch;
+        
+        [runner release];
+    }];
+}
+
+/*!
+ @brief 入力記録の並列再生
+ 
+ 入力記録のデータをそれぞれ別のゲームデータで並列に再生する。
+ ヘッダーが不正なデータは実行せず、状態更新の回数を0として記録する。
+ @param replays 入力記録のデータの配列
+ */
+- (void)runReplays:(NSArray *)replays
+{
+    [self prepareResults:replays.count];
+    
+    [self runWithBlock:^(NSInteger index, struct AKParallelRunResult *result) {
+        
+        // 入力記録を読み込む
+        AKInputReplayer *replayer = [[AKInputReplayer alloc] initWithData:[replays objectAtIndex:index]];
+        if (replayer == nil) {
+            AKLog(kAKLogParallelRunner_0, @"入力記録が不正:index=%d", index);
+            result->mismatchTick = kAKReplayNoMismatch;
+            return;
+        }
+        
+        // 記録開始時のステージから再生する
+        AKHeadlessRunner *runner = [[AKHeadlessRunner alloc] initWithStageNo:replayer.stage];
+        
+        // 実行結果を記録する
+        result->mismatchTick = [runner runReplay:replayer];
+        result->stage = replayer.stage;
+        result->tickCount = runner.tickCount;
+        result->elapsedTime = runner.elapsedTime;
+        result->score = runner.data.score;
+        result->life = runner.data.life;
+        result->checksum = [runner.data stateChecksum];
+        
+        [runner release];
+        [replayer release];
+    }];
+}
+
+/*!
+ @brief 実行結果取得
+ 
+ 指定した実行番号の実行結果を取得する。
+ @param index 実行番号
+ @return 実行結果
+ */
+- (const struct AKParallelRunResult *)resultAtIndex:(NSInteger)index
+{
+    NSAssert(index >= 0 && index < runCount_, @"実行番号が範囲外");
+    return &results_[index];
+}
+
+/*!
+ @brief 状態更新の合計回数取得
+ 
+ 全実行の状態更新の回数の合計を取得する。
+ @return 状態更新の合計回数
+ */
+- (NSInteger)totalTickCount
+{
+    NSInteger total = 0;
+    for (NSInteger i = 0; i < runCount_; i++) {
+        total += results_[i].tickCount;
+    }
+    return total;
+}
+
+/*!
+ @brief 1秒あたりの状態更新回数取得
+ 
+ 全実行の状態更新の合計回数を全体の実行時間で割り、並列実行全体での処理速度を求める。
+ @return 1秒あたりの状態更新回数
+ */
+- (double)ticksPerSecond
+{
+    if (wallTime_ <= 0.0) {
+        return 0.0;
+    }
+    return [self totalTickCount] / wallTime_;
+}
+
+/*!
+ @brief 実行結果の文字列作成
+ 
+ 全体の処理速度を1行目に、各実行の結果を2行目以降に1行ずつ出力する。
+ @return 実行結果の文字列
+ */
+- (NSString *)summary
+{
+    // 各実行の処理時間の合計から並列化の効果を計算する
+    NSTimeInterval elapsedTotal = 0.0;
+    for (NSInteger i = 0; i < runCount_; i++) {
+        elapsedTotal += results_[i].elapsedTime;
+    }
+    double speedup = (wallTime_ > 0.0) ? elapsedTotal / wallTime_ : 0.0;
+    
+    NSMutableString *summary = [NSMutableString stringWithFormat:@"runs=%d cpus=%u ticks=%d wall=%.3fms ticksPerSec=%.0f speedup=%.2f\n",
+                                runCount_,
+                                [[NSProcessInfo processInfo] activeProcessorCount],
+                                [self totalTickCount],
+                                wallTime_ * 1000.0,
+                                [self ticksPerSecond],
+                                speedup];
+    
+    for (NSInteger i = 0; i < runCount_; i++) {
+        const struct AKParallelRunResult *result = &results_[i];
+        [summary appendFormat:@"run=%d stage=%d ticks=%d time=%.3fms score=%d life=%d checksum=%08x mismatchTick=%d\n",
+         i,
+         result->stage,
+         result->tickCount,
+         result->elapsedTime * 1000.0,
+         result->score,
+         result->life,
+         result->checksum,
+         result->mismatchTick];
+    }
+    
+    return summary;
+}
+
+/*!
+ @brief ステージの並列実行
+ 
+ 指定したステージを画面なしで並列に実行し、実行結果の文字列を返す。
+ @param stage ステージ番号
+ @param tickCount 1回の実行で行う状態更新の回数
+ @param runCount 実行する回数
+ @return 実行結果の文字列
+ */
++ (NSString *)runStage:(NSInteger)stage tickCount:(NSInteger)tickCount runCount:(NSInteger)runCount
+{
+    AKParallelRunner *runner = [[[AKParallelRunner alloc] init] autorelease];
+    
+    [runner runStage:stage tickCount:tickCount runCount:runCount];
+    
+    return [runner summary];
+}
+
+/*!
+ @brief 実行結果のバッファ確保
+ 
+ 前回の実行結果を破棄し、実行回数分の実行結果のバッファを0で初期化して確保する。
+ @param runCount 実行する回数
+ */
+- (void)prepareResults:(NSInteger)runCount
+{
+    free(results_);
+    results_ = calloc(MAX(runCount, 1), sizeof(struct AKParallelRunResult));
+    runCount_ = runCount;
+    wallTime_ = 0.0;
+}
+
+/*!
+ @brief 並列実行
+ 
+ 実行回数分のブロックをGCDのグローバルキューで並列に実行し、全体の実行時間を計測する。
+ 実行前に共有する画像サイズの読み込みと、画像不使用モード・固定画面サイズの設定を行い、
+ 実行中は共有の状態が書き換えられないようにする。
+ 実行1回ごとに自動解放プールを作成し、一時オブジェクトが実行の終了まで残らないようにする。
+ @param block 実行するブロック(実行番号と結果の格納先を受け取る)
+ */
+- (void)runWithBlock:(void (^)(NSInteger index, struct AKParallelRunResult *result))block
+{
+    // 画像不使用モードにして画面サイズを固定する
+    BOOL prevHeadless = [AKCharacter isHeadless];
+    CGSize prevScreenSize = [AKScreenSize fixedScreenSize];
+    [AKCharacter setHeadless:YES];
+    [AKScreenSize setFixedScreenSize:kAKParallelScreenSize];
+    
+    // 共有する画像サイズを実行前に読み込んでおく
+    [AKCharacter addImageSizesWithFile:kAKTextureAtlasDefFile];
+    
+    AKLog(kAKLogParallelRunner_1, @"start runCount=%d", runCount_);
+    
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    
+    struct AKParallelRunResult *results = results_;
+    dispatch_apply(runCount_, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t index) {
+        
+        NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
+        
+        block(index, &results[index]);
+        
+        [pool release];
+    });
+    
+    wallTime_ = CFAbsoluteTimeGetCurrent() - start;
+    
+    AKLog(kAKLogParallelRunner_1, @"end wallTime=%f", wallTime_);
+    
+    // 画像不使用モードと画面サイズを元に戻す
+    [AKCharacter setHeadless:prevHeadless];
+    [AKScreenSize setFixedScreenSize:prevScreenSize];
+}
+@end
@@ -37,12 +37,20 @@
 #import "AKPlayingScene.h"
 #import "AKPlayer.h"
 #import "AKTileMap.h"
+#import "AKStagePrefetcher.h"
 #import "AKCharacterPool.h"
+#import "AKCollisionGrid.h"
 #import "AKEnemyShot.h"
+#import "AKEnemyShotEngine.h"
+#import "AKFrameProfiler.h"
+#import "AKInputRecorder.h"
 #import "AKPlayDataInterface.h"
 
 @class AKPlayingScene;
 
+/// キャラクターテクスチャアトラス定義ファイル名
+extern NSString *kAKTextureAtlasDefFile;
+
 // ゲームデータ
 @interface AKPlayData : NSObject<AKPlayDataInterface> {
     /// シーンクラス(弱い参照)
@@ -61,6 +69,8 @@
     NSInteger hiScore_;
     /// スクリプト情報
     AKTileMap *tileMap_;
+    /// 次のステージの先読み
+    AKStagePrefetcher *prefetcher_;
     /// 自機
     AKPlayer *player_;
     /// 自機弾プール
@@ -69,12 +79,22 @@
     AKCharacterPool *reflectedShotPool_;
     /// 敵キャラプール
     AKCharacterPool *enemyPool_;
-    /// 敵弾プール
-    AKCharacterPool *enemyShotPool_;
+    /// 敵弾エンジン
+    AKEnemyShotEngine *enemyShotEngine_;
     /// 画面効果プール
     AKCharacterPool *effectPool_;
     /// 障害物プール
     AKCharacterPool *blockPool_;
+    /// 自機弾当たり判定グリッド
+    AKCollisionGrid *playerShotGrid_;
+    /// 反射弾当たり判定グリッド
+    AKCollisionGrid *reflectedShotGrid_;
+    /// 敵キャラ当たり判定グリッド
+    AKCollisionGrid *enemyGrid_;
+    /// 障害物当たり判定グリッド
+    AKCollisionGrid *blockGrid_;
+    /// 障害物当たり判定グリッドの再構築が必要かどうか
+    BOOL isBlockGridDirty_;
     /// キャラクター配置バッチノード
     NSMutableArray *batches_;
     /// シールドモード
@@ -83,14 +103,28 @@
     float scrollSpeedX_;
     /// y軸方向のスクロールスピード
     float scrollSpeedY_;
+    /// フレームプロファイラ
+    AKFrameProfiler *profiler_;
+    /// 入力記録
+    AKInputRecorder *recorder_;
+    /// スコア表示の更新が必要かどうか
+    BOOL isScoreDirty_;
+    /// 残機表示の更新が必要かどうか
+    BOOL isLifeDirty_;
+    /// 表示中のチキンゲージ(未表示の場合は負の値)
+    NSInteger displayedChickenGauge_;
 }
 
 /// シーンクラス(弱い参照)
 @property (nonatomic, readonly)AKPlayingScene *scene;
 /// 残機
 @property (nonatomic)NSInteger life;
+/// スコア
+@property (nonatomic, readonly)NSInteger score;
 /// スクリプト情報
 @property (nonatomic, retain)AKTileMap *tileMap;
+/// 次のステージの先読み
+@property (nonatomic, retain)AKStagePrefetcher *prefetcher;
 /// 自機
 @property (nonatomic, retain)AKPlayer *player;
 /// 自機弾プール
@@ -99,12 +133,20 @@
 @property (nonatomic, retain)AKCharacterPool *refrectedShotPool;
 /// 敵キャラプール
 @property (nonatomic, retain)AKCharacterPool *enemyPool;
-/// 敵弾プール
-@property (nonatomic, retain)AKCharacterPool *enemyShotPool;
+/// 敵弾エンジン
+@property (nonatomic, retain)AKEnemyShotEngine *enemyShotEngine;
 /// 画面効果プール
 @property (nonatomic, retain)AKCharacterPool *effectPool;
 /// 障害物プール
 @property (nonatomic, retain)AKCharacterPool *blockPool;
+/// 自機弾当たり判定グリッド
+@property (nonatomic, retain)AKCollisionGrid *playerShotGrid;
+/// 反射弾当たり判定グリッド
+@property (nonatomic, retain)AKCollisionGrid *reflectedShotGrid;
+/// 敵キャラ当たり判定グリッド
+@property (nonatomic, retain)AKCollisionGrid *enemyGrid;
+/// 障害物当たり判定グリッド
+@property (nonatomic, retain)AKCollisionGrid *blockGrid;
 /// キャラクター配置バッチノード
 @property (nonatomic, retain)NSMutableArray *batches;
 /// シールドモード
@@ -113,6 +155,10 @@
 @property (nonatomic)float scrollSpeedX;
 /// y軸方向のスクロールスピード
 @property (nonatomic)float scrollSpeedY;
+/// フレームプロファイラ(計測しない場合はnil)
+@property (nonatomic, retain)AKFrameProfiler *profiler;
+/// 入力記録(記録しない場合はnil)
+@property (nonatomic, retain)AKInputRecorder *recorder;
 
 // オブジェクト初期化処理
 - (id)initWithScene:(AKPlayingScene *)scene;
@@ -122,14 +168,34 @@
 - (void)clearPlayData;
 // スクリプト読み込み
 - (void)readScript:(NSInteger)stage;
+// ステージパックからのスクリプト読み込み
+- (void)readScript:(NSInteger)stage stagePack:(AKStagePack *)stagePack;
 // ハイスコアファイル読込
 - (void)readHiScore;
 // ハイスコアファイル書込
 - (void)writeHiScore;
+// プロファイル結果書込
+- (void)writeProfile;
+// 入力記録書込
+- (void)writeInputRecord;
 // 状態更新
 - (void)update;
+// 当たり判定グリッド再構築
+- (void)rebuildCollisionGrid;
+// 画像表示位置更新
+- (void)updateImagePositionWithAlpha:(float)alpha;
+// 情報表示更新
+- (void)updateHUD;
 // 自機の移動
 - (void)movePlayerByDx:(float)dx dy:(float)dy;
+// シールドボタンの操作
+- (void)changeShield:(BOOL)shield;
+// 状態のチェックサム計算
+- (uint32_t)stateChecksum;
+// 状態の保存
+- (void)writeSnapshot:(AKSnapshot *)snapshot;
+// 状態の復元
+- (BOOL)readSnapshot:(AKSnapshot *)snapshot;
 // ツイートメッセージの作成
 - (NSString *)makeTweet;
 // ポーズ
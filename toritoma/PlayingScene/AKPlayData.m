@@ -49,7 +49,9 @@ static const NSInteger kAKMaxPlayerShotCount = 128;
 /// 敵キャラの同時出現最大数
 static const NSInteger kAKMaxEnemyCount = 32;
 /// 敵弾の同時出現最大数
-static const NSInteger kAKMaxEnemyShotCount = 256;
+static const NSInteger kAKMaxEnemyShotCount = 4096;
+/// 反射弾の同時出現最大数
+static const NSInteger kAKMaxReflectedShotCount = 256;
 /// 画面効果の同時出現最大数
 static const NSInteger kAKMaxEffectCount = 64;
 /// 障害物の同時出現最大数
@@ -76,6 +78,20 @@ static const NSInteger kAKStageCount = 5;
 static NSString *kAKGameClearTweetKey = @"GameClearTweet";
 /// ゲームオーバー時のツイートのフォーマットのキー
 static NSString *kAKGameOverTweetKey = @"GameOverTweet";
+/// フレームプロファイラのCSVファイル名
+static NSString *kAKProfileCSVFileName = @"profile.csv";
+/// フレームプロファイラのChromeトレースファイル名
+static NSString *kAKProfileTraceFileName = @"profile.json";
+/// 入力記録ファイル名
+static NSString *kAKInputRecordFileName = @"input.dat";
+#ifdef DEBUG
+/// フレームプロファイラを使用するかどうか
+static const BOOL kAKUseProfiler = NO;
+/// フレームプロファイラで保持するフレーム数
+static const NSInteger kAKProfilerFrameCount = 600;
+/// 入力を記録するかどうか
+static const BOOL kAKUseInputRecorder = NO;
+#endif
 
 /// キャラクター配置のz座標
 enum AKCharacterPositionZ {
@@ -93,23 +109,43 @@ enum AKCharacterPositionZ {
  @brief ゲームデータ
  
  プレイ画面のゲームデータを管理する。
+ キャラクターが画像不使用モードの場合はテクスチャとバッチノードを作成せず、
+ シーンなしで状態更新のみを実行できるようにする。
  */
+// プライベートメソッド宣言
+@interface AKPlayData ()
+// z座標に対応するバッチノード取得
+- (CCNode *)batchAtPositionZ:(enum AKCharacterPositionZ)z;
+// キャラクターの状態のチェックサム加算
+- (uint32_t)addChecksum:(uint32_t)checksum character:(AKCharacter *)character;
+// キャラクタープールの状態のチェックサム加算
+- (uint32_t)addChecksum:(uint32_t)checksum pool:(AKCharacterPool *)pool;
+@end
+
 @implementation AKPlayData
 
 @synthesize scene = scene_;
 @synthesize life = life_;
+@synthesize score = score_;
 @synthesize tileMap = tileMap_;
+@synthesize prefetcher = prefetcher_;
 @synthesize player = player_;
 @synthesize playerShotPool = playerShotPool_;
 @synthesize refrectedShotPool = reflectedShotPool_;
 @synthesize enemyPool = enemyPool_;
-@synthesize enemyShotPool = enemyShotPool_;
+@synthesize enemyShotEngine = enemyShotEngine_;
 @synthesize effectPool = effectPool_;
 @synthesize blockPool = blockPool_;
+@synthesize playerShotGrid = playerShotGrid_;
+@synthesize reflectedShotGrid = reflectedShotGrid_;
+@synthesize enemyGrid = enemyGrid_;
+@synthesize blockGrid = blockGrid_;
 @synthesize batches = batches_;
 @synthesize shield = shield_;
 @synthesize scrollSpeedX = scrollSpeedX_;
 @synthesize scrollSpeedY = scrollSpeedY_;
+@synthesize profiler = profiler_;
+@synthesize recorder = recorder_;
 
 #pragma mark オブジェクト初期化
 
@@ -134,8 +170,14 @@ enum AKCharacterPositionZ {
     // シーンをメンバに設定する
     scene_ = scene;
     
+    // 画像不使用モードの場合はテクスチャの代わりに画像サイズのみ読み込む
+    if ([AKCharacter isHeadless]) {
+        [AKCharacter addImageSizesWithFile:kAKTextureAtlasDefFile];
+    }
     // テクスチャアトラスを読み込む
-    [[CCSpriteFrameCache sharedSpriteFrameCache] addSpriteFramesWithFile:kAKTextureAtlasDefFile textureFilename:kAKTextureAtlasFile];
+    else {
+        [[CCSpriteFrameCache sharedSpriteFrameCache] addSpriteFramesWithFile:kAKTextureAtlasDefFile textureFilename:kAKTextureAtlasFile];
+    }
     
     // メンバオブジェクトを生成する
     [self createMember];
@@ -158,39 +200,60 @@ enum AKCharacterPositionZ {
     self.batches = [NSMutableArray arrayWithCapacity:kAKCharaPosZCount];
     
     // 各z座標用にバッチノードを作成する
-    for (int i = 0; i < kAKCharaPosZCount; i++) {
-        
-        // バッチノードをファイルから作成する
-        CCSpriteBatchNode *batch = [CCSpriteBatchNode batchNodeWithFile:kAKTextureAtlasFile];
-        
-        // 配列に保存する
-        [self.batches addObject:batch];
-        
-        // シーンに配置する
-        [self.scene.characterLayer addChild:batch z:i];
+    // 画像不使用モードの場合は作成しない
+    if (![AKCharacter isHeadless]) {
+        for (int i = 0; i < kAKCharaPosZCount; i++) {
+            
+            // バッチノードをファイルから作成する
+            CCSpriteBatchNode *batch = [CCSpriteBatchNode batchNodeWithFile:kAKTextureAtlasFile];
+            
+            // 配列に保存する
+            [self.batches addObject:batch];
+            
+            // シーンに配置する
+            [self.scene.characterLayer addChild:batch z:i];
+        }
     }
     
     // 自機を作成する
-    self.player = [[[AKPlayer alloc] initWithParent:[self.batches objectAtIndex:kAKCharaPosZPlayer]
-                                       optionParent:[self.batches objectAtIndex:kAKCharaPosZOption]] autorelease];
+    self.player = [[[AKPlayer alloc] initWithParent:[self batchAtPositionZ:kAKCharaPosZPlayer]
+                                       optionParent:[self batchAtPositionZ:kAKCharaPosZOption]] autorelease];
     
     // 自機弾プールを作成する
     self.playerShotPool = [[[AKCharacterPool alloc] initWithClass:[AKPlayerShot class] Size:kAKMaxPlayerShotCount] autorelease];
     
     // 反射弾プールを作成する
-    self.refrectedShotPool = [[[AKCharacterPool alloc] initWithClass:[AKEnemyShot class] Size:kAKMaxEnemyShotCount] autorelease];
+    self.refrectedShotPool = [[[AKCharacterPool alloc] initWithClass:[AKEnemyShot class] Size:kAKMaxReflectedShotCount] autorelease];
     
     // 敵キャラプールを作成する
     self.enemyPool = [[[AKCharacterPool alloc] initWithClass:[AKEnemy class] Size:kAKMaxEnemyCount] autorelease];
     
-    // 敵弾プールを作成する
-    self.enemyShotPool = [[[AKCharacterPool alloc] initWithClass:[AKEnemyShot class] Size:kAKMaxEnemyShotCount] autorelease];
+    // 敵弾エンジンを作成する
+    self.enemyShotEngine = [[[AKEnemyShotEngine alloc] initWithCapacity:kAKMaxEnemyShotCount
+                                                                  parent:[self batchAtPositionZ:kAKCharaPosZEnemyShot]] autorelease];
     
     // 画面効果プールを作成する
     self.effectPool = [[[AKCharacterPool alloc] initWithClass:[AKEffect class] Size:kAKMaxEffectCount] autorelease];
     
     // 障害物プールを作成する
     self.blockPool = [[[AKCharacterPool alloc] initWithClass:[AKBlock class] Size:kAKMaxBlockCount] autorelease];
+    
+    // 当たり判定グリッドを作成する
+    self.playerShotGrid = [[[AKCollisionGrid alloc] initWithCapacity:kAKMaxPlayerShotCount] autorelease];
+    self.reflectedShotGrid = [[[AKCollisionGrid alloc] initWithCapacity:kAKMaxReflectedShotCount] autorelease];
+    self.enemyGrid = [[[AKCollisionGrid alloc] initWithCapacity:kAKMaxEnemyCount] autorelease];
+    self.blockGrid = [[[AKCollisionGrid alloc] initWithCapacity:kAKMaxBlockCount] autorelease];
+    isBlockGridDirty_ = NO;
+    
+    // 次のステージの先読みを作成する
+    self.prefetcher = [[[AKStagePrefetcher alloc] init] autorelease];
+    
+#ifdef DEBUG
+    // 処理時間を計測する場合はフレームプロファイラを作成する
+    if (kAKUseProfiler) {
+        self.profiler = [[[AKFrameProfiler alloc] initWithCapacity:kAKProfilerFrameCount] autorelease];
+    }
+#endif
 }
 
 /*!
@@ -222,6 +285,10 @@ enum AKCharacterPositionZ {
     score_ = 0;
     clearWait_ = 0;
     rebirthWait_ = 0;
+    
+    // 次の情報表示更新ですべての表示を更新する
+    isScoreDirty_ = YES;
+    displayedChickenGauge_ = -1;
 }
 
 #pragma mark オブジェクト解放
@@ -240,9 +307,16 @@ enum AKCharacterPositionZ {
     self.playerShotPool = nil;
     self.refrectedShotPool = nil;
     self.enemyPool = nil;
-    self.enemyShotPool = nil;
+    self.enemyShotEngine = nil;
     self.effectPool = nil;
     self.blockPool = nil;
+    self.playerShotGrid = nil;
+    self.reflectedShotGrid = nil;
+    self.enemyGrid = nil;
+    self.blockGrid = nil;
+    self.profiler = nil;
+    self.recorder = nil;
+    self.prefetcher = nil;
     for (CCNode *node in [self.batches objectEnumerator]) {
         [node removeFromParentAndCleanup:YES];
     }
@@ -256,6 +330,23 @@ enum AKCharacterPositionZ {
 
 #pragma mark アクセサ
 
+/*!
+ @brief z座標に対応するバッチノード取得
+ 
+ キャラクターを配置するz座標に対応するバッチノードを取得する。
+ @param z z座標
+ @return バッチノード。画像不使用モードの場合はnilを返す。
+ */
+- (CCNode *)batchAtPositionZ:(enum AKCharacterPositionZ)z
+{
+    // バッチノードを作成していない場合はnilを返す
+    if (self.batches.count == 0) {
+        return nil;
+    }
+    
+    return [self.batches objectAtIndex:z];
+}
+
 /*!
  @brief 自機の位置情報取得
  
@@ -278,11 +369,29 @@ enum AKCharacterPositionZ {
     return self.blockPool.pool;
 }
 
+/*!
+ @brief 障害物当たり判定グリッド取得
+ 
+ 障害物当たり判定グリッドを取得する。
+ 障害物の生成・移動後、最初に取得した時にグリッドの再構築を行う。
+ @return 障害物当たり判定グリッド
+ */
+- (AKCollisionGrid *)blockGrid
+{
+    // 障害物が変化している場合はグリッドを再構築する
+    if (isBlockGridDirty_) {
+        [blockGrid_ rebuildWithPool:self.blockPool];
+        isBlockGridDirty_ = NO;
+    }
+    
+    return blockGrid_;
+}
+
 /*!
  @brief 残機設定
  
  残機を設定する。
- 画面の残機表示の更新も行う。
+ 画面の残機表示は次の情報表示更新で行う。
  @param life 残機
  */
 - (void)setLife:(NSInteger)life
@@ -290,8 +399,8 @@ enum AKCharacterPositionZ {
     // メンバに設定する
     life_ = life;
     
-    // シーンの残機表示の更新を行う
-    self.scene.life.lifeCount = life;
+    // 残機表示の更新が必要な状態にする
+    isLifeDirty_ = YES;
 }
 
 /*!
@@ -319,19 +428,51 @@ enum AKCharacterPositionZ {
 /*!
  @brief スクリプト読み込み
  
- スクリプトファイルを読み込む。
+ ステージ番号に対応するステージパックを読み込む。
+ 先読みしている場合は先読みしたステージパックを受け取り、先読みが完了していない場合は完了を待つ。
+ 先読みの完了待ちを含めた読み込み時間をプロファイラで計測する。
  @param stage ステージ番号
  */
 - (void)readScript:(NSInteger)stage
+{
+    uint64_t phaseStart = AKProfilerBegin(self.profiler);
+    
+    [self readScript:stage stagePack:[self.prefetcher takeStagePackOfStageNo:stage]];
+    
+    AKProfilerEnd(self.profiler, kAKProfilePhaseStageLoad, phaseStart);
+}
+
+/*!
+ @brief ステージパックからのスクリプト読み込み
+ 
+ 読み込み済みのステージパックからスクリプトを作成し、次のステージの先読みを開始する。
+ @param stage ステージ番号
+ @param stagePack ステージパック
+ */
+- (void)readScript:(NSInteger)stage stagePack:(AKStagePack *)stagePack
 {
     // ステージ番号をメンバに設定する
     stage_ = stage;
     
-    // スクリプトファイルを読み込む
-    self.tileMap = [AKTileMap scriptWithStageNo:stage layer:self.scene.backgroundLayer];
+#ifdef DEBUG
+    // 入力を記録する場合は最初のステージの読み込み時に記録を開始する
+    if (kAKUseInputRecorder && self.recorder == nil) {
+        self.recorder = [[[AKInputRecorder alloc] initWithStageNo:stage] autorelease];
+    }
+#endif
+    
+    // 前のステージのマップを画面から取り除き、ステージパックからスクリプトを作成する
+    [self.tileMap.tileMap removeFromParentAndCleanup:YES];
+    self.tileMap = [AKTileMap scriptWithStagePack:stagePack layer:self.scene.backgroundLayer];
     
     // 初期表示の1画面分の処理を行う
     [self.tileMap update:self];
+    
+    // ステージのプレイ中に次のステージの先読みを行い、
+    // ステージクリア後の切り替えでは先読みしたステージパックを受け取るだけにする
+    if (stage < kAKStageCount) {
+        [self.prefetcher prefetchStageNo:stage + 1];
+    }
 }
 
 /*!
@@ -417,6 +558,56 @@ enum AKCharacterPositionZ {
     [[AKGameCenterHelper sharedHelper] reportHiScore:score_];
 }
 
+/*!
+ @brief プロファイル結果書込
+ 
+ フレームプロファイラの計測結果をCSVファイルとChromeトレースファイルに書き込む。
+ フレームプロファイラを使用していない場合は何もしない。
+ */
+- (void)writeProfile
+{
+    // フレームプロファイラを使用していない場合は処理しない
+    if (self.profiler == nil) {
+        return;
+    }
+    
+    // Documentsディレクトリへのパスを作成する
+    NSString *docDir = [NSHomeDirectory() stringByAppendingPathComponent:@"Documents"];
+    
+    // CSVファイルを書き込む
+    NSString *csvPath = [docDir stringByAppendingPathComponent:kAKProfileCSVFileName];
+    [[self.profiler csvString] writeToFile:csvPath atomically:YES encoding:NSUTF8StringEncoding error:NULL];
+    
+    // Chromeトレースファイルを書き込む
+    NSString *tracePath = [docDir stringByAppendingPathComponent:kAKProfileTraceFileName];
+    [[self.profiler chromeTraceString] writeToFile:tracePath atomically:YES encoding:NSUTF8StringEncoding error:NULL];
+    
+    AKLog(kAKLogPlayData_1, @"プロファイル結果書込:%@", docDir);
+}
+
+/*!
+ @brief 入力記録書込
+ 
+ 記録した入力をファイルに書き込む。
+ 入力を記録していない場合は何もしない。
+ */
+- (void)writeInputRecord
+{
+    // 入力を記録していない場合は処理しない
+    if (self.recorder == nil) {
+        return;
+    }
+    
+    // Documentsディレクトリへのパスを作成する
+    NSString *docDir = [NSHomeDirectory() stringByAppendingPathComponent:@"Documents"];
+    
+    // 入力記録ファイルを書き込む
+    NSString *filePath = [docDir stringByAppendingPathComponent:kAKInputRecordFileName];
+    [self.recorder.data writeToFile:filePath atomically:YES];
+    
+    AKLog(kAKLogPlayData_1, @"入力記録書込:tickCount=%d", self.recorder.tickCount);
+}
+
 #pragma mark シーンクラスからのデータ操作用
 
 /*!
@@ -443,7 +634,10 @@ enum AKCharacterPositionZ {
                 AKLog(kAKLogPlayData_1, @"ステージクリア後の待機時間経過");
                 
                 // ステージクリアの実績をGame Centerへ送信する
-                [[AKGameCenterHelper sharedHelper] reportStageClear:stage_];
+                // シーンなしで実行している場合は送信しない
+                if (self.scene != nil) {
+                    [[AKGameCenterHelper sharedHelper] reportStageClear:stage_];
+                }
                 
                 // ステージを進める
                 stage_++;
@@ -472,117 +666,141 @@ enum AKCharacterPositionZ {
         }
     }
     
+    // 処理時間を計測する場合はプロファイラを取得する
+    AKFrameProfiler *profiler = self.profiler;
+    uint64_t phaseStart = 0;
+    
     // マップを更新する
+    phaseStart = AKProfilerBegin(profiler);
     [self.tileMap update:self];
+    AKProfilerEnd(profiler, kAKProfilePhaseTileMap, phaseStart);
     
     // 障害物を更新する
-    for (AKBlock *block in [self.blockPool.pool objectEnumerator]) {
-        if (block.isStaged) {
-            [block move:self];
-        }
-    }
+    phaseStart = AKProfilerBegin(profiler);
+    [self.blockPool makeActiveObjectsPerformSelector:@selector(move:) withObject:self];
+    AKProfilerEnd(profiler, kAKProfilePhaseBlockMove, phaseStart);
+    
+    // 障害物の位置が変わったため、当たり判定グリッドを再構築させる
+    isBlockGridDirty_ = YES;
     
     // 自機を更新する
+    phaseStart = AKProfilerBegin(profiler);
     [self.player move:self];
+    AKProfilerEnd(profiler, kAKProfilePhasePlayerMove, phaseStart);
     
     // 自機弾を更新する
-    for (AKPlayerShot *playerShot in [self.playerShotPool.pool objectEnumerator]) {
-        if (playerShot.isStaged) {
-            [playerShot move:self];
-        }
-    }
+    phaseStart = AKProfilerBegin(profiler);
+    [self.playerShotPool makeActiveObjectsPerformSelector:@selector(move:) withObject:self];
     
     // 反射弾を更新する
-    for (AKEnemyShot *refrectedShot in [self.refrectedShotPool.pool objectEnumerator]) {
-        if (refrectedShot.isStaged) {
-            [refrectedShot move:self];
-        }
-    }
+    [self.refrectedShotPool makeActiveObjectsPerformSelector:@selector(move:) withObject:self];
+    AKProfilerEnd(profiler, kAKProfilePhaseShotMove, phaseStart);
     
     // 敵を更新する
-    for (AKEnemy *enemy in [self.enemyPool.pool objectEnumerator]) {
-        if (enemy.isStaged) {
-            AKLog(kAKLogPlayData_2, @"enemy move start.");
-            [enemy move:self];
-        }
-    }
+    AKLog(kAKLogPlayData_2, @"enemy move start. count=%d", self.enemyPool.activeCount);
+    phaseStart = AKProfilerBegin(profiler);
+    [self.enemyPool makeActiveObjectsPerformSelector:@selector(move:) withObject:self];
+    AKProfilerEnd(profiler, kAKProfilePhaseEnemyMove, phaseStart);
     
     // 敵弾を更新する
-    for (AKEnemyShot *enemyShot in [self.enemyShotPool.pool objectEnumerator]) {
-        if (enemyShot.isStaged) {
-            [enemyShot move:self];
-        }
-    }
+    phaseStart = AKProfilerBegin(profiler);
+    [self.enemyShotEngine move:self];
+    AKProfilerEnd(profiler, kAKProfilePhaseEnemyShotMove, phaseStart);
     
     // 画面効果を更新する
-    for (AKEffect *effect in [self.effectPool.pool objectEnumerator]) {
-        if (effect.isStaged) {
-            [effect move:self];
-        }
-    }
+    phaseStart = AKProfilerBegin(profiler);
+    [self.effectPool makeActiveObjectsPerformSelector:@selector(move:) withObject:self];
+    AKProfilerEnd(profiler, kAKProfilePhaseEffectMove, phaseStart);
+    
+    // 当たり判定グリッドを再構築する
+    phaseStart = AKProfilerBegin(profiler);
+    [self rebuildCollisionGrid];
+    AKProfilerEnd(profiler, kAKProfilePhaseGridRebuild, phaseStart);
     
     // 障害物の当たり判定を行う
-    for (AKBlock *block in [self.blockPool.pool objectEnumerator]) {
-        if (block.isStaged) {
-            
-            // 自機との当たり判定を行う
-            [block checkHit:[NSArray arrayWithObject:self.player] data:self];
-            
-            // 自機弾との当たり判定を行う
-            [block checkHit:[self.playerShotPool.pool objectEnumerator] data:self];
-            
-            // 敵は移動処理の中で障害物との当たり判定を処理しているので
-            // ここでは処理しない。
-//            [block checkHit:[self.enemyPool.pool objectEnumerator] data:self];
-            
-            // 敵弾との当たり判定を行う
-            [block checkHit:[self.enemyShotPool.pool objectEnumerator] data:self];
-        }
+    phaseStart = AKProfilerBegin(profiler);
+    for (NSInteger i = 0; i < self.blockPool.activeCount; i++) {
+        
+        AKBlock *block = [self.blockPool activeAtIndex:i];
+        
+        // 自機との当たり判定を行う
+        [block checkHitWithCharacter:self.player data:self];
+        
+        // 自機弾との当たり判定を行う
+        [block checkHitWithGrid:self.playerShotGrid data:self];
+        
+        // 敵、敵弾は移動処理の中で障害物との当たり判定を処理しているので
+        // ここでは処理しない。
+//        [block checkHit:[self.enemyPool.pool objectEnumerator] data:self];
     }
+    AKProfilerEnd(profiler, kAKProfilePhaseBlockHit, phaseStart);
     
     // 敵と自機弾、反射弾の当たり判定を行う
-    for (AKEnemy *enemy in [self.enemyPool.pool objectEnumerator]) {
+    phaseStart = AKProfilerBegin(profiler);
+    for (NSInteger i = 0; i < self.enemyPool.activeCount; i++) {
+        
+        AKEnemy *enemy = [self.enemyPool activeAtIndex:i];
         
         // 自機弾との当たり判定を行う
-        [enemy checkHit:[self.playerShotPool.pool objectEnumerator] data:self];
+        [enemy checkHitWithGrid:self.playerShotGrid data:self];
         
         // 反射弾との当たり判定を行う
-        [enemy checkHit:[self.refrectedShotPool.pool objectEnumerator] data:self];
+        [enemy checkHitWithGrid:self.reflectedShotGrid data:self];
     }
+    AKProfilerEnd(profiler, kAKProfilePhaseEnemyHit, phaseStart);
     
     // シールド有効時、反射の判定を行う
+    phaseStart = AKProfilerBegin(profiler);
     if (self.shield) {
         
-        // オプションを取得する
-        AKOption *option = self.player.option;
-        
-        // 各オプションに対して当たり判定を行う
-        while (option != nil && option.isStaged) {
+        // 配置中の各オプションに対して当たり判定を行う
+        for (NSInteger i = 0; i < self.player.optionCount; i++) {
             
             AKLog(kAKLogPlayData_1, @"反射判定");
             
             // 敵弾との当たり判定を行う
-            [option checkHit:[self.enemyShotPool.pool objectEnumerator] data:self];
-            
-            // 次のオプションを取得する
-            option = option.next;
+            [self.enemyShotEngine reflectWithCharacter:[self.player.options objectAtIndex:i] data:self];
         }
     }
+    AKProfilerEnd(profiler, kAKProfilePhaseReflect, phaseStart);
     
     // 自機が無敵状態でない場合は当たり判定処理を行う
+    phaseStart = AKProfilerBegin(profiler);
     if (!self.player.isInvincible) {
         
         // 自機と敵弾のかすり判定処理を行う
-        [self.player graze:[self.enemyShotPool.pool objectEnumerator]];
+        [self.player graze:self.enemyShotEngine];
         
         // 自機と敵の当たり判定処理を行う
-        [self.player checkHit:[self.enemyPool.pool objectEnumerator] data:self];
+        [self.player checkHitWithGrid:self.enemyGrid data:self];
         
         // 自機と敵弾の当たり判定処理を行う
-        [self.player checkHit:[self.enemyShotPool.pool objectEnumerator] data:self];
+        [self.enemyShotEngine checkHitWithCharacter:self.player];
+    }
+    AKProfilerEnd(profiler, kAKProfilePhasePlayerHit, phaseStart);
+    
+    AKLog(kAKLogPlayData_2, @"pair test:playerShot=%u reflectedShot=%u enemy=%u enemyShot=%u",
+          self.playerShotGrid.pairTestCount, self.reflectedShotGrid.pairTestCount,
+          self.enemyGrid.pairTestCount, self.enemyShotEngine.hitTestCount);
+    
+    // 状態更新回数、キャラクター数、当たり判定回数を記録する
+    if (profiler != nil) {
+        [profiler addCount:1 counter:kAKProfileCounterStep];
+        [profiler setCount:self.blockPool.activeCount counter:kAKProfileCounterBlock];
+        [profiler setCount:self.playerShotPool.activeCount counter:kAKProfileCounterPlayerShot];
+        [profiler setCount:self.refrectedShotPool.activeCount counter:kAKProfileCounterReflectedShot];
+        [profiler setCount:self.enemyPool.activeCount counter:kAKProfileCounterEnemy];
+        [profiler setCount:self.enemyShotEngine.count counter:kAKProfileCounterEnemyShot];
+        [profiler setCount:self.effectPool.activeCount counter:kAKProfileCounterEffect];
+        [profiler addCount:(self.playerShotGrid.pairTestCount +
+                            self.reflectedShotGrid.pairTestCount +
+                            self.enemyGrid.pairTestCount +
+                            self.enemyShotEngine.hitTestCount)
+                   counter:kAKProfileCounterPairTest];
     }
     
     // シールドが有効な場合はチキンゲージを減少させる
+    phaseStart = AKProfilerBegin(profiler);
     if (self.shield) {
         self.player.chickenGauge--;
         
@@ -593,11 +811,106 @@ enum AKCharacterPositionZ {
         }
     }
     
-    // チキンゲージの溜まっている比率を更新する
-    self.scene.chickenGauge.percent = self.player.chickenGauge;
-    
     // チキンゲージからオプション個数を決定する
     [self.player updateOptionCount];
+    AKProfilerEnd(profiler, kAKProfilePhaseHUD, phaseStart);
+    
+    // 入力を記録している場合は更新後の状態のチェックサムを記録する
+    if (self.recorder != nil) {
+        [self.recorder recordTickWithChecksum:[self stateChecksum]];
+    }
+}
+
+/*!
+ @brief 当たり判定グリッド再構築
+ 
+ 移動後のキャラクターの位置で当たり判定グリッドを再構築する。
+ 当たり判定処理の間は判定対象のキャラクターは移動しないため、グリッドは1フレームに1回構築すればよい。
+ 反射弾はオプションとの当たり判定で生成されるが、生成後にそのフレーム内で判定対象とはならない。
+ */
+- (void)rebuildCollisionGrid
+{
+    // 判定回数をクリアする
+    [self.playerShotGrid resetStatistics];
+    [self.reflectedShotGrid resetStatistics];
+    [self.enemyGrid resetStatistics];
+    [self.enemyShotEngine resetStatistics];
+    
+    // 各プールのキャラクターを登録し直す
+    [self.playerShotGrid rebuildWithPool:self.playerShotPool];
+    [self.reflectedShotGrid rebuildWithPool:self.refrectedShotPool];
+    [self.enemyGrid rebuildWithPool:self.enemyPool];
+}
+
+/*!
+ @brief 画像表示位置更新
+ 
+ キャラクターの画像とマップの表示位置を前回と今回の状態更新の間で補間した位置に更新する。
+ 状態更新とは別に画面更新のたびに呼び出す。
+ @param alpha 補間の割合(0で前回の状態更新の位置、1で今回の状態更新の位置)
+ */
+- (void)updateImagePositionWithAlpha:(float)alpha
+{
+    // 処理時間を計測する
+    uint64_t phaseStart = AKProfilerBegin(self.profiler);
+    
+    // マップの表示位置を更新する
+    [self.tileMap updateImagePositionWithAlpha:alpha];
+    
+    // 障害物の表示位置を更新する
+    [self.blockPool updateImagePositionWithAlpha:alpha];
+    
+    // 自機とオプションの表示位置を更新する
+    [self.player updateImagePositionWithAlpha:alpha];
+    
+    // 自機弾の表示位置を更新する
+    [self.playerShotPool updateImagePositionWithAlpha:alpha];
+    
+    // 反射弾の表示位置を更新する
+    [self.refrectedShotPool updateImagePositionWithAlpha:alpha];
+    
+    // 敵の表示位置を更新する
+    [self.enemyPool updateImagePositionWithAlpha:alpha];
+    
+    // 敵弾の表示位置を更新する
+    [self.enemyShotEngine updateSpritesWithAlpha:alpha];
+    
+    // 画面効果の表示位置を更新する
+    [self.effectPool updateImagePositionWithAlpha:alpha];
+    
+    AKProfilerEnd(self.profiler, kAKProfilePhaseDraw, phaseStart);
+}
+
+/*!
+ @brief 情報表示更新
+ 
+ スコア、残機、チキンゲージのうち、前回の情報表示更新から変化したものだけを画面に反映する。
+ 1フレームに複数回の状態更新や複数回のスコア加算があっても、表示の更新はフレームの最後に1回だけ行う。
+ */
+- (void)updateHUD
+{
+    // 処理時間を計測する
+    uint64_t phaseStart = AKProfilerBegin(self.profiler);
+    
+    // スコア表示を更新する
+    if (isScoreDirty_) {
+        [self.scene setScoreLabel:score_];
+        isScoreDirty_ = NO;
+    }
+    
+    // 残機表示を更新する
+    if (isLifeDirty_) {
+        self.scene.life.lifeCount = life_;
+        isLifeDirty_ = NO;
+    }
+    
+    // チキンゲージの溜まっている比率を更新する
+    if (self.player.chickenGauge != displayedChickenGauge_) {
+        self.scene.chickenGauge.percent = self.player.chickenGauge;
+        displayedChickenGauge_ = self.player.chickenGauge;
+    }
+    
+    AKProfilerEnd(self.profiler, kAKProfilePhaseHUD, phaseStart);
 }
 
 /*!
@@ -609,6 +922,9 @@ enum AKCharacterPositionZ {
  */
 - (void)movePlayerByDx:(float)dx dy:(float)dy
 {
+    // 入力を記録する
+    [self.recorder recordMoveDx:dx dy:dy];
+    
     AKLog(kAKLogPlayData_3, @"x=%f dx=%f width=%f y=%f dy=%f height=%f",
           self.player.positionX, dx, kAKStageSize.width,
           self.player.positionY, dy, kAKStageSize.height);
@@ -623,6 +939,205 @@ enum AKCharacterPositionZ {
                          data:self];
 }
 
+/*!
+ @brief シールドボタンの操作
+ 
+ シールドボタンの操作によってシールドモードを切り替える。
+ チキンゲージ切れなどゲーム内の処理による切り替えと区別して、入力として記録する。
+ @param shield シールドを有効にするかどうか
+ */
+- (void)changeShield:(BOOL)shield
+{
+    // 入力を記録する
+    [self.recorder recordShield:shield];
+    
+    // シールドモードを切り替える
+    self.shield = shield;
+}
+
+/*!
+ @brief 状態のチェックサム計算
+ 
+ ゲームの進行状態と各キャラクターの位置・速度・HPからチェックサムを計算する。
+ 入力の再生時に記録時と同じ状態になっているかを状態更新単位で検証するために使用する。
+ 画像の表示状態は含めない。
+ @return チェックサム
+ */
+- (uint32_t)stateChecksum
+{
+    uint32_t checksum = kAKChecksumInit;
+    
+    // ゲームの進行状態を加える
+    NSInteger values[] = {stage_, score_, life_, clearWait_, rebirthWait_, shield_,
+                          self.tileMap.progress, self.player.chickenGauge};
+    checksum = AKChecksumAdd(checksum, values, sizeof(values));
+    float scrollSpeed[] = {scrollSpeedX_, scrollSpeedY_};
+    checksum = AKChecksumAdd(checksum, scrollSpeed, sizeof(scrollSpeed));
+    
+    // 自機とオプションを加える
+    checksum = [self addChecksum:checksum character:self.player];
+    for (AKOption *option in self.player.options) {
+        checksum = [self addChecksum:checksum character:option];
+    }
+    
+    // 各キャラクタープールを加える
+    checksum = [self addChecksum:checksum pool:self.playerShotPool];
+    checksum = [self addChecksum:checksum pool:self.refrectedShotPool];
+    checksum = [self addChecksum:checksum pool:self.enemyPool];
+    checksum = [self addChecksum:checksum pool:self.effectPool];
+    checksum = [self addChecksum:checksum pool:self.blockPool];
+    
+    // 敵弾を加える
+    for (NSInteger i = 0; i < self.enemyShotEngine.count; i++) {
+        CGPoint position = [self.enemyShotEngine positionAtIndex:i];
+        NSInteger hitPoint = [self.enemyShotEngine hitPointAtIndex:i];
+        checksum = AKChecksumAdd(checksum, &position, sizeof(position));
+        checksum = AKChecksumAdd(checksum, &hitPoint, sizeof(hitPoint));
+    }
+    
+    return checksum;
+}
+
+/*!
+ @brief キャラクターの状態のチェックサム加算
+ 
+ キャラクターの配置状態・位置・速度・HPをチェックサムに加える。
+ @param checksum 加算前のチェックサム
+ @param character キャラクター
+ @return 加算後のチェックサム
+ */
+- (uint32_t)addChecksum:(uint32_t)checksum character:(AKCharacter *)character
+{
+    float values[] = {character.positionX, character.positionY, character.speedX, character.speedY};
+    NSInteger state[] = {character.isStaged, character.hitPoint};
+    checksum = AKChecksumAdd(checksum, values, sizeof(values));
+    return AKChecksumAdd(checksum, state, sizeof(state));
+}
+
+/*!
+ @brief キャラクタープールの状態のチェックサム加算
+ 
+ キャラクタープールの使用中のキャラクターの数と各キャラクターの状態をチェックサムに加える。
+ @param checksum 加算前のチェックサム
+ @param pool キャラクタープール
+ @return 加算後のチェックサム
+ */
+- (uint32_t)addChecksum:(uint32_t)checksum pool:(AKCharacterPool *)pool
+{
+    NSInteger count = pool.activeCount;
+    checksum = AKChecksumAdd(checksum, &count, sizeof(count));
+    
+    for (NSInteger i = 0; i < count; i++) {
+        checksum = [self addChecksum:checksum character:[pool activeAtIndex:i]];
+    }
+    
+    return checksum;
+}
+
+/*!
+ @brief 状態の保存
+ 
+ ゲームの進行状態、マップ、自機・オプション、各キャラクタープール、敵弾の状態を保存する。
+ 保存先のバッファは繰り返し使用できるため、容量が足りていればメモリの確保は発生しない。
+ ハイスコア、プロファイラ、入力記録は保存しない。
+ @param snapshot 保存先
+ */
+- (void)writeSnapshot:(AKSnapshot *)snapshot
+{
+    [snapshot beginWrite];
+    
+    // ゲームの進行状態を保存する
+    NSInteger values[] = {stage_, clearWait_, rebirthWait_, life_, score_, shield_};
+    float scrollSpeed[] = {scrollSpeedX_, scrollSpeedY_};
+    [snapshot writeBytes:values length:sizeof(values)];
+    [snapshot writeBytes:scrollSpeed length:sizeof(scrollSpeed)];
+    
+    // マップの状態を保存する
+    [self.tileMap writeSnapshot:snapshot];
+    
+    // 自機とオプションの状態を保存する
+    [self.player writeSnapshot:snapshot];
+    
+    // 各キャラクタープールの状態を保存する
+    [self.playerShotPool writeSnapshot:snapshot];
+    [self.refrectedShotPool writeSnapshot:snapshot];
+    [self.enemyPool writeSnapshot:snapshot];
+    [self.effectPool writeSnapshot:snapshot];
+    [self.blockPool writeSnapshot:snapshot];
+    
+    // 敵弾の状態を保存する
+    [self.enemyShotEngine writeSnapshot:snapshot];
+    
+    [snapshot endWrite];
+}
+
+/*!
+ @brief 状態の復元
+ 
+ 保存した状態を読み込み、保存時と同じ状態に戻す。
+ 保存時とステージが異なる場合はマップを読み込み直す。
+ 初期表示のイベントはマップの状態とともに復元するため、読み込み直した時に実行はしない。
+ @param snapshot 読み込み元
+ @return 復元できた場合YES、保存データが不正な場合NO
+ */
+- (BOOL)readSnapshot:(AKSnapshot *)snapshot
+{
+    // ヘッダーを検証する
+    if (![snapshot beginRead]) {
+        AKLog(kAKLogPlayData_0, @"保存データが不正");
+        return NO;
+    }
+    
+    // ゲームの進行状態を読み込む
+    NSInteger values[6];
+    float scrollSpeed[2];
+    [snapshot readBytes:values length:sizeof(values)];
+    [snapshot readBytes:scrollSpeed length:sizeof(scrollSpeed)];
+    
+    // ステージが異なる場合はマップを読み込み直す
+    if (self.tileMap == nil || values[0] != stage_) {
+        [self.tileMap.tileMap removeFromParentAndCleanup:YES];
+        self.tileMap = [AKTileMap scriptWithStageNo:values[0] layer:self.scene.backgroundLayer];
+    }
+    
+    // ゲームの進行状態を設定する
+    // シールドはオプションの画像も切り替えるため、オプションの状態の復元よりも先に設定する
+    stage_ = values[0];
+    clearWait_ = values[1];
+    rebirthWait_ = values[2];
+    self.life = values[3];
+    score_ = values[4];
+    self.shield = values[5];
+    scrollSpeedX_ = scrollSpeed[0];
+    scrollSpeedY_ = scrollSpeed[1];
+    
+    // マップの状態を復元する
+    [self.tileMap readSnapshot:snapshot];
+    
+    // 自機とオプションの状態を復元する
+    [self.player readSnapshot:snapshot];
+    
+    // 各キャラクタープールの状態を復元する
+    [self.playerShotPool readSnapshot:snapshot parent:[self batchAtPositionZ:kAKCharaPosZPlayerShot]];
+    [self.refrectedShotPool readSnapshot:snapshot parent:[self batchAtPositionZ:kAKCharaPosZPlayerShot]];
+    [self.enemyPool readSnapshot:snapshot parent:[self batchAtPositionZ:kAKCharaPosZEnemy]];
+    [self.effectPool readSnapshot:snapshot parent:[self batchAtPositionZ:kAKCharaPosZEffect]];
+    [self.blockPool readSnapshot:snapshot parent:[self batchAtPositionZ:kAKCharaPosZBlock]];
+    
+    // 敵弾の状態を復元する
+    [self.enemyShotEngine readSnapshot:snapshot];
+    
+    // 障害物が入れ替わったため、当たり判定グリッドを再構築させる
+    isBlockGridDirty_ = YES;
+    
+    // 次の情報表示更新ですべての表示を更新する
+    isScoreDirty_ = YES;
+    isLifeDirty_ = YES;
+    displayedChickenGauge_ = -1;
+    
+    return YES;
+}
+
 /*!
  @brief ツイートメッセージの作成
  
@@ -659,27 +1174,37 @@ enum AKCharacterPositionZ {
  */
 - (void)resume
 {
-    // すべてのキャラクターのアニメーションを再開する
+    // 入力を記録する
+    [self.recorder recordResume];
+    
+    // ステージに配置されているすべてのキャラクターのアニメーションを再開する
     // 自機
     [self.player.image resumeSchedulerAndActions];
     
     // 自機弾
-    for (AKCharacter *character in self.playerShotPool.pool.objectEnumerator) {
+    for (NSInteger i = 0; i < self.playerShotPool.activeCount; i++) {
+        AKCharacter *character = [self.playerShotPool activeAtIndex:i];
         [character.image resumeSchedulerAndActions];
     }
     
     // 敵
-    for (AKCharacter *character in self.enemyPool.pool.objectEnumerator) {
+    for (NSInteger i = 0; i < self.enemyPool.activeCount; i++) {
+        AKCharacter *character = [self.enemyPool activeAtIndex:i];
         [character.image resumeSchedulerAndActions];
     }
     
     // 敵弾
-    for (AKCharacter *character in self.enemyShotPool.pool.objectEnumerator) {
+    [self.enemyShotEngine resumeSprites];
+    
+    // 反射弾
+    for (NSInteger i = 0; i < self.refrectedShotPool.activeCount; i++) {
+        AKCharacter *character = [self.refrectedShotPool activeAtIndex:i];
         [character.image resumeSchedulerAndActions];
     }
     
     // 画面効果
-    for (AKCharacter *character in self.effectPool.pool.objectEnumerator) {
+    for (NSInteger i = 0; i < self.effectPool.activeCount; i++) {
+        AKCharacter *character = [self.effectPool activeAtIndex:i];
         [character.image resumeSchedulerAndActions];
     }
 }
@@ -691,27 +1216,43 @@ enum AKCharacterPositionZ {
  */
 - (void)pause
 {
-    // すべてのキャラクターのアニメーションを停止する
+    // 入力を記録する
+    [self.recorder recordPause];
+    
+    // 処理時間を計測している場合は計測結果を書き込む
+    [self writeProfile];
+    
+    // 入力を記録している場合は記録した入力を書き込む
+    [self writeInputRecord];
+    
+    // ステージに配置されているすべてのキャラクターのアニメーションを停止する
     // 自機
     [self.player.image pauseSchedulerAndActions];
     
     // 自機弾
-    for (AKCharacter *character in [self.playerShotPool.pool objectEnumerator]) {
+    for (NSInteger i = 0; i < self.playerShotPool.activeCount; i++) {
+        AKCharacter *character = [self.playerShotPool activeAtIndex:i];
         [character.image pauseSchedulerAndActions];
     }
     
     // 敵
-    for (AKCharacter *character in [self.enemyPool.pool objectEnumerator]) {
+    for (NSInteger i = 0; i < self.enemyPool.activeCount; i++) {
+        AKCharacter *character = [self.enemyPool activeAtIndex:i];
         [character.image pauseSchedulerAndActions];
     }
     
     // 敵弾
-    for (AKCharacter *character in [self.enemyShotPool.pool objectEnumerator]) {
+    [self.enemyShotEngine pauseSprites];
+    
+    // 反射弾
+    for (NSInteger i = 0; i < self.refrectedShotPool.activeCount; i++) {
+        AKCharacter *character = [self.refrectedShotPool activeAtIndex:i];
         [character.image pauseSchedulerAndActions];
     }
     
     // 画面効果
-    for (AKCharacter *character in [self.effectPool.pool objectEnumerator]) {
+    for (NSInteger i = 0; i < self.effectPool.activeCount; i++) {
+        AKCharacter *character = [self.effectPool activeAtIndex:i];
         [character.image pauseSchedulerAndActions];
     }
 }
@@ -755,16 +1296,24 @@ enum AKCharacterPositionZ {
     }
     
     // 自機弾を生成する
-    [playerShot createPlayerShotAtX:x y:y parent:[self.batches objectAtIndex:kAKCharaPosZPlayerShot]];
+    [playerShot createPlayerShotAtX:x y:y parent:[self batchAtPositionZ:kAKCharaPosZPlayerShot]];
 }
 
 /*!
  @brief 反射弾生成
  
  反射弾を生成する。
- @param enemyShot 反射する敵弾
+ @param type 反射する敵弾の種類
+ @param x x座標
+ @param y y座標
+ @param speedX x方向の速度
+ @param speedY y方向の速度
  */
-- (void)createReflectiedShot:(AKEnemyShot *)enemyShot
+- (void)createReflectedShotType:(NSInteger)type
+                              x:(float)x
+                              y:(float)y
+                         speedX:(float)speedX
+                         speedY:(float)speedY
 {
     AKLog(kAKLogPlayData_1, @"反射弾生成");
     
@@ -778,7 +1327,26 @@ enum AKCharacterPositionZ {
     }
     
     // 反射する敵弾を元に反射弾を生成する
-    [reflectedShot createReflectedShot:enemyShot parent:[self.batches objectAtIndex:kAKCharaPosZPlayerShot]];
+    [reflectedShot createReflectedShotType:type
+                                         x:x
+                                         y:y
+                                    speedX:speedX
+                                    speedY:speedY
+                                    parent:[self batchAtPositionZ:kAKCharaPosZPlayerShot]];
+}
+
+/*!
+ @brief 敵弾の一括予約
+ 
+ 一度に発射する弾の数だけ敵弾の空きを予約する。
+ 空きが足りない場合は全体を予約失敗とする。
+ 発射のたびに呼ばれるため、ログは予約失敗時に敵弾エンジン側でのみ出力する。
+ @param count 予約する弾の数
+ @return 予約した範囲。予約に失敗した場合は長さ0の範囲を返す。
+ */
+- (NSRange)reserveEnemyShots:(NSInteger)count
+{
+    return [self.enemyShotEngine reserveShots:count];
 }
 
 /*!
@@ -804,35 +1372,7 @@ enum AKCharacterPositionZ {
     }
     
     // 敵を生成する
-    [enemy createEnemyType:type x:x y:y progress:progress parent:[self.batches objectAtIndex:kAKCharaPosZEnemy]];
-}
-
-/*!
- @brief 敵弾インスタンスの取得
- 
- 敵弾プールから次のインスタンスを取得する。
- @return 敵弾インスタンス
- */
-- (AKEnemyShot *)getEnemyShot
-{
-    // プールから未使用のメモリを取得する
-    AKEnemyShot *enemyShot = [self.enemyShotPool getNext];
-    
-    AKLog(kAKLogPlayData_0 && enemyShot == nil, @"敵弾プールに空きなし");
-    NSAssert(enemyShot, @"敵弾プールに空きなし");
-    
-    return enemyShot;
-}
-
-/*!
- @brief 敵弾配置ノードの取得
- 
- 敵弾を配置するノードを取得する。
- @return 敵弾配置ノード
- */
-- (CCNode *)getEnemyShotParent
-{
-    return [self.batches objectAtIndex:kAKCharaPosZEnemyShot];
+    [enemy createEnemyType:type x:x y:y progress:progress parent:[self batchAtPositionZ:kAKCharaPosZEnemy]];
 }
 
 /*!
@@ -860,18 +1400,33 @@ enum AKCharacterPositionZ {
     [effect createEffectType:type
                            x:x
                            y:y
-                      parent:[self.batches objectAtIndex:kAKCharaPosZEffect]];
+                      parent:[self batchAtPositionZ:kAKCharaPosZEffect]];
 }
 
 /*!
  @brief 障害物生成
  
- 障害物を生成する。
+ タイル1個分の障害物を生成する。
  @param type 障害物種別
  @param x 前回作成した背景/障害物からのx方向の距離
  @param y 前回作成した背景/障害物からのy方向の距離
  */
 - (void)createBlock:(NSInteger)type x:(float)x y:(float)y
+{
+    [self createBlock:type x:x y:y colCount:1 rowCount:1];
+}
+
+/*!
+ @brief 複数のタイルをまとめた障害物生成
+ 
+ 同じ種別のタイルを縦横にまとめた障害物を生成する。
+ @param type 障害物種別
+ @param x まとめたタイル全体の中心x座標
+ @param y まとめたタイル全体の中心y座標
+ @param colCount まとめたタイルの列数
+ @param rowCount まとめたタイルの行数
+ */
+- (void)createBlock:(NSInteger)type x:(float)x y:(float)y colCount:(NSInteger)colCount rowCount:(NSInteger)rowCount
 {
     AKLog(kAKLogPlayData_1, @"障害物生成");
     
@@ -888,7 +1443,12 @@ enum AKCharacterPositionZ {
     [block createBlockType:type
                          x:x
                          y:y
-                    parent:[self.batches objectAtIndex:kAKCharaPosZBlock]];
+                  colCount:colCount
+                  rowCount:rowCount
+                    parent:[self batchAtPositionZ:kAKCharaPosZBlock]];
+    
+    // 障害物が追加されたため、当たり判定グリッドを再構築させる
+    isBlockGridDirty_ = YES;
 }
 
 /*!
@@ -920,7 +1480,7 @@ enum AKCharacterPositionZ {
  @brief スコア加算
  
  スコアを加算する。ハイスコアを超えている場合はハイスコアも合わせて更新する。
- スコア、ハイスコアの表示を更新する。
+ スコアの表示は次の情報表示更新で行う。
  @param score スコア増加量
  */
 - (void)addScore:(NSInteger)score
@@ -943,8 +1503,8 @@ enum AKCharacterPositionZ {
     // スコアを加算する
     score_ += score;
     
-    // スコア表示を更新する
-    [self.scene setScoreLabel:score_];
+    // スコア表示の更新が必要な状態にする
+    isScoreDirty_ = YES;
     
     // ハイスコアを更新している場合はハイスコアを設定する
     if (score_ > hiScore_) {
@@ -957,11 +1517,11 @@ enum AKCharacterPositionZ {
 /*!
  @brief 進行度を進める
  
- 進行度を進める。
+ 進行度を進め、実行する進行度に到達したイベントを実行する。
  @param progress 進行度
  */
 - (void)addProgress:(NSInteger)progress
 {
-    self.tileMap.progress += progress;
+    [self.tileMap addProgress:progress data:self];
 }
 @end
@@ -36,7 +36,8 @@
 
 #import "AKToritoma.h"
 
-@class AKEnemyShot;
+@class AKCollisionGrid;
+@class AKEnemyShotEngine;
 
 /*!
  @brief ゲームデータインターフェースプロトコル
@@ -52,25 +53,33 @@
 @property (nonatomic)float scrollSpeedY;
 /// 障害物キャラクター
 @property (nonatomic, readonly)NSArray *blocks;
+/// 障害物当たり判定グリッド
+@property (nonatomic, readonly)AKCollisionGrid *blockGrid;
 /// 自機の位置情報
 @property (nonatomic, readonly)CGPoint playerPosition;
+/// 敵弾エンジン
+@property (nonatomic, readonly)AKEnemyShotEngine *enemyShotEngine;
 
 /// デバイス座標からタイル座標の取得
 - (CGPoint)tilePositionFromDevicePosition:(CGPoint)devicePosition;
 /// 自機弾生成
 - (void)createPlayerShotAtX:(NSInteger)x y:(NSInteger)y;
 /// 反射弾生成
-- (void)createReflectiedShot:(AKEnemyShot *)enemyShot;
+- (void)createReflectedShotType:(NSInteger)type
+                              x:(float)x
+                              y:(float)y
+                         speedX:(float)speedX
+                         speedY:(float)speedY;
+/// 敵弾の一括予約
+- (NSRange)reserveEnemyShots:(NSInteger)count;
 /// 敵生成
 - (void)createEnemy:(NSInteger)type x:(NSInteger)x y:(NSInteger)y progress:(NSInteger)progress;
-/// 敵弾インスタンスの取得
-- (AKEnemyShot *)getEnemyShot;
-/// 敵弾配置ノードの取得
-- (CCNode *)getEnemyShotParent;
 /// 画面効果生成
 - (void)createEffect:(NSInteger)type x:(NSInteger)x y:(NSInteger)y;
 /// 障害物生成
 - (void)createBlock:(NSInteger)type x:(float)x y:(float)y;
+/// 複数のタイルをまとめた障害物生成
+- (void)createBlock:(NSInteger)type x:(float)x y:(float)y colCount:(NSInteger)colCount rowCount:(NSInteger)rowCount;
 /// 失敗時処理
 - (void)miss;
 /// 進行度を進める
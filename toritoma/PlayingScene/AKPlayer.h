@@ -35,6 +35,7 @@
 
 #import "AKCharacter.h"
 #import "AKOption.h"
+#import "AKEnemyShotEngine.h"
 
 // 自機クラス
 @interface AKPlayer : AKCharacter {
@@ -47,7 +48,15 @@
     /// チキンゲージ
     NSInteger chickenGauge_;
     /// オプション
-    AKOption *option_;
+    NSArray *options_;
+    /// 配置中のオプション数
+    NSInteger optionCount_;
+    /// 移動履歴のリングバッファ
+    CGPoint *moveHistory_;
+    /// 移動履歴の次の書き込み位置
+    NSInteger moveHistoryHead_;
+    /// 移動履歴に格納されている座標の数
+    NSInteger moveHistoryCount_;
 }
 
 /// 無敵状態かどうか
@@ -55,7 +64,9 @@
 /// チキンゲージ
 @property (nonatomic)NSInteger chickenGauge;
 /// オプション
-@property (nonatomic, retain)AKOption *option;
+@property (nonatomic, retain)NSArray *options;
+/// 配置中のオプション数
+@property (nonatomic, readonly)NSInteger optionCount;
 
 // 初期化処理
 - (id)initWithParent:(CCNode *)parent optionParent:(CCNode *)optionParent;
@@ -64,7 +75,7 @@
 // 初期化
 - (void)reset;
 // かすり判定
-- (void)graze:(const NSEnumerator *)characters;
+- (void)graze:(AKEnemyShotEngine *)enemyShotEngine;
 // 移動座標設定
 - (void)setPositionX:(float)x y:(float)y data:(id<AKPlayDataInterface>)data;
 // オプション数更新
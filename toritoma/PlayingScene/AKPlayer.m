@@ -34,7 +34,6 @@
  */
 
 #import "AKPlayer.h"
-#import "AKEnemyShot.h"
 
 /// 自機のサイズ
 static const NSInteger kAKPlayerSize = 8;
@@ -52,17 +51,32 @@ static const NSInteger kAKPlayerAnimationCount = 2;
 static const float kAKPlayerShotInterval = 12;
 /// 最大のオプション数
 static const NSInteger kAKMaxOptionCount = 3;
+/// オプション間の距離(移動履歴の座標数)
+static const NSInteger kAKOptionSpace = 20;
+/// 移動履歴の容量(最大のオプション数 * オプション間の距離)
+static const NSInteger kAKMoveHistoryCapacity = 60;
+
+// プライベートメソッド宣言
+@interface AKPlayer ()
+// 移動履歴追加
+- (void)addMoveHistoryX:(float)x y:(float)y;
+// オプション移動
+- (void)moveOptions;
+@end
 
 /*!
  @brief 自機クラス
 
  自機を管理する。
+ オプションは自機の移動履歴を共有し、k番目のオプションはk * kAKOptionSpace個前の座標に移動する。
+ 移動履歴は固定サイズのリングバッファのため、オプション数によらず移動時にメモリ確保や要素の移動は発生しない。
  */
 @implementation AKPlayer
 
 @synthesize isInvincible = isInvincible_;
 @synthesize chickenGauge = chickenGauge_;
-@synthesize option = option_;
+@synthesize options = options_;
+@synthesize optionCount = optionCount_;
 
 /*!
  @brief オブジェクト生成処理
@@ -108,11 +122,36 @@ static const NSInteger kAKMaxOptionCount = 3;
     [parent addChild:self.image];
     
     // オプションを作成する
-    self.option = [[[AKOption alloc] initWithOptionCount:kAKMaxOptionCount parent:optionParent] autorelease];
-                                              
+    NSMutableArray *options = [NSMutableArray arrayWithCapacity:kAKMaxOptionCount];
+    for (NSInteger i = 0; i < kAKMaxOptionCount; i++) {
+        [options addObject:[[[AKOption alloc] initWithParent:optionParent] autorelease]];
+    }
+    self.options = options;
+    optionCount_ = 0;
+    
+    // 移動履歴のバッファを確保する
+    moveHistory_ = malloc(sizeof(CGPoint) * kAKMoveHistoryCapacity);
+    moveHistoryHead_ = 0;
+    moveHistoryCount_ = 0;
+    
     return self;
 }
 
+/*!
+ @brief インスタンス解放時処理
+ 
+ インスタンス解放時にオブジェクトを解放する。
+ */
+- (void)dealloc
+{
+    // メンバを解放する
+    self.options = nil;
+    free(moveHistory_);
+    
+    // スーパークラスの解放処理
+    [super dealloc];
+}
+
 /*!
  @brief キャラクター固有の動作
 
@@ -148,9 +187,9 @@ static const NSInteger kAKMaxOptionCount = 3;
         shootFrame_ = kAKPlayerShotInterval;
     }
     
-    // オプションの移動を行う
-    if (self.option) {
-        [self.option move:data];
+    // 配置中のオプションの移動を行う
+    for (NSInteger i = 0; i < optionCount_; i++) {
+        [[options_ objectAtIndex:i] move:data];
     }
 }
 
@@ -201,9 +240,12 @@ static const NSInteger kAKMaxOptionCount = 3;
     self.chickenGauge = 0;
     
     // 無敵中はブリンクする
-    CCBlink *blink = [CCBlink actionWithDuration:(kAKInvincibleTime / 60)
-                                          blinks:(kAKInvincibleTime / 60) * 8];
-    [self.image runAction:blink];
+    // 画像不使用モードではスプライトがないため、アクションを作成しない
+    if (self.image != nil) {
+        CCBlink *blink = [CCBlink actionWithDuration:(kAKInvincibleTime / 60)
+                                              blinks:(kAKInvincibleTime / 60) * 8];
+        [self.image runAction:blink];
+    }
 }
 
 /*!
@@ -237,62 +279,32 @@ static const NSInteger kAKMaxOptionCount = 3;
  @brief かすり判定
  
  自機が敵弾にかすっているか判定し、かすっている場合は弾のかすりポイントを自機の方へ移す。
- @param characters 判定対象のキャラクター群
+ @param enemyShotEngine 敵弾エンジン
  */
-- (void)graze:(const NSEnumerator *)characters
+- (void)graze:(AKEnemyShotEngine *)enemyShotEngine
 {
     // 画面に配置されていない場合は処理しない
     if (!self.isStaged) {
         return;
     }
     
-    // 自キャラのかすり判定の上下左右の端を計算する
-    float myleft = self.positionX - kAKPlayerGrazeSize / 2.0f;
-    float myright = self.positionX + kAKPlayerGrazeSize / 2.0f;
-    float mytop = self.positionY + kAKPlayerGrazeSize / 2.0f;
-    float mybottom = self.positionY - kAKPlayerGrazeSize / 2.0f;
+    // 自キャラのかすり判定の範囲に入っている弾のかすりポイントを取得する
+    // 弾のかすりポイントは取得時にリセットされる
+    float grazePoint = [enemyShotEngine grazeLeft:self.positionX - kAKPlayerGrazeSize / 2.0f
+                                            right:self.positionX + kAKPlayerGrazeSize / 2.0f
+                                              top:self.positionY + kAKPlayerGrazeSize / 2.0f
+                                           bottom:self.positionY - kAKPlayerGrazeSize / 2.0f];
     
-    // 判定対象のキャラクターごとに判定を行う
-    for (AKEnemyShot *target in characters) {
+    // かすりポイントをチキンゲージに加算する
+    if (grazePoint > 0.0f) {
+        self.chickenGauge += grazePoint;
         
-        // 相手が画面に配置されていない場合は処理しない
-        if (!target.isStaged) {
-            continue;
+        // 最大で100%とする
+        if (self.chickenGauge > 100) {
+            self.chickenGauge = 100;
         }
         
-        // 相手の上下左右の端を計算する
-        float targetleft = target.positionX - target.width / 2.0f;
-        float targetright = target.positionX + target.width / 2.0f;
-        float targettop = target.positionY + target.height / 2.0f;
-        float targetbottom = target.positionY - target.height / 2.0f;
-        
-        AKLog(kAKLogPlayer_1, @"target=(%f, %f, %f, %f)", targetleft, targetright, targettop, targetbottom);
-        
-        // 以下のすべての条件を満たしている時、衝突していると判断する。
-        //   ・相手の右端が自キャラの左端よりも右側にある
-        //   ・相手の左端が自キャラの右端よりも左側にある
-        //   ・相手の上端が自キャラの下端よりも上側にある
-        //   ・相手の下端が自キャラの上端よりも下側にある
-        if ((targetright > myleft) &&
-            (targetleft < myright) &&
-            (targettop > mybottom) &&
-            (targetbottom < mytop)) {
-            
-            // 相手のかすりポイントを取得する
-            if (target.grazePoint > 0.0f) {
-                self.chickenGauge += target.grazePoint;
-                
-                // 最大で100%とする
-                if (self.chickenGauge > 100) {
-                    self.chickenGauge = 100;
-                }
-            }
-            
-            // 相手のかすりポイントをリセットする
-            target.grazePoint = 0.0f;
-            
-            AKLog(kAKLogPlayer_1, @"chickenGauge=%d", self.chickenGauge);
-        }
+        AKLog(kAKLogPlayer_1, @"chickenGauge=%d", self.chickenGauge);
     }
 }
 
@@ -306,9 +318,10 @@ static const NSInteger kAKMaxOptionCount = 3;
  */
 - (void)setPositionX:(float)x y:(float)y data:(id<AKPlayDataInterface>)data
 {
-    // オプションに自分の移動前の座標を通知する
-    if (self.option != nil && self.option.isStaged) {
-        [self.option setPositionX:self.positionX y:self.positionY];
+    // オプションが付属している場合は移動前の座標を移動履歴に追加し、オプションを移動する
+    if (optionCount_ > 0) {
+        [self addMoveHistoryX:self.positionX y:self.positionY];
+        [self moveOptions];
     }
     
     // 移動前の座標を記憶する
@@ -320,15 +333,62 @@ static const NSInteger kAKMaxOptionCount = 3;
     self.positionY = y;
     
     // 障害物との衝突判定を行う
-    [self checkHit:[data.blocks objectEnumerator]
-              data:data
-              func:@selector(moveOfBlockHit:data:)];
+    [self checkHitWithGrid:data.blockGrid
+                      data:data
+                      func:@selector(moveOfBlockHit:data:)];
+}
+
+/*!
+ @brief 移動履歴追加
+ 
+ 移動履歴のリングバッファに座標を追加する。
+ バッファが一杯の場合は最も古い座標を上書きする。
+ @param x x座標
+ @param y y座標
+ */
+- (void)addMoveHistoryX:(float)x y:(float)y
+{
+    moveHistory_[moveHistoryHead_] = ccp(x, y);
+    moveHistoryHead_ = (moveHistoryHead_ + 1) % kAKMoveHistoryCapacity;
+    
+    if (moveHistoryCount_ < kAKMoveHistoryCapacity) {
+        moveHistoryCount_++;
+    }
+}
+
+/*!
+ @brief オプション移動
+ 
+ 配置中のオプションを移動履歴の座標に移動する。
+ k番目のオプションは最新からk * kAKOptionSpace個目の座標に移動する。
+ 移動履歴がその位置まで溜まっていないオプションは移動しない。
+ */
+- (void)moveOptions
+{
+    for (NSInteger i = 0; i < optionCount_; i++) {
+        
+        // 最新の座標からの距離を計算する
+        NSInteger distance = (i + 1) * kAKOptionSpace;
+        
+        // 移動履歴が溜まっていない場合は以降のオプションも移動しない
+        if (distance > moveHistoryCount_) {
+            break;
+        }
+        
+        // 移動履歴の座標に移動する
+        CGPoint point = moveHistory_[(moveHistoryHead_ - distance + kAKMoveHistoryCapacity) % kAKMoveHistoryCapacity];
+        AKOption *option = [options_ objectAtIndex:i];
+        option.positionX = point.x;
+        option.positionY = point.y;
+    }
 }
 
 /*!
  @brief オプション個数更新
  
  チキンゲージに応じてオプション個数を更新する。
+ 増えたオプションは前のオプション(1個目は自機)の位置に配置する。
+ オプションがなくなった場合は移動履歴をクリアする。
  */
 - (void)updateOptionCount
 {
@@ -342,9 +402,23 @@ static const NSInteger kAKMaxOptionCount = 3;
     
     AKLog(kAKLogPlayer_1, @"ゲージ=%d オプション個数=%d", self.chickenGauge, count);
     
-    // 自分の座標を初期座標として次のオプションを設定する
-    if (self.option != nil) {
-        [self.option setOptionCount:count x:self.positionX y:self.positionY];
+    // 増えたオプションを前のオプションの位置に配置する
+    for (NSInteger i = optionCount_; i < count; i++) {
+        AKCharacter *prev = (i > 0 ? [options_ objectAtIndex:i - 1] : self);
+        [[options_ objectAtIndex:i] stageAtX:prev.positionX y:prev.positionY];
+    }
+    
+    // 減ったオプションの配置を解除する
+    for (NSInteger i = count; i < optionCount_; i++) {
+        [[options_ objectAtIndex:i] unstage];
+    }
+    
+    optionCount_ = count;
+    
+    // オプションがなくなった場合は移動履歴をクリアする
+    if (optionCount_ == 0) {
+        moveHistoryHead_ = 0;
+        moveHistoryCount_ = 0;
     }
 }
 
@@ -356,9 +430,97 @@ static const NSInteger kAKMaxOptionCount = 3;
  */
 - (void)setShield:(BOOL)shield
 {
-    // オプションがある場合はオプションのシールド有無を設定する
-    if (self.option != nil) {
-        self.option.shield = shield;
+    // すべてのオプションのシールド有無を設定する
+    for (AKOption *option in options_) {
+        option.shield = shield;
+    }
+}
+
+/*!
+ @brief 画像表示位置更新(補間あり)
+ 
+ 自機はタッチ操作により状態更新の間にも移動するため、補間を行わずに現在の座標に表示する。
+ オプションの表示位置の更新も行う。
+ @param alpha 補間の割合(使用しない)
+ */
+- (void)updateImagePositionWithAlpha:(float)alpha
+{
+    // 現在の座標に表示する
+    [self updateImagePosition];
+    
+    // 配置中のオプションの表示位置を更新する
+    for (NSInteger i = 0; i < optionCount_; i++) {
+        [[options_ objectAtIndex:i] updateImagePositionWithAlpha:alpha];
+    }
+}
+
+/*!
+ @brief 状態の保存
+ 
+ キャラクター共通の状態に続けて、自機固有の状態、移動履歴、オプションの状態を保存する。
+ 移動履歴は古い順に保存する。
+ @param snapshot 保存先
+ */
+- (void)writeSnapshot:(AKSnapshot *)snapshot
+{
+    // スーパークラスの処理を行う
+    [super writeSnapshot:snapshot];
+    
+    NSInteger values[] = {isInvincible_, invincivleFrame_, shootFrame_, chickenGauge_, optionCount_, moveHistoryCount_};
+    [snapshot writeBytes:values length:sizeof(values)];
+    
+    // 移動履歴を古い順に保存する
+    for (NSInteger i = moveHistoryCount_; i > 0; i--) {
+        [snapshot writeBytes:&moveHistory_[(moveHistoryHead_ - i + kAKMoveHistoryCapacity) % kAKMoveHistoryCapacity]
+                      length:sizeof(CGPoint)];
+    }
+    
+    // オプションの状態を保存する
+    for (AKOption *option in options_) {
+        [option writeSnapshot:snapshot];
+    }
+}
+
+/*!
+ @brief 状態の復元
+ 
+ キャラクター共通の状態に続けて、自機固有の状態、移動履歴、オプションの状態を復元する。
+ 移動履歴はバッファの先頭から古い順に格納し直す。
+ 無敵状態の場合は残りの無敵時間でブリンクをやり直す。
+ @param snapshot 読み込み元
+ */
+- (void)readSnapshot:(AKSnapshot *)snapshot
+{
+    // スーパークラスの処理を行う
+    [super readSnapshot:snapshot];
+    
+    NSInteger values[6];
+    [snapshot readBytes:values length:sizeof(values)];
+    isInvincible_ = values[0];
+    invincivleFrame_ = values[1];
+    shootFrame_ = values[2];
+    chickenGauge_ = values[3];
+    optionCount_ = values[4];
+    moveHistoryCount_ = values[5];
+    
+    NSAssert(optionCount_ <= kAKMaxOptionCount && moveHistoryCount_ <= kAKMoveHistoryCapacity,
+             @"オプション数または移動履歴の数が不正");
+    
+    // 移動履歴を古い順に読み込む
+    [snapshot readBytes:moveHistory_ length:sizeof(CGPoint) * moveHistoryCount_];
+    moveHistoryHead_ = moveHistoryCount_ % kAKMoveHistoryCapacity;
+    
+    // 実行中のブリンクを停止し、無敵状態の場合は残り時間でブリンクする
+    [self.image stopAllActions];
+    if (self.image != nil && isInvincible_ && isStaged_) {
+        CCBlink *blink = [CCBlink actionWithDuration:(invincivleFrame_ / 60.0f)
+                                              blinks:(invincivleFrame_ / 60) * 8];
+        [self.image runAction:blink];
+    }
+    
+    // オプションの状態を復元する
+    for (AKOption *option in options_) {
+        [option readSnapshot:snapshot];
     }
 }
 @end
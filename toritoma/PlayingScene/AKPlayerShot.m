@@ -65,7 +65,7 @@ static const NSInteger kAKPlayerShotHeight = 6;
     self.speedY = 0.0f;
     
     // 配置フラグを立てる
-    isStaged_ = YES;
+    self.isStaged = YES;
     
     // 画像名を設定する
     self.imageName = kAKPlayerShotImage;
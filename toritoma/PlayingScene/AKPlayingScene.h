@@ -67,6 +67,8 @@ enum AKGameState {
     enum AKGameState nextState_;
     /// スリープフレーム数
     NSInteger sleepFrame_;
+    /// 状態更新を行っていない経過時間
+    ccTime accumulatedTime_;
     /// 残機表示
     AKLife *life_;
 }
@@ -64,6 +64,10 @@ static const float kAKPlayerMoveVal = 1.8f;
 static const NSInteger kAKStartStage = 1;
 /// ゲームオーバー時の待機フレーム数
 static const NSInteger kAKGameOverWaitFrame = 60;
+/// 1回の状態更新で進める時間
+static const ccTime kAKStepTime = 1.0f / 60.0f;
+/// 1回の画面更新で行う状態更新の最大回数
+static const NSInteger kAKMaxStepCount = 4;
 
 //======================================================================
 // コントロールの表示に関する定数
@@ -78,6 +82,10 @@ static const float kAKLifePosYOfStage = 272.0f;
 static const float kAKScorePosYOfStage = 272.0f;
 /// スコア表示のフォーマット
 static NSString *kAKScoreFormat = @"SCORE:%06d";
+/// スコア表示の数値の桁数
+static const NSInteger kAKScoreDigits = 6;
+/// スコア表示の数値の位置(先頭からの文字数)
+static const NSInteger kAKScoreNumberPosition = 6;
 
 //======================================================================
 // 枠の表示に関する定数
@@ -131,6 +139,8 @@ static NSString *kAKFrameBarRightBottom = @"FrameRightBottom.png";
 - (void)updatePlaying;
 // スリープ処理中の更新処理
 - (void)updateSleep;
+// 固定間隔の状態更新
+- (void)updateStepWithTime:(ccTime)dt;
 // ゲーム再開
 - (void)resume;
 // 終了メニュー表示
@@ -191,6 +201,7 @@ static NSString *kAKFrameBarRightBottom = @"FrameRightBottom.png";
     
     // スリープフレーム数を初期化する
     sleepFrame_ = 0;
+    accumulatedTime_ = 0.0f;
     
     // ゲームデータを生成する
     self.data = [[[AKPlayData alloc] initWithScene:self] autorelease];
@@ -483,13 +494,13 @@ static NSString *kAKFrameBarRightBottom = @"FrameRightBottom.png";
     switch (item.touch.phase) {
         case UITouchPhaseBegan:     // タッチ開始
             // シールドモードを有効にする
-            self.data.shield = YES;
+            [self.data changeShield:YES];
             break;
             
         case UITouchPhaseCancelled: // タッチ取り消し
         case UITouchPhaseEnded:     // タッチ終了
             // シールドモードを無効にする
-            self.data.shield = NO;
+            [self.data changeShield:NO];
             break;
             
         default:                    // その他は無処理
@@ -636,6 +647,7 @@ static NSString *kAKFrameBarRightBottom = @"FrameRightBottom.png";
  @brief 更新処理
  
  ゲームの状態によって、更新処理を行う。
+ プレイ中とスリープ中は経過時間に応じて固定間隔の状態更新を行う。
  @param dt フレーム更新間隔
  */
 - (void)update:(ccTime)dt
@@ -644,21 +656,20 @@ static NSString *kAKFrameBarRightBottom = @"FrameRightBottom.png";
     switch (self.state) {
         case kAKGameStateStart:     // ゲーム開始時
             [self updateStart];
-            break;
             
-        case kAKGameStatePlaying:   // プレイ中
-            [self updatePlaying];
+            // 開始前の経過時間は状態更新に含めない
+            accumulatedTime_ = 0.0f;
             break;
             
+        case kAKGameStatePlaying:   // プレイ中
         case kAKGameStateSleep:     // スリープ中
-            [self updateSleep];
+            [self updateStepWithTime:dt];
             break;
             
         default:
             // その他の状態のときは変化はないため、無処理とする
             break;
     }
-    
 }
 
 #pragma mark AKPlayDataからのシーン操作用
@@ -677,16 +688,13 @@ static NSString *kAKFrameBarRightBottom = @"FrameRightBottom.png";
 /*!
  @brief スコアラベル更新
  
- スコアラベルの文字列を更新する。
+ スコアラベルの数値部分を更新する。
+ 文字列は作成せず、変化した桁のみ更新する。
  @param score スコア
  */
 - (void)setScoreLabel:(NSInteger)score
 {
-    // ラベルに設定する文字列を作成する
-    NSString *string = [NSString stringWithFormat:kAKScoreFormat, score];
-    
-    // ラベルの文字列を変更する
-    [self.score setString:string];
+    [self.score setNumber:score digits:kAKScoreDigits position:kAKScoreNumberPosition];
 }
 
 /*!
@@ -1084,6 +1092,67 @@ static NSString *kAKFrameBarRightBottom = @"FrameRightBottom.png";
     }
 }
 
+/*!
+ @brief 固定間隔の状態更新
+ 
+ 経過時間を蓄積し、状態更新の間隔分の時間が経過するごとに1回状態更新を行う。
+ 画面の更新間隔が変わってもゲームの進行速度が変わらないようにする。
+ 処理落ちで時間が溜まりすぎた場合は最大回数まで状態更新を行い、残りの時間は切り捨てる。
+ 最後にキャラクターの表示位置を前回と今回の状態更新の間で補間し、情報表示を更新する。
+ @param dt フレーム更新間隔
+ */
+- (void)updateStepWithTime:(ccTime)dt
+{
+    // 処理時間を計測している場合はフレームの計測を開始する
+    [self.data.profiler beginFrame];
+    
+    // 経過時間を蓄積する
+    accumulatedTime_ += dt;
+    
+    // 状態更新の間隔分の時間が経過するごとに状態更新を行う
+    for (NSInteger i = 0; i < kAKMaxStepCount && accumulatedTime_ >= kAKStepTime; i++) {
+        
+        // 状態によって処理を分岐する
+        if (self.state == kAKGameStatePlaying) {
+            [self updatePlaying];
+        }
+        else if (self.state == kAKGameStateSleep) {
+            [self updateSleep];
+        }
+        // 状態更新中に他の状態に遷移した場合は処理を終了する
+        else {
+            accumulatedTime_ = 0.0f;
+            [self.data updateHUD];
+            [self.data.profiler endFrame];
+            return;
+        }
+        
+        accumulatedTime_ -= kAKStepTime;
+    }
+    
+    // 最大回数を超えた分の時間は切り捨てる
+    if (accumulatedTime_ >= kAKStepTime) {
+        AKLog(kAKLogPlayingScene_1, @"処理落ち:accumulatedTime_=%f", accumulatedTime_);
+        accumulatedTime_ = fmodf(accumulatedTime_, kAKStepTime);
+    }
+    
+    // ゲームデータの更新を行っている場合は表示位置を補間する
+    // 更新を行っていない場合は補間すると表示位置が前回の位置との間で揺れるため、現在位置に表示する
+    if (self.state == kAKGameStatePlaying ||
+        (self.state == kAKGameStateSleep && nextState_ == kAKGameStateGameOver)) {
+        [self.data updateImagePositionWithAlpha:accumulatedTime_ / kAKStepTime];
+    }
+    else {
+        [self.data updateImagePositionWithAlpha:1.0f];
+    }
+    
+    // 状態更新で変化した情報表示をまとめて更新する
+    [self.data updateHUD];
+    
+    // フレームの計測を終了する
+    [self.data.profiler endFrame];
+}
+
 #pragma mark プライベートメソッド_状態遷移
 
 /*!
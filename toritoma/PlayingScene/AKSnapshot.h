@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2013 Akihiro Kaneda.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1.Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   2.Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   3.Neither the name of the Monochrome Soft nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ @file AKSnapshot.h
+ @brief 状態保存クラス定義
+ 
+ ゲームの状態をバイナリ形式で保存・復元するためのバッファクラスを定義する。
+ */
+
+#import <Foundation/Foundation.h>
+
+/// 状態保存のバイナリ形式の識別子
+extern const uint32_t kAKSnapshotMagic;
+/// 状態保存のバイナリ形式のバージョン
+extern const uint16_t kAKSnapshotVersion;
+
+/// 状態保存のヘッダー
+struct AKSnapshotHeader {
+    uint32_t magic;     ///< 識別子
+    uint16_t version;   ///< バージョン
+    uint16_t reserved;  ///< 予約領域
+    uint32_t length;    ///< ヘッダーを含むデータ全体のバイト数
+};
+
+// 状態保存クラス
+@interface AKSnapshot : NSObject {
+    /// 保存バッファ
+    uint8_t *bytes_;
+    /// 保存バッファのサイズ
+    NSUInteger capacity_;
+    /// 書き込んだデータのバイト数
+    NSUInteger length_;
+    /// 読み込み位置
+    NSUInteger offset_;
+}
+
+/// 書き込んだデータのバイト数
+@property (nonatomic, readonly)NSUInteger length;
+/// 保存バッファのサイズ
+@property (nonatomic, readonly)NSUInteger capacity;
+
+// 初期化処理
+- (id)initWithCapacity:(NSUInteger)capacity;
+// 保存データからの初期化処理
+- (id)initWithData:(NSData *)data;
+// 書き込み開始
+- (void)beginWrite;
+// 書き込み終了
+- (void)endWrite;
+// 読み込み開始
+- (BOOL)beginRead;
+// データの書き込み
+- (void)writeBytes:(const void *)bytes length:(NSUInteger)length;
+// データの読み込み
+- (void)readBytes:(void *)bytes length:(NSUInteger)length;
+// 保存データの取得
+- (NSData *)data;
+@end
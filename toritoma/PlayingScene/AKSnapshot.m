@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2013 Akihiro Kaneda.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1.Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   2.Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   3.Neither the name of the Monochrome Soft nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ @file AKSnapshot.m
+ @brief 状態保存クラス定義
+ 
+ ゲームの状態をバイナリ形式で保存・復元するためのバッファクラスを定義する。
+ */
+
+#import "AKSnapshot.h"
+#import "AKToritoma.h"
+
+/// 状態保存のバイナリ形式の識別子("AKSS")
+const uint32_t kAKSnapshotMagic = 0x53534B41;
+/// 状態保存のバイナリ形式のバージョン
+const uint16_t kAKSnapshotVersion = 6;
+
+/*!
+ @brief 状態保存クラス
+ 
+ ゲームの状態を書き込むバッファを管理する。
+ バッファは初期化時に確保し、書き込み開始のたびに先頭から上書きする。
+ 容量が不足した場合のみバッファを拡張するため、
+ 一度保存した後は同じ規模の状態を繰り返し保存してもメモリの確保は発生しない。
+ データの先頭にはヘッダーを書き込み、復元時に識別子・バージョン・長さを検証する。
+ 数値はデバイスのバイト順で格納する。
+ */
+@implementation AKSnapshot
+
+@synthesize length = length_;
+@synthesize capacity = capacity_;
+
+/*!
+ @brief 初期化処理
+ 
+ 保存バッファを確保する。
+ @param capacity 保存バッファの初期サイズ
+ @return 初期化したオブジェクト。失敗時はnilを返す。
+ */
+- (id)initWithCapacity:(NSUInteger)capacity
+{
+    // スーパークラスの初期化処理を行う
+    self = [super init];
+    if (!self) {
+        AKLog(kAKLogSnapshot_0, @"error");
+        return nil;
+    }
+    
+    // 保存バッファを確保する
+    capacity_ = MAX(capacity, sizeof(struct AKSnapshotHeader));
+    bytes_ = malloc(capacity_);
+    length_ = 0;
+    offset_ = 0;
+    
+    return self;
+}
+
+/*!
+ @brief 保存データからの初期化処理
+ 
+ 保存データを保存バッファにコピーし、ヘッダーを検証する。
+ @param data 保存データ
+ @return 初期化したオブジェクト。ヘッダーが不正な場合はnilを返す。
+ */
+- (id)initWithData:(NSData *)data
+{
+    // 保存データと同じサイズのバッファで初期化する
+    self = [self initWithCapacity:data.length];
+    if (!self) {
+        return nil;
+    }
+    
+    // 保存データをコピーする
+    memcpy(bytes_, data.bytes, data.length);
+    length_ = data.length;
+    
+    // ヘッダーを検証する
+    if (![self beginRead]) {
+        [self release];
+        return nil;
+    }
+    
+    return self;
+}
+
+/*!
+ @brief インスタンス解放時処理
+ 
+ インスタンス解放時に保存バッファを解放する。
+ */
+- (void)dealloc
+{
+    // 保存バッファを解放する
+    free(bytes_);
+    
+    // スーパークラスの解放処理
+    [super dealloc];
+}
+
+/*!
+ @brief 書き込み開始
+ 
+ 前回の保存データを破棄し、ヘッダーを書き込む。
+ ヘッダーの長さは書き込み終了時に設定する。
+ */
+- (void)beginWrite
+{
+    length_ = 0;
+    offset_ = 0;
+    
+    struct AKSnapshotHeader header = {kAKSnapshotMagic, kAKSnapshotVersion, 0, 0};
+    [self writeBytes:&header length:sizeof(header)];
+}
+
+/*!
+ @brief 書き込み終了
+ 
+ 書き込んだデータの長さをヘッダーに設定する。
+ */
+- (void)endWrite
+{
+    struct AKSnapshotHeader *header = (struct AKSnapshotHeader *)bytes_;
+    header->length = (uint32_t)length_;
+    
+    AKLog(kAKLogSnapshot_1, @"length=%u capacity=%u", length_, capacity_);
+}
+
+/*!
+ @brief 読み込み開始
+ 
+ ヘッダーを検証し、読み込み位置をヘッダーの直後に設定する。
+ @return ヘッダーが正しい場合YES
+ */
+- (BOOL)beginRead
+{
+    offset_ = 0;
+    
+    // ヘッダー分のデータがない場合はエラーとする
+    if (length_ < sizeof(struct AKSnapshotHeader)) {
+        AKLog(kAKLogSnapshot_0, @"ヘッダーがない");
+        return NO;
+    }
+    
+    // 識別子・バージョン・長さを検証する
+    struct AKSnapshotHeader header;
+    [self readBytes:&header length:sizeof(header)];
+    if (header.magic != kAKSnapshotMagic ||
+        header.version != kAKSnapshotVersion ||
+        header.length != length_) {
+        
+        AKLog(kAKLogSnapshot_0, @"ヘッダーが不正");
+        offset_ = 0;
+        return NO;
+    }
+    
+    return YES;
+}
+
+/*!
+ @brief データの書き込み
+ 
+ データを保存バッファの末尾に書き込む。
+ 容量が不足する場合はバッファを2倍ずつ拡張する。
+ @param bytes 書き込むデータ
+ @param length 書き込むバイト数
+ */
+- (void)writeBytes:(const void *)bytes length:(NSUInteger)length
+{
+    // 容量が不足する場合はバッファを拡張する
+    if (length_ + length > capacity_) {
+        
+        while (length_ + length > capacity_) {
+            capacity_ *= 2;
+        }
+        bytes_ = realloc(bytes_, capacity_);
+        
+        AKLog(kAKLogSnapshot_1, @"バッファ拡張:capacity=%u", capacity_);
+    }
+    
+    memcpy(bytes_ + length_, bytes, length);
+    length_ += length;
+}
+
+/*!
+ @brief データの読み込み
+ 
+ 現在の読み込み位置から指定したバイト数を読み込み、読み込み位置を進める。
+ @param bytes 読み込み先
+ @param length 読み込むバイト数
+ */
+- (void)readBytes:(void *)bytes length:(NSUInteger)length
+{
+    NSAssert(offset_ + length <= length_, @"保存データの範囲外の読み込み");
+    
+    memcpy(bytes, bytes_ + offset_, length);
+    offset_ += length;
+}
+
+/*!
+ @brief 保存データの取得
+ 
+ 書き込んだデータをコピーして返す。
+ ファイルへの保存などに使用する。
+ @return 保存データ
+ */
+- (NSData *)data
+{
+    return [NSData dataWithBytes:bytes_ length:length_];
+}
+@end
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2013 Akihiro Kaneda.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1.Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   2.Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   3.Neither the name of the Monochrome Soft nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ @file AKStagePack.h
+ @brief ステージパッククラス定義
+ 
+ タイルマップファイルを変換したステージ構成定義のバイナリ形式(ステージパック)を扱うクラスを定義する。
+ */
+
+#import "AKToritoma.h"
+
+/// ステージパックのバイナリ形式の識別子
+extern const uint32_t kAKStagePackMagic;
+/// ステージパックのバイナリ形式のバージョン
+extern const uint16_t kAKStagePackVersion;
+
+/// タイルマップイベントの種類
+enum AKTileMapEventType {
+    kAKTileMapEventTypeBlock = 0,       ///< 障害物作成
+    kAKTileMapEventTypeEnemy,           ///< 敵作成
+    kAKTileMapEventTypeScrollSpeedX,    ///< 水平方向のスクロールスピード変更
+    kAKTileMapEventTypeBGM,             ///< BGM変更
+    kAKTileMapEventTypeClear            ///< ステージクリア
+};
+
+/// タイルマップイベント(ステージパックにそのまま格納するため固定長の型とする)
+struct AKTileMapEvent {
+    int32_t type;                   ///< イベントの種類(enum AKTileMapEventType)
+    int32_t value;                  ///< 障害物・敵の種別、またはイベント実行で使用する値
+    int32_t progress;               ///< 敵を倒した時に進む進行度、またはイベントを実行する進行度
+    float offsetY;                  ///< マップ下端からのy座標
+    int32_t colCount;               ///< まとめたタイルの列数(障害物のみ使用する)
+    int32_t rowCount;               ///< まとめたタイルの行数(障害物のみ使用する)
+};
+
+/// ステージパックのヘッダー
+struct AKStagePackHeader {
+    uint32_t magic;                 ///< 識別子
+    uint16_t version;               ///< バージョン
+    uint16_t layerCount;            ///< 表示レイヤーの数
+    uint32_t length;                ///< ヘッダーを含むデータ全体のバイト数
+    int32_t mapWidth;               ///< マップの幅(タイル数)
+    int32_t mapHeight;              ///< マップの高さ(タイル数)
+    int32_t tileWidth;              ///< タイルの幅
+    int32_t tileHeight;             ///< タイルの高さ
+    int32_t eventCount;             ///< イベントの数
+    int32_t waitEventCapacity;      ///< 進行待ちのイベントのバッファに必要なサイズ
+};
+
+/// ステージパックの表示レイヤー
+struct AKStagePackLayer {
+    char name[32];                  ///< レイヤー名
+    char image[64];                 ///< タイルセットの画像ファイル名
+    int32_t zOrder;                 ///< タイルマップ内の描画順
+    int32_t width;                  ///< レイヤーの幅(タイル数)
+    int32_t height;                 ///< レイヤーの高さ(タイル数)
+    int32_t opacity;                ///< 不透明度
+    int32_t minGid;                 ///< 使用しているGIDの最小値
+    int32_t maxGid;                 ///< 使用しているGIDの最大値
+    int32_t firstGid;               ///< タイルセットの最初のGID
+    int32_t tileWidth;              ///< タイルセットのタイルの幅
+    int32_t tileHeight;             ///< タイルセットのタイルの高さ
+    int32_t spacing;                ///< タイルセットのタイルの間隔
+    int32_t margin;                 ///< タイルセットの余白
+    int32_t imageWidth;             ///< タイルセットの画像の幅
+    int32_t imageHeight;            ///< タイルセットの画像の高さ
+};
+
+// ステージパッククラス
+@interface AKStagePack : NSObject {
+    /// 変換元のタイルマップファイル名(ステージパックファイルから読み込んだ場合はnil)
+    NSString *tileMapFileName_;
+    /// タイルマップファイルから変換したデータ
+    NSData *compiledData_;
+    /// ステージパックファイルをマッピングしたアドレス
+    void *mappedBytes_;
+    /// ステージパックファイルをマッピングしたサイズ
+    size_t mappedLength_;
+    /// ヘッダー
+    const struct AKStagePackHeader *header_;
+    /// 列ごとのイベントの開始位置(列数+1個)
+    const int32_t *colStart_;
+    /// 全列のイベント(列番号順に格納する)
+    const struct AKTileMapEvent *events_;
+    /// 表示レイヤー
+    const struct AKStagePackLayer *layers_;
+    /// 全表示レイヤーのタイル(レイヤー順に格納する)
+    const uint32_t *tiles_;
+}
+
+/// 変換元のタイルマップファイル名(ステージパックファイルから読み込んだ場合はnil)
+@property (nonatomic, retain)NSString *tileMapFileName;
+/// タイルマップファイルから変換したデータ
+@property (nonatomic, retain)NSData *compiledData;
+/// ヘッダー
+@property (nonatomic, readonly)const struct AKStagePackHeader *header;
+/// 列ごとのイベントの開始位置(列数+1個)
+@property (nonatomic, readonly)const int32_t *colStart;
+/// 全列のイベント(列番号順に格納する)
+@property (nonatomic, readonly)const struct AKTileMapEvent *events;
+
+// タイルマップファイルからの初期化処理
+- (id)initWithTileMapFile:(NSString *)fileName;
+// ステージパックファイルからの初期化処理
+- (id)initWithContentsOfFile:(NSString *)path;
+// ステージ番号からの作成
++ (AKStagePack *)stagePackOfStageNo:(NSInteger)stage;
+// ステージの存在確認
++ (BOOL)existsStageNo:(NSInteger)stage;
+// タイルマップファイル名取得
++ (NSString *)tileMapFileNameOfStageNo:(NSInteger)stage;
+// ステージパックファイル名取得
++ (NSString *)stagePackFileNameOfStageNo:(NSInteger)stage;
+// ステージパックファイルの作成
++ (NSInteger)compileAllToDirectory:(NSString *)directory;
+// ステージパックファイルの書き込み
+- (BOOL)writeToFile:(NSString *)path;
+// 表示レイヤー取得
+- (const struct AKStagePackLayer *)layerAtIndex:(NSInteger)index;
+// 表示レイヤーのタイル取得
+- (const uint32_t *)tilesOfLayerAtIndex:(NSInteger)index;
+// チャンクのノード作成
+- (CCNode *)createChunkFromCol:(NSInteger)col count:(NSInteger)count;
+@end
@@ -0,0 +1,1062 @@
+/*
+ * Copyright (c) 2013 Akihiro Kaneda.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1.Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   2.Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   3.Neither the name of the Monochrome Soft nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ @file AKStagePack.m
+ @brief ステージパッククラス定義
+ 
+ タイルマップファイルを変換したステージ構成定義のバイナリ形式(ステージパック)を扱うクラスを定義する。
+ */
+
+#import <sys/mman.h>
+#import <sys/stat.h>
+#import <fcntl.h>
+#import <unistd.h>
+#import "AKStagePack.h"
+#import "AKBlock.h"
+
+/// ステージパックのバイナリ形式の識別子("AKSP")
+const uint32_t kAKStagePackMagic = 0x50534B41;
+/// ステージパックのバイナリ形式のバージョン
+const uint16_t kAKStagePackVersion = 3;
+
+/// タイルマップのファイル名
+static NSString *kAKTileMapFileName = @"Stage_%02d.tmx";
+/// ステージパックのファイル名
+static NSString *kAKStagePackFileName = @"Stage_%02d.akpack";
+
+/// イベントを解析するレイヤーの種類
+enum AKEventLayerType {
+    kAKEventLayerEvent = 0, ///< イベントレイヤー
+    kAKEventLayerBlock,     ///< 障害物レイヤー
+    kAKEventLayerEnemy      ///< 敵レイヤー
+};
+
+/// 障害物レイヤーのタイルをまとめた矩形
+struct AKBlockRect {
+    int32_t col;        ///< 左端の列番号
+    int32_t row;        ///< 上端の行番号
+    int32_t colCount;   ///< 列数
+    int32_t rowCount;   ///< 行数
+    int32_t type;       ///< 障害物の種別
+};
+
+/*!
+ @brief 障害物の矩形の比較
+ 
+ 障害物の矩形を左端の列番号順、同じ列の場合は上端の行番号順に並べるための比較関数。
+ @param a 比較する矩形
+ @param b 比較する矩形
+ @return aが先の場合は負の値、bが先の場合は正の値
+ */
+static int AKCompareBlockRect(const void *a, const void *b)
+{
+    const struct AKBlockRect *rectA = a;
+    const struct AKBlockRect *rectB = b;
+    
+    if (rectA->col != rectB->col) {
+        return (rectA->col < rectB->col ? -1 : 1);
+    }
+    
+    return (rectA->row < rectB->row ? -1 : (rectA->row > rectB->row ? 1 : 0));
+}
+
+/*!
+ @brief ステージパッククラス
+ 
+ ステージ構成定義のタイルマップファイルを、ステージ開始時に解析なしで使用できる形式に変換したものを扱う。
+ ステージパックは以下の順に固定長のデータを並べたもので、数値はデバイスのバイト順で格納する。
+ ヘッダー、列ごとのイベントの開始位置(列数+1個)、イベント(列番号順)、表示レイヤー、表示レイヤーのタイル(レイヤー順)。
+ イベントは障害物・イベント・敵レイヤーのタイルのプロパティを解析したもので、
+ 1列の中ではイベント、障害物、敵のレイヤーの順に、各レイヤーは上の行から順に格納する。
+ 障害物レイヤーは同じ種別のタイルが横に並んだ部分を1つにまとめ、さらに同じ列の範囲で縦に並んだものをまとめた矩形とし、
+ 矩形の左端の列のイベントとして格納する。これにより当たり判定を行う障害物の数を減らす。
+ 表示レイヤーはイベント用の3レイヤー以外の表示するレイヤーで、タイルセットの情報とタイルのGIDを格納する。
+ 障害物の画像は障害物がキャラクターとして表示するため、障害物レイヤーは表示レイヤーに含めない。
+ 
+ ステージパックファイルはmmapでマッピングし、ヘッダーの検証のみを行ってそのまま参照する。
+ タイルマップファイルから作成した場合は同じ形式のデータをメモリ上に作成して参照するため、
+ どちらから作成した場合も同じように扱うことができる。
+ 
+ チャンクのノード作成以外はバックグラウンドのスレッドから呼び出すことができる。
+ 作成処理はファイルのパスの解決にNSBundle、読み込みにmmapとNSDataを使用し、
+ タイルマップファイルの解析はファイルを読み込んだ文字列からCCTMXMapInfoで行う。
+ CCTMXMapInfoは文字列から解析する場合はNSXMLParserとデータの展開のみを使用し、
+ CCFileUtilsやCCTextureCacheなどのcocos2dの共有オブジェクトを使用しない。
+ チャンクのノード作成はCCTMXLayerでテクスチャを読み込むため、メインスレッドからのみ呼び出す。
+ ステージパックファイルはデバッグ時の起動引数でタイルマップファイルから作成する。
+ */
+// プライベートメソッド宣言
+@interface AKStagePack ()
+// ステージパックのデータの設定
+- (BOOL)setupWithBytes:(const void *)bytes length:(size_t)length;
+// タイルマップファイルの解析結果の変換
+- (NSData *)compileMapInfo:(CCTMXMapInfo *)mapInfo;
+// 名前からレイヤー情報の取得
+- (CCTMXLayerInfo *)layerInfoNamed:(NSString *)name mapInfo:(CCTMXMapInfo *)mapInfo;
+// レイヤーごとのイベントの解析
+- (NSInteger)compileEventLayer:(CCTMXLayerInfo *)layer
+                          type:(enum AKEventLayerType)type
+                       mapInfo:(CCTMXMapInfo *)mapInfo
+                           col:(NSInteger)col
+                        events:(NSMutableData *)events;
+// 障害物レイヤーのタイルをまとめた矩形の作成
+- (NSData *)compileBlockLayer:(CCTMXLayerInfo *)layer mapInfo:(CCTMXMapInfo *)mapInfo;
+// タイルのプロパティの解析
+- (BOOL)parseProperties:(NSDictionary *)properties type:(enum AKEventLayerType)type event:(struct AKTileMapEvent *)event;
+// 表示レイヤーの変換
+- (BOOL)compileLayer:(CCTMXLayerInfo *)layerInfo
+             mapInfo:(CCTMXMapInfo *)mapInfo
+              zOrder:(NSInteger)zOrder
+              layers:(NSMutableData *)layers
+               tiles:(NSMutableData *)tiles;
+// レイヤーのタイルセットの取得
+- (CCTMXTilesetInfo *)tilesetForLayer:(CCTMXLayerInfo *)layerInfo mapInfo:(CCTMXMapInfo *)mapInfo;
+@end
+
+@implementation AKStagePack
+
+@synthesize tileMapFileName = tileMapFileName_;
+@synthesize compiledData = compiledData_;
+@synthesize header = header_;
+@synthesize colStart = colStart_;
+@synthesize events = events_;
+
+/*!
+ @brief タイルマップファイルからの初期化処理
+ 
+ タイルマップファイルを解析し、ステージパックの形式に変換する。
+ cocos2dの共有オブジェクトを使用しないため、バックグラウンドのスレッドから呼び出すことができる。
+ @param fileName タイルマップファイル名
+ @return 初期化したオブジェクト。失敗時はnilを返す。
+ */
+- (id)initWithTileMapFile:(NSString *)fileName
+{
+    // スーパークラスの初期化処理を行う
+    self = [super init];
+    if (!self) {
+        AKLog(kAKLogStagePack_0, @"error");
+        return nil;
+    }
+    
+    // 変換元のファイル名を保持する
+    self.tileMapFileName = fileName;
+    
+    // タイルマップファイルを読み込む
+    // cocos2dの共有のファイル管理はスレッドセーフではないため、パスの解決と読み込みはFoundationで行う
+    NSString *path = [[NSBundle mainBundle] pathForResource:fileName ofType:nil];
+    NSString *xml = nil;
+    if (path != nil) {
+        xml = [NSString stringWithContentsOfFile:path encoding:NSUTF8StringEncoding error:NULL];
+    }
+    
+    if (xml == nil) {
+        AKLog(kAKLogStagePack_0, @"タイルマップファイルを読み込めない:%@", fileName);
+        NSAssert(NO, @"タイルマップ読み込みに失敗");
+        [self release];
+        return nil;
+    }
+    
+    // 読み込んだ文字列を解析する
+    // 文字列からの解析はcocos2dの共有オブジェクトを使用しないため、排他制御は行わない
+    CCTMXMapInfo *mapInfo = [CCTMXMapInfo formatWithXML:xml resourcePath:[path stringByDeletingLastPathComponent]];
+    
+    NSAssert(mapInfo != nil, @"タイルマップ読み込みに失敗");
+    
+    // ステージパックの形式に変換する
+    self.compiledData = [self compileMapInfo:mapInfo];
+    
+    // 変換したデータを参照する
+    if (![self setupWithBytes:self.compiledData.bytes length:self.compiledData.length]) {
+        AKLog(kAKLogStagePack_0, @"変換結果が不正:%@", fileName);
+        NSAssert(NO, @"変換結果が不正");
+        [self release];
+        return nil;
+    }
+    
+    return self;
+}
+
+/*!
+ @brief ステージパックファイルからの初期化処理
+ 
+ ステージパックファイルを読み込み専用でメモリにマッピングする。
+ ヘッダーと各データの範囲を検証するのみで、データの解析やコピーは行わない。
+ @param path ステージパックファイルのパス
+ @return 初期化したオブジェクト。失敗時はnilを返す。
+ */
+- (id)initWithContentsOfFile:(NSString *)path
+{
+    // スーパークラスの初期化処理を行う
+    self = [super init];
+    if (!self) {
+        AKLog(kAKLogStagePack_0, @"error");
+        return nil;
+    }
+    
+    // ファイルを開く
+    int fd = open([path fileSystemRepresentation], O_RDONLY);
+    if (fd < 0) {
+        AKLog(kAKLogStagePack_0, @"ファイルを開けない:%@", path);
+        [self release];
+        return nil;
+    }
+    
+    // ファイルのサイズを取得する
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        AKLog(kAKLogStagePack_0, @"ファイルのサイズを取得できない:%@", path);
+        close(fd);
+        [self release];
+        return nil;
+    }
+    
+    // ファイルをマッピングする
+    // マッピング後はファイルを閉じてもマッピングは解除されない
+    void *bytes = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (bytes == MAP_FAILED) {
+        AKLog(kAKLogStagePack_0, @"ファイルをマッピングできない:%@", path);
+        [self release];
+        return nil;
+    }
+    
+    mappedBytes_ = bytes;
+    mappedLength_ = (size_t)st.st_size;
+    
+    // マッピングしたデータを参照する
+    if (![self setupWithBytes:mappedBytes_ length:mappedLength_]) {
+        AKLog(kAKLogStagePack_0, @"ステージパックが不正:%@", path);
+        [self release];
+        return nil;
+    }
+    
+    AKLog(kAKLogStagePack_1, @"path=%@ length=%lu", path, (unsigned long)mappedLength_);
+    
+    return self;
+}
+
+/*!
+ @brief ステージ番号からの作成
+ 
+ ステージ番号に対応するステージパックを作成する。
+ リソースにステージパックファイルがある場合はそれを読み込み、
+ ない場合や読み込みに失敗した場合はタイルマップファイルから変換する。
+ バックグラウンドのスレッドから呼び出すことができる。
+ @param stage ステージ番号
+ @return ステージパック
+ */
++ (AKStagePack *)stagePackOfStageNo:(NSInteger)stage
+{
+    // ステージパックファイルがある場合は読み込む
+    NSString *path = [[NSBundle mainBundle] pathForResource:[AKStagePack stagePackFileNameOfStageNo:stage] ofType:nil];
+    if (path != nil) {
+        
+        AKStagePack *stagePack = [[[AKStagePack alloc] initWithContentsOfFile:path] autorelease];
+        if (stagePack != nil) {
+            return stagePack;
+        }
+    }
+    
+    // タイルマップファイルから変換する
+    return [[[AKStagePack alloc] initWithTileMapFile:[AKStagePack tileMapFileNameOfStageNo:stage]] autorelease];
+}
+
+/*!
+ @brief ステージの存在確認
+ 
+ ステージ番号に対応するステージパックファイルかタイルマップファイルがリソースにあるかを調べる。
+ @param stage ステージ番号
+ @return ファイルがある場合YES、ない場合NO
+ */
++ (BOOL)existsStageNo:(NSInteger)stage
+{
+    NSBundle *bundle = [NSBundle mainBundle];
+    return ([bundle pathForResource:[AKStagePack stagePackFileNameOfStageNo:stage] ofType:nil] != nil ||
+            [bundle pathForResource:[AKStagePack tileMapFileNameOfStageNo:stage] ofType:nil] != nil);
+}
+
+/*!
+ @brief タイルマップファイル名取得
+ 
+ ステージ番号からタイルマップのファイル名を取得する。
+ @param stage ステージ番号
+ @return タイルマップファイル名
+ */
++ (NSString *)tileMapFileNameOfStageNo:(NSInteger)stage
+{
+    return [NSString stringWithFormat:kAKTileMapFileName, stage];
+}
+
+/*!
+ @brief ステージパックファイル名取得
+ 
+ ステージ番号からステージパックのファイル名を取得する。
+ @param stage ステージ番号
+ @return ステージパックファイル名
+ */
++ (NSString *)stagePackFileNameOfStageNo:(NSInteger)stage
+{
+    return [NSString stringWithFormat:kAKStagePackFileName, stage];
+}
+
+/*!
+ @brief ステージパックファイルの作成
+ 
+ リソースにあるタイルマップファイルをステージ1から順に変換し、指定したディレクトリにステージパックファイルを書き込む。
+ タイルマップファイルがないステージ番号に達した時点で終了する。
+ 作成したファイルをリソースに追加することで、ゲームはステージパックファイルを使用するようになる。
+ @param directory 書き込み先のディレクトリ
+ @return 作成したファイルの数。書き込みに失敗した場合は-1を返す。
+ */
++ (NSInteger)compileAllToDirectory:(NSString *)directory
+{
+    NSInteger count = 0;
+    for (NSInteger stage = 1; ; stage++) {
+        
+        // タイルマップファイルがない場合は終了する
+        NSString *fileName = [AKStagePack tileMapFileNameOfStageNo:stage];
+        if ([[NSBundle mainBundle] pathForResource:fileName ofType:nil] == nil) {
+            break;
+        }
+        
+        // タイルマップファイルを変換して書き込む
+        AKStagePack *stagePack = [[AKStagePack alloc] initWithTileMapFile:fileName];
+        NSString *path = [directory stringByAppendingPathComponent:[AKStagePack stagePackFileNameOfStageNo:stage]];
+        BOOL isSuccess = [stagePack writeToFile:path];
+        [stagePack release];
+        
+        if (!isSuccess) {
+            AKLog(kAKLogStagePack_0, @"書き込みに失敗:%@", path);
+            return -1;
+        }
+        
+        AKLog(kAKLogStagePack_1, @"%@ -> %@", fileName, path);
+        count++;
+    }
+    
+    return count;
+}
+
+/*!
+ @brief オブジェクト解放処理
+ 
+ オブジェクトの解放を行う。ファイルをマッピングしている場合はマッピングを解除する。
+ */
+- (void)dealloc
+{
+    // メンバを解放する
+    self.tileMapFileName = nil;
+    self.compiledData = nil;
+    
+    // マッピングを解除する
+    if (mappedBytes_ != NULL) {
+        munmap(mappedBytes_, mappedLength_);
+    }
+    
+    // スーパークラスの処理を行う
+    [super dealloc];
+}
+
+/*!
+ @brief ステージパックのデータの設定
+ 
+ ヘッダーの識別子・バージョン・長さと、各データがデータの範囲内に収まっていることを検証し、
+ 各データの先頭アドレスを設定する。
+ @param bytes ステージパックのデータ
+ @param length データのバイト数
+ @return 正しいデータの場合YES、不正なデータの場合NO
+ */
+- (BOOL)setupWithBytes:(const void *)bytes length:(size_t)length
+{
+    // ヘッダーを検証する
+    if (length < sizeof(struct AKStagePackHeader)) {
+        AKLog(kAKLogStagePack_0, @"ヘッダーが不足:%lu", (unsigned long)length);
+        return NO;
+    }
+    
+    const struct AKStagePackHeader *header = bytes;
+    if (header->magic != kAKStagePackMagic ||
+        header->version != kAKStagePackVersion ||
+        header->length != length) {
+        
+        AKLog(kAKLogStagePack_0, @"ヘッダーが不正:magic=%08x version=%d length=%u",
+              header->magic, header->version, header->length);
+        return NO;
+    }
+    
+    if (header->mapWidth <= 0 || header->mapHeight <= 0 ||
+        header->eventCount < 0 || header->waitEventCapacity <= 0) {
+        
+        AKLog(kAKLogStagePack_0, @"マップのサイズが不正");
+        return NO;
+    }
+    
+    // 各データの位置を求め、データの範囲内に収まっていることを確認する
+    // 不正な値で桁あふれしないように64ビットで計算する
+    const uint8_t *top = bytes;
+    uint64_t offset = sizeof(struct AKStagePackHeader);
+    size_t colStartOffset = (size_t)offset;
+    offset += sizeof(int32_t) * ((uint64_t)header->mapWidth + 1);
+    size_t eventsOffset = (size_t)offset;
+    offset += sizeof(struct AKTileMapEvent) * (uint64_t)header->eventCount;
+    size_t layersOffset = (size_t)offset;
+    offset += sizeof(struct AKStagePackLayer) * (uint64_t)header->layerCount;
+    if (offset > length) {
+        AKLog(kAKLogStagePack_0, @"データが不足");
+        return NO;
+    }
+    
+    const struct AKStagePackLayer *layers = (const struct AKStagePackLayer *)(top + layersOffset);
+    size_t tilesOffset = (size_t)offset;
+    for (NSInteger i = 0; i < header->layerCount; i++) {
+        
+        if (layers[i].width <= 0 || layers[i].height <= 0) {
+            AKLog(kAKLogStagePack_0, @"レイヤーのサイズが不正:%d", i);
+            return NO;
+        }
+        
+        offset += sizeof(uint32_t) * (uint64_t)layers[i].width * (uint64_t)layers[i].height;
+        if (offset > length) {
+            AKLog(kAKLogStagePack_0, @"タイルのデータが不足:%d", i);
+            return NO;
+        }
+    }
+    
+    if (offset != length) {
+        AKLog(kAKLogStagePack_0, @"データの長さが不正:%lu", (unsigned long)offset);
+        return NO;
+    }
+    
+    // 列ごとの開始位置が昇順でイベントの範囲内に収まっていることを確認する
+    const int32_t *colStart = (const int32_t *)(top + colStartOffset);
+    if (colStart[0] != 0 || colStart[header->mapWidth] != header->eventCount) {
+        AKLog(kAKLogStagePack_0, @"列の開始位置が不正");
+        return NO;
+    }
+    
+    for (NSInteger i = 0; i < header->mapWidth; i++) {
+        if (colStart[i] > colStart[i + 1]) {
+            AKLog(kAKLogStagePack_0, @"列の開始位置が不正:%d", i);
+            return NO;
+        }
+    }
+    
+    // 各データの先頭アドレスを設定する
+    header_ = header;
+    colStart_ = colStart;
+    events_ = (const struct AKTileMapEvent *)(top + eventsOffset);
+    layers_ = layers;
+    tiles_ = (const uint32_t *)(top + tilesOffset);
+    
+    return YES;
+}
+
+/*!
+ @brief ステージパックファイルの書き込み
+ 
+ ステージパックのデータをファイルに書き込む。
+ @param path 書き込み先のパス
+ @return 成功した場合YES、失敗した場合NO
+ */
+- (BOOL)writeToFile:(NSString *)path
+{
+    NSData *data = [NSData dataWithBytesNoCopy:(void *)header_ length:header_->length freeWhenDone:NO];
+    return [data writeToFile:path atomically:YES];
+}
+
+/*!
+ @brief 表示レイヤー取得
+ 
+ 表示レイヤーの情報を取得する。
+ @param index 表示レイヤーの番号
+ @return 表示レイヤー
+ */
+- (const struct AKStagePackLayer *)layerAtIndex:(NSInteger)index
+{
+    NSAssert(index >= 0 && index < header_->layerCount, @"表示レイヤーの番号が範囲外");
+    return &layers_[index];
+}
+
+/*!
+ @brief 表示レイヤーのタイル取得
+ 
+ 表示レイヤーの全タイルのGIDを取得する。上の行から順に、各行は左の列から順に格納している。
+ @param index 表示レイヤーの番号
+ @return タイルのGID
+ */
+- (const uint32_t *)tilesOfLayerAtIndex:(NSInteger)index
+{
+    NSAssert(index >= 0 && index < header_->layerCount, @"表示レイヤーの番号が範囲外");
+    
+    const uint32_t *tiles = tiles_;
+    for (NSInteger i = 0; i < index; i++) {
+        tiles += layers_[i].width * layers_[i].height;
+    }
+    
+    return tiles;
+}
+
+/*!
+ @brief チャンクのノード作成
+ 
+ 指定した列の範囲を切り出した表示レイヤーでチャンクのノードを作成する。
+ ノードの位置はマップの左端からの範囲の左端の位置とする。
+ タイルマップファイルから変換した場合も変換済みのデータから作成し、タイルマップファイルの解析は行わない。
+ テクスチャを読み込むため、メインスレッドから呼び出すこと。
+ @param col 範囲の最初の列番号
+ @param count 範囲の列数
+ @return チャンクのノード
+ */
+- (CCNode *)createChunkFromCol:(NSInteger)col count:(NSInteger)count
+{
+    NSAssert(col >= 0 && count > 0, @"列の範囲が不正");
+    
+    // 表示レイヤーを配置するノードを作成する
+    CCNode *chunk = [CCNode node];
+    chunk.position = ccp(col * header_->tileWidth, 0);
+    
+    // 各レイヤーに共通のマップ情報を作成する
+    CCTMXMapInfo *mapInfo = [[[CCTMXMapInfo alloc] init] autorelease];
+    mapInfo.orientation = CCTMXOrientationOrtho;
+    mapInfo.mapSize = CGSizeMake(header_->mapWidth, header_->mapHeight);
+    mapInfo.tileSize = CGSizeMake(header_->tileWidth, header_->tileHeight);
+    
+    CGSize contentSize = CGSizeZero;
+    for (NSInteger i = 0; i < header_->layerCount; i++) {
+        
+        const struct AKStagePackLayer *layer = &layers_[i];
+        
+        // レイヤーの範囲外の場合は作成しない
+        NSInteger width = MIN(count, layer->width - col);
+        if (width <= 0) {
+            continue;
+        }
+        
+        // タイルセットの情報を作成する
+        CCTMXTilesetInfo *tilesetInfo = [[[CCTMXTilesetInfo alloc] init] autorelease];
+        tilesetInfo.name = [NSString stringWithUTF8String:layer->image];
+        tilesetInfo.sourceImage = [NSString stringWithUTF8String:layer->image];
+        tilesetInfo.firstGid = layer->firstGid;
+        tilesetInfo.tileSize = CGSizeMake(layer->tileWidth, layer->tileHeight);
+        tilesetInfo.spacing = layer->spacing;
+        tilesetInfo.margin = layer->margin;
+        tilesetInfo.imageSize = CGSizeMake(layer->imageWidth, layer->imageHeight);
+        
+        // レイヤーの情報を作成する
+        // タイルのバッファはレイヤーが解放するため、範囲の列を行ごとにコピーして渡す
+        const uint32_t *tiles = [self tilesOfLayerAtIndex:i];
+        CCTMXLayerInfo *layerInfo = [[[CCTMXLayerInfo alloc] init] autorelease];
+        layerInfo.name = [NSString stringWithUTF8String:layer->name];
+        layerInfo.layerSize = CGSizeMake(width, layer->height);
+        layerInfo.tiles = malloc(sizeof(uint32_t) * width * layer->height);
+        for (NSInteger row = 0; row < layer->height; row++) {
+            memcpy(&layerInfo.tiles[row * width], &tiles[row * layer->width + col], sizeof(uint32_t) * width);
+        }
+        layerInfo.visible = YES;
+        layerInfo.opacity = layer->opacity;
+        layerInfo.minGID = layer->minGid;
+        layerInfo.maxGID = layer->maxGid;
+        
+        // レイヤーを作成する
+        CCTMXLayer *tmxLayer = [CCTMXLayer layerWithTilesetInfo:tilesetInfo layerInfo:layerInfo mapInfo:mapInfo];
+        layerInfo.ownTiles = NO;
+        [tmxLayer setupTiles];
+        
+        [chunk addChild:tmxLayer z:layer->zOrder tag:layer->zOrder];
+        
+        // ノードのサイズは全レイヤーを含むサイズとする
+        contentSize.width = MAX(contentSize.width, tmxLayer.contentSize.width);
+        contentSize.height = MAX(contentSize.height, tmxLayer.contentSize.height);
+    }
+    
+    chunk.contentSize = contentSize;
+    
+    return chunk;
+}
+
+/*!
+ @brief タイルマップファイルの解析結果の変換
+ 
+ 障害物・イベント・敵レイヤーの全タイルのプロパティを解析して列番号順のイベントの配列を作成し、
+ それ以外の表示するレイヤーのタイルとあわせてステージパックの形式のデータを作成する。
+ 進行待ちのイベントのバッファはイベントレイヤーのイベントがすべて待機した場合の数とする。
+ @param mapInfo タイルマップファイルの解析結果
+ @return ステージパックの形式のデータ
+ */
+- (NSData *)compileMapInfo:(CCTMXMapInfo *)mapInfo
+{
+    // 各レイヤーの情報を取得する
+    CCTMXLayerInfo *blockLayer = [self layerInfoNamed:@"Block" mapInfo:mapInfo];
+    CCTMXLayerInfo *eventLayer = [self layerInfoNamed:@"Event" mapInfo:mapInfo];
+    CCTMXLayerInfo *enemyLayer = [self layerInfoNamed:@"Enemy" mapInfo:mapInfo];
+    
+    NSAssert(blockLayer != nil, @"障害物レイヤーの取得に失敗");
+    NSAssert(eventLayer != nil, @"イベントレイヤーの取得に失敗");
+    
+    // 障害物レイヤーのタイルをまとめた矩形を作成する
+    NSData *blockRectData = [self compileBlockLayer:blockLayer mapInfo:mapInfo];
+    const struct AKBlockRect *blockRects = blockRectData.bytes;
+    NSInteger blockRectCount = blockRectData.length / sizeof(struct AKBlockRect);
+    NSInteger blockRectIndex = 0;
+    
+    // 列ごとの開始位置とイベントを作成する
+    NSInteger colCount = mapInfo.mapSize.width;
+    NSMutableData *colStartData = [NSMutableData dataWithLength:sizeof(int32_t) * (colCount + 1)];
+    NSMutableData *eventData = [NSMutableData data];
+    int32_t *colStart = colStartData.mutableBytes;
+    NSInteger eventCount = 0;
+    NSInteger layerEventCount = 0;
+    for (NSInteger col = 0; col < colCount; col++) {
+        
+        // 列の開始位置を設定する
+        colStart[col] = eventCount;
+        
+        // イベントレイヤー、障害物レイヤー、敵レイヤーの順に解析する
+        NSInteger count = [self compileEventLayer:eventLayer type:kAKEventLayerEvent mapInfo:mapInfo col:col events:eventData];
+        layerEventCount += count;
+        eventCount += count;
+        
+        // 左端がこの列にある障害物の矩形をイベントとして追加する
+        // y座標は矩形の上下の真ん中とする
+        for (; blockRectIndex < blockRectCount && blockRects[blockRectIndex].col == col; blockRectIndex++) {
+            
+            const struct AKBlockRect *rect = &blockRects[blockRectIndex];
+            struct AKTileMapEvent event;
+            memset(&event, 0, sizeof(event));
+            event.type = kAKTileMapEventTypeBlock;
+            event.value = rect->type;
+            event.offsetY = (mapInfo.mapSize.height - (rect->row + rect->rowCount / 2.0f)) * mapInfo.tileSize.height;
+            event.colCount = rect->colCount;
+            event.rowCount = rect->rowCount;
+            
+            [eventData appendBytes:&event length:sizeof(event)];
+            eventCount++;
+        }
+        
+        eventCount += [self compileEventLayer:enemyLayer type:kAKEventLayerEnemy mapInfo:mapInfo col:col events:eventData];
+    }
+    
+    // 終端を設定する
+    colStart[colCount] = eventCount;
+    
+    // 表示レイヤーを変換する
+    // 描画順はcocos2dのタイルマップと同じく表示するレイヤーの並び順とする
+    NSMutableData *layerData = [NSMutableData data];
+    NSMutableData *tileData = [NSMutableData data];
+    NSInteger layerCount = 0;
+    NSInteger zOrder = 0;
+    for (CCTMXLayerInfo *layerInfo in mapInfo.layers) {
+        
+        // 非表示のレイヤーは処理しない
+        if (!layerInfo.visible) {
+            continue;
+        }
+        
+        // イベント用のレイヤー以外を変換する
+        if (layerInfo != blockLayer && layerInfo != eventLayer && layerInfo != enemyLayer) {
+            if ([self compileLayer:layerInfo mapInfo:mapInfo zOrder:zOrder layers:layerData tiles:tileData]) {
+                layerCount++;
+            }
+        }
+        
+        zOrder++;
+    }
+    
+    // ヘッダーを作成する
+    struct AKStagePackHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = kAKStagePackMagic;
+    header.version = kAKStagePackVersion;
+    header.layerCount = layerCount;
+    header.length = sizeof(header) + colStartData.length + eventData.length + layerData.length + tileData.length;
+    header.mapWidth = mapInfo.mapSize.width;
+    header.mapHeight = mapInfo.mapSize.height;
+    header.tileWidth = mapInfo.tileSize.width;
+    header.tileHeight = mapInfo.tileSize.height;
+    header.eventCount = eventCount;
+    header.waitEventCapacity = MAX(layerEventCount, 1);
+    
+    AKLog(kAKLogStagePack_1, @"colCount=%d eventCount=%d layerCount=%d length=%u",
+          colCount, eventCount, layerCount, header.length);
+    
+    // 各データを連結する
+    NSMutableData *data = [NSMutableData dataWithCapacity:header.length];
+    [data appendBytes:&header length:sizeof(header)];
+    [data appendData:colStartData];
+    [data appendData:eventData];
+    [data appendData:layerData];
+    [data appendData:tileData];
+    
+    return data;
+}
+
+/*!
+ @brief 名前からレイヤー情報の取得
+ 
+ タイルマップファイルの解析結果から指定した名前のレイヤーの情報を取得する。
+ @param name レイヤー名
+ @param mapInfo タイルマップファイルの解析結果
+ @return レイヤー情報。存在しない場合はnilを返す。
+ */
+- (CCTMXLayerInfo *)layerInfoNamed:(NSString *)name mapInfo:(CCTMXMapInfo *)mapInfo
+{
+    for (CCTMXLayerInfo *layerInfo in [mapInfo.layers objectEnumerator]) {
+        if ([layerInfo.name isEqualToString:name]) {
+            return layerInfo;
+        }
+    }
+    
+    return nil;
+}
+
+/*!
+ @brief レイヤーごとのイベントの解析
+ 
+ 指定されたレイヤーの1列分のタイルを解析し、イベントのデータの末尾に追加する。
+ レイヤーが存在しない場合は何もしない。
+ @param layer レイヤー情報
+ @param type レイヤーの種類
+ @param mapInfo タイルマップファイルの解析結果
+ @param col 列番号
+ @param events 追加先のイベントのデータ
+ @return 追加したイベントの数
+ */
+- (NSInteger)compileEventLayer:(CCTMXLayerInfo *)layer
+                          type:(enum AKEventLayerType)type
+                       mapInfo:(CCTMXMapInfo *)mapInfo
+                           col:(NSInteger)col
+                        events:(NSMutableData *)events
+{
+    // レイヤーが存在しない場合は処理しない
+    if (layer == nil) {
+        return 0;
+    }
+    
+    // レイヤーの一番上の行から一番下の行まで処理を行う
+    NSInteger count = 0;
+    NSInteger rowCount = mapInfo.mapSize.height;
+    NSInteger layerWidth = layer.layerSize.width;
+    for (NSInteger i = 0; i < rowCount; i++) {
+        
+        // タイルのGIDを取得する
+        // 反転のフラグは除外する
+        unsigned int tileGid = layer.tiles[col + i * layerWidth] & kCCFlippedMask;
+        
+        // タイルが存在しない場合は処理しない
+        if (tileGid == 0) {
+            continue;
+        }
+        
+        // プロパティを取得する
+        NSDictionary *properties = [mapInfo.tileProperties objectForKey:[NSNumber numberWithUnsignedInt:tileGid]];
+        if (properties == nil) {
+            continue;
+        }
+        
+        // プロパティを解析する
+        struct AKTileMapEvent event;
+        memset(&event, 0, sizeof(event));
+        if (![self parseProperties:properties type:type event:&event]) {
+            continue;
+        }
+        
+        // y座標はマップの下端 + (マップの行数 - 行番号) * タイルサイズ (行番号は上から0,1,2…)
+        // タイルの真ん中を指定するために行番号には+0.5する
+        event.offsetY = (rowCount - (i + 0.5)) * mapInfo.tileSize.height;
+        
+        [events appendBytes:&event length:sizeof(event)];
+        count++;
+    }
+    
+    return count;
+}
+
+/*!
+ @brief 障害物レイヤーのタイルをまとめた矩形の作成
+ 
+ 障害物レイヤーの同じ種別のタイルが横に並んでいる部分を1つの矩形にまとめ、
+ 上の行の矩形と列の範囲と種別が同じ場合は縦にもまとめる。
+ 当たり判定のサイズがタイルのサイズより小さい種別は隙間ができるため、その方向にはまとめない。
+ 矩形は左端の列番号順、同じ列の場合は上端の行番号順に並べる。
+ @param layer レイヤー情報
+ @param mapInfo タイルマップファイルの解析結果
+ @return 矩形(struct AKBlockRect)を並べたデータ
+ */
+- (NSData *)compileBlockLayer:(CCTMXLayerInfo *)layer mapInfo:(CCTMXMapInfo *)mapInfo
+{
+    NSMutableData *rectData = [NSMutableData data];
+    
+    // レイヤーが存在しない場合は処理しない
+    if (layer == nil) {
+        return rectData;
+    }
+    
+    NSInteger colCount = mapInfo.mapSize.width;
+    NSInteger rowCount = mapInfo.mapSize.height;
+    NSInteger layerWidth = layer.layerSize.width;
+    
+    // 上の行で各列を左端とする矩形の位置(矩形がない場合は-1)
+    NSMutableData *aboveData = [NSMutableData dataWithLength:sizeof(NSInteger) * colCount];
+    NSMutableData *currentData = [NSMutableData dataWithLength:sizeof(NSInteger) * colCount];
+    NSInteger *above = aboveData.mutableBytes;
+    NSInteger *current = currentData.mutableBytes;
+    for (NSInteger col = 0; col < colCount; col++) {
+        above[col] = -1;
+    }
+    
+    NSInteger tileCount = 0;
+    for (NSInteger row = 0; row < rowCount; row++) {
+        
+        for (NSInteger col = 0; col < colCount; col++) {
+            current[col] = -1;
+        }
+        
+        NSInteger col = 0;
+        while (col < colCount) {
+            
+            // タイルの障害物の種別を取得する
+            NSInteger type = 0;
+            unsigned int tileGid = layer.tiles[col + row * layerWidth] & kCCFlippedMask;
+            NSDictionary *properties = (tileGid != 0 ? [mapInfo.tileProperties objectForKey:[NSNumber numberWithUnsignedInt:tileGid]] : nil);
+            struct AKTileMapEvent event;
+            if (properties != nil && [self parseProperties:properties type:kAKEventLayerBlock event:&event]) {
+                type = event.value;
+            }
+            
+            // 障害物がない場合は次の列へ進む
+            if (type <= 0) {
+                col++;
+                continue;
+            }
+            
+            // 当たり判定がタイルと同じサイズの場合のみ、隣のタイルとまとめる
+            CGSize hitSize = [AKBlock hitSizeOfType:type];
+            BOOL canMergeX = (hitSize.width == mapInfo.tileSize.width);
+            BOOL canMergeY = (hitSize.height == mapInfo.tileSize.height);
+            
+            // 同じ種別のタイルが横に並んでいる範囲を求める
+            NSInteger runCount = 1;
+            while (canMergeX && col + runCount < colCount) {
+                
+                unsigned int nextGid = layer.tiles[col + runCount + row * layerWidth] & kCCFlippedMask;
+                NSDictionary *nextProperties = (nextGid != 0 ? [mapInfo.tileProperties objectForKey:[NSNumber numberWithUnsignedInt:nextGid]] : nil);
+                if (nextProperties == nil ||
+                    ![self parseProperties:nextProperties type:kAKEventLayerBlock event:&event] ||
+                    event.value != type) {
+                    break;
+                }
+                
+                runCount++;
+            }
+            tileCount += runCount;
+            
+            // 上の行に同じ列の範囲と種別の矩形がある場合は縦に伸ばす
+            struct AKBlockRect *rects = rectData.mutableBytes;
+            NSInteger index = above[col];
+            if (canMergeY && index >= 0 && rects[index].colCount == runCount && rects[index].type == type) {
+                rects[index].rowCount++;
+            }
+            // ない場合は新しい矩形を作成する
+            else {
+                struct AKBlockRect rect = {col, row, runCount, 1, type};
+                [rectData appendBytes:&rect length:sizeof(rect)];
+                index = rectData.length / sizeof(struct AKBlockRect) - 1;
+            }
+            current[col] = index;
+            
+            col += runCount;
+        }
+        
+        // 現在の行を次の行の上の行とする
+        NSInteger *work = above;
+        above = current;
+        current = work;
+    }
+    
+    // 左端の列番号順に並べる
+    NSInteger count = rectData.length / sizeof(struct AKBlockRect);
+    qsort(rectData.mutableBytes, count, sizeof(struct AKBlockRect), AKCompareBlockRect);
+    
+    AKLog(kAKLogStagePack_1, @"障害物のタイル数=%d 矩形数=%d", tileCount, count);
+    
+    return rectData;
+}
+
+/*!
+ @brief タイルのプロパティの解析
+ 
+ タイルのプロパティからイベントの種類とパラメータを取得する。
+ 障害物レイヤーのプロパティは以下のとおり。
+ Type:障害物の種別
+ 
+ 敵レイヤーのプロパティは以下のとおり。
+ Type:敵の種別
+ Progress:倒した時に進む進行度
+ 
+ イベントレイヤーのプロパティは以下のとおり。
+ Type:イベントの種類
+ Value:イベント実行で使用する値
+ Progress:ステージ進行度がこの値以上のときにイベント実行する
+ 
+ イベントの種類は以下のとおり、
+ bgm:BGMを変更する
+ hspeed:水平方向のスクロールスピードを変更する
+ clear:ステージクリアのフラグを立てる
+ @param properties タイルのプロパティ
+ @param type タイルのレイヤーの種類
+ @param event 解析結果を格納するイベント
+ @return 解析に成功した場合YES、不明な種別の場合NO
+ */
+- (BOOL)parseProperties:(NSDictionary *)properties type:(enum AKEventLayerType)type event:(struct AKTileMapEvent *)event
+{
+    // 障害物レイヤーの場合
+    if (type == kAKEventLayerBlock) {
+        event->type = kAKTileMapEventTypeBlock;
+        event->value = [[properties objectForKey:@"Type"] integerValue];
+        event->progress = 0;
+        return YES;
+    }
+    
+    // 敵レイヤーの場合
+    if (type == kAKEventLayerEnemy) {
+        event->type = kAKTileMapEventTypeEnemy;
+        event->value = [[properties objectForKey:@"Type"] integerValue];
+        event->progress = [[properties objectForKey:@"Progress"] integerValue];
+        return YES;
+    }
+    
+    // イベントレイヤーの場合は種別を取得する
+    NSString *type = [properties objectForKey:@"Type"];
+    
+    // 水平方向のスクロールスピード変更の場合
+    if ([type isEqualToString:@"hspeed"]) {
+        event->type = kAKTileMapEventTypeScrollSpeedX;
+    }
+    // BGM変更の場合
+    else if ([type isEqualToString:@"bgm"]) {
+        event->type = kAKTileMapEventTypeBGM;
+    }
+    // ステージクリアの場合
+    else if ([type isEqualToString:@"clear"]) {
+        event->type = kAKTileMapEventTypeClear;
+    }
+    // 不明な種別の場合
+    else {
+        AKLog(kAKLogStagePack_0, @"不明な種別:%@", type);
+        NSAssert(NO, @"不明な種別");
+        return NO;
+    }
+    
+    // 値と実行する進行度を取得する
+    event->value = [[properties objectForKey:@"Value"] integerValue];
+    event->progress = [[properties objectForKey:@"Progress"] integerValue];
+    
+    return YES;
+}
+
+/*!
+ @brief 表示レイヤーの変換
+ 
+ 表示するレイヤーのタイルセットの情報とタイルを表示レイヤーのデータの末尾に追加する。
+ タイルが1つもないレイヤーはcocos2dのタイルマップでも作成されないため変換しない。
+ @param layerInfo レイヤー情報
+ @param mapInfo タイルマップファイルの解析結果
+ @param zOrder タイルマップ内の描画順
+ @param layers 追加先の表示レイヤーのデータ
+ @param tiles 追加先のタイルのデータ
+ @return 変換した場合YES、タイルがないため変換しなかった場合NO
+ */
+- (BOOL)compileLayer:(CCTMXLayerInfo *)layerInfo
+             mapInfo:(CCTMXMapInfo *)mapInfo
+              zOrder:(NSInteger)zOrder
+              layers:(NSMutableData *)layers
+               tiles:(NSMutableData *)tiles
+{
+    // タイルセットを取得する
+    CCTMXTilesetInfo *tileset = [self tilesetForLayer:layerInfo mapInfo:mapInfo];
+    if (tileset == nil) {
+        AKLog(kAKLogStagePack_1, @"タイルのないレイヤー:%@", layerInfo.name);
+        return NO;
+    }
+    
+    NSString *image = [tileset.sourceImage lastPathComponent];
+    
+    struct AKStagePackLayer layer;
+    memset(&layer, 0, sizeof(layer));
+    
+    NSAssert([layerInfo.name lengthOfBytesUsingEncoding:NSUTF8StringEncoding] < sizeof(layer.name), @"レイヤー名が長すぎる");
+    NSAssert([image lengthOfBytesUsingEncoding:NSUTF8StringEncoding] < sizeof(layer.image), @"画像ファイル名が長すぎる");
+    
+    strncpy(layer.name, [layerInfo.name UTF8String], sizeof(layer.name) - 1);
+    strncpy(layer.image, [image UTF8String], sizeof(layer.image) - 1);
+    layer.zOrder = zOrder;
+    layer.width = layerInfo.layerSize.width;
+    layer.height = layerInfo.layerSize.height;
+    layer.opacity = layerInfo.opacity;
+    layer.minGid = layerInfo.minGID;
+    layer.maxGid = layerInfo.maxGID;
+    layer.firstGid = tileset.firstGid;
+    layer.tileWidth = tileset.tileSize.width;
+    layer.tileHeight = tileset.tileSize.height;
+    layer.spacing = tileset.spacing;
+    layer.margin = tileset.margin;
+    layer.imageWidth = tileset.imageSize.width;
+    layer.imageHeight = tileset.imageSize.height;
+    
+    [layers appendBytes:&layer length:sizeof(layer)];
+    [tiles appendBytes:layerInfo.tiles length:sizeof(uint32_t) * layer.width * layer.height];
+    
+    return YES;
+}
+
+/*!
+ @brief レイヤーのタイルセットの取得
+ 
+ cocos2dのタイルマップと同じく、最初のGIDが大きいタイルセットから順に、
+ そのタイルセットのタイルを使用しているかを調べ、最初に見つかったタイルセットをレイヤーのタイルセットとする。
+ @param layerInfo レイヤー情報
+ @param mapInfo タイルマップファイルの解析結果
+ @return タイルセット。タイルが1つもない場合はnilを返す。
+ */
+- (CCTMXTilesetInfo *)tilesetForLayer:(CCTMXLayerInfo *)layerInfo mapInfo:(CCTMXMapInfo *)mapInfo
+{
+    NSInteger tileCount = layerInfo.layerSize.width * layerInfo.layerSize.height;
+    for (CCTMXTilesetInfo *tileset in [mapInfo.tilesets reverseObjectEnumerator]) {
+        for (NSInteger i = 0; i < tileCount; i++) {
+            
+            unsigned int gid = layerInfo.tiles[i] & kCCFlippedMask;
+            if (gid != 0 && gid >= tileset.firstGid) {
+                return tileset;
+            }
+        }
+    }
+    
+    return nil;
+}
+@end
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2013 Akihiro Kaneda.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1.Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   2.Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   3.Neither the name of the Monochrome Soft nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ @file AKStagePrefetcher.h
+ @brief ステージ先読みクラス定義
+ 
+ 次のステージのステージパックをバックグラウンドで読み込むクラスを定義する。
+ */
+
+#import "AKToritoma.h"
+#import "AKStagePack.h"
+
+// ステージ先読みクラス
+@interface AKStagePrefetcher : NSObject {
+    /// 先読み中のステージ番号(先読みしていない場合は0)
+    NSInteger stage_;
+    /// 先読みしたステージパック
+    AKStagePack *stagePack_;
+    /// 先読み処理のグループ
+    dispatch_group_t group_;
+    /// 直前の受け取りで先読みの完了を待った時間(秒)
+    NSTimeInterval waitTime_;
+}
+
+/// 先読み中のステージ番号(先読みしていない場合は0)
+@property (nonatomic, readonly)NSInteger stage;
+/// 直前の受け取りで先読みの完了を待った時間(秒)
+@property (nonatomic, readonly)NSTimeInterval waitTime;
+
+// 先読み開始
+- (void)prefetchStageNo:(NSInteger)stage;
+// 先読み完了確認
+- (BOOL)isReady;
+// ステージパックの受け取り
+- (AKStagePack *)takeStagePackOfStageNo:(NSInteger)stage;
+@end
@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2013 Akihiro Kaneda.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1.Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   2.Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   3.Neither the name of the Monochrome Soft nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ @file AKStagePrefetcher.m
+ @brief ステージ先読みクラス定義
+ 
+ 次のステージのステージパックをバックグラウンドで読み込むクラスを定義する。
+ */
+
+#import <mach/mach_time.h>
+#import "AKStagePrefetcher.h"
+
+/*!
+ @brief ステージ先読みクラス
+ 
+ ステージの読み込み時に次のステージのステージパックの作成をバックグラウンドのスレッドで開始しておき、
+ ステージクリア後の切り替え時にはメインスレッドで作成済みのステージパックを受け取るだけにする。
+ 受け取り時に先読みが完了していない場合は完了まで待ち、待った時間を記録する。
+ 先読みしていないステージの受け取りを要求された場合はその場でステージパックを作成する。
+ 
+ 先読み処理はステージパックの作成のみを行う。
+ ステージパックの作成はNSBundle、mmap、NSData、文字列からのCCTMXMapInfoの解析のみを使用し、
+ cocos2dの共有オブジェクトを使用しないため、メインスレッドの描画処理と並行して実行できる。
+ テクスチャを読み込むチャンクのノード作成は、受け取った後にメインスレッドで行う。
+ 先読み処理が書き込むステージパックは、メインスレッドでは先読み処理の完了を待ってから参照する。
+ 先読み処理はインスタンス自体を保持しないため、解放時には先読み処理の完了を待つ。
+ */
+@implementation AKStagePrefetcher
+
+@synthesize stage = stage_;
+@synthesize waitTime = waitTime_;
+
+/*!
+ @brief 初期化処理
+ 
+ 初期化処理を行う。
+ @return 初期化したオブジェクト。失敗時はnilを返す。
+ */
+- (id)init
+{
+    // スーパークラスの初期化処理を行う
+    self = [super init];
+    if (!self) {
+        AKLog(kAKLogStagePrefetcher_0, @"error");
+        return nil;
+    }
+    
+    // 先読み処理のグループを作成する
+    group_ = dispatch_group_create();
+    
+    stage_ = 0;
+    stagePack_ = nil;
+    waitTime_ = 0.0;
+    
+    return self;
+}
+
+/*!
+ @brief オブジェクト解放処理
+ 
+ オブジェクトの解放を行う。先読み中の場合は完了を待ってから解放する。
+ */
+- (void)dealloc
+{
+    // 先読み中の処理の完了を待つ
+    dispatch_group_wait(group_, DISPATCH_TIME_FOREVER);
+    dispatch_release(group_);
+    
+    // メンバを解放する
+    [stagePack_ release];
+    
+    // スーパークラスの処理を行う
+    [super dealloc];
+}
+
+/*!
+ @brief 先読み開始
+ 
+ 指定したステージのステージパックの作成をバックグラウンドで開始する。
+ 前回の先読みが完了していない場合は完了を待ってから破棄する。
+ リソースにステージがない場合は先読みしない。
+ @param stage ステージ番号
+ */
+- (void)prefetchStageNo:(NSInteger)stage
+{
+    // 前回の先読みの完了を待って破棄する
+    dispatch_group_wait(group_, DISPATCH_TIME_FOREVER);
+    [stagePack_ release];
+    stagePack_ = nil;
+    stage_ = 0;
+    
+    // ステージがない場合は先読みしない
+    if (![AKStagePack existsStageNo:stage]) {
+        AKLog(kAKLogStagePrefetcher_1, @"ステージなし:%d", stage);
+        return;
+    }
+    
+    AKLog(kAKLogStagePrefetcher_1, @"先読み開始:%d", stage);
+    
+    // バックグラウンドでステージパックを作成する
+    // ステージパックの作成はcocos2dの共有オブジェクトを使用しないため、メインスレッドと競合しない
+    // ブロックがselfを保持しないように、書き込み先はメンバのアドレスで渡す
+    stage_ = stage;
+    AKStagePack **result = &stagePack_;
+    dispatch_group_async(group_, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_LOW, 0), ^{
+        
+        NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
+        
+        *result = [[AKStagePack stagePackOfStageNo:stage] retain];
+        
+        [pool release];
+    });
+}
+
+/*!
+ @brief 先読み完了確認
+ 
+ 先読みが完了しているかを調べる。待機は行わない。
+ @return 先読みが完了している場合、または先読みしていない場合YES
+ */
+- (BOOL)isReady
+{
+    return (dispatch_group_wait(group_, DISPATCH_TIME_NOW) == 0);
+}
+
+/*!
+ @brief ステージパックの受け取り
+ 
+ 先読みしたステージパックを受け取る。
+ 先読みが完了していない場合は完了まで待ち、待った時間を記録する。
+ 先読みしていないステージの場合はその場でステージパックを作成する。
+ 受け取った後は先読みしていない状態に戻る。
+ @param stage ステージ番号
+ @return ステージパック
+ */
+- (AKStagePack *)takeStagePackOfStageNo:(NSInteger)stage
+{
+    waitTime_ = 0.0;
+    
+    // 先読みしていないステージの場合はその場で作成する
+    if (stage != stage_) {
+        AKLog(kAKLogStagePrefetcher_1, @"先読みなし:%d", stage);
+        return [AKStagePack stagePackOfStageNo:stage];
+    }
+    
+    // 先読みの完了を待ち、待った時間を記録する
+    uint64_t start = mach_absolute_time();
+    dispatch_group_wait(group_, DISPATCH_TIME_FOREVER);
+    uint64_t elapsed = mach_absolute_time() - start;
+    
+    mach_timebase_info_data_t timebase;
+    mach_timebase_info(&timebase);
+    waitTime_ = (double)elapsed * timebase.numer / timebase.denom / NSEC_PER_SEC;
+    
+    // 待ちが発生した場合は報告する
+    if (waitTime_ > 0.001) {
+        AKLog(kAKLogStagePrefetcher_0, @"先読み未完了のため待機:stage=%d wait=%.3fms", stage, waitTime_ * 1000.0);
+    }
+    
+    // 先読みしたステージパックを受け取り、先読みしていない状態に戻す
+    AKStagePack *stagePack = [stagePack_ autorelease];
+    stagePack_ = nil;
+    stage_ = 0;
+    
+    return stagePack;
+}
+@end
@@ -35,68 +35,89 @@
 
 #import "AKToritoma.h"
 #import "AKPlayDataInterface.h"
-#import "AKTileMapEventParameter.h"
-
-@class AKTileMap;
+#import "AKSnapshot.h"
+#import "AKStagePack.h"
 
 // タイルマップ管理クラス
 @interface AKTileMap : NSObject {
+    /// ステージパック
+    AKStagePack *stagePack_;
     /// タイルマップ
-    CCTMXTiledMap *tileMap_;
-    /// 背景レイヤー
-    CCTMXLayer *background_;
-    /// 前景レイヤー
-    CCTMXLayer *foreground_;
-    /// 障害物レイヤー
-    CCTMXLayer *block_;
-    /// イベントレイヤー
-    CCTMXLayer *event_;
-    /// 敵レイヤー
-    CCTMXLayer *enemy_;
+    CCNode *tileMap_;
+    /// 作成済みのチャンク(チャンク番号順)
+    NSMutableArray *chunks_;
+    /// 作成済みの最初のチャンク番号
+    NSInteger firstChunk_;
+    /// 作成済みのチャンクの数
+    NSInteger chunkCount_;
+    /// マップの位置(状態更新で使用する位置)
+    CGPoint position_;
+    /// 前回の状態更新時のマップの位置
+    CGPoint prevPosition_;
     /// 実行した列番号
     NSInteger currentCol_;
     /// ステージ進行度
     NSInteger progress_;
-    /// 進行待ちのイベント
-    NSMutableArray *waitEvents_;
+    /// 全列のイベント(ステージパックのデータを参照する)
+    const struct AKTileMapEvent *events_;
+    /// イベントの数
+    NSInteger eventCount_;
+    /// 列ごとのイベントの開始位置(ステージパックのデータを参照する)
+    const int32_t *colStart_;
+    /// 列数
+    NSInteger colCount_;
+    /// 進行待ちのイベントのヒープ(イベントの位置を実行する進行度の小さい順に並べた二分ヒープ)
+    int32_t *waitEventHeap_;
+    /// 進行待ちのイベントの数
+    NSInteger waitEventCount_;
+    /// 進行待ちのイベントのバッファのサイズ
+    NSInteger waitEventCapacity_;
+    /// マップのサイズ(タイル数)
+    CGSize mapSize_;
+    /// タイルのサイズ
+    CGSize tileSize_;
 }
 
-/// タイルマップ
-@property (nonatomic, retain)CCTMXTiledMap *tileMap;
-/// 背景レイヤー
-@property (nonatomic, retain)CCTMXLayer *background;
-/// 前景レイヤー
-@property (nonatomic, retain)CCTMXLayer *foreground;
-/// 障害物レイヤー
-@property (nonatomic, retain)CCTMXLayer *block;
-/// イベントレイヤー
-@property (nonatomic, retain)CCTMXLayer *event;
-/// 敵レイヤー
-@property (nonatomic, retain)CCTMXLayer *enemy;
+/// ステージパック
+@property (nonatomic, retain)AKStagePack *stagePack;
+/// タイルマップ(画面に表示しない場合はnil)
+@property (nonatomic, retain)CCNode *tileMap;
+/// 作成済みのチャンク(チャンク番号順、画面に表示しない場合はnil)
+@property (nonatomic, retain)NSMutableArray *chunks;
+/// 作成済みの最初のチャンク番号
+@property (nonatomic, readonly)NSInteger firstChunk;
+/// 作成済みのチャンクの数
+@property (nonatomic, readonly)NSInteger chunkCount;
 /// ステージ進行状況
-@property (nonatomic)NSInteger progress;
-/// 進行待ちのイベント
-@property (nonatomic, retain)NSMutableArray *waitEvents;
+@property (nonatomic, readonly)NSInteger progress;
+/// イベントの数
+@property (nonatomic, readonly)NSInteger eventCount;
+/// 進行待ちのイベントの数
+@property (nonatomic, readonly)NSInteger waitEventCount;
 
 // 初期化処理
 - (id)initWithStageNo:(NSInteger)stage layer:(CCNode *)layer;
+// ステージパックからの初期化処理
+- (id)initWithStagePack:(AKStagePack *)stagePack layer:(CCNode *)layer;
 // コンビニエンスコンストラクタ
 + (id)scriptWithStageNo:(NSInteger)stage layer:(CCNode *)layer;
+// ステージパックからのコンビニエンスコンストラクタ
++ (id)scriptWithStagePack:(AKStagePack *)stagePack layer:(CCNode *)layer;
 // 更新処理
 - (void)update:(id<AKPlayDataInterface>)data;
+// マップ表示位置更新
+- (void)updateImagePositionWithAlpha:(float)alpha;
 // 列単位のイベント実行
 - (void)execEventByCol:(NSInteger)col data:(id<AKPlayDataInterface>)data;
-// レイヤーごとのイベント実行
-- (void)execEventLayer:(CCTMXLayer *)layer col:(NSInteger)col x:(float)x data:(id<AKPlayDataInterface>)data execFunc:(SEL)execFunc;
+// 進行度を進める
+- (void)addProgress:(NSInteger)progress data:(id<AKPlayDataInterface>)data;
 // デバイス座標からマップ座標の取得
 - (CGPoint)mapPositionFromDevicePosition:(CGPoint)devicePosition;
 // タイルの座標取得
 - (CGPoint)tilePositionFromMapPosition:(CGPoint)mapPosition;
-// 障害物作成
-- (void)createBlock:(AKTileMapEventParameter*)param;
-// 敵作成
-- (void)createEnemy:(AKTileMapEventParameter*)param;
-// イベント実行
-- (void)execEvent:(AKTileMapEventParameter*)param;
+// 状態の保存
+- (void)writeSnapshot:(AKSnapshot *)snapshot;
+// 状態の復元
+- (void)readSnapshot:(AKSnapshot *)snapshot;
 
 @end
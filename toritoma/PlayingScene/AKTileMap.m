@@ -35,36 +35,83 @@
 
 #import "AKTileMap.h"
 
-/// 進行待ち待機イベント初期配列数
-static const NSUInteger kAKWaitEventsInitCapacity = 5;
-
-/// タイルマップのファイル名
-static NSString *kAKTileMapFileName = @"Stage_%02d.tmx";
+/// チャンクの列数
+static const NSInteger kAKChunkColCount = 16;
+/// 画面外に作成しておくチャンクの数(左右それぞれ)
+static const NSInteger kAKChunkMargin = 1;
 
 /*!
  @brief タイルマップ管理クラス
  
- ステージ構成定義のタイルマップファイルを読み込む。
+ ステージ構成定義のステージパックを読み込む。
+ イベントはステージパックの列ごとのイベントの配列をそのまま参照するため、
+ ステージ開始時にタイルマップファイルの解析は行わない。
+ 画面に表示しない場合はタイルマップのノードを作成せずにイベントのみを処理できる。
+ 
+ タイルマップのノードはステージ全体を一度に作成せず、一定の列数ごとのチャンクに分けて作成する。
+ スクロール位置に合わせて画面とその左右のチャンクのみを作成し、画面外に出たチャンクは解放するため、
+ ステージの長さによらず読み込み時間とメモリ使用量は一定となる。
+ 画面に表示しない場合もチャンクの範囲のみは管理する。
+ 
+ イベントレイヤーのイベントで実行する進行度に到達していないものは、
+ イベントの位置を実行する進行度をキーとした二分ヒープに入れて待機させる。
+ 進行度が進んだ時はヒープの先頭から到達したイベントのみを取り出して実行するため、
+ 待機中のイベントを毎回走査することはない。
+ 進行度が同じイベントはイベントの位置の順(列番号順)に実行する。
  */
+// プライベートメソッド宣言
+@interface AKTileMap ()
+// 待機イベントの順序比較
+- (BOOL)isWaitEvent:(int32_t)a before:(int32_t)b;
+// 待機イベントの追加
+- (void)pushWaitEvent:(int32_t)index;
+// 待機イベントの取り出し
+- (int32_t)popWaitEvent;
+// 待機イベントの実行
+- (void)execWaitEvents:(id<AKPlayDataInterface>)data;
+// チャンクの更新
+- (void)updateChunks;
+// チャンクの作成
+- (CCNode *)createChunk:(NSInteger)chunk;
+// イベント実行
+- (void)execEvent:(const struct AKTileMapEvent *)event x:(float)x y:(float)y data:(id<AKPlayDataInterface>)data;
+@end
+
 @implementation AKTileMap
 
+@synthesize stagePack = stagePack_;
 @synthesize tileMap = tileMap_;
-@synthesize background = background_;
-@synthesize foreground = foreground_;
-@synthesize block = block_;
-@synthesize event = event_;
+@synthesize chunks = chunks_;
+@synthesize firstChunk = firstChunk_;
+@synthesize chunkCount = chunkCount_;
 @synthesize progress = progress_;
-@synthesize waitEvents = waitEvents_;
+@synthesize eventCount = eventCount_;
+@synthesize waitEventCount = waitEventCount_;
 
 /*!
  @brief 初期化処理
  
- 初期化処理を行う。
+ ステージ番号に対応するステージパックを読み込んで初期化処理を行う。
+ 配置するレイヤーがnilの場合はタイルマップのノードを作成せず、イベントの読み込みのみを行う。
  @param stage ステージ番号
  @param layer マップを配置するレイヤー
  @return 初期化したオブジェクト。失敗時はnilを返す。
  */
 - (id)initWithStageNo:(NSInteger)stage layer:(CCNode *)layer
+{
+    return [self initWithStagePack:[AKStagePack stagePackOfStageNo:stage] layer:layer];
+}
+
+/*!
+ @brief ステージパックからの初期化処理
+ 
+ 初期化処理を行う。
+ 配置するレイヤーがnilの場合はタイルマップのノードを作成せず、イベントの読み込みのみを行う。
+ @param stagePack ステージパック
+ @param layer マップを配置するレイヤー
+ @return 初期化したオブジェクト。失敗時はnilを返す。
+ */
+- (id)initWithStagePack:(AKStagePack *)stagePack layer:(CCNode *)layer
 {
     // スーパークラスの初期化処理を行う
     self = [super init];
@@ -73,40 +120,51 @@ static NSString *kAKTileMapFileName = @"Stage_%02d.tmx";
         return nil;
     }
     
+    NSAssert(stagePack != nil, @"ステージパック読み込みに失敗");
+    
     // メンバ変数を初期化する
     progress_ = 0;
-    waitEvents_ = [NSMutableArray arrayWithCapacity:kAKWaitEventsInitCapacity];
     
-    // ステージ番号からタイルマップのファイル名を決定する
-    NSString *fileName = [NSString stringWithFormat:kAKTileMapFileName, stage];
+    // ステージパックを保持し、マップとタイルのサイズを取得する
+    self.stagePack = stagePack;
+    const struct AKStagePackHeader *header = stagePack.header;
+    mapSize_ = CGSizeMake(header->mapWidth, header->mapHeight);
+    tileSize_ = CGSizeMake(header->tileWidth, header->tileHeight);
     
-    // タイルマップファイルを開く
-    self.tileMap = [CCTMXTiledMap tiledMapWithTMXFile:fileName];
+    // イベントはステージパックのデータを参照する
+    colCount_ = header->mapWidth;
+    colStart_ = stagePack.colStart;
+    events_ = stagePack.events;
+    eventCount_ = header->eventCount;
     
-    NSAssert(self.tileMap != nil, @"タイルマップ読み込みに失敗");
+    // 進行待ちのイベントのバッファを確保する
+    waitEventCapacity_ = header->waitEventCapacity;
+    waitEventHeap_ = malloc(sizeof(int32_t) * waitEventCapacity_);
+    waitEventCount_ = 0;
     
-    // 各レイヤーを取得する
-    self.background = [self.tileMap layerNamed:@"Background"];
-    self.foreground = [self.tileMap layerNamed:@"Foreground"];
-    self.block = [self.tileMap layerNamed:@"Block"];
-    self.event = [self.tileMap layerNamed:@"Event"];
-    self.enemy = [self.tileMap layerNamed:@"Enemy"];
+    AKLog(kAKLogScript_1, @"colCount=%d eventCount=%d", colCount_, eventCount_);
     
-    NSAssert(self.background != nil, @"背景レイヤーの取得に失敗");
-    NSAssert(self.foreground != nil, @"前景レイヤーの取得に失敗");
-    NSAssert(self.block != nil, @"障害物レイヤーの取得に失敗");
-    NSAssert(self.event != nil, @"イベントレイヤーの取得に失敗");
-    
-    // 背景・前景以外は非表示とする
-    self.block.visible = NO;
-    self.enemy.visible = NO;
-    self.event.visible = NO;
-    
-    // レイヤーに配置する
-    [layer addChild:self.tileMap z:1];
+    // 配置するレイヤーがある場合はタイルマップを作成する
+    if (layer != nil) {
+        
+        // チャンクを配置するノードを作成する
+        // チャンクは位置を決めた後に作成する
+        self.tileMap = [CCNode node];
+        self.chunks = [NSMutableArray array];
+        
+        // レイヤーに配置する
+        [layer addChild:self.tileMap z:1];
+    }
     
     // 左端に初期位置を移動する
-    self.tileMap.position = ccp([AKScreenSize xOfStage:0], [AKScreenSize yOfStage:0]);
+    position_ = ccp([AKScreenSize xOfStage:0], [AKScreenSize yOfStage:0]);
+    prevPosition_ = position_;
+    self.tileMap.position = position_;
+    
+    // 初期位置のチャンクを作成する
+    firstChunk_ = 0;
+    chunkCount_ = 0;
+    [self updateChunks];
     
     return self;
 }
@@ -124,6 +182,19 @@ static NSString *kAKTileMapFileName = @"Stage_%02d.tmx";
     return [[[AKTileMap alloc] initWithStageNo:stage layer:layer] autorelease];
 }
 
+/*!
+ @brief ステージパックからのコンビニエンスコンストラクタ
+ 
+ インスタンスの生成、初期化、autoreleaseを行う。
+ @param stagePack ステージパック
+ @param layer マップを配置するレイヤー
+ @return 初期化したオブジェクト。失敗時はnilを返す。
+ */
++ (id)scriptWithStagePack:(AKStagePack *)stagePack layer:(CCNode *)layer
+{
+    return [[[AKTileMap alloc] initWithStagePack:stagePack layer:layer] autorelease];
+}
+
 /*!
  @brief オブジェクト解放処理
  
@@ -132,13 +203,14 @@ static NSString *kAKTileMapFileName = @"Stage_%02d.tmx";
 - (void)dealloc
 {
     // メンバを解放する
-    self.background = nil;
-    self.foreground = nil;
-    self.block = nil;
-    self.event = nil;
-    self.enemy = nil;
+    self.chunks = nil;
     self.tileMap = nil;
-    self.waitEvents = nil;
+    
+    // イベントはステージパックのデータを参照しているため、ステージパックの解放のみ行う
+    self.stagePack = nil;
+    
+    // 進行待ちのイベントのバッファを解放する
+    free(waitEventHeap_);
     
     // スーパークラスの処理を行う
     [super dealloc];
@@ -155,11 +227,12 @@ static NSString *kAKTileMapFileName = @"Stage_%02d.tmx";
 - (void)update:(id<AKPlayDataInterface>)data
 {
     // 背景をスクロールする
-    self.tileMap.position = ccp(self.tileMap.position.x - data.scrollSpeedX,
-                                self.tileMap.position.y - data.scrollSpeedY);
+    // 表示位置は画面更新時に補間して設定するため、ここではマップの位置のみ更新する
+    prevPosition_ = position_;
+    position_ = ccp(position_.x - data.scrollSpeedX, position_.y - data.scrollSpeedY);
     
     // 表示中の一番右側の列+2列目までを処理対象とする
-    NSInteger maxCol = ([AKScreenSize stageSize].width - [AKScreenSize xOfDevice:self.tileMap.position.x]) / self.tileMap.tileSize.width + 2;
+    NSInteger maxCol = ([AKScreenSize stageSize].width - [AKScreenSize xOfDevice:position_.x]) / tileSize_.width + 2;
     
     AKLog(kAKLogScript_2, @"currentCol_=%d maxCol=%d", currentCol_, maxCol);
     
@@ -168,83 +241,323 @@ static NSString *kAKTileMapFileName = @"Stage_%02d.tmx";
         
         [self execEventByCol:currentCol_ data:data];
     }
+    
+    // スクロール位置に合わせてチャンクを作成・解放する
+    [self updateChunks];
+}
+
+/*!
+ @brief チャンクの更新
+ 
+ 画面に表示する範囲のチャンクと、その左右kAKChunkMargin個のチャンクが作成済みとなるようにする。
+ 範囲外になったチャンクは解放し、不足するチャンクは作成する。
+ 作成済みのチャンクは常に連続した範囲とし、最初のチャンク番号と数で管理する。
+ 画面に表示しない場合はチャンクの範囲のみを更新する。
+ */
+- (void)updateChunks
+{
+    // マップの左端から画面の左端までの距離を求める
+    float left = -[AKScreenSize xOfDevice:position_.x];
+    float chunkWidth = tileSize_.width * kAKChunkColCount;
+    
+    // 作成しておくチャンクの範囲を求める
+    NSInteger totalChunkCount = (colCount_ + kAKChunkColCount - 1) / kAKChunkColCount;
+    NSInteger first = MAX((NSInteger)floorf(left / chunkWidth) - kAKChunkMargin, 0);
+    NSInteger last = MIN((NSInteger)floorf((left + [AKScreenSize stageSize].width) / chunkWidth) + kAKChunkMargin,
+                         totalChunkCount - 1);
+    
+    // 左側の範囲外のチャンクを解放する
+    while (chunkCount_ > 0 && firstChunk_ < first) {
+        
+        AKLog(kAKLogScript_1, @"チャンク解放:%d", firstChunk_);
+        
+        [[self.chunks objectAtIndex:0] removeFromParentAndCleanup:YES];
+        [self.chunks removeObjectAtIndex:0];
+        firstChunk_++;
+        chunkCount_--;
+    }
+    
+    // 右側の範囲外のチャンクを解放する
+    while (chunkCount_ > 0 && firstChunk_ + chunkCount_ - 1 > last) {
+        
+        AKLog(kAKLogScript_1, @"チャンク解放:%d", firstChunk_ + chunkCount_ - 1);
+        
+        [[self.chunks lastObject] removeFromParentAndCleanup:YES];
+        [self.chunks removeLastObject];
+        chunkCount_--;
+    }
+    
+    // 作成済みのチャンクがない場合は範囲の左端から作成する
+    if (chunkCount_ == 0) {
+        firstChunk_ = first;
+    }
+    
+    // 左側に不足するチャンクを作成する
+    while (chunkCount_ > 0 && firstChunk_ > first) {
+        
+        firstChunk_--;
+        chunkCount_++;
+        
+        CCNode *chunk = [self createChunk:firstChunk_];
+        if (chunk != nil) {
+            [self.chunks insertObject:chunk atIndex:0];
+        }
+    }
+    
+    // 右側に不足するチャンクを作成する
+    while (firstChunk_ + chunkCount_ - 1 < last) {
+        
+        chunkCount_++;
+        
+        CCNode *chunk = [self createChunk:firstChunk_ + chunkCount_ - 1];
+        if (chunk != nil) {
+            [self.chunks addObject:chunk];
+        }
+    }
+}
+
+/*!
+ @brief チャンクの作成
+ 
+ 指定したチャンク番号の列の範囲の表示レイヤーを作成し、タイルマップのノードに配置する。
+ 画面に表示しない場合は作成しない。
+ @param chunk チャンク番号
+ @return チャンクのノード。画面に表示しない場合はnilを返す。
+ */
+- (CCNode *)createChunk:(NSInteger)chunk
+{
+    // 画面に表示しない場合は作成しない
+    if (self.tileMap == nil) {
+        return nil;
+    }
+    
+    AKLog(kAKLogScript_1, @"チャンク作成:%d", chunk);
+    
+    CCNode *node = [self.stagePack createChunkFromCol:chunk * kAKChunkColCount count:kAKChunkColCount];
+    [self.tileMap addChild:node];
+    
+    return node;
+}
+
+/*!
+ @brief マップ表示位置更新
+ 
+ 前回の状態更新時の位置と現在の位置の間で補間した位置にマップを表示する。
+ @param alpha 補間の割合(0で前回の位置、1で現在の位置)
+ */
+- (void)updateImagePositionWithAlpha:(float)alpha
+{
+    self.tileMap.position = ccp(prevPosition_.x + (position_.x - prevPosition_.x) * alpha,
+                                prevPosition_.y + (position_.y - prevPosition_.y) * alpha);
 }
 
 /*!
  @brief 列単位のイベント実行
  
- 指定した列番号のタイルのイベントを実行する。
+ 指定した列番号のイベントを実行する。
+ 読み込み時に解析したイベントの配列から該当する列の範囲だけを処理する。
  @param col 列番号
  @param data ゲームデータ
  */
 - (void)execEventByCol:(NSInteger)col data:(id<AKPlayDataInterface>)data
 {
+    // マップの範囲外の列は処理しない
+    if (col < 0 || col >= colCount_) {
+        return;
+    }
+    
     // x座標はマップの左端 + タイルサイズ * 列番号 (列番号は左から0,1,2,…)
     // タイルの真ん中を指定するために列番号には+0.5する
-    float x = [AKScreenSize xOfDevice:self.tileMap.position.x] + self.tileMap.tileSize.width * (col + 0.5);
+    float x = [AKScreenSize xOfDevice:position_.x] + tileSize_.width * (col + 0.5);
     
-    AKLog(kAKLogScript_4, @"position=%f x=%f", self.tileMap.position.x, x);
+    // マップの下端のy座標を取得する
+    float bottom = [AKScreenSize yOfDevice:position_.y];
     
-    // イベントレイヤーの処理を行う
-    [self execEventLayer:self.event col:col x:x data:data execFunc:@selector(execEvent:)];
+    AKLog(kAKLogScript_4, @"position=%f x=%f", position_.x, x);
     
-    // 障害物レイヤーの処理を行う
-    [self execEventLayer:self.block col:col x:x data:data execFunc:@selector(createBlock:)];
+    // 列の範囲のイベントを実行する
+    for (NSInteger i = colStart_[col]; i < colStart_[col + 1]; i++) {
+        
+        const struct AKTileMapEvent *event = &events_[i];
+        
+        // イベントレイヤーのイベントで、実行する進行度に到達していない場合は待機させる
+        if (event->type != kAKTileMapEventTypeBlock &&
+            event->type != kAKTileMapEventTypeEnemy &&
+            event->progress > progress_) {
+            
+            [self pushWaitEvent:(int32_t)i];
+            continue;
+        }
+        
+        [self execEvent:event x:x y:bottom + event->offsetY data:data];
+    }
+}
+
+/*!
+ @brief 進行度を進める
+ 
+ ステージ進行度を進め、実行する進行度に到達した待機イベントを実行する。
+ @param progress 進める進行度
+ @param data ゲームデータ
+ */
+- (void)addProgress:(NSInteger)progress data:(id<AKPlayDataInterface>)data
+{
+    progress_ += progress;
     
-    // 敵レイヤーの処理を行う
-    [self execEventLayer:self.enemy col:col x:x data:data execFunc:@selector(createEnemy:)];
+    [self execWaitEvents:data];
 }
 
 /*!
- @brief レイヤーごとのイベント実行
+ @brief 待機イベントの実行
  
- レイヤーごとにイベントを実行する。
- 指定されたレイヤーの1列分のイベントを実行する。
- @param layer レイヤー
- @param col 列番号
- @param x x座標
+ 実行する進行度に到達した待機イベントをヒープの先頭から順に取り出して実行する。
+ 待機イベントは位置を持たないイベントレイヤーのイベントのため、処理済みの一番右側の列の位置で実行する。
  @param data ゲームデータ
- @param execFunc イベント処理関数
  */
-- (void)execEventLayer:(CCTMXLayer *)layer col:(NSInteger)col x:(float)x data:(id<AKPlayDataInterface>)data execFunc:(SEL)execFunc
+- (void)execWaitEvents:(id<AKPlayDataInterface>)data
 {
-    // レイヤーの一番上の行から一番下の行まで処理を行う
-    for (int i = 0; i < self.tileMap.mapSize.height; i++) {
+    float x = [AKScreenSize xOfDevice:position_.x] + tileSize_.width * (currentCol_ - 0.5);
+    float bottom = [AKScreenSize yOfDevice:position_.y];
+    
+    while (waitEventCount_ > 0 && events_[waitEventHeap_[0]].progress <= progress_) {
         
-        // 処理対象のタイルの座標を作成する
-        CGPoint tilePos = ccp(col, i);
+        const struct AKTileMapEvent *event = &events_[[self popWaitEvent]];
         
-        // タイルのGIDを取得する
-        int tileGid = [layer tileGIDAt:tilePos];
+        AKLog(kAKLogScript_1, @"待機イベント実行:type=%d progress=%d", event->type, event->progress);
         
-        AKLog(kAKLogScript_2, @"i=%d tileGid=%d", i, tileGid);
+        [self execEvent:event x:x y:bottom + event->offsetY data:data];
+    }
+}
+
+/*!
+ @brief 待機イベントの順序比較
+ 
+ 待機イベントのヒープでの順序を比較する。
+ 実行する進行度の小さい方を先とし、同じ場合はイベントの位置が小さい方を先とする。
+ @param a イベントの位置
+ @param b イベントの位置
+ @return aがbより先の場合YES
+ */
+- (BOOL)isWaitEvent:(int32_t)a before:(int32_t)b
+{
+    if (events_[a].progress != events_[b].progress) {
+        return events_[a].progress < events_[b].progress;
+    }
+    
+    return a < b;
+}
+
+/*!
+ @brief 待機イベントの追加
+ 
+ イベントの位置をヒープの末尾に追加し、親と入れ替えながら順序を満たす位置まで上げる。
+ 各イベントは一度しか待機しないため、ヒープのサイズはイベントレイヤーのイベントの数で足りる。
+ @param index イベントの位置
+ */
+- (void)pushWaitEvent:(int32_t)index
+{
+    NSAssert(waitEventCount_ < waitEventCapacity_, @"待機イベントのバッファが不足");
+    
+    NSInteger child = waitEventCount_;
+    waitEventCount_++;
+    
+    while (child > 0) {
+        
+        NSInteger parent = (child - 1) / 2;
+        if (![self isWaitEvent:index before:waitEventHeap_[parent]]) {
+            break;
+        }
+        
+        waitEventHeap_[child] = waitEventHeap_[parent];
+        child = parent;
+    }
+    
+    waitEventHeap_[child] = index;
+}
+
+/*!
+ @brief 待機イベントの取り出し
+ 
+ ヒープの先頭のイベントの位置を取り出し、末尾の要素を先頭から子と入れ替えながら順序を満たす位置まで下げる。
+ @return イベントの位置
+ */
+- (int32_t)popWaitEvent
+{
+    NSAssert(waitEventCount_ > 0, @"待機イベントがない");
+    
+    int32_t top = waitEventHeap_[0];
+    waitEventCount_--;
+    
+    int32_t last = waitEventHeap_[waitEventCount_];
+    NSInteger parent = 0;
+    while (YES) {
         
-        // タイルが存在する場合
-        if (tileGid > 0) {
+        // 子のうち先に実行する方を選ぶ
+        NSInteger child = parent * 2 + 1;
+        if (child >= waitEventCount_) {
+            break;
+        }
+        if (child + 1 < waitEventCount_ && [self isWaitEvent:waitEventHeap_[child + 1] before:waitEventHeap_[child]]) {
+            child++;
+        }
+        
+        if (![self isWaitEvent:waitEventHeap_[child] before:last]) {
+            break;
+        }
+        
+        waitEventHeap_[parent] = waitEventHeap_[child];
+        parent = child;
+    }
+    
+    waitEventHeap_[parent] = last;
+    
+    return top;
+}
+
+/*!
+ @brief イベント実行
+ 
+ イベントの種類に応じた処理を実行する。
+ @param event イベント
+ @param x x座標
+ @param y y座標
+ @param data ゲームデータ
+ */
+- (void)execEvent:(const struct AKTileMapEvent *)event x:(float)x y:(float)y data:(id<AKPlayDataInterface>)data
+{
+    AKLog(kAKLogScript_2, @"type=%d value=%d", event->type, event->value);
+    
+    switch (event->type) {
+        case kAKTileMapEventTypeBlock:          // 障害物作成
+            // 複数のタイルをまとめた障害物はイベントの列を左端とする
+            [data createBlock:event->value
+                            x:x + tileSize_.width * (event->colCount - 1) / 2.0f
+                            y:y
+                     colCount:event->colCount
+                     rowCount:event->rowCount];
+            break;
             
-            // プロパティを取得する
-            NSDictionary *properties = [self.tileMap propertiesForGID:tileGid];
+        case kAKTileMapEventTypeEnemy:          // 敵作成
+            [data createEnemy:event->value x:x y:y progress:event->progress];
+            break;
             
-            AKLog(kAKLogScript_2, @"properties=%p", properties);
+        case kAKTileMapEventTypeScrollSpeedX:   // 水平方向のスクロールスピード変更
+            // スピードは0.1単位で指定するものとする
+            data.scrollSpeedX = event->value / 10.0f;
+            break;
             
-            // プロパティが取得できた場合
-            if (properties) {
-                
-                // y座標はマップの下端 + (マップの行数 - 行番号) * タイルサイズ (行番号は上から0,1,2…)
-                // タイルの真ん中を指定するために行番号には+0.5する
-                float y = [AKScreenSize yOfDevice:self.tileMap.position.y] + (self.tileMap.mapSize.height - (i + 0.5)) * self.tileMap.tileSize.height;
-                
-                // パラメータを作成する
-                AKTileMapEventParameter *param = [[[AKTileMapEventParameter alloc] init] autorelease];
-                param.x = x;
-                param.y = y;
-                param.properties = properties;
-                param.data = data;
-                
-                // イベントを実行する
-                [self performSelector:execFunc withObject:param];
-            }
-        }
+        case kAKTileMapEventTypeBGM:            // BGM変更
+            // TODO:BGM変更処理を作成する
+            break;
+            
+        case kAKTileMapEventTypeClear:          // ステージクリア
+            // TODO:ステージクリアフラグを立てる
+            break;
+            
+        default:
+            AKLog(kAKLogScript_0, @"不明な種別:%d", event->type);
+            NSAssert(NO, @"不明な種別");
+            break;
     }
 }
 
@@ -259,10 +572,10 @@ static NSString *kAKTileMapFileName = @"Stage_%02d.tmx";
 - (CGPoint)mapPositionFromDevicePosition:(CGPoint)devicePosition
 {
     // タイルマップの左端からの距離をタイル幅で割った値を列番号とする
-    NSInteger col = (devicePosition.x - self.tileMap.position.x) / self.tileMap.tileSize.width;
+    NSInteger col = (devicePosition.x - position_.x) / tileSize_.width;
     
     // タイルマップの下端からの距離をタイル高さで割り、上下を反転させた値を行番号とする
-    NSInteger row = self.tileMap.mapSize.height - (devicePosition.y - self.tileMap.position.y) / self.tileMap.tileSize.height;
+    NSInteger row = mapSize_.height - (devicePosition.y - position_.y) / tileSize_.height;
     
     return ccp(col, row);
 }
@@ -279,114 +592,62 @@ static NSString *kAKTileMapFileName = @"Stage_%02d.tmx";
 {
     // x座標はマップの左端 + タイルサイズ * 列番号 (列番号は左から0,1,2,…)
     // タイルの真ん中を指定するために列番号には+0.5する
-    NSInteger x = round(self.tileMap.position.x) + self.tileMap.tileSize.width * (mapPosition.x + 0.5);
+    NSInteger x = round(position_.x) + tileSize_.width * (mapPosition.x + 0.5);
 
     // y座標はマップの下端 + (マップの行数 - 行番号) * タイルサイズ (行番号は上から0,1,2…)
     // タイルの真ん中を指定するために行番号には+0.5する
-    NSInteger y = round(self.tileMap.position.y) + self.tileMap.tileSize.height * (self.tileMap.mapSize.height - (mapPosition.y + 0.5));
+    NSInteger y = round(position_.y) + tileSize_.height * (mapSize_.height - (mapPosition.y + 0.5));
     
     return ccp(x, y);
 }
 
-
 /*!
- @brief 障害物作成
+ @brief 状態の保存
  
- 障害物を作成する。
- 障害物レイヤーのプロパティから以下の項目を取得し、障害物の作成を行う。
- Type:障害物の種別
- @param param イベント実行パラメータ
+ マップの位置、実行済みの列番号、ステージ進行度、進行待ちのイベントのヒープを保存する。
+ ステージパックのイベントはステージ番号から読み込み直せるため保存しない。
+ @param snapshot 保存先
  */
-- (void)createBlock:(AKTileMapEventParameter*)param
+- (void)writeSnapshot:(AKSnapshot *)snapshot
 {
-    // 種別を取得する
-    NSString *typeString = [param.properties objectForKey:@"Type"];
-    NSInteger type = [typeString integerValue];
+    CGPoint positions[] = {position_, prevPosition_};
+    NSInteger values[] = {currentCol_, progress_, waitEventCount_};
     
-    // 障害物を作成する
-    [param.data createBlock:type x:param.x y:param.y];
+    [snapshot writeBytes:positions length:sizeof(positions)];
+    [snapshot writeBytes:values length:sizeof(values)];
+    [snapshot writeBytes:waitEventHeap_ length:sizeof(int32_t) * waitEventCount_];
 }
 
 /*!
- @brief 敵作成
+ @brief 状態の復元
  
- 敵を作成する。
- 障害物レイヤーのプロパティから以下の項目を取得し、敵の作成を行う。
- Type:敵の種別
- Progress:倒した時に進む進行度
- @param param イベント実行パラメータ
+ マップの位置、実行済みの列番号、ステージ進行度、進行待ちのイベントのヒープを復元する。
+ 同じステージのステージパックが読み込まれていることを前提とする。
+ @param snapshot 読み込み元
  */
-- (void)createEnemy:(AKTileMapEventParameter*)param
+- (void)readSnapshot:(AKSnapshot *)snapshot
 {
-    // 種別を取得する
-    NSString *typeString = [param.properties objectForKey:@"Type"];
-    NSInteger type = [typeString integerValue];
+    CGPoint positions[2];
+    NSInteger values[3];
     
-    // 倒した時に進む進行度を取得する
-    NSString *progressString = [param.properties objectForKey:@"Progress"];
-    NSInteger progress = [progressString integerValue];
+    [snapshot readBytes:positions length:sizeof(positions)];
+    [snapshot readBytes:values length:sizeof(values)];
     
-    // 敵を作成する
-    [param.data createEnemy:type x:param.x y:param.y progress:progress];
-}
-
-/*!
- @brief イベント実行
- 
- イベントを実行する。
- イベントレイヤーのプロパティから以下の項目を取得し、イベントを実行する。
- Type:イベントの種類
- Value:イベント実行で使用する値
- Progress:ステージ進行度がこの値以上のときにイベント実行する
- 
- イベントの種類は以下のとおり、
- bgm:BGMを変更する
- hspeed:水平方向のスクロールスピードを変更する
- clear:ステージクリアのフラグを立てる
- @param param イベント実行パラメータ
- */
-- (void)execEvent:(AKTileMapEventParameter*)param
-{
-    // 実行する進行状況の値を取得する
-    NSString *progressString = [param.properties objectForKey:@"progress"];
-    NSInteger progress = [progressString integerValue];
+    NSAssert(values[2] >= 0 && values[2] <= waitEventCapacity_, @"進行待ちのイベントの数が範囲外");
     
-    // 実行する進行度に到達していない場合は待機イベントの配列に入れて処理を終了する
-    if (progress < self.progress) {
-        
-        // 座標が0以上の場合はマップからの呼び出しと判断する。
-        // マップ読み込みからの実行時は待機イベント配列へ入れる。
-        if (!(param.x < 0.0f && param.y < 0.0f)) {
-            
-            [self.waitEvents addObject:param.properties];
-        }
-        
-        return;
-    }
-    
-    // 種別を取得する
-    NSString *type = [param.properties objectForKey:@"Type"];
+    position_ = positions[0];
+    prevPosition_ = positions[1];
+    currentCol_ = values[0];
+    progress_ = values[1];
+    waitEventCount_ = values[2];
+    [snapshot readBytes:waitEventHeap_ length:sizeof(int32_t) * waitEventCount_];
     
-    // 値を取得する
-    NSString *valueString = [param.properties objectForKey:@"Value"];
-    NSInteger value = [valueString integerValue];
-    
-    // 水平方向のスクロールスピード変更の場合
-    if ([type isEqualToString:@"hspeed"]) {
-        // スピードは0.1単位で指定するものとする
-        param.data.scrollSpeedX = value / 10.0f;
-    }
-    else if ([type isEqualToString:@"bgm"]) {
-        // TODO:BGM変更処理を作成する
-    }
-    // ステージクリアの場合
-    else if ([type isEqualToString:@"clear"]) {
-        // TODO:ステージクリアフラグを立てる
-    }
-    // 不明な種別の場合
-    else {
-        AKLog(kAKLogScript_0, @"不明な種別:%@", type);
-        NSAssert(NO, @"不明な種別");
+    for (NSInteger i = 0; i < waitEventCount_; i++) {
+        NSAssert(waitEventHeap_[i] >= 0 && waitEventHeap_[i] < eventCount_, @"進行待ちのイベントの位置が範囲外");
     }
+    
+    // マップの表示位置を合わせ、位置に合わせてチャンクを作り直す
+    self.tileMap.position = position_;
+    [self updateChunks];
 }
 @end
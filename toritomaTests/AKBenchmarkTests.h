@@ -27,33 +27,18 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 /*!
- @file AKTileMapEventParameter.h
- @brief タイルマップイベントパラメータクラス
+ @file AKBenchmarkTests.h
+ @brief AKBenchmarkのテスト
  
- タイルマップイベント処理で使用するパラメータ。
+ AKBenchmarkのテストクラスを定義する
  */
+#import <SenTestingKit/SenTestingKit.h>
+#import "AKBenchmark.h"
 
-#import "AKPlayDataInterface.h"
-
-// タイルマップイベントパラメータクラス
-@interface AKTileMapEventParameter : NSObject {
-    /// タイルのx座標
-    float x_;
-    /// タイルのy座標
-    float y_;
-    /// タイルのプロパティ
-    NSDictionary *properties_;
-    /// ゲームデータ
-    id<AKPlayDataInterface> data_;
-}
-
-/// タイルのx座標
-@property (nonatomic)float x;
-/// タイルのy座標
-@property (nonatomic)float y;
-/// タイルのプロパティ
-@property (nonatomic, assign)NSDictionary *properties;
-/// ゲームデータ
-@property (nonatomic, assign)id<AKPlayDataInterface> data;
+// AKBenchmarkのテストクラス
+@interface AKBenchmarkTests : SenTestCase
 
+- (void)testRunScenario_1;
+- (void)testRunScenario_2;
+- (void)testSummary_1;
 @end
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2013 Akihiro Kaneda.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1.Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   2.Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   3.Neither the name of the Monochrome Soft nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import <pthread.h>
+#import "AKBenchmarkTests.h"
+
+/// テストで計測する状態更新の回数
+static const NSInteger kAKTestTickCount = 100;
+
+/*!
+ @brief メモリ確保を行うスレッド関数
+ 
+ メモリ確保回数の計測対象外のスレッドでメモリ確保を行う。
+ @param arg 未使用
+ @return 常にNULL
+ */
+static void *AKTestAllocOnThread(void *arg)
+{
+    free(malloc(16));
+    return NULL;
+}
+
+@implementation AKBenchmarkTests
+
+/*
+ 全シナリオが計測でき、処理時間の統計値の大小関係が正しいことを確認する。
+ */
+- (void)testRunScenario_1
+{
+    AKBenchmark *benchmark = [[[AKBenchmark alloc] init] autorelease];
+    
+    for (NSInteger i = 0; i < kAKBenchmarkScenarioCount; i++) {
+        
+        const struct AKBenchmarkResult *result = [benchmark runScenario:i tickCount:kAKTestTickCount];
+        
+        STAssertEquals(result->tickCount, kAKTestTickCount, @"計測回数が不正:%d", i);
+        STAssertTrue(result->nsPerTick > 0.0, @"平均処理時間が不正:%d", i);
+        STAssertTrue(result->p50 <= result->p99, @"中央値が99パーセンタイルより大きい:%d", i);
+        STAssertTrue(result->p99 <= result->max, @"99パーセンタイルが最大値より大きい:%d", i);
+        STAssertTrue(result->allocsPerTick >= 0.0, @"メモリ確保回数が不正:%d", i);
+    }
+}
+
+/*
+ 敵弾最大数のシナリオで、計測中に敵弾が最大数に保たれていることを確認する。
+ デバッグビルドではメモリ確保回数の計測が開始されていることを確認する。
+ */
+- (void)testRunScenario_2
+{
+    AKBenchmark *benchmark = [[[AKBenchmark alloc] init] autorelease];
+    
+    [benchmark runScenario:kAKBenchmarkEnemyShotGraze tickCount:kAKTestTickCount];
+    
+#ifdef DEBUG
+    STAssertTrue([AKAllocCounter isInstalled], @"メモリ確保回数の計測が開始されていない");
+    
+    // 計測区間外のメモリ確保が数えられることを確認する
+    int64_t count = [AKAllocCounter count];
+    void *ptr = malloc(16);
+    STAssertTrue([AKAllocCounter count] > count, @"メモリ確保回数が数えられていない");
+    free(ptr);
+    
+    // 他のスレッドのメモリ確保が数えられないことを確認する
+    count = [AKAllocCounter count];
+    pthread_t thread;
+    pthread_create(&thread, NULL, AKTestAllocOnThread, NULL);
+    pthread_join(thread, NULL);
+    STAssertEquals([AKAllocCounter count], count, @"他のスレッドのメモリ確保が数えられている");
+#endif
+    
+    // 計測していないシナリオは回数が0となることを確認する
+    STAssertEquals([benchmark resultOfScenario:kAKBenchmarkBoss]->tickCount, (NSInteger)0, @"計測していないシナリオの回数が不正");
+}
+
+/*
+ 計測結果が計測したシナリオごとに1行のJSON形式で出力されることを確認する。
+ */
+- (void)testSummary_1
+{
+    AKBenchmark *benchmark = [[[AKBenchmark alloc] init] autorelease];
+    
+    [benchmark runScenario:kAKBenchmarkBoss tickCount:kAKTestTickCount];
+    [benchmark runScenario:kAKBenchmarkStageChange tickCount:kAKTestTickCount];
+    
+    NSArray *lines = [[benchmark summary] componentsSeparatedByString:@"\n"];
+    
+    // 末尾の改行の後の空文字列を含めて3要素となる
+    STAssertEquals(lines.count, (NSUInteger)3, @"出力行数が不正");
+    
+    for (NSInteger i = 0; i < 2; i++) {
+        NSData *json = [[lines objectAtIndex:i] dataUsingEncoding:NSUTF8StringEncoding];
+        NSDictionary *result = [NSJSONSerialization JSONObjectWithData:json options:0 error:NULL];
+        STAssertNotNil(result, @"JSON形式でない:%@", [lines objectAtIndex:i]);
+        STAssertEquals([[result objectForKey:@"ticks"] integerValue], kAKTestTickCount, @"計測回数が不正");
+    }
+    
+    STAssertTrue([[lines objectAtIndex:0] rangeOfString:@"\"scenario\":\"boss\""].location != NSNotFound, @"シナリオ名が不正");
+    STAssertTrue([[lines objectAtIndex:1] rangeOfString:@"\"scenario\":\"stage_change\""].location != NSNotFound, @"シナリオ名が不正");
+}
+@end
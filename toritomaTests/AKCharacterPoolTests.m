@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2013 Akihiro Kaneda.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1.Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   2.Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   3.Neither the name of the Monochrome Soft nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "AKCharacterPoolTests.h"
+
+/// プールのサイズ
+static const NSInteger kAKTestPoolSize = 256;
+/// ベンチマークの繰り返し回数
+static const NSInteger kAKTestBenchmarkLoop = 10000;
+
+// テスト用のメッセージ送信先
+@interface AKCharacter (AKCharacterPoolTests)
+// 処理したキャラクターの記録
+- (void)recordVisit:(NSMutableArray *)visited;
+@end
+
+@implementation AKCharacter (AKCharacterPoolTests)
+
+/*
+ 処理したキャラクターを記録する。
+ 4番目に処理したキャラクターは先頭で処理したキャラクターを未使用にする。
+ */
+- (void)recordVisit:(NSMutableArray *)visited
+{
+    [visited addObject:self];
+    
+    if (visited.count == 4) {
+        ((AKCharacter *)[visited objectAtIndex:0]).isStaged = NO;
+    }
+}
+@end
+
+@implementation AKCharacterPoolTests
+
+/*
+ 配置フラグの変化に合わせて使用中の数が増減することを確認する。
+ */
+- (void)testGetNext_1
+{
+    AKCharacterPool *pool = [[[AKCharacterPool alloc] initWithClass:[AKCharacter class] Size:4] autorelease];
+    
+    AKCharacter *first = [pool getNext];
+    STAssertNotNil(first, @"未使用キャラクターが取得できない");
+    STAssertEquals(pool.activeCount, (NSInteger)0, @"配置前に使用中になっている");
+    
+    first.isStaged = YES;
+    STAssertEquals(pool.activeCount, (NSInteger)1, @"配置後に使用中になっていない");
+    
+    AKCharacter *second = [pool getNext];
+    STAssertTrue(first != second, @"使用中のキャラクターが取得された");
+    second.isStaged = YES;
+    STAssertEquals(pool.activeCount, (NSInteger)2, @"配置後に使用中になっていない");
+    
+    first.isStaged = NO;
+    STAssertEquals(pool.activeCount, (NSInteger)1, @"配置解除後に未使用になっていない");
+    STAssertEquals([pool activeAtIndex:0], second, @"使用中のキャラクターが正しくない");
+}
+
+/*
+ すべて使用中の場合にnilが返され、解放後は再度取得できることを確認する。
+ */
+- (void)testGetNext_2
+{
+    AKCharacterPool *pool = [[[AKCharacterPool alloc] initWithClass:[AKCharacter class] Size:4] autorelease];
+    
+    for (int i = 0; i < 4; i++) {
+        AKCharacter *character = [pool getNext];
+        character.isStaged = YES;
+    }
+    
+    STAssertNil([pool getNext], @"空きがないのにnil以外が返された");
+    
+    AKCharacter *released = [pool activeAtIndex:2];
+    released.isStaged = NO;
+    
+    STAssertEquals([pool getNext], released, @"解放したキャラクターが取得できない");
+    
+    [pool reset];
+    STAssertEquals(pool.activeCount, (NSInteger)0, @"リセット後に使用中のキャラクターが残っている");
+}
+
+/*
+ 取得したキャラクターを配置せずに再度取得した場合にアサーションで検出されることを確認する。
+ */
+- (void)testGetNext_3
+{
+    AKCharacterPool *pool = [[[AKCharacterPool alloc] initWithClass:[AKCharacter class] Size:4] autorelease];
+    
+    AKCharacter *first = [pool getNext];
+#ifdef DEBUG
+    STAssertThrows([pool getNext], @"配置前の再取得が検出されない");
+#endif
+    
+    // 配置後は次のキャラクターが取得できる
+    first.isStaged = YES;
+    AKCharacter *second = [pool getNext];
+    STAssertTrue(first != second, @"使用中のキャラクターが取得された");
+    
+    // リセット後は配置待ちが取り消される
+    [pool reset];
+    STAssertNoThrow([pool getNext], @"リセット後に取得できない");
+}
+
+/*
+ メッセージ送信中以外に使用中の途中のキャラクターが未使用になっても、
+ 残りのキャラクターが使用中になった順に並び、新たに使用中になったキャラクターが末尾に並ぶことを確認する。
+ */
+- (void)testDeactivateCharacter_1
+{
+    AKCharacterPool *pool = [[[AKCharacterPool alloc] initWithClass:[AKCharacter class] Size:8] autorelease];
+    
+    NSMutableArray *order = [NSMutableArray arrayWithCapacity:8];
+    for (int i = 0; i < 6; i++) {
+        AKCharacter *character = [pool getNext];
+        character.isStaged = YES;
+        [order addObject:character];
+    }
+    
+    // 途中のキャラクターを未使用にする
+    ((AKCharacter *)[order objectAtIndex:1]).isStaged = NO;
+    ((AKCharacter *)[order objectAtIndex:3]).isStaged = NO;
+    [order removeObjectAtIndex:3];
+    [order removeObjectAtIndex:1];
+    
+    // 新たに使用中にする
+    AKCharacter *added = [pool getNext];
+    added.isStaged = YES;
+    [order addObject:added];
+    
+    STAssertEquals(pool.activeCount, (NSInteger)order.count, @"使用中の数が正しくない");
+    for (NSInteger i = 0; i < pool.activeCount; i++) {
+        STAssertEquals([pool activeAtIndex:i], [order objectAtIndex:i], @"使用中の並び順が使用中になった順になっていない");
+    }
+}
+
+/*
+ メッセージ送信中に未使用になったキャラクターがあってもすべてのキャラクターが1回ずつ処理されることを確認する。
+ */
+- (void)testMakeActiveObjectsPerformSelector_1
+{
+    AKCharacterPool *pool = [[[AKCharacterPool alloc] initWithClass:[AKCharacter class] Size:8] autorelease];
+    
+    for (int i = 0; i < 8; i++) {
+        AKCharacter *character = [pool getNext];
+        character.isStaged = YES;
+        character.hitPoint = 1;
+    }
+    
+    // 破壊処理で配置フラグが落ちるため、すべて未使用になる
+    [pool makeActiveObjectsPerformSelector:@selector(destroy:) withObject:nil];
+    
+    STAssertEquals(pool.activeCount, (NSInteger)0, @"処理されていないキャラクターがある");
+    for (AKCharacter *character in [pool.pool objectEnumerator]) {
+        STAssertFalse(character.isStaged, @"処理されていないキャラクターがある");
+    }
+}
+
+/*
+ メッセージ送信中に処理済みのキャラクターが未使用になっても、
+ 開始時点で使用中のキャラクターが並び順に1回ずつ処理され、残りのキャラクターの並び順が保たれることを確認する。
+ */
+- (void)testMakeActiveObjectsPerformSelector_2
+{
+    AKCharacterPool *pool = [[[AKCharacterPool alloc] initWithClass:[AKCharacter class] Size:8] autorelease];
+    
+    NSMutableArray *order = [NSMutableArray arrayWithCapacity:8];
+    for (int i = 0; i < 8; i++) {
+        AKCharacter *character = [pool getNext];
+        character.isStaged = YES;
+        [order addObject:character];
+    }
+    
+    NSMutableArray *visited = [NSMutableArray arrayWithCapacity:8];
+    [pool makeActiveObjectsPerformSelector:@selector(recordVisit:) withObject:visited];
+    
+    STAssertEqualObjects(visited, order, @"処理順が並び順と一致しない");
+    
+    // 先頭のキャラクターが未使用になり、残りは並び順を保っている
+    STAssertEquals(pool.activeCount, (NSInteger)7, @"使用中の数が正しくない");
+    for (NSInteger i = 0; i < pool.activeCount; i++) {
+        STAssertEquals([pool activeAtIndex:i], [order objectAtIndex:i + 1], @"使用中の並び順が変わっている");
+    }
+}
+
+/*
+ 1フレームあたりの処理時間がプールのサイズではなく使用中の数に比例することを確認する。
+ */
+- (void)testBenchmarkActiveCount
+{
+    const NSInteger kAKLiveCounts[] = {16, 64, 255};
+    
+    for (int n = 0; n < sizeof(kAKLiveCounts) / sizeof(kAKLiveCounts[0]); n++) {
+        
+        AKCharacterPool *pool = [[[AKCharacterPool alloc] initWithClass:[AKCharacter class] Size:kAKTestPoolSize] autorelease];
+        for (int i = 0; i < kAKLiveCounts[n]; i++) {
+            AKCharacter *character = [pool getNext];
+            character.isStaged = YES;
+        }
+        
+        // 使用中のキャラクターの更新処理
+        CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+        for (int loop = 0; loop < kAKTestBenchmarkLoop; loop++) {
+            [pool makeActiveObjectsPerformSelector:@selector(updateImagePosition) withObject:nil];
+        }
+        CFAbsoluteTime iterateTime = CFAbsoluteTimeGetCurrent() - start;
+        
+        // 取得と解放の繰り返し
+        start = CFAbsoluteTimeGetCurrent();
+        for (int loop = 0; loop < kAKTestBenchmarkLoop; loop++) {
+            AKCharacter *character = [pool getNext];
+            character.isStaged = YES;
+            character.isStaged = NO;
+        }
+        CFAbsoluteTime acquireTime = CFAbsoluteTimeGetCurrent() - start;
+        
+        NSLog(@"live=%d/%d: iterate=%.3fus/tick acquire+release=%.3fus",
+              kAKLiveCounts[n], kAKTestPoolSize,
+              iterateTime * 1000000.0 / kAKTestBenchmarkLoop,
+              acquireTime * 1000000.0 / kAKTestBenchmarkLoop);
+        
+        STAssertEquals(pool.activeCount, kAKLiveCounts[n], @"使用中の数が変化している");
+    }
+}
+@end
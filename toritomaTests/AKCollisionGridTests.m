@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2013 Akihiro Kaneda.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1.Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   2.Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   3.Neither the name of the Monochrome Soft nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "AKCollisionGridTests.h"
+
+/// 自機弾の同時出現最大数
+static const NSInteger kAKTestPlayerShotCount = 128;
+/// 敵キャラの同時出現最大数
+static const NSInteger kAKTestEnemyCount = 32;
+/// 敵弾の同時出現最大数
+static const NSInteger kAKTestEnemyShotCount = 256;
+/// 障害物の同時出現最大数
+static const NSInteger kAKTestBlockCount = 128;
+/// ベンチマークの繰り返し回数
+static const NSInteger kAKTestBenchmarkLoop = 600;
+
+@implementation AKCollisionGridTests
+
+/*
+ ステージ上(画面外の余白を含む)にランダムに配置したキャラクターを作成する。
+ */
+- (NSArray *)createCharacters:(NSInteger)count size:(NSInteger)size
+{
+    NSMutableArray *characters = [NSMutableArray arrayWithCapacity:count];
+    
+    for (int i = 0; i < count; i++) {
+        AKCharacter *character = [[[AKCharacter alloc] init] autorelease];
+        character.positionX = (float)(random() % (NSInteger)(kAKStageSize.width + 100)) - 50.0f;
+        character.positionY = (float)(random() % (NSInteger)(kAKStageSize.height + 100)) - 50.0f;
+        character.width = size;
+        character.height = size;
+        character.hitPoint = 1000;
+        character.isStaged = (random() % 8 != 0);
+        [characters addObject:character];
+    }
+    
+    return characters;
+}
+
+/*
+ 全組み合わせの判定とグリッドを使用した判定でHPの減り方が一致することを確認する。
+ */
+- (void)checkHitResultWithSeed:(unsigned)seed selfCount:(NSInteger)selfCount selfSize:(NSInteger)selfSize targetCount:(NSInteger)targetCount targetSize:(NSInteger)targetSize
+{
+    srandom(seed);
+    NSArray *bruteSelves = [self createCharacters:selfCount size:selfSize];
+    NSArray *bruteTargets = [self createCharacters:targetCount size:targetSize];
+    
+    srandom(seed);
+    NSArray *gridSelves = [self createCharacters:selfCount size:selfSize];
+    NSArray *gridTargets = [self createCharacters:targetCount size:targetSize];
+    
+    AKCollisionGrid *grid = [[[AKCollisionGrid alloc] initWithCapacity:targetCount] autorelease];
+    [grid rebuildWithCharacters:gridTargets];
+    
+    for (int i = 0; i < selfCount; i++) {
+        BOOL bruteHit = [[bruteSelves objectAtIndex:i] checkHit:[bruteTargets objectEnumerator] data:nil func:@selector(hit:data:)];
+        BOOL gridHit = [[gridSelves objectAtIndex:i] checkHitWithGrid:grid data:nil func:@selector(hit:data:)];
+        STAssertEquals(bruteHit, gridHit, @"衝突有無が一致しない:%d", i);
+    }
+    
+    for (int i = 0; i < selfCount; i++) {
+        STAssertEquals([[bruteSelves objectAtIndex:i] hitPoint], [[gridSelves objectAtIndex:i] hitPoint], @"HPが一致しない:%d", i);
+    }
+    for (int i = 0; i < targetCount; i++) {
+        STAssertEquals([[bruteTargets objectAtIndex:i] hitPoint], [[gridTargets objectAtIndex:i] hitPoint], @"HPが一致しない:%d", i);
+    }
+}
+
+/*
+ 敵と自機弾・反射弾の組み合わせで判定結果が一致することを確認する。
+ */
+- (void)testHitResult_1
+{
+    [self checkHitResultWithSeed:1
+                       selfCount:kAKTestEnemyCount
+                        selfSize:32
+                     targetCount:kAKTestPlayerShotCount + kAKTestEnemyShotCount
+                      targetSize:8];
+}
+
+/*
+ セルより大きいキャラクターとの組み合わせで判定結果が一致することを確認する。
+ */
+- (void)testHitResult_2
+{
+    [self checkHitResultWithSeed:2
+                       selfCount:kAKTestBlockCount
+                        selfSize:32
+                     targetCount:kAKTestEnemyCount
+                      targetSize:80];
+}
+
+/*
+ 全プールが埋まった状態で全組み合わせの判定とグリッドを使用した判定の判定回数と処理時間を比較する。
+ */
+- (void)testBenchmarkFullOccupancy
+{
+    srandom(3);
+    NSArray *selves = [self createCharacters:kAKTestBlockCount + kAKTestEnemyCount + 1 size:32];
+    NSArray *targets = [self createCharacters:kAKTestEnemyShotCount size:8];
+    for (AKCharacter *character in targets) {
+        character.isStaged = YES;
+    }
+    
+    AKCollisionGrid *grid = [[[AKCollisionGrid alloc] initWithCapacity:kAKTestEnemyShotCount] autorelease];
+    
+    // 全組み合わせの判定
+    NSUInteger bruteCount = 0;
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    for (int loop = 0; loop < kAKTestBenchmarkLoop; loop++) {
+        for (AKCharacter *character in selves) {
+            [character checkHit:[targets objectEnumerator] data:nil func:NULL];
+            bruteCount += targets.count;
+        }
+    }
+    CFAbsoluteTime bruteTime = CFAbsoluteTimeGetCurrent() - start;
+    
+    // グリッドを使用した判定(グリッドの構築時間を含む)
+    start = CFAbsoluteTimeGetCurrent();
+    for (int loop = 0; loop < kAKTestBenchmarkLoop; loop++) {
+        [grid rebuildWithCharacters:targets];
+        for (AKCharacter *character in selves) {
+            [character checkHitWithGrid:grid data:nil func:NULL];
+        }
+    }
+    CFAbsoluteTime gridTime = CFAbsoluteTimeGetCurrent() - start;
+    
+    NSLog(@"brute force: pair=%u time=%.3fms/frame", bruteCount / kAKTestBenchmarkLoop, bruteTime * 1000.0 / kAKTestBenchmarkLoop);
+    NSLog(@"grid       : pair=%u time=%.3fms/frame", grid.pairTestCount / kAKTestBenchmarkLoop, gridTime * 1000.0 / kAKTestBenchmarkLoop);
+    
+    STAssertTrue(grid.pairTestCount < bruteCount, @"判定回数が減っていない");
+}
+@end
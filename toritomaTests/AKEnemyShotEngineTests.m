@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2013 Akihiro Kaneda.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1.Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   2.Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   3.Neither the name of the Monochrome Soft nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "AKEnemyShotEngineTests.h"
+#import "AKCharacter.h"
+
+/// ベンチマークの弾の数
+static const NSInteger kAKTestShotCount = 4096;
+/// ベンチマークの繰り返し回数
+static const NSInteger kAKTestBenchmarkLoop = 1000;
+
+@implementation AKEnemyShotEngineTests
+
+/*
+ 通常弾は速度分移動し、スクロール影響弾はスクロール分も移動することを確認する。
+ */
+- (void)testMove_1
+{
+    AKEnemyShotEngine *engine = [[[AKEnemyShotEngine alloc] initWithCapacity:4 parent:nil] autorelease];
+    
+    NSInteger normal = [engine createNormalShotAtX:100.0f y:100.0f direction:AKNWayDirectionMake(0.0f) speed:2.0f];
+    NSInteger scroll = [engine createScrollShotAtX:100.0f y:100.0f direction:AKNWayDirectionMake(0.0f) speed:2.0f];
+    STAssertEquals(engine.count, (NSInteger)2, @"弾が生成されていない");
+    
+    [engine moveWithScrollSpeedX:1.0f scrollSpeedY:0.0f blockGrid:nil];
+    
+    STAssertEqualsWithAccuracy([engine positionAtIndex:normal].x, (CGFloat)102.0f, 0.001f, @"通常弾の移動量が正しくない");
+    STAssertEqualsWithAccuracy([engine positionAtIndex:scroll].x, (CGFloat)101.0f, 0.001f, @"スクロール影響弾の移動量が正しくない");
+}
+
+/*
+ 速度変更弾が指定したフレーム数の移動後に速度を変更することを確認する。
+ */
+- (void)testMove_2
+{
+    AKEnemyShotEngine *engine = [[[AKEnemyShotEngine alloc] initWithCapacity:4 parent:nil] autorelease];
+    
+    NSInteger index = [engine createChangeSpeedShotAtX:100.0f
+                                                     y:100.0f
+                                             direction:AKNWayDirectionMake(0.0f)
+                                                 speed:1.0f
+                                        changeInterval:3
+                                       changeDirection:AKNWayDirectionMake(M_PI / 2)
+                                           changeSpeed:2.0f];
+    
+    for (int i = 0; i < 2; i++) {
+        [engine moveWithScrollSpeedX:0.0f scrollSpeedY:0.0f blockGrid:nil];
+    }
+    STAssertEqualsWithAccuracy([engine speedAtIndex:index].x, (CGFloat)1.0f, 0.001f, @"間隔経過前に速度が変更された");
+    
+    [engine moveWithScrollSpeedX:0.0f scrollSpeedY:0.0f blockGrid:nil];
+    STAssertEqualsWithAccuracy([engine speedAtIndex:index].x, (CGFloat)0.0f, 0.001f, @"間隔経過後に速度が変更されていない");
+    STAssertEqualsWithAccuracy([engine speedAtIndex:index].y, (CGFloat)2.0f, 0.001f, @"間隔経過後に速度が変更されていない");
+    STAssertEqualsWithAccuracy([engine positionAtIndex:index].x, (CGFloat)103.0f, 0.001f, @"変更前の速度で移動していない");
+}
+
+/*
+ 加速弾が進行方向に加速することを確認する。
+ */
+- (void)testMove_3
+{
+    AKEnemyShotEngine *engine = [[[AKEnemyShotEngine alloc] initWithCapacity:4 parent:nil] autorelease];
+    
+    NSInteger index = [engine createAccelShotAtX:100.0f y:100.0f direction:AKNWayDirectionMake(M_PI / 2) speed:1.0f accel:0.5f];
+    STAssertEquals([engine motionAtIndex:index], (enum AKEnemyShotMotion)kAKEnemyShotMotionAccel, @"動作種別が正しくない");
+    
+    for (int i = 0; i < 4; i++) {
+        [engine moveWithScrollSpeedX:0.0f scrollSpeedY:0.0f blockGrid:nil];
+    }
+    
+    // 移動量は1.0 + 1.5 + 2.0 + 2.5、速度は3.0となる
+    STAssertEqualsWithAccuracy([engine positionAtIndex:index].y, (CGFloat)107.0f, 0.001f, @"加速後の位置が正しくない");
+    STAssertEqualsWithAccuracy([engine speedAtIndex:index].y, (CGFloat)3.0f, 0.001f, @"加速後の速度が正しくない");
+    STAssertEqualsWithAccuracy([engine speedAtIndex:index].x, (CGFloat)0.0f, 0.001f, @"進行方向以外に加速している");
+}
+
+/*
+ 回転弾が速さを保ったまま進行方向を変えることを確認する。
+ */
+- (void)testMove_4
+{
+    AKEnemyShotEngine *engine = [[[AKEnemyShotEngine alloc] initWithCapacity:4 parent:nil] autorelease];
+    
+    NSInteger index = [engine createAngularShotAtX:200.0f y:100.0f direction:AKNWayDirectionMake(0.0f) speed:2.0f angularSpeed:M_PI / 60];
+    
+    for (int i = 0; i < 30; i++) {
+        [engine moveWithScrollSpeedX:0.0f scrollSpeedY:0.0f blockGrid:nil];
+    }
+    
+    // 30フレームで90度回転する
+    CGPoint speed = [engine speedAtIndex:index];
+    STAssertEqualsWithAccuracy(speed.x, (CGFloat)0.0f, 0.001f, @"回転量が正しくない");
+    STAssertEqualsWithAccuracy(speed.y, (CGFloat)2.0f, 0.001f, @"回転量が正しくない");
+}
+
+/*
+ 画面外に出た弾とHPが0になった弾が取り除かれ、残りの弾が先頭に詰められることを確認する。
+ */
+- (void)testRemove_1
+{
+    AKEnemyShotEngine *engine = [[[AKEnemyShotEngine alloc] initWithCapacity:4 parent:nil] autorelease];
+    
+    [engine createNormalShotAtX:-60.0f y:100.0f direction:AKNWayDirectionMake(M_PI) speed:1.0f];
+    [engine createNormalShotAtX:100.0f y:100.0f direction:AKNWayDirectionMake(0.0f) speed:1.0f];
+    [engine createNormalShotAtX:-60.0f y:100.0f direction:AKNWayDirectionMake(0.0f) speed:1.0f];
+    [engine createNormalShotAtX:200.0f y:100.0f direction:AKNWayDirectionMake(0.0f) speed:1.0f];
+    
+    // 画面外で外側に向かっている弾だけが取り除かれる
+    [engine moveWithScrollSpeedX:0.0f scrollSpeedY:0.0f blockGrid:nil];
+    STAssertEquals(engine.count, (NSInteger)3, @"画面外の弾が取り除かれていない");
+    
+    // 自機と同じ位置の弾のHPを0にする
+    AKCharacter *character = [[[AKCharacter alloc] init] autorelease];
+    character.positionX = 202.0f;
+    character.positionY = 100.0f;
+    character.width = 4;
+    character.height = 4;
+    character.hitPoint = 10;
+    character.isStaged = YES;
+    [engine checkHitWithCharacter:character];
+    
+    [engine moveWithScrollSpeedX:0.0f scrollSpeedY:0.0f blockGrid:nil];
+    STAssertEquals(engine.count, (NSInteger)2, @"HPが0の弾が取り除かれていない");
+    for (NSInteger i = 0; i < engine.count; i++) {
+        STAssertTrue([engine hitPointAtIndex:i] > 0, @"HPが0の弾が残っている");
+    }
+    
+    [engine removeAllShots];
+    STAssertEquals(engine.count, (NSInteger)0, @"全弾削除後に弾が残っている");
+}
+
+/*
+ 衝突した弾とキャラクターのHPが減り、かすりポイントは1回だけ取得できることを確認する。
+ */
+- (void)testCheckHitWithCharacter_1
+{
+    AKEnemyShotEngine *engine = [[[AKEnemyShotEngine alloc] initWithCapacity:4 parent:nil] autorelease];
+    
+    NSInteger near = [engine createNormalShotAtX:100.0f y:100.0f direction:AKNWayDirectionMake(0.0f) speed:0.0f];
+    NSInteger far = [engine createNormalShotAtX:150.0f y:100.0f direction:AKNWayDirectionMake(0.0f) speed:0.0f];
+    
+    AKCharacter *character = [[[AKCharacter alloc] init] autorelease];
+    character.positionX = 102.0f;
+    character.positionY = 100.0f;
+    character.width = 8;
+    character.height = 8;
+    character.hitPoint = 1;
+    character.isStaged = YES;
+    
+    [engine checkHitWithCharacter:character];
+    STAssertEquals(character.hitPoint, (NSInteger)0, @"キャラクターのHPが減っていない");
+    STAssertEquals([engine hitPointAtIndex:near], (NSInteger)0, @"衝突した弾のHPが減っていない");
+    STAssertEquals([engine hitPointAtIndex:far], (NSInteger)1, @"衝突していない弾のHPが減った");
+    
+    float grazePoint = [engine grazeLeft:80.0f right:120.0f top:120.0f bottom:80.0f];
+    STAssertTrue(grazePoint > 0.0f, @"かすりポイントが取得できない");
+    grazePoint = [engine grazeLeft:80.0f right:120.0f top:120.0f bottom:80.0f];
+    STAssertEqualsWithAccuracy(grazePoint, 0.0f, 0.001f, @"かすりポイントがリセットされていない");
+}
+
+/*
+ 空きが足りる場合は末尾から連続した範囲が予約され、足りない場合は全体が予約失敗になることを確認する。
+ */
+- (void)testReserveShots_1
+{
+    AKEnemyShotEngine *engine = [[[AKEnemyShotEngine alloc] initWithCapacity:4 parent:nil] autorelease];
+    
+    [engine createNormalShotAtX:100.0f y:100.0f direction:AKNWayDirectionMake(0.0f) speed:1.0f];
+    
+    NSRange range = [engine reserveShots:3];
+    STAssertEquals(range.location, (NSUInteger)1, @"予約範囲の先頭が不正");
+    STAssertEquals(range.length, (NSUInteger)3, @"予約範囲の長さが不正");
+    
+    for (int i = 0; i < 3; i++) {
+        NSInteger index = [engine createNormalShotAtX:100.0f y:100.0f direction:AKNWayDirectionMake(0.0f) speed:1.0f];
+        STAssertEquals(index, (NSInteger)(range.location + i), @"予約範囲に格納されていない");
+    }
+    STAssertEquals(engine.count, (NSInteger)4, @"弾の数が不正");
+    
+    range = [engine reserveShots:1];
+    STAssertEquals(range.length, (NSUInteger)0, @"空きが足りないのに予約できた");
+    STAssertEquals(engine.count, (NSInteger)4, @"予約失敗で弾の数が変わった");
+}
+
+/*
+ 弾の数が多い場合の1フレームあたりの移動処理と当たり判定の時間を計測する。
+ */
+- (void)testBenchmarkMove
+{
+    AKEnemyShotEngine *engine = [[[AKEnemyShotEngine alloc] initWithCapacity:kAKTestShotCount parent:nil] autorelease];
+    
+    // 画面外に出ないように画面中央を回転する弾を配置する
+    srand(1);
+    for (int i = 0; i < kAKTestShotCount; i++) {
+        [engine createAngularShotAtX:rand() % (int)kAKStageSize.width
+                                   y:rand() % (int)kAKStageSize.height
+                           direction:AKNWayDirectionMake((rand() % 360) * M_PI / 180.0f)
+                               speed:1.0f
+                        angularSpeed:M_PI / 30];
+    }
+    
+    AKCharacter *character = [[[AKCharacter alloc] init] autorelease];
+    character.positionX = kAKStageSize.width / 2;
+    character.positionY = kAKStageSize.height / 2;
+    character.width = 8;
+    character.height = 8;
+    character.power = 0;
+    character.isStaged = YES;
+    
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    for (int loop = 0; loop < kAKTestBenchmarkLoop; loop++) {
+        [engine moveWithScrollSpeedX:0.0f scrollSpeedY:0.0f blockGrid:nil];
+        [engine checkHitWithCharacter:character];
+    }
+    CFAbsoluteTime elapsed = CFAbsoluteTimeGetCurrent() - start;
+    
+    NSLog(@"shots=%d: move+hit=%.3fus/tick",
+          engine.count, elapsed * 1000000.0 / kAKTestBenchmarkLoop);
+    
+    STAssertEquals(engine.count, kAKTestShotCount, @"弾の数が変化している");
+}
+@end
@@ -35,6 +35,9 @@
 #import <SenTestingKit/SenTestingKit.h>
 #import "AKPlayData.h"
 #import "AKEnemy.h"
+#import "AKBlock.h"
+#import "AKEnemyShot.h"
+#import "AKEnemyShotEngine.h"
 #import "ccMacros.h"
 
 // AKEnemyのテストクラス
@@ -64,6 +67,8 @@
 - (void)testCheckBlockPosition_15;
 - (void)testCheckBlockPosition_16;
 - (void)testCheckBlockPosition_17;
+- (void)testCheckBlockPosition_19;
+- (void)testCheckBlockPosition_20;
 - (void)testGetBlockAtFeetAtX_1;
 - (void)testGetBlockAtFeetAtX_2;
 - (void)testGetBlockAtFeetAtX_3;
@@ -74,4 +79,8 @@
 - (void)testGetBlockAtFeetAtX_8;
 - (void)testGetBlockAtFeetAtX_9;
 - (void)testGetBlockAtFeetAtX_10;
+- (void)testAnimation_1;
+- (void)testAnimation_2;
+- (void)testBlockCellImages_1;
+- (void)testEnemyShotAnimation_1;
 @end
@@ -30,6 +30,15 @@
 #import "AKEnemyTests.h"
 #import "ccMacros.h"
 
+/// セミの敵の種類
+static const NSInteger kAKTestEnemyCicada = 12;
+/// カマキリの敵の種類
+static const NSInteger kAKTestEnemyMantis = 32;
+/// アニメーションを確認する移動処理の回数
+static const NSInteger kAKTestAnimationTickCount = 600;
+/// 表示位置の比較で許容する誤差
+static const float kAKTestPositionAccuracy = 0.01f;
+
 @implementation AKEnemyTests
 
 
@@ -330,6 +339,53 @@
     STAssertEquals(newPoint.y, 216.0f, @"正しい位置に移動していない");
 }
 
+/*
+ 横にまとめた障害物の場合に、タイル1個ずつ配置した場合と同じ位置に移動することを確認する。
+ 段差の近い方の判定を足元のタイルで行っていることを確認する。
+ */
+- (void)testCheckBlockPosition_19
+{
+    AKPlayData *tileData = [[[AKPlayData alloc] initWithScene:nil] autorelease];
+    [tileData createBlock:1 x:16.0f y:16.0f];
+    [tileData createBlock:1 x:48.0f y:16.0f];
+    [tileData createBlock:1 x:80.0f y:16.0f];
+    [tileData createBlock:6 x:112.0f y:48.0f];
+    
+    AKPlayData *mergedData = [[[AKPlayData alloc] initWithScene:nil] autorelease];
+    [mergedData createBlock:1 x:48.0f y:16.0f colCount:3 rowCount:1];
+    [mergedData createBlock:6 x:112.0f y:48.0f];
+    
+    CGPoint tilePoint = [AKEnemy checkBlockPosition:ccp(100, 50) size:CGSizeMake(32, 32) isReverse:NO data:tileData];
+    CGPoint mergedPoint = [AKEnemy checkBlockPosition:ccp(100, 50) size:CGSizeMake(32, 32) isReverse:NO data:mergedData];
+    
+    STAssertEquals(tilePoint.x, 112.0f, @"正しい位置に移動していない");
+    STAssertEquals(tilePoint.y, 80.0f, @"正しい位置に移動していない");
+    STAssertEquals(mergedPoint.x, tilePoint.x, @"まとめた障害物で移動先が異なる");
+    STAssertEquals(mergedPoint.y, tilePoint.y, @"まとめた障害物で移動先が異なる");
+}
+
+/*
+ 縦にまとめた障害物の場合に、頭より上のタイルを除外して足元のタイルに合わせることを確認する。
+ */
+- (void)testCheckBlockPosition_20
+{
+    AKPlayData *tileData = [[[AKPlayData alloc] initWithScene:nil] autorelease];
+    [tileData createBlock:6 x:16.0f y:16.0f];
+    [tileData createBlock:6 x:16.0f y:48.0f];
+    [tileData createBlock:6 x:16.0f y:80.0f];
+    
+    AKPlayData *mergedData = [[[AKPlayData alloc] initWithScene:nil] autorelease];
+    [mergedData createBlock:6 x:16.0f y:48.0f colCount:1 rowCount:3];
+    
+    CGPoint tilePoint = [AKEnemy checkBlockPosition:ccp(16, 44) size:CGSizeMake(32, 32) isReverse:NO data:tileData];
+    CGPoint mergedPoint = [AKEnemy checkBlockPosition:ccp(16, 44) size:CGSizeMake(32, 32) isReverse:NO data:mergedData];
+    
+    STAssertEquals(tilePoint.x, 16.0f, @"正しい位置に移動していない");
+    STAssertEquals(tilePoint.y, 80.0f, @"正しい位置に移動していない");
+    STAssertEquals(mergedPoint.x, tilePoint.x, @"まとめた障害物で移動先が異なる");
+    STAssertEquals(mergedPoint.y, tilePoint.y, @"まとめた障害物で移動先が異なる");
+}
+
 /*
  障害物がひとつもない場合にnilが返されることを確認する。
  */
@@ -337,7 +393,7 @@
 {
     AKPlayData *data = [[[AKPlayData alloc] initWithScene:nil] autorelease];
     
-    AKCharacter *blockAtFeet = [AKEnemy getBlockAtFeetAtX:16.0f from:64.0f isReverse:NO blocks:data.blocks];
+    AKCharacter *blockAtFeet = [AKEnemy getBlockAtFeetAtX:16.0f from:64.0f isReverse:NO blockGrid:data.blockGrid];
     
     STAssertNil(blockAtFeet, @"障害物がない場合にnil以外が返された");
 }
@@ -354,7 +410,7 @@
         block.isStaged = NO;
     }
 
-    AKCharacter *blockAtFeet = [AKEnemy getBlockAtFeetAtX:16.0f from:64.0f isReverse:NO blocks:data.blocks];
+    AKCharacter *blockAtFeet = [AKEnemy getBlockAtFeetAtX:16.0f from:64.0f isReverse:NO blockGrid:data.blockGrid];
     
     STAssertNil(blockAtFeet, @"配置フラグが立っていない障害物が検索対象になっている");
 }
@@ -370,7 +426,7 @@
     [data createBlock:1 x:16.0f y:240.0f];
     [data createBlock:1 x:48.0f y:200.0f];
     
-    AKCharacter *blockAtFeet = [AKEnemy getBlockAtFeetAtX:32.0f from:70.0f isReverse:NO blocks:data.blocks];
+    AKCharacter *blockAtFeet = [AKEnemy getBlockAtFeetAtX:32.0f from:70.0f isReverse:NO blockGrid:data.blockGrid];
     
     STAssertNotNil(blockAtFeet, @"障害物の取得ができていない");
     STAssertEquals(blockAtFeet.positionX, 16.0f, @"正しい障害物が取得できていない");
@@ -388,7 +444,7 @@
     [data createBlock:1 x:16.0f y:200.0f];
     [data createBlock:1 x:48.0f y:240.0f];
     
-    AKCharacter *blockAtFeet = [AKEnemy getBlockAtFeetAtX:32.0f from:70.0f isReverse:NO blocks:data.blocks];
+    AKCharacter *blockAtFeet = [AKEnemy getBlockAtFeetAtX:32.0f from:70.0f isReverse:NO blockGrid:data.blockGrid];
     
     STAssertNotNil(blockAtFeet, @"障害物の取得ができていない");
     STAssertEquals(blockAtFeet.positionX, 48.0f, @"正しい障害物が取得できていない");
@@ -406,7 +462,7 @@
     [data createBlock:1 x:16.0f y:200.0f];
     [data createBlock:1 x:48.0f y:240.0f];
     
-    AKCharacter *blockAtFeet = [AKEnemy getBlockAtFeetAtX:32.0f from:70.0f isReverse:YES blocks:data.blocks];
+    AKCharacter *blockAtFeet = [AKEnemy getBlockAtFeetAtX:32.0f from:70.0f isReverse:YES blockGrid:data.blockGrid];
     
     STAssertNotNil(blockAtFeet, @"障害物の取得ができていない");
     STAssertEquals(blockAtFeet.positionX, 16.0f, @"正しい障害物が取得できていない");
@@ -424,7 +480,7 @@
     [data createBlock:1 x:16.0f y:240.0f];
     [data createBlock:1 x:48.0f y:200.0f];
     
-    AKCharacter *blockAtFeet = [AKEnemy getBlockAtFeetAtX:32.0f from:70.0f isReverse:YES blocks:data.blocks];
+    AKCharacter *blockAtFeet = [AKEnemy getBlockAtFeetAtX:32.0f from:70.0f isReverse:YES blockGrid:data.blockGrid];
     
     STAssertNotNil(blockAtFeet, @"障害物の取得ができていない");
     STAssertEquals(blockAtFeet.positionX, 48.0f, @"正しい障害物が取得できていない");
@@ -442,7 +498,7 @@
     [data createBlock:1 x:16.0f y:200.0f];
     [data createBlock:3 x:48.0f y:200.0f];
     
-    AKCharacter *blockAtFeet = [AKEnemy getBlockAtFeetAtX:32.0f from:70.0f isReverse:NO blocks:data.blocks];
+    AKCharacter *blockAtFeet = [AKEnemy getBlockAtFeetAtX:32.0f from:70.0f isReverse:NO blockGrid:data.blockGrid];
     
     STAssertNotNil(blockAtFeet, @"障害物の取得ができていない");
     STAssertEquals(blockAtFeet.positionX, 16.0f, @"正しい障害物が取得できていない");
@@ -460,7 +516,7 @@
     [data createBlock:3 x:16.0f y:200.0f];
     [data createBlock:1 x:48.0f y:200.0f];
     
-    AKCharacter *blockAtFeet = [AKEnemy getBlockAtFeetAtX:32.0f from:70.0f isReverse:NO blocks:data.blocks];
+    AKCharacter *blockAtFeet = [AKEnemy getBlockAtFeetAtX:32.0f from:70.0f isReverse:NO blockGrid:data.blockGrid];
     
     STAssertNotNil(blockAtFeet, @"障害物の取得ができていない");
     STAssertEquals(blockAtFeet.positionX, 48.0f, @"正しい障害物が取得できていない");
@@ -478,7 +534,7 @@
     [data createBlock:1 x:16.0f y:200.0f];
     [data createBlock:3 x:48.0f y:200.0f];
     
-    AKCharacter *blockAtFeet = [AKEnemy getBlockAtFeetAtX:32.0f from:70.0f isReverse:YES blocks:data.blocks];
+    AKCharacter *blockAtFeet = [AKEnemy getBlockAtFeetAtX:32.0f from:70.0f isReverse:YES blockGrid:data.blockGrid];
     
     STAssertNotNil(blockAtFeet, @"障害物の取得ができていない");
     STAssertEquals(blockAtFeet.positionX, 16.0f, @"正しい障害物が取得できていない");
@@ -496,10 +552,115 @@
     [data createBlock:3 x:16.0f y:208.0f];
     [data createBlock:1 x:48.0f y:200.0f];
     
-    AKCharacter *blockAtFeet = [AKEnemy getBlockAtFeetAtX:32.0f from:70.0f isReverse:YES blocks:data.blocks];
+    AKCharacter *blockAtFeet = [AKEnemy getBlockAtFeetAtX:32.0f from:70.0f isReverse:YES blockGrid:data.blockGrid];
     
     STAssertNotNil(blockAtFeet, @"障害物の取得ができていない");
     STAssertEquals(blockAtFeet.positionX, 48.0f, @"正しい障害物が取得できていない");
     STAssertEquals(blockAtFeet.positionY, 200.0f, @"正しい障害物が取得できていない");
 }
+/*
+ 画像のパターン番号が連続していない敵(セミ)を生成して移動させた場合に、
+ 途中の番号のパターンでアニメーションできることを確認する。
+ */
+- (void)testAnimation_1
+{
+    AKPlayData *data = [[[AKPlayData alloc] initWithScene:nil] autorelease];
+    [data createEnemy:kAKTestEnemyCicada x:400 y:160 progress:0];
+    
+    AKEnemy *enemy = [data.enemyPool activeAtIndex:0];
+    STAssertNotNil(enemy.image, @"スプライトが作成されていない");
+    
+    // 移動を開始するとパターン11からのアニメーションとなる
+    CCSpriteFrameCache *cache = [CCSpriteFrameCache sharedSpriteFrameCache];
+    BOOL isAnimated = NO;
+    for (NSInteger i = 0; i < kAKTestAnimationTickCount && enemy.isStaged; i++) {
+        STAssertNoThrow([enemy move:data], @"移動処理で例外が発生した");
+        
+        if ([enemy.image isFrameDisplayed:[cache spriteFrameByName:@"Enemy_12_12.png"]]) {
+            isAnimated = YES;
+        }
+    }
+    
+    STAssertTrue(isAnimated, @"パターン12が表示されていない");
+}
+
+/*
+ 振り上げている鎌の数で表示パターンを切り替える敵(カマキリ)を生成して移動させた場合に、
+ 例外が発生しないことを確認する。
+ */
+- (void)testAnimation_2
+{
+    AKPlayData *data = [[[AKPlayData alloc] initWithScene:nil] autorelease];
+    [data createEnemy:kAKTestEnemyMantis x:400 y:160 progress:0];
+    
+    AKEnemy *enemy = [data.enemyPool activeAtIndex:0];
+    STAssertNotNil(enemy.image, @"スプライトが作成されていない");
+    
+    for (NSInteger i = 0; i < kAKTestAnimationTickCount && enemy.isStaged; i++) {
+        STAssertNoThrow([enemy move:data], @"移動処理で例外が発生した");
+    }
+}
+/*
+ 複数のタイルをまとめた障害物が、タイル1個ずつの障害物が並んでいた場合と同じ位置にタイルごとのスプライトを表示することを確認する。
+ */
+- (void)testBlockCellImages_1
+{
+    const NSInteger kAKColCount = 3;
+    const NSInteger kAKRowCount = 2;
+    
+    AKPlayData *data = [[[AKPlayData alloc] initWithScene:nil] autorelease];
+    [data createBlock:1 x:100.0f y:100.0f colCount:kAKColCount rowCount:kAKRowCount];
+    
+    AKBlock *block = [data.blockPool activeAtIndex:0];
+    STAssertNotNil(block.image, @"スプライトが作成されていない");
+    STAssertEquals(block.image.children.count, (NSUInteger)(kAKColCount * kAKRowCount - 1), @"タイルごとのスプライトの数が正しくない");
+    
+    [block updateImagePosition];
+    CGSize size = block.image.contentSize;
+    
+    // 左上のタイルの中心が、まとめたタイル全体の中心から左上にずれた位置にあることを確認する
+    CGPoint topLeft = [block.image convertToWorldSpace:ccp(size.width / 2.0f, size.height / 2.0f)];
+    STAssertEqualsWithAccuracy(topLeft.x, block.image.position.x - size.width * (kAKColCount - 1) / 2.0f,
+                               kAKTestPositionAccuracy, @"左上のタイルの位置が正しくない");
+    STAssertEqualsWithAccuracy(topLeft.y, block.image.position.y + size.height * (kAKRowCount - 1) / 2.0f,
+                               kAKTestPositionAccuracy, @"左上のタイルの位置が正しくない");
+    
+    // 残りのタイルが左上のタイルからタイルの大きさずつずれた位置にあることを確認する
+    for (CCSprite *cell in block.image.children) {
+        CGPoint position = [block.image convertToWorldSpace:cell.position];
+        float col = (position.x - topLeft.x) / size.width;
+        float row = (topLeft.y - position.y) / size.height;
+        STAssertEqualsWithAccuracy(col, roundf(col), kAKTestPositionAccuracy, @"タイルの位置が正しくない");
+        STAssertEqualsWithAccuracy(row, roundf(row), kAKTestPositionAccuracy, @"タイルの位置が正しくない");
+        STAssertTrue(col >= 0.0f && col < kAKColCount && row >= 0.0f && row < kAKRowCount, @"タイルの位置が範囲外");
+    }
+}
+
+/*
+ 敵弾エンジンの画像が、弾の種類の画像定義と生成からの経過フレーム数で決まるパターンを表示し、
+ 一時停止と再開で例外が発生しないことを確認する。
+ */
+- (void)testEnemyShotAnimation_1
+{
+    CCNode *parent = [CCNode node];
+    AKEnemyShotEngine *engine = [[[AKEnemyShotEngine alloc] initWithCapacity:4 parent:parent] autorelease];
+    [engine createNormalShotAtX:kAKStageSize.width / 2 y:kAKStageSize.height / 2 direction:AKNWayDirectionMake(0.0f) speed:0.0f];
+    
+    const struct AKEnemyShotImageDef *imageDef = [AKEnemyShot imageDefinitionOfType:kAKEnemyShotTypeNormal];
+    NSArray *frames = [AKCharacter spriteFramesOfImageName:[AKEnemyShot imageNameOfType:kAKEnemyShotTypeNormal]];
+    NSInteger patternCount = MAX(imageDef->animationFrame, 1);
+    NSInteger interval = MAX((NSInteger)imageDef->animationInterval, 1);
+    
+    for (NSInteger i = 1; i <= kAKTestAnimationTickCount; i++) {
+        [engine moveWithScrollSpeedX:0.0f scrollSpeedY:0.0f blockGrid:nil];
+        [engine updateSpritesWithAlpha:1.0f];
+        
+        CCSprite *sprite = [parent.children objectAtIndex:0];
+        NSInteger pattern = (i % (patternCount * interval)) / interval;
+        STAssertTrue([sprite isFrameDisplayed:[frames objectAtIndex:pattern]], @"表示パターンが正しくない:frame=%d", i);
+    }
+    
+    STAssertNoThrow([engine pauseSprites], @"一時停止で例外が発生した");
+    STAssertNoThrow([engine resumeSprites], @"再開で例外が発生した");
+}
 @end
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2013 Akihiro Kaneda.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1.Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   2.Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   3.Neither the name of the Monochrome Soft nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "AKFrameProfilerTests.h"
+
+@implementation AKFrameProfilerTests
+
+/*
+ 保持するフレーム数を超えて計測した場合に古いフレームから上書きされることを確認する。
+ */
+- (void)testRingBuffer_1
+{
+    AKFrameProfiler *profiler = [[[AKFrameProfiler alloc] initWithCapacity:4] autorelease];
+    
+    for (int i = 0; i < 6; i++) {
+        [profiler beginFrame];
+        [profiler setCount:i counter:kAKProfileCounterEnemy];
+        [profiler addCount:1 counter:kAKProfileCounterStep];
+        [profiler addCount:2 counter:kAKProfileCounterStep];
+        [profiler endFrame];
+    }
+    
+    STAssertEquals(profiler.frameCount, (NSInteger)6, @"計測したフレーム数が不正");
+    STAssertEquals([profiler storedFrameCount], (NSInteger)4, @"保持しているフレーム数が不正");
+    STAssertEquals([profiler frameAtIndex:0]->counters[kAKProfileCounterEnemy], (NSUInteger)2, @"最も古いフレームが不正");
+    STAssertEquals([profiler frameAtIndex:3]->counters[kAKProfileCounterEnemy], (NSUInteger)5, @"最も新しいフレームが不正");
+    STAssertEquals([profiler frameAtIndex:3]->counters[kAKProfileCounterStep], (NSUInteger)3, @"計数項目が加算されていない");
+}
+
+/*
+ CSV形式の文字列にヘッダー行と保持しているフレーム数分の行が出力されることを確認する。
+ */
+- (void)testCsvString_1
+{
+    AKFrameProfiler *profiler = [[[AKFrameProfiler alloc] initWithCapacity:8] autorelease];
+    
+    for (int i = 0; i < 3; i++) {
+        [profiler beginFrame];
+        uint64_t start = AKProfilerBegin(profiler);
+        AKProfilerEnd(profiler, kAKProfilePhaseEnemyMove, start);
+        [profiler endFrame];
+    }
+    
+    NSString *csv = [profiler csvString];
+    NSArray *lines = [[csv stringByTrimmingCharactersInSet:[NSCharacterSet newlineCharacterSet]]
+                      componentsSeparatedByString:@"\n"];
+    STAssertEquals(lines.count, (NSUInteger)4, @"行数が不正");
+    STAssertTrue([[lines objectAtIndex:0] hasPrefix:@"frame,Frame,TileMap"], @"ヘッダー行が不正");
+    STAssertEquals([[[lines objectAtIndex:1] componentsSeparatedByString:@","] count],
+                   (NSUInteger)(1 + kAKProfilePhaseCount + kAKProfileCounterCount), @"列数が不正");
+}
+
+/*
+ Chromeトレース形式の文字列がJSONとして読み込めることを確認する。
+ */
+- (void)testChromeTraceString_1
+{
+    AKFrameProfiler *profiler = [[[AKFrameProfiler alloc] initWithCapacity:8] autorelease];
+    
+    for (int i = 0; i < 2; i++) {
+        [profiler beginFrame];
+        uint64_t start = AKProfilerBegin(profiler);
+        AKProfilerEnd(profiler, kAKProfilePhaseTileMap, start);
+        [profiler setCount:10 counter:kAKProfileCounterEnemyShot];
+        [profiler endFrame];
+    }
+    
+    NSData *data = [[profiler chromeTraceString] dataUsingEncoding:NSUTF8StringEncoding];
+    NSDictionary *trace = [NSJSONSerialization JSONObjectWithData:data options:0 error:NULL];
+    STAssertNotNil(trace, @"JSONとして読み込めない");
+    
+    NSArray *events = [trace objectForKey:@"traceEvents"];
+    STAssertTrue(events.count >= 2, @"イベント数が不正");
+}
+
+/*
+ プロファイラがnilの場合は計測関数が時刻を取得しないことを確認する。
+ */
+- (void)testDisabled_1
+{
+    AKFrameProfiler *profiler = nil;
+    
+    uint64_t start = AKProfilerBegin(profiler);
+    STAssertEquals(start, (uint64_t)0, @"計測しない場合に時刻を取得している");
+    AKProfilerEnd(profiler, kAKProfilePhaseTileMap, start);
+}
+
+/*
+ デバッグビルドでフレーム中のメモリ確保回数が記録されることを確認する。
+ */
+- (void)testAllocCount_1
+{
+#ifdef DEBUG
+    AKFrameProfiler *profiler = [[[AKFrameProfiler alloc] initWithCapacity:2] autorelease];
+    
+    // メモリ確保を行わないフレーム
+    [profiler beginFrame];
+    [profiler endFrame];
+    
+    // メモリ確保を行うフレーム
+    [profiler beginFrame];
+    void *buffer = malloc(16);
+    [profiler endFrame];
+    free(buffer);
+    
+    STAssertEquals([profiler frameAtIndex:0]->counters[kAKProfileCounterAlloc], (NSUInteger)0, @"メモリ確保回数が不正");
+    STAssertTrue([profiler frameAtIndex:1]->counters[kAKProfileCounterAlloc] >= 1, @"メモリ確保が計測されていない");
+#endif
+}
+
+@end
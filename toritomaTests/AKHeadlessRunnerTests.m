@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2013 Akihiro Kaneda.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1.Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   2.Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   3.Neither the name of the Monochrome Soft nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "AKHeadlessRunnerTests.h"
+
+@implementation AKHeadlessRunnerTests
+
+/*
+ 画面なしでステージの状態更新が実行でき、スプライトとタイルマップのノードが作成されないことを確認する。
+ */
+- (void)testRunTicks_1
+{
+    AKHeadlessRunner *runner = [[AKHeadlessRunner alloc] initWithStageNo:1];
+    
+    [runner runTicks:600];
+    
+    STAssertEquals(runner.tickCount, (NSInteger)600, @"実行した回数が不正");
+    STAssertTrue(runner.data.tileMap.eventCount > 0, @"イベントが解析されていない");
+    STAssertNil(runner.data.tileMap.tileMap, @"タイルマップのノードが作成されている");
+    STAssertNil(runner.data.player.image, @"自機のスプライトが作成されている");
+    STAssertTrue(runner.data.batches.count == 0, @"バッチノードが作成されている");
+    
+    [runner release];
+}
+
+/*
+ 同じステージを同じ回数実行した場合に同じ状態になることを確認する。
+ */
+- (void)testRunTicks_2
+{
+    AKHeadlessRunner *runner1 = [[AKHeadlessRunner alloc] initWithStageNo:1];
+    [runner1 runTicks:900];
+    CGPoint position1 = runner1.data.playerPosition;
+    NSInteger enemyCount1 = runner1.data.enemyPool.activeCount;
+    NSInteger enemyShotCount1 = runner1.data.enemyShotEngine.count;
+    NSInteger blockCount1 = runner1.data.blockPool.activeCount;
+    [runner1 release];
+    
+    AKHeadlessRunner *runner2 = [[AKHeadlessRunner alloc] initWithStageNo:1];
+    [runner2 runTicks:900];
+    
+    STAssertEquals(runner2.data.playerPosition, position1, @"自機の位置が一致しない");
+    STAssertEquals(runner2.data.enemyPool.activeCount, enemyCount1, @"敵の数が一致しない");
+    STAssertEquals(runner2.data.enemyShotEngine.count, enemyShotCount1, @"敵弾の数が一致しない");
+    STAssertEquals(runner2.data.blockPool.activeCount, blockCount1, @"障害物の数が一致しない");
+    
+    [runner2 release];
+}
+
+/*
+ ステージ開始後の定常状態の状態更新でメモリ確保が行われないことを確認する。
+ メモリ確保回数はデバッグビルドでのみ計測される。
+ */
+- (void)testRunTicks_3
+{
+    AKHeadlessRunner *runner = [[AKHeadlessRunner alloc] initWithStageNo:1];
+    
+    // キャラクターの初回生成などが終わるまで実行する
+    [runner runTicks:600];
+    
+    // プロファイラを設定して1回ずつメモリ確保回数を計測する
+    runner.data.profiler = [[[AKFrameProfiler alloc] initWithCapacity:300] autorelease];
+    [runner runTicks:300];
+    
+    AKFrameProfiler *profiler = runner.data.profiler;
+    STAssertEquals([profiler storedFrameCount], (NSInteger)300, @"計測したフレーム数が不正");
+    for (NSInteger i = 0; i < [profiler storedFrameCount]; i++) {
+        STAssertEquals([profiler frameAtIndex:i]->counters[kAKProfileCounterAlloc], (NSUInteger)0,
+                       @"状態更新でメモリ確保が行われている:%d", i);
+    }
+    
+    [runner release];
+}
+
+/*
+ 解放時に画像不使用モードが元に戻ることを確認する。
+ */
+- (void)testDealloc_1
+{
+    STAssertFalse([AKCharacter isHeadless], @"実行前に画像不使用モードになっている");
+    
+    AKHeadlessRunner *runner = [[AKHeadlessRunner alloc] initWithStageNo:1];
+    
+    STAssertTrue([AKCharacter isHeadless], @"画像不使用モードになっていない");
+    
+    [runner release];
+    
+    STAssertFalse([AKCharacter isHeadless], @"画像不使用モードが元に戻っていない");
+}
+@end
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2013 Akihiro Kaneda.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1.Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   2.Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   3.Neither the name of the Monochrome Soft nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "AKInputReplayerTests.h"
+#import "AKHeadlessRunner.h"
+
+/// テストで記録する状態更新の回数
+static const NSInteger kAKTestTickCount = 300;
+
+/*
+ 自機の移動とシールドボタンの操作を行いながらステージ1を実行し、入力を記録する。
+ */
+static NSData *AKRecordTestInput(void)
+{
+    AKHeadlessRunner *runner = [[AKHeadlessRunner alloc] initWithStageNo:1];
+    runner.data.recorder = [[[AKInputRecorder alloc] initWithStageNo:1] autorelease];
+    
+    for (NSInteger i = 0; i < kAKTestTickCount; i++) {
+        
+        [runner.data movePlayerByDx:(i % 7) - 3.0f dy:(i % 5) - 2.0f];
+        
+        if (i == 100) {
+            [runner.data changeShield:YES];
+        }
+        else if (i == 150) {
+            [runner.data changeShield:NO];
+        }
+        
+        [runner runTicks:1];
+    }
+    
+    NSData *data = [[runner.data.recorder.data copy] autorelease];
+    [runner release];
+    
+    return data;
+}
+
+@implementation AKInputReplayerTests
+
+/*
+ 記録した入力を再生した場合にすべての状態更新でチェックサムが一致することを確認する。
+ */
+- (void)testReplay_1
+{
+    NSData *data = AKRecordTestInput();
+    
+    AKInputReplayer *replayer = [[[AKInputReplayer alloc] initWithData:data] autorelease];
+    AKHeadlessRunner *runner = [[AKHeadlessRunner alloc] initWithStageNo:replayer.stage];
+    
+    NSInteger mismatchTick = [runner runReplay:replayer];
+    
+    STAssertEquals(mismatchTick, kAKReplayNoMismatch, @"チェックサムが一致しない");
+    STAssertEquals(replayer.tickCount, kAKTestTickCount, @"再生した状態更新の回数が不正");
+    STAssertTrue([replayer isEnd], @"最後まで再生されていない");
+    
+    [runner release];
+}
+
+/*
+ 記録したチェックサムと異なる状態になった場合にその状態更新の番号が返されることを確認する。
+ */
+- (void)testReplay_2
+{
+    NSMutableData *data = [[AKRecordTestInput() mutableCopy] autorelease];
+    
+    // 最後の状態更新のチェックサムを書き換える
+    uint8_t *bytes = data.mutableBytes;
+    bytes[data.length - 1] ^= 0xFF;
+    
+    AKInputReplayer *replayer = [[[AKInputReplayer alloc] initWithData:data] autorelease];
+    AKHeadlessRunner *runner = [[AKHeadlessRunner alloc] initWithStageNo:replayer.stage];
+    
+    NSInteger mismatchTick = [runner runReplay:replayer];
+    
+    STAssertEquals(mismatchTick, kAKTestTickCount - 1, @"不一致の状態更新の番号が不正");
+    
+    [runner release];
+}
+
+/*
+ ヘッダーが不正なデータの場合に初期化に失敗することを確認する。
+ */
+- (void)testInitWithData_1
+{
+    uint8_t bytes[8] = {0};
+    NSData *data = [NSData dataWithBytes:bytes length:sizeof(bytes)];
+    
+    STAssertNil([[[AKInputReplayer alloc] initWithData:data] autorelease], @"不正なヘッダーで初期化された");
+}
+@end
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2013 Akihiro Kaneda.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1.Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   2.Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   3.Neither the name of the Monochrome Soft nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "AKNWayAngleTests.h"
+
+/// 許容誤差
+static const float kAKTestAccuracy = 0.0001f;
+
+@implementation AKNWayAngleTests
+
+/*
+ 中心角度指定で奇数弾を計算し、各弾の方向が角度から直接計算した値と一致することを確認する。
+ */
+- (void)testCalcDirections_1
+{
+    const NSInteger kAKCount = 5;
+    const float kAKInterval = M_PI / 8;
+    struct AKNWayDirection directions[kAKCount];
+    
+    NSInteger count = [AKNWayAngle calcDirections:directions
+                                  fromCenterAngle:M_PI / 2
+                                            count:kAKCount
+                                         interval:kAKInterval];
+    
+    STAssertEquals(count, kAKCount, nil);
+    
+    for (int i = 0; i < kAKCount; i++) {
+        float angle = M_PI / 2 + (i - 2) * kAKInterval;
+        STAssertEqualsWithAccuracy(directions[i].angle, angle, kAKTestAccuracy, nil);
+        STAssertEqualsWithAccuracy(directions[i].cos, cosf(angle), kAKTestAccuracy, nil);
+        STAssertEqualsWithAccuracy(directions[i].sin, sinf(angle), kAKTestAccuracy, nil);
+    }
+}
+
+/*
+ 2点間指定で偶数弾を計算し、中心の2発が自機方向を挟んで対称になることを確認する。
+ 多数の弾を回転で求めても方向が単位ベクトルのままであることを確認する。
+ */
+- (void)testCalcDirections_2
+{
+    const NSInteger kAKCount = 36;
+    const float kAKInterval = M_PI / 18;
+    struct AKNWayDirection directions[kAKCount];
+    
+    [AKNWayAngle calcDirections:directions
+                        fromSrc:CGPointMake(100.0f, 100.0f)
+                           dest:CGPointMake(0.0f, 100.0f)
+                          count:kAKCount
+                       interval:kAKInterval];
+    
+    STAssertEqualsWithAccuracy(directions[17].angle, (float)(M_PI - kAKInterval / 2), kAKTestAccuracy, nil);
+    STAssertEqualsWithAccuracy(directions[18].angle, (float)(M_PI + kAKInterval / 2), kAKTestAccuracy, nil);
+    STAssertEqualsWithAccuracy(directions[17].sin, -directions[18].sin, kAKTestAccuracy, nil);
+    
+    for (int i = 0; i < kAKCount; i++) {
+        float length = directions[i].cos * directions[i].cos + directions[i].sin * directions[i].sin;
+        STAssertEqualsWithAccuracy(length, 1.0f, kAKTestAccuracy, nil);
+    }
+}
+
+/*
+ 各象限の点に対して2点間の角度が正しく計算できることを確認する。
+ */
+- (void)testCalcDestAngleFrom_1
+{
+    CGPoint src = CGPointMake(0.0f, 0.0f);
+    
+    STAssertEqualsWithAccuracy([AKNWayAngle calcDestAngleFrom:src to:CGPointMake(1.0f, 1.0f)], (float)(M_PI / 4), kAKTestAccuracy, nil);
+    STAssertEqualsWithAccuracy([AKNWayAngle calcDestAngleFrom:src to:CGPointMake(-1.0f, 1.0f)], (float)(M_PI * 3 / 4), kAKTestAccuracy, nil);
+    STAssertEqualsWithAccuracy([AKNWayAngle calcDestAngleFrom:src to:CGPointMake(1.0f, -1.0f)], (float)(-M_PI / 4), kAKTestAccuracy, nil);
+    STAssertEqualsWithAccuracy([AKNWayAngle calcDestAngleFrom:src to:CGPointMake(0.0f, 1.0f)], (float)(M_PI / 2), kAKTestAccuracy, nil);
+}
+
+@end
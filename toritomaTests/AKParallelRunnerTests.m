@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2013 Akihiro Kaneda.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1.Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   2.Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   3.Neither the name of the Monochrome Soft nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "AKParallelRunnerTests.h"
+#import "AKHeadlessRunner.h"
+
+/// テストで並列実行する回数
+static const NSInteger kAKTestRunCount = 8;
+/// テストで1回に実行する状態更新の回数
+static const NSInteger kAKTestTickCount = 200;
+
+@implementation AKParallelRunnerTests
+
+/*
+ 同じ条件で2回並列実行した場合に、各実行の結果が一致することを確認する。
+ */
+- (void)testRunStage_1
+{
+    AKParallelRunner *runner1 = [[[AKParallelRunner alloc] init] autorelease];
+    AKParallelRunner *runner2 = [[[AKParallelRunner alloc] init] autorelease];
+    
+    [runner1 runStage:1 tickCount:kAKTestTickCount runCount:kAKTestRunCount];
+    [runner2 runStage:1 tickCount:kAKTestTickCount runCount:kAKTestRunCount];
+    
+    STAssertEquals(runner1.runCount, kAKTestRunCount, @"実行回数が不正");
+    STAssertEquals([runner1 totalTickCount], kAKTestTickCount * kAKTestRunCount, @"状態更新の合計回数が不正");
+    
+    for (NSInteger i = 0; i < kAKTestRunCount; i++) {
+        STAssertEquals([runner1 resultAtIndex:i]->tickCount, kAKTestTickCount, @"状態更新の回数が不正:%d", i);
+        STAssertEquals([runner1 resultAtIndex:i]->checksum, [runner2 resultAtIndex:i]->checksum, @"実行結果が一致しない:%d", i);
+    }
+}
+
+/*
+ 並列に実行した結果が、単独で実行した結果と一致することを確認する。
+ */
+- (void)testRunStage_2
+{
+    AKParallelRunner *single = [[[AKParallelRunner alloc] init] autorelease];
+    AKParallelRunner *parallel = [[[AKParallelRunner alloc] init] autorelease];
+    
+    [single runStage:1 tickCount:kAKTestTickCount runCount:1];
+    [parallel runStage:1 tickCount:kAKTestTickCount runCount:kAKTestRunCount];
+    
+    STAssertEquals([parallel resultAtIndex:0]->checksum, [single resultAtIndex:0]->checksum, @"並列実行で結果が変わった");
+    STAssertEquals([parallel resultAtIndex:0]->score, [single resultAtIndex:0]->score, @"並列実行でスコアが変わった");
+}
+
+/*
+ 同じ入力記録を並列に再生した場合に、すべてチェックサムが一致することを確認する。
+ */
+- (void)testRunReplays_1
+{
+    // 入力を記録する
+    AKHeadlessRunner *recorder = [[AKHeadlessRunner alloc] initWithStageNo:1];
+    recorder.data.recorder = [[[AKInputRecorder alloc] initWithStageNo:1] autorelease];
+    for (NSInteger i = 0; i < kAKTestTickCount; i++) {
+        [recorder.data movePlayerByDx:(i % 7) - 3.0f dy:(i % 5) - 2.0f];
+        [recorder runTicks:1];
+    }
+    NSData *data = [[recorder.data.recorder.data copy] autorelease];
+    uint32_t checksum = [recorder.data stateChecksum];
+    [recorder release];
+    
+    // 同じ入力記録を並列に再生する
+    NSMutableArray *replays = [NSMutableArray arrayWithCapacity:kAKTestRunCount];
+    for (NSInteger i = 0; i < kAKTestRunCount; i++) {
+        [replays addObject:data];
+    }
+    
+    AKParallelRunner *runner = [[[AKParallelRunner alloc] init] autorelease];
+    [runner runReplays:replays];
+    
+    for (NSInteger i = 0; i < kAKTestRunCount; i++) {
+        STAssertEquals([runner resultAtIndex:i]->mismatchTick, kAKReplayNoMismatch, @"チェックサムが一致しない:%d", i);
+        STAssertEquals([runner resultAtIndex:i]->checksum, checksum, @"再生後の状態が記録時と異なる:%d", i);
+    }
+}
+@end
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2013 Akihiro Kaneda.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1.Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   2.Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   3.Neither the name of the Monochrome Soft nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "AKPlayerTests.h"
+#import "AKHeadlessRunner.h"
+
+@implementation AKPlayerTests
+
+/*
+ オプションが自機の移動履歴を一定間隔ごとに追従することを確認する。
+ */
+- (void)testSetPosition_1
+{
+    // 障害物のないゲームデータで確認する
+    AKHeadlessRunner *runner = [[AKHeadlessRunner alloc] initWithStageNo:0];
+    AKPlayer *player = runner.data.player;
+    
+    player.positionX = 0.0f;
+    player.positionY = 100.0f;
+    player.chickenGauge = 100;
+    [player updateOptionCount];
+    STAssertEquals(player.optionCount, (NSInteger)3, @"オプション数が不正");
+    
+    // x座標を1ずつ増やしながら移動する
+    for (NSInteger i = 1; i <= 60; i++) {
+        [player setPositionX:i y:100.0f data:runner.data];
+    }
+    
+    // 移動前の座標0〜59が移動履歴に入っているため、20個ずつ前の座標に移動している
+    STAssertEquals([[player.options objectAtIndex:0] positionX], 40.0f, @"1個目のオプションの位置が不正");
+    STAssertEquals([[player.options objectAtIndex:1] positionX], 20.0f, @"2個目のオプションの位置が不正");
+    STAssertEquals([[player.options objectAtIndex:2] positionX], 0.0f, @"3個目のオプションの位置が不正");
+    
+    [runner release];
+}
+
+/*
+ チキンゲージに応じてオプションが配置、配置解除されることを確認する。
+ */
+- (void)testUpdateOptionCount_1
+{
+    AKHeadlessRunner *runner = [[AKHeadlessRunner alloc] initWithStageNo:0];
+    AKPlayer *player = runner.data.player;
+    
+    player.chickenGauge = 50;
+    [player updateOptionCount];
+    STAssertEquals(player.optionCount, (NSInteger)2, @"オプション数が不正");
+    STAssertTrue([[player.options objectAtIndex:1] isStaged], @"オプションが配置されていない");
+    STAssertFalse([[player.options objectAtIndex:2] isStaged], @"オプションが配置されている");
+    
+    player.chickenGauge = 0;
+    [player updateOptionCount];
+    STAssertEquals(player.optionCount, (NSInteger)0, @"オプション数が不正");
+    for (AKOption *option in player.options) {
+        STAssertFalse(option.isStaged, @"オプションの配置が解除されていない");
+    }
+    
+    [runner release];
+}
+@end
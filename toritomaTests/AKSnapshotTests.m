@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2013 Akihiro Kaneda.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1.Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   2.Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   3.Neither the name of the Monochrome Soft nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "AKSnapshotTests.h"
+#import "AKHeadlessRunner.h"
+
+/// 保存バッファの初期サイズ
+static const NSUInteger kAKTestSnapshotCapacity = 1024;
+
+/*
+ 自機を移動させながら指定した回数の状態更新を行う。
+ 移動量は状態更新の番号から決めるため、同じ番号から実行すれば同じ入力となる。
+ */
+static void AKRunTestTicks(AKHeadlessRunner *runner, NSInteger start, NSInteger count)
+{
+    for (NSInteger i = start; i < start + count; i++) {
+        [runner.data movePlayerByDx:(i % 7) - 3.0f dy:(i % 5) - 2.0f];
+        [runner runTicks:1];
+    }
+}
+
+@implementation AKSnapshotTests
+
+/*
+ 保存した状態に復元して同じ入力で実行した場合に同じ状態になることを確認する。
+ */
+- (void)testReadSnapshot_1
+{
+    AKHeadlessRunner *runner = [[AKHeadlessRunner alloc] initWithStageNo:1];
+    AKSnapshot *snapshot = [[[AKSnapshot alloc] initWithCapacity:kAKTestSnapshotCapacity] autorelease];
+    
+    AKRunTestTicks(runner, 0, 200);
+    
+    // 状態を保存する
+    [runner.data writeSnapshot:snapshot];
+    uint32_t savedChecksum = [runner.data stateChecksum];
+    
+    // 保存後に実行した結果を記憶する
+    AKRunTestTicks(runner, 200, 200);
+    uint32_t checksum = [runner.data stateChecksum];
+    
+    // 保存した状態に復元する
+    STAssertTrue([runner.data readSnapshot:snapshot], @"復元に失敗");
+    STAssertEquals([runner.data stateChecksum], savedChecksum, @"復元直後の状態が保存時と異なる");
+    
+    // 同じ入力で実行した結果が一致することを確認する
+    AKRunTestTicks(runner, 200, 200);
+    STAssertEquals([runner.data stateChecksum], checksum, @"復元後に実行した状態が異なる");
+    
+    [runner release];
+}
+
+/*
+ 保存データから作成した状態を別のゲームデータに復元できることを確認する。
+ */
+- (void)testReadSnapshot_2
+{
+    AKHeadlessRunner *runner = [[AKHeadlessRunner alloc] initWithStageNo:1];
+    AKSnapshot *snapshot = [[[AKSnapshot alloc] initWithCapacity:kAKTestSnapshotCapacity] autorelease];
+    
+    AKRunTestTicks(runner, 0, 300);
+    [runner.data writeSnapshot:snapshot];
+    
+    // 保存データから別のゲームデータに復元する
+    AKSnapshot *loaded = [[[AKSnapshot alloc] initWithData:[snapshot data]] autorelease];
+    STAssertNotNil(loaded, @"保存データの読み込みに失敗");
+    
+    AKHeadlessRunner *restored = [[AKHeadlessRunner alloc] initWithStageNo:1];
+    STAssertTrue([restored.data readSnapshot:loaded], @"復元に失敗");
+    STAssertEquals([restored.data stateChecksum], [runner.data stateChecksum], @"復元した状態が異なる");
+    
+    // 同じ入力で実行した結果が一致することを確認する
+    AKRunTestTicks(runner, 300, 100);
+    AKRunTestTicks(restored, 300, 100);
+    STAssertEquals([restored.data stateChecksum], [runner.data stateChecksum], @"復元後に実行した状態が異なる");
+    
+    [restored release];
+    [runner release];
+}
+
+/*
+ 2回目以降の保存で保存バッファの拡張が発生しないことを確認する。
+ */
+- (void)testWriteSnapshot_1
+{
+    AKHeadlessRunner *runner = [[AKHeadlessRunner alloc] initWithStageNo:1];
+    AKSnapshot *snapshot = [[[AKSnapshot alloc] initWithCapacity:kAKTestSnapshotCapacity] autorelease];
+    
+    AKRunTestTicks(runner, 0, 100);
+    [runner.data writeSnapshot:snapshot];
+    NSUInteger capacity = snapshot.capacity;
+    NSUInteger length = snapshot.length;
+    
+    // 同じ状態を繰り返し保存する
+    for (NSInteger i = 0; i < 10; i++) {
+        [runner.data writeSnapshot:snapshot];
+    }
+    
+    STAssertEquals(snapshot.capacity, capacity, @"保存バッファが拡張された");
+    STAssertEquals(snapshot.length, length, @"保存データの長さが異なる");
+    
+    [runner release];
+}
+
+/*
+ ヘッダーが不正なデータの場合に初期化に失敗することを確認する。
+ */
+- (void)testInitWithData_1
+{
+    uint8_t bytes[16] = {0};
+    NSData *data = [NSData dataWithBytes:bytes length:sizeof(bytes)];
+    
+    STAssertNil([[[AKSnapshot alloc] initWithData:data] autorelease], @"不正なヘッダーで初期化された");
+}
+@end
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2013 Akihiro Kaneda.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1.Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   2.Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   3.Neither the name of the Monochrome Soft nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "AKStagePackTests.h"
+#import "AKHeadlessRunner.h"
+
+/// テストで読み込むステージ番号
+static const NSInteger kAKTestStage = 1;
+/// テストで実行する状態更新の回数
+static const NSInteger kAKTestTickCount = 600;
+
+@implementation AKStagePackTests
+
+/*
+ タイルマップファイルから変換したステージパックをファイルに書き込み、
+ マッピングして読み込んだ内容が変換結果と一致することを確認する。
+ */
+- (void)testInitWithContentsOfFile_1
+{
+    AKStagePack *compiled = [[[AKStagePack alloc] initWithTileMapFile:[AKStagePack tileMapFileNameOfStageNo:kAKTestStage]] autorelease];
+    STAssertNotNil(compiled, @"タイルマップファイルの変換に失敗");
+    STAssertTrue(compiled.header->eventCount > 0, @"イベントが変換されていない");
+    STAssertTrue(compiled.header->layerCount > 0, @"表示レイヤーが変換されていない");
+    
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:@"AKStagePackTests.akpack"];
+    STAssertTrue([compiled writeToFile:path], @"ファイルの書き込みに失敗");
+    
+    AKStagePack *mapped = [[[AKStagePack alloc] initWithContentsOfFile:path] autorelease];
+    STAssertNotNil(mapped, @"ファイルの読み込みに失敗");
+    STAssertNil(mapped.tileMapFileName, @"変換元のファイル名が設定されている");
+    
+    // ヘッダーを含むデータ全体が一致することを確認する
+    STAssertEquals(mapped.header->length, compiled.header->length, @"データの長さが不正");
+    STAssertTrue(memcmp(mapped.header, compiled.header, compiled.header->length) == 0, @"データが一致しない");
+    
+    // 列ごとの開始位置から参照したイベントが一致することを確認する
+    NSInteger colCount = compiled.header->mapWidth;
+    STAssertEquals(mapped.colStart[colCount], compiled.header->eventCount, @"終端の位置が不正");
+    for (NSInteger i = 0; i < colCount; i++) {
+        STAssertTrue(mapped.colStart[i] <= mapped.colStart[i + 1], @"列の開始位置が昇順でない:%d", i);
+    }
+    
+    for (NSInteger i = 0; i < compiled.header->layerCount; i++) {
+        const struct AKStagePackLayer *layer = [mapped layerAtIndex:i];
+        STAssertTrue(memcmp([mapped tilesOfLayerAtIndex:i], [compiled tilesOfLayerAtIndex:i], sizeof(uint32_t) * layer->width * layer->height) == 0, @"タイルが一致しない:%d", i);
+    }
+    
+    [[NSFileManager defaultManager] removeItemAtPath:path error:NULL];
+}
+
+/*
+ 不正なステージパックファイルは読み込みに失敗することを確認する。
+ */
+- (void)testInitWithContentsOfFile_2
+{
+    AKStagePack *compiled = [[[AKStagePack alloc] initWithTileMapFile:[AKStagePack tileMapFileNameOfStageNo:kAKTestStage]] autorelease];
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:@"AKStagePackTests.akpack"];
+    
+    // 末尾が欠けたファイル
+    NSData *data = [NSData dataWithBytes:compiled.header length:compiled.header->length - 4];
+    [data writeToFile:path atomically:YES];
+    STAssertNil([[[AKStagePack alloc] initWithContentsOfFile:path] autorelease], @"末尾が欠けたファイルを読み込んだ");
+    
+    // 識別子が異なるファイル
+    NSMutableData *mutableData = [NSMutableData dataWithBytes:compiled.header length:compiled.header->length];
+    ((struct AKStagePackHeader *)mutableData.mutableBytes)->magic = 0;
+    [mutableData writeToFile:path atomically:YES];
+    STAssertNil([[[AKStagePack alloc] initWithContentsOfFile:path] autorelease], @"識別子が異なるファイルを読み込んだ");
+    
+    // 存在しないファイル
+    [[NSFileManager defaultManager] removeItemAtPath:path error:NULL];
+    STAssertNil([[[AKStagePack alloc] initWithContentsOfFile:path] autorelease], @"存在しないファイルを読み込んだ");
+}
+
+/*
+ タイルマップファイルから変換したステージパックとファイルから読み込んだステージパックで、
+ 同じ回数の状態更新を実行した結果が一致することを確認する。
+ */
+- (void)testReadScript_1
+{
+    AKStagePack *compiled = [[[AKStagePack alloc] initWithTileMapFile:[AKStagePack tileMapFileNameOfStageNo:kAKTestStage]] autorelease];
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:@"AKStagePackTests.akpack"];
+    [compiled writeToFile:path];
+    AKStagePack *mapped = [[[AKStagePack alloc] initWithContentsOfFile:path] autorelease];
+    
+    AKHeadlessRunner *runner1 = [[AKHeadlessRunner alloc] initWithStageNo:0];
+    [runner1.data readScript:kAKTestStage stagePack:compiled];
+    [runner1 runTicks:kAKTestTickCount];
+    
+    AKHeadlessRunner *runner2 = [[AKHeadlessRunner alloc] initWithStageNo:0];
+    [runner2.data readScript:kAKTestStage stagePack:mapped];
+    [runner2 runTicks:kAKTestTickCount];
+    
+    STAssertTrue(runner1.data.tileMap.eventCount > 0, @"イベントが読み込まれていない");
+    STAssertEquals([runner1.data stateChecksum], [runner2.data stateChecksum], @"実行結果が一致しない");
+    
+    [runner1 release];
+    [runner2 release];
+    
+    [[NSFileManager defaultManager] removeItemAtPath:path error:NULL];
+}
+/*
+ 障害物レイヤーが表示レイヤーに含まれないことを確認する。
+ 障害物の画像は障害物のキャラクターがバッチノードに表示するため、タイルマップでは表示しない。
+ */
+- (void)testInitWithTileMapFile_1
+{
+    AKStagePack *compiled = [[[AKStagePack alloc] initWithTileMapFile:[AKStagePack tileMapFileNameOfStageNo:kAKTestStage]] autorelease];
+    STAssertNotNil(compiled, @"タイルマップファイルの変換に失敗");
+    
+    for (NSInteger i = 0; i < compiled.header->layerCount; i++) {
+        const struct AKStagePackLayer *layer = [compiled layerAtIndex:i];
+        STAssertTrue(strncmp(layer->name, "Block", sizeof(layer->name)) != 0, @"障害物レイヤーが表示レイヤーに含まれている");
+    }
+}
+@end
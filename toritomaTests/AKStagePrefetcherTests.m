@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2013 Akihiro Kaneda.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1.Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   2.Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   3.Neither the name of the Monochrome Soft nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "AKStagePrefetcherTests.h"
+
+/// テストで読み込むステージ番号
+static const NSInteger kAKTestStage = 1;
+/// リソースにないステージ番号
+static const NSInteger kAKTestMissingStage = 99;
+
+@implementation AKStagePrefetcherTests
+
+/*
+ リソースにないステージは先読みしないことを確認する。
+ */
+- (void)testPrefetchStageNo_1
+{
+    AKStagePrefetcher *prefetcher = [[[AKStagePrefetcher alloc] init] autorelease];
+    
+    [prefetcher prefetchStageNo:kAKTestMissingStage];
+    
+    STAssertEquals(prefetcher.stage, (NSInteger)0, @"リソースにないステージを先読みしている");
+    STAssertTrue([prefetcher isReady], @"先読みしていないのに完了していない");
+}
+
+/*
+ 先読みしたステージパックを受け取れること、受け取り後は先読みしていない状態に戻ることを確認する。
+ */
+- (void)testTakeStagePackOfStageNo_1
+{
+    AKStagePrefetcher *prefetcher = [[[AKStagePrefetcher alloc] init] autorelease];
+    
+    [prefetcher prefetchStageNo:kAKTestStage];
+    STAssertEquals(prefetcher.stage, kAKTestStage, @"先読み中のステージ番号が不正");
+    
+    AKStagePack *stagePack = [prefetcher takeStagePackOfStageNo:kAKTestStage];
+    STAssertNotNil(stagePack, @"ステージパックを受け取れない");
+    STAssertTrue(stagePack.header->eventCount > 0, @"イベントが読み込まれていない");
+    STAssertTrue(prefetcher.waitTime >= 0.0, @"待った時間が不正");
+    STAssertEquals(prefetcher.stage, (NSInteger)0, @"受け取り後に先読み中のまま");
+    STAssertTrue([prefetcher isReady], @"受け取り後に完了していない");
+}
+
+/*
+ 先読みしていないステージを要求した場合はその場で作成し、待った時間が0となることを確認する。
+ */
+- (void)testTakeStagePackOfStageNo_2
+{
+    AKStagePrefetcher *prefetcher = [[[AKStagePrefetcher alloc] init] autorelease];
+    
+    AKStagePack *stagePack = [prefetcher takeStagePackOfStageNo:kAKTestStage];
+    STAssertNotNil(stagePack, @"ステージパックを作成できない");
+    STAssertEquals(prefetcher.waitTime, 0.0, @"先読みしていないのに待った時間がある");
+}
+@end
@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2013 Akihiro Kaneda.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   1.Redistributions of source code must retain the above copyright notice,
+ *     this list of conditions and the following disclaimer.
+ *   2.Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *   3.Neither the name of the Monochrome Soft nor the names of its contributors
+ *     may be used to endorse or promote products derived from this software
+ *     without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import "AKTileMapTests.h"
+#import "AKHeadlessRunner.h"
+
+/// 短いステージの列数
+static const NSInteger kAKTestShortColCount = 100;
+/// 長いステージの列数
+static const NSInteger kAKTestLongColCount = 10000;
+/// テストのステージの行数
+static const NSInteger kAKTestRowCount = 9;
+/// テストのステージのタイルサイズ
+static const NSInteger kAKTestTileSize = 32;
+/// テストのスクロールスピード
+static const float kAKTestScrollSpeed = 4.0f;
+/// テストで実行する状態更新の回数
+static const NSInteger kAKTestTickCount = 600;
+/// 進行待ちのイベントのテストのイベント(実行する進行度の順に並べない)
+static const struct AKTileMapEvent kAKTestWaitEvents[] = {
+    {kAKTileMapEventTypeScrollSpeedX, 10, 5, 0.0f},
+    {kAKTileMapEventTypeScrollSpeedX, 20, 2, 0.0f},
+    {kAKTileMapEventTypeScrollSpeedX, 30, 8, 0.0f}
+};
+
+/*!
+ @brief テスト用のステージパック作成
+ 
+ 全タイルを埋めた表示レイヤーが1つのステージパックファイルを作成して読み込む。
+ イベントはすべて先頭の列に配置する。
+ @param colCount 列数
+ @param events イベント
+ @param eventCount イベントの数
+ @return ステージパック
+ */
+static AKStagePack *AKCreateTestStagePack(NSInteger colCount, const struct AKTileMapEvent *events, NSInteger eventCount)
+{
+    struct AKStagePackHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = kAKStagePackMagic;
+    header.version = kAKStagePackVersion;
+    header.layerCount = 1;
+    header.mapWidth = colCount;
+    header.mapHeight = kAKTestRowCount;
+    header.tileWidth = kAKTestTileSize;
+    header.tileHeight = kAKTestTileSize;
+    header.eventCount = eventCount;
+    header.waitEventCapacity = MAX(eventCount, 1);
+    
+    struct AKStagePackLayer layer;
+    memset(&layer, 0, sizeof(layer));
+    strcpy(layer.name, "Background");
+    strcpy(layer.image, "Back.png");
+    layer.width = colCount;
+    layer.height = kAKTestRowCount;
+    layer.opacity = 255;
+    layer.minGid = 1;
+    layer.maxGid = 1;
+    layer.firstGid = 1;
+    layer.tileWidth = kAKTestTileSize;
+    layer.tileHeight = kAKTestTileSize;
+    
+    NSMutableData *colStart = [NSMutableData dataWithLength:sizeof(int32_t) * (colCount + 1)];
+    int32_t *starts = colStart.mutableBytes;
+    for (NSInteger i = 1; i <= colCount; i++) {
+        starts[i] = eventCount;
+    }
+    
+    NSMutableData *tiles = [NSMutableData dataWithLength:sizeof(uint32_t) * colCount * kAKTestRowCount];
+    uint32_t *gids = tiles.mutableBytes;
+    for (NSInteger i = 0; i < colCount * kAKTestRowCount; i++) {
+        gids[i] = 1;
+    }
+    
+    header.length = sizeof(header) + colStart.length + sizeof(struct AKTileMapEvent) * eventCount + sizeof(layer) + tiles.length;
+    
+    NSMutableData *data = [NSMutableData dataWithBytes:&header length:sizeof(header)];
+    [data appendData:colStart];
+    [data appendBytes:events length:sizeof(struct AKTileMapEvent) * eventCount];
+    [data appendBytes:&layer length:sizeof(layer)];
+    [data appendData:tiles];
+    
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSString stringWithFormat:@"AKTileMapTests_%d.akpack", colCount]];
+    [data writeToFile:path atomically:YES];
+    
+    AKStagePack *stagePack = [[[AKStagePack alloc] initWithContentsOfFile:path] autorelease];
+    [[NSFileManager defaultManager] removeItemAtPath:path error:NULL];
+    
+    return stagePack;
+}
+
+@implementation AKTileMapTests
+
+/*
+ ステージの長さによらず、読み込み時に作成するチャンクの範囲が同じになることを確認する。
+ */
+- (void)testUpdateChunks_1
+{
+    // 画面サイズを固定するために画面なし実行のゲームデータを作成しておく
+    AKHeadlessRunner *runner = [[AKHeadlessRunner alloc] initWithStageNo:0];
+    
+    AKStagePack *shortPack = AKCreateTestStagePack(kAKTestShortColCount, NULL, 0);
+    AKStagePack *longPack = AKCreateTestStagePack(kAKTestLongColCount, NULL, 0);
+    STAssertNotNil(shortPack, @"短いステージの読み込みに失敗");
+    STAssertNotNil(longPack, @"長いステージの読み込みに失敗");
+    
+    AKTileMap *shortMap = [[[AKTileMap alloc] initWithStagePack:shortPack layer:nil] autorelease];
+    AKTileMap *longMap = [[[AKTileMap alloc] initWithStagePack:longPack layer:nil] autorelease];
+    
+    STAssertEquals(shortMap.firstChunk, (NSInteger)0, @"最初のチャンク番号が不正");
+    STAssertTrue(shortMap.chunkCount > 0, @"チャンクが作成されていない");
+    STAssertEquals(longMap.firstChunk, shortMap.firstChunk, @"最初のチャンク番号が異なる");
+    STAssertEquals(longMap.chunkCount, shortMap.chunkCount, @"チャンクの数が異なる");
+    
+    [runner release];
+}
+
+/*
+ スクロールに合わせて画面外に出たチャンクが解放され、チャンクの数が一定に保たれることを確認する。
+ */
+- (void)testUpdateChunks_2
+{
+    AKHeadlessRunner *runner = [[AKHeadlessRunner alloc] initWithStageNo:0];
+    runner.data.scrollSpeedX = kAKTestScrollSpeed;
+    
+    AKTileMap *map = [[[AKTileMap alloc] initWithStagePack:AKCreateTestStagePack(kAKTestLongColCount, NULL, 0) layer:nil] autorelease];
+    NSInteger initialCount = map.chunkCount;
+    
+    NSInteger maxCount = 0;
+    for (NSInteger i = 0; i < kAKTestTickCount; i++) {
+        [map update:runner.data];
+        maxCount = MAX(maxCount, map.chunkCount);
+    }
+    
+    // 画面の左端を越えたチャンクが解放されている
+    STAssertTrue(map.firstChunk > 0, @"スクロールしたチャンクが解放されていない");
+    
+    // 初期位置では左側の余白がないため、スクロール中は境界をまたぐ1個と左側の余白の1個までしか増えない
+    STAssertTrue(maxCount <= initialCount + 2, @"チャンクの数が増え続けている:%d", maxCount);
+    
+    [runner release];
+}
+
+/*
+ 進行待ちのイベントが進行度の到達した順に実行され、到達していないものは待機し続けることを確認する。
+ */
+- (void)testAddProgress_1
+{
+    AKHeadlessRunner *runner = [[AKHeadlessRunner alloc] initWithStageNo:0];
+    runner.data.scrollSpeedX = 0.0f;
+    
+    NSInteger eventCount = sizeof(kAKTestWaitEvents) / sizeof(kAKTestWaitEvents[0]);
+    AKTileMap *map = [[[AKTileMap alloc] initWithStagePack:AKCreateTestStagePack(kAKTestShortColCount, kAKTestWaitEvents, eventCount)
+                                                     layer:nil] autorelease];
+    
+    // 先頭の列のイベントはすべて進行待ちになる
+    [map update:runner.data];
+    STAssertEquals(map.waitEventCount, eventCount, @"進行待ちのイベントの数が不正");
+    STAssertEquals(runner.data.scrollSpeedX, 0.0f, @"進行度に到達していないイベントが実行された");
+    
+    // 進行度2のイベントのみ実行される
+    [map addProgress:2 data:runner.data];
+    STAssertEquals(map.waitEventCount, eventCount - 1, @"進行待ちのイベントの数が不正");
+    STAssertEquals(runner.data.scrollSpeedX, 2.0f, @"進行度2のイベントが実行されていない");
+    
+    // 進行度5のイベントのみ実行される
+    [map addProgress:3 data:runner.data];
+    STAssertEquals(map.waitEventCount, eventCount - 2, @"進行待ちのイベントの数が不正");
+    STAssertEquals(runner.data.scrollSpeedX, 1.0f, @"進行度5のイベントが実行されていない");
+    
+    // 残りのイベントが実行される
+    [map addProgress:10 data:runner.data];
+    STAssertEquals(map.waitEventCount, (NSInteger)0, @"進行待ちのイベントが残っている");
+    STAssertEquals(runner.data.scrollSpeedX, 3.0f, @"進行度8のイベントが実行されていない");
+    
+    [runner release];
+}
+@end